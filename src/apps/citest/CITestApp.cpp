@@ -14,7 +14,6 @@
 
 #include "crosspad/app/AppRegistrar.hpp"
 #include "crosspad-gui/platform/IGuiPlatform.h"
-#include "crosspad/audio/AudioRingBuffer.hpp"
 #include "crosspad/synth/ISynthEngine.hpp"
 #include "crosspad/platform/PlatformServices.hpp"
 
@@ -152,9 +151,22 @@ static void delayMs(uint32_t ms) {
     vTaskDelay(pdMS_TO_TICKS(ms));
 }
 
-static void drainTap(crosspad::AudioRingBuffer<int16_t>& tap) {
-    int16_t junk[512];
-    while (tap.available() > 0) tap.read(junk, 512);
+/// Read everything the tap has for @p cur into @p out.
+static void drainTap(AudioBroadcastTap& tap, AudioBroadcastTap::Cursor& cur,
+                     std::vector<int16_t>& out) {
+    int16_t chunk[512 * 2];
+    while (uint32_t n = tap.read(cur, chunk, 512))
+        out.insert(out.end(), chunk, chunk + n * 2);
+}
+
+/// Capture from @p tap while waiting @p ms (reads every 20 ms so the
+/// ring never overruns).
+static void captureFor(AudioBroadcastTap& tap, AudioBroadcastTap::Cursor& cur,
+                       std::vector<int16_t>& out, uint32_t ms) {
+    for (uint32_t waited = 0; waited < ms; waited += 20) {
+        delayMs(20);
+        drainTap(tap, cur, out);
+    }
 }
 
 // ── Test runner (runs in FreeRTOS task) ──
@@ -165,9 +177,6 @@ static void testRunnerTask(void* pvParam) {
     auto& mixer = getMixerEngine();
     auto* synth = pc_platform_get_synth_engine();
 
-    // Tap buffer: 2 seconds stereo at 48kHz
-    crosspad::AudioRingBuffer<int16_t> tapBuf(48000 * 2 * 2);
-
     if (!synth) {
         for (int i = 0; i < NUM_STAGES; i++)
             setStage(i, StageResult::FAIL, "no synth engine");
@@ -338,30 +347,26 @@ static void testRunnerTask(void* pvParam) {
     {
         setStage(5, StageResult::RUNNING);
 
-        // Enable tap on OUT1
-        mixer.setTapOutput(MixerOutput::OUT1);
-        mixer.setTapBuffer(&tapBuf);
-        drainTap(tapBuf);  // clear any stale data
+        // Attach to the OUT1 tap (starts at the live edge, no stale data)
+        auto& tap = mixer.outputTap(MixerOutput::OUT1);
+        auto cursor = tap.attach();
+        std::vector<int16_t> captured;
+        captured.reserve(48000 * 2);
 
         synth->noteOn(60, 100);
-        delayMs(500);  // capture ~0.5s of audio
+        captureFor(tap, cursor, captured, 500);  // capture ~0.5s of audio
         synth->noteOff(60);
-        delayMs(100);
+        captureFor(tap, cursor, captured, 100);
 
-        mixer.setTapBuffer(nullptr);  // disable tap
+        tap.detach();
 
-        // Read captured audio
-        size_t avail = tapBuf.available();
-        int frames = (int)(avail / 2);  // stereo pairs
+        int frames = (int)(captured.size() / 2);  // stereo pairs
 
         if (frames < 100) {
             char detail[128];
             snprintf(detail, sizeof(detail), "only %d frames captured", frames);
             setStage(5, StageResult::FAIL, detail);
         } else {
-            std::vector<int16_t> captured(avail);
-            tapBuf.read(captured.data(), avail);
-
             auto stats = analyzeAudio(captured.data(), frames);
 
             char detail[128];
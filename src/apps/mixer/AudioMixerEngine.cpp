@@ -9,15 +9,13 @@
 #include "audio/PcAudio.hpp"
 #include "audio/PcAudioInput.hpp"
 #include "synth/MlPianoSynth.hpp"
-
-#include <ArduinoJson.h>
+#include "pc_stubs/StateSnapshot.hpp"
 
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
 #include <chrono>
 #include <vector>
-#include <fstream>
 
 AudioMixerEngine::~AudioMixerEngine()
 {
@@ -249,10 +247,11 @@ void AudioMixerEngine::mixerThreadFunc()
             std::memset(inBuf[2].data(), 0, STEREO_SAMPLES * sizeof(int16_t));
         }
 
-        // ── 2. Compute per-channel peaks ──
+        // ── 2. Compute per-channel peaks, feed input taps ──
         for (int ch = 0; ch < MIXER_NUM_INPUTS; ch++) {
             computePeak(inBuf[ch].data(), CHUNK,
                         channels_[ch].peakL, channels_[ch].peakR);
+            inputTaps_[ch].write(inBuf[ch].data(), CHUNK, sampleRate);
         }
 
         // ── 3. Solo logic ──
@@ -339,11 +338,11 @@ void AudioMixerEngine::mixerThreadFunc()
                 }
             }
 
-            // Write to tap buffer (for CI audio capture)
+            // Feed output taps (CI capture, remote audio_stream / shm)
+            outputTaps_[out].write(outBuf.data(), CHUNK, sampleRate);
             if (out == tapOutput_.load(std::memory_order_relaxed)) {
-                auto* tap = tapBuffer_.load(std::memory_order_relaxed);
-                if (tap) {
-                    tap->write(outBuf.data(), STEREO_SAMPLES);
+                if (auto sink = tapSink_.load(std::memory_order_relaxed)) {
+                    sink(outBuf.data(), CHUNK, sampleRate);
                 }
             }
         }
@@ -384,102 +383,59 @@ void AudioMixerEngine::setDefaults()
 
 // ── State persistence ──
 
-void AudioMixerEngine::saveState(const std::string& path) const
+AudioMixerEngine::State AudioMixerEngine::captureState() const
 {
-    JsonDocument doc;
-
-    // Route matrix
-    JsonArray routesArr = doc["routes"].to<JsonArray>();
+    State st;
     for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
         for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
-            JsonObject r = routesArr.add<JsonObject>();
-            r["in"] = i;
-            r["out"] = o;
-            r["enabled"] = routes_[i][o].enabled.load(std::memory_order_relaxed);
-            r["volume"] = routes_[i][o].volume.load(std::memory_order_relaxed);
+            st.routes[i][o].volume  = routes_[i][o].volume.load(std::memory_order_relaxed);
+            st.routes[i][o].enabled = routes_[i][o].enabled.load(std::memory_order_relaxed);
         }
+        st.channels[i].volume = channels_[i].volume.load(std::memory_order_relaxed);
+        st.channels[i].muted  = channels_[i].muted.load(std::memory_order_relaxed);
+        st.channels[i].soloed = channels_[i].soloed.load(std::memory_order_relaxed);
+    }
+    for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+        st.outputs[o].volume = outputs_[o].volume.load(std::memory_order_relaxed);
+        st.outputs[o].muted  = outputs_[o].muted.load(std::memory_order_relaxed);
     }
+    return st;
+}
 
-    // Channel state
-    JsonArray chArr = doc["channels"].to<JsonArray>();
+void AudioMixerEngine::applyState(const State& st)
+{
     for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
-        JsonObject ch = chArr.add<JsonObject>();
-        ch["volume"] = channels_[i].volume.load(std::memory_order_relaxed);
-        ch["muted"] = channels_[i].muted.load(std::memory_order_relaxed);
-        ch["soloed"] = channels_[i].soloed.load(std::memory_order_relaxed);
+        for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+            routes_[i][o].volume.store(st.routes[i][o].volume, std::memory_order_relaxed);
+            routes_[i][o].enabled.store(st.routes[i][o].enabled, std::memory_order_relaxed);
+        }
+        channels_[i].volume.store(st.channels[i].volume, std::memory_order_relaxed);
+        channels_[i].muted.store(st.channels[i].muted, std::memory_order_relaxed);
+        channels_[i].soloed.store(st.channels[i].soloed, std::memory_order_relaxed);
     }
-
-    // Output bus state
-    JsonArray outArr = doc["outputs"].to<JsonArray>();
     for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
-        JsonObject ob = outArr.add<JsonObject>();
-        ob["volume"] = outputs_[o].volume.load(std::memory_order_relaxed);
-        ob["muted"] = outputs_[o].muted.load(std::memory_order_relaxed);
-    }
-
-    std::ofstream f(path);
-    if (!f.is_open()) {
-        printf("[Mixer] Failed to save state to %s\n", path.c_str());
-        return;
+        outputs_[o].volume.store(st.outputs[o].volume, std::memory_order_relaxed);
+        outputs_[o].muted.store(st.outputs[o].muted, std::memory_order_relaxed);
     }
-    serializeJsonPretty(doc, f);
-    printf("[Mixer] State saved to %s\n", path.c_str());
 }
 
-void AudioMixerEngine::loadState(const std::string& path)
+void AudioMixerEngine::loadState(const std::string& pathStem)
 {
-    std::ifstream f(path);
-    if (!f.is_open()) {
-        printf("[Mixer] No saved state at %s, using defaults\n", path.c_str());
-        setDefaults();
-        return;
-    }
-
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, f);
-    if (err) {
-        printf("[Mixer] State parse error: %s, using defaults\n", err.c_str());
+    std::string path;
+    State st;
+    const bool ok = StateSnapshot::readNewest(pathStem, [&](const std::string& data) {
+        st = captureState();
+        return StateSnapshot::isSnapshot(data) ? stateFromSnapshot(data, st) : stateFromJson(data, st);
+    }, &path);
+    if (!ok) {
+        if (path.empty())
+            printf("[Mixer] No saved state at %s.json, using defaults\n", pathStem.c_str());
+        else
+            printf("[Mixer] State parse error in %s, using defaults\n", path.c_str());
         setDefaults();
         return;
     }
 
-    // Route matrix
-    JsonArray routesArr = doc["routes"];
-    if (routesArr) {
-        for (JsonObject r : routesArr) {
-            int i = r["in"] | 0;
-            int o = r["out"] | 0;
-            if (i >= 0 && i < MIXER_NUM_INPUTS && o >= 0 && o < MIXER_NUM_OUTPUTS) {
-                routes_[i][o].enabled.store(r["enabled"] | false, std::memory_order_relaxed);
-                routes_[i][o].volume.store(r["volume"] | 1.0f, std::memory_order_relaxed);
-            }
-        }
-    }
-
-    // Channel state
-    JsonArray chArr = doc["channels"];
-    if (chArr) {
-        int idx = 0;
-        for (JsonObject ch : chArr) {
-            if (idx >= MIXER_NUM_INPUTS) break;
-            channels_[idx].volume.store(ch["volume"] | 1.0f, std::memory_order_relaxed);
-            channels_[idx].muted.store(ch["muted"] | false, std::memory_order_relaxed);
-            channels_[idx].soloed.store(ch["soloed"] | false, std::memory_order_relaxed);
-            idx++;
-        }
-    }
-
-    // Output bus state
-    JsonArray outArr = doc["outputs"];
-    if (outArr) {
-        int idx = 0;
-        for (JsonObject ob : outArr) {
-            if (idx >= MIXER_NUM_OUTPUTS) break;
-            outputs_[idx].volume.store(ob["volume"] | 1.0f, std::memory_order_relaxed);
-            outputs_[idx].muted.store(ob["muted"] | false, std::memory_order_relaxed);
-            idx++;
-        }
-    }
-
+    applyState(st);
     printf("[Mixer] State loaded from %s\n", path.c_str());
 }
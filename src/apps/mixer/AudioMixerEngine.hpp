@@ -13,7 +13,8 @@
 #include <cstdint>
 #include <thread>
 #include <string>
-#include <crosspad/audio/AudioRingBuffer.hpp>
+#include <string_view>
+#include "audio/AudioBroadcastTap.hpp"
 
 static constexpr int MIXER_NUM_INPUTS  = 3;  // IN1, IN2, SYNTH
 static constexpr int MIXER_NUM_OUTPUTS = 2;  // OUT1, OUT2
@@ -86,28 +87,62 @@ public:
     bool isAnySoloed() const;
 
     // State persistence
-    void saveState(const std::string& path) const;
-    void loadState(const std::string& path);
+    struct State {
+        struct Route   { float volume; bool enabled; };
+        struct Channel { float volume; bool muted; bool soloed; };
+        struct Output  { float volume; bool muted; };
+        Route   routes[MIXER_NUM_INPUTS][MIXER_NUM_OUTPUTS];
+        Channel channels[MIXER_NUM_INPUTS];
+        Output  outputs[MIXER_NUM_OUTPUTS];
+    };
+
+    /// Copy the persisted state (cheap: relaxed loads, no allocation).
+    State captureState() const;
+
+    void applyState(const State& state);
+
+    // State file codecs (MixerStateCodec.cpp). The parsers only overwrite
+    // what the file contains, so start from captureState() or defaults.
+    /// mixer_state.json contents for @p state (any thread).
+    static std::string stateToJson(const State& state);
+    /// mixer_state.bin contents (a StateSnapshot) for @p state (any thread).
+    static std::string stateToSnapshot(const State& state);
+    static bool stateFromJson(std::string_view text, State& state);
+    static bool stateFromSnapshot(std::string_view data, State& state);
+
+    /// Load <pathStem>.json or <pathStem>.bin, whichever was written last;
+    /// defaults if there is none.
+    void loadState(const std::string& pathStem);
 
     // Set defaults (SYNTH->OUT1 enabled) without loading from file
     void setDefaults();
 
-    // ── Tap buffer for audio capture (CI testing) ────────────────
-    /// Set a ring buffer to receive a copy of OUT1 audio.
-    /// Pass nullptr to disable. Caller owns the buffer.
-    void setTapBuffer(crosspad::AudioRingBuffer<int16_t>* buf) { tapBuffer_.store(buf); }
+    // ── Audio taps (CI capture, remote analysis) ─────────────────
+    /// Raw input signal, before channel volume/mute. Attach a Cursor to read.
+    AudioBroadcastTap& inputTap(MixerInput in) { return inputTaps_[static_cast<int>(in)]; }
 
-    /// Which output to tap (default: OUT1)
+    /// Final output signal, as written to the device.
+    AudioBroadcastTap& outputTap(MixerOutput out) { return outputTaps_[static_cast<int>(out)]; }
+
+    /// Which output feeds the tap sink (default: OUT1)
     void setTapOutput(MixerOutput out) { tapOutput_.store(static_cast<uint8_t>(out)); }
 
+    /// Callback receiving the tapped output on the mixer thread (must not block).
+    using TapSink = void (*)(const int16_t* interleaved, uint32_t frames, uint32_t sampleRate);
+
+    /// Forward the tapped output to @p sink as well (e.g. remote shared memory).
+    void setTapSink(TapSink sink) { tapSink_.store(sink); }
+
 private:
     MixerRoute     routes_[MIXER_NUM_INPUTS][MIXER_NUM_OUTPUTS];
     MixerChannel   channels_[MIXER_NUM_INPUTS];
     MixerOutputBus outputs_[MIXER_NUM_OUTPUTS];
 
     std::atomic<bool> running_{false};
-    std::atomic<crosspad::AudioRingBuffer<int16_t>*> tapBuffer_{nullptr};
+    AudioBroadcastTap inputTaps_[MIXER_NUM_INPUTS];
+    AudioBroadcastTap outputTaps_[MIXER_NUM_OUTPUTS];
     std::atomic<uint8_t> tapOutput_{0};  // MixerOutput::OUT1
+    std::atomic<TapSink> tapSink_{nullptr};
 
     void mixerThreadFunc();
 };
@@ -26,6 +26,7 @@
 #include <crosspad/pad/PadManager.hpp>
 #include "crosspad-gui/platform/IGuiPlatform.h"
 #include "crosspad-gui/components/vu_meter.h"
+#include "widgets/VuMeter.hpp"
 
 #include "lvgl.h"
 
@@ -34,11 +35,9 @@
 /* ── Static state ──────────────────────────────────────────────────────── */
 
 static App* s_thisApp = nullptr;
-static lv_timer_t* s_vuTimer = nullptr;
 
-// VU bar objects: 0=IN1, 1=IN2, 2=SYNTH, 3=OUT1, 4=OUT2
-static lv_obj_t* s_vuBarsL[5] = {};
-static lv_obj_t* s_vuBarsR[5] = {};
+// VU meters (stereo): 0=IN1, 1=IN2, 2=SYNTH, 3=OUT1, 4=OUT2
+static lv_obj_t* s_vuMeters[5] = {};
 static lv_obj_t* s_vuLabels[5] = {};
 
 // Routing matrix buttons [input][output]
@@ -55,9 +54,6 @@ static lv_obj_t* s_channelSliders[3] = {};
 static lv_obj_t* s_outSliders[2] = {};
 static lv_obj_t* s_outMuteButtons[2] = {};
 
-// VU decay values
-static int16_t s_vuDecay[5][2] = {};  // [channel][L/R]
-
 /* ── Color constants ──────────────────────────────────────────────────── */
 
 static const lv_color_t COL_BG        = lv_color_hex(0x000000);
@@ -79,13 +75,12 @@ static void syncGuiFromEngine();
 
 /* ── Helpers ───────────────────────────────────────────────────────────── */
 
-static lv_color_t vuColor(int16_t level, int16_t max)
+/// Set a background colour only if it differs; re-setting an equal local
+/// style still invalidates the object.
+static void set_bg_color(lv_obj_t* obj, lv_color_t color)
 {
-    if (max <= 0) return lv_color_hex(0x00AA00);
-    float pct = (float)level / (float)max;
-    if (pct > 0.85f) return lv_color_hex(0xFF2222);  // red
-    if (pct > 0.60f) return lv_color_hex(0xDDAA00);  // yellow
-    return lv_color_hex(0x00AA00);                    // green
+    if (lv_color_eq(lv_obj_get_style_bg_color(obj, LV_PART_MAIN), color)) return;
+    lv_obj_set_style_bg_color(obj, color, 0);
 }
 
 /* ── Callbacks ─────────────────────────────────────────────────────────── */
@@ -174,8 +169,7 @@ static void syncGuiFromEngine()
             auto mi = static_cast<MixerInput>(in);
             auto mo = static_cast<MixerOutput>(out);
             bool en = engine.isRouteEnabled(mi, mo);
-            lv_obj_set_style_bg_color(s_routeButtons[in][out],
-                                      en ? COL_ROUTE_ON : COL_ROUTE_OFF, 0);
+            set_bg_color(s_routeButtons[in][out], en ? COL_ROUTE_ON : COL_ROUTE_OFF);
         }
     }
 
@@ -183,77 +177,39 @@ static void syncGuiFromEngine()
     for (int i = 0; i < 3; i++) {
         if (!s_muteButtons[i] || !s_soloButtons[i]) continue;
         auto ch = static_cast<MixerInput>(i);
-        lv_obj_set_style_bg_color(s_muteButtons[i],
-                                  engine.isChannelMuted(ch) ? COL_MUTE_ON : COL_MUTE_OFF, 0);
-        lv_obj_set_style_bg_color(s_soloButtons[i],
-                                  engine.isChannelSoloed(ch) ? COL_SOLO_ON : COL_SOLO_OFF, 0);
+        set_bg_color(s_muteButtons[i], engine.isChannelMuted(ch) ? COL_MUTE_ON : COL_MUTE_OFF);
+        set_bg_color(s_soloButtons[i], engine.isChannelSoloed(ch) ? COL_SOLO_ON : COL_SOLO_OFF);
     }
 
     // Output mute buttons
     for (int i = 0; i < 2; i++) {
         if (!s_outMuteButtons[i]) continue;
         auto mo = static_cast<MixerOutput>(i);
-        lv_obj_set_style_bg_color(s_outMuteButtons[i],
-                                  engine.isOutputMuted(mo) ? COL_MUTE_ON : COL_MUTE_OFF, 0);
+        set_bg_color(s_outMuteButtons[i], engine.isOutputMuted(mo) ? COL_MUTE_ON : COL_MUTE_OFF);
     }
 }
 
-/* ── VU meter timer ────────────────────────────────────────────────────── */
+/* ── VU meters + engine sync ───────────────────────────────────────────── */
 
-static void vu_timer_cb(lv_timer_t*)
+/// Level source for meter @p ctx (index into s_vuMeters).
+static void vu_level(void* ctx, int16_t& left, int16_t& right)
 {
     auto& engine = getMixerEngine();
+    intptr_t idx = (intptr_t)ctx;
+    if (idx < 3) engine.getChannelLevel(static_cast<MixerInput>(idx), left, right);
+    else         engine.getOutputLevel(static_cast<MixerOutput>(idx - 3), left, right);
+}
+
+static uint16_t vu_scale(int16_t level, uint16_t max)
+{
+    return (uint16_t)int16toLogScale(level, (int16_t)max);
+}
 
+static void sync_tick(void*)
+{
     // Sync GUI toggles (mute/solo/route buttons) from engine state
     // so pad-driven changes are reflected immediately in the GUI
     syncGuiFromEngine();
-
-    constexpr int DECAY = 230;  // 230/256 ~ 0.90
-    constexpr int16_t BAR_MAX = 100;
-
-    // Input channels
-    for (int i = 0; i < 3; i++) {
-        if (!s_vuBarsL[i] || !s_vuBarsR[i]) continue;
-        int16_t rawL, rawR;
-        engine.getChannelLevel(static_cast<MixerInput>(i), rawL, rawR);
-
-        int16_t logL = (int16_t)int16toLogScale(rawL, BAR_MAX);
-        int16_t logR = (int16_t)int16toLogScale(rawR, BAR_MAX);
-
-        // Apply decay
-        s_vuDecay[i][0] = static_cast<int16_t>((s_vuDecay[i][0] * DECAY) / 256);
-        s_vuDecay[i][1] = static_cast<int16_t>((s_vuDecay[i][1] * DECAY) / 256);
-        if (logL > s_vuDecay[i][0]) s_vuDecay[i][0] = logL;
-        if (logR > s_vuDecay[i][1]) s_vuDecay[i][1] = logR;
-
-        lv_bar_set_value(s_vuBarsL[i], s_vuDecay[i][0], LV_ANIM_OFF);
-        lv_bar_set_value(s_vuBarsR[i], s_vuDecay[i][1], LV_ANIM_OFF);
-
-        lv_obj_set_style_bg_color(s_vuBarsL[i], vuColor(s_vuDecay[i][0], BAR_MAX), LV_PART_INDICATOR);
-        lv_obj_set_style_bg_color(s_vuBarsR[i], vuColor(s_vuDecay[i][1], BAR_MAX), LV_PART_INDICATOR);
-    }
-
-    // Output buses
-    for (int i = 0; i < 2; i++) {
-        int idx = 3 + i;
-        if (!s_vuBarsL[idx] || !s_vuBarsR[idx]) continue;
-        int16_t rawL, rawR;
-        engine.getOutputLevel(static_cast<MixerOutput>(i), rawL, rawR);
-
-        int16_t logL = (int16_t)int16toLogScale(rawL, BAR_MAX);
-        int16_t logR = (int16_t)int16toLogScale(rawR, BAR_MAX);
-
-        s_vuDecay[idx][0] = static_cast<int16_t>((s_vuDecay[idx][0] * DECAY) / 256);
-        s_vuDecay[idx][1] = static_cast<int16_t>((s_vuDecay[idx][1] * DECAY) / 256);
-        if (logL > s_vuDecay[idx][0]) s_vuDecay[idx][0] = logL;
-        if (logR > s_vuDecay[idx][1]) s_vuDecay[idx][1] = logR;
-
-        lv_bar_set_value(s_vuBarsL[idx], s_vuDecay[idx][0], LV_ANIM_OFF);
-        lv_bar_set_value(s_vuBarsR[idx], s_vuDecay[idx][1], LV_ANIM_OFF);
-
-        lv_obj_set_style_bg_color(s_vuBarsL[idx], vuColor(s_vuDecay[idx][0], BAR_MAX), LV_PART_INDICATOR);
-        lv_obj_set_style_bg_color(s_vuBarsR[idx], vuColor(s_vuDecay[idx][1], BAR_MAX), LV_PART_INDICATOR);
-    }
 }
 
 /* ── GUI builder helpers ───────────────────────────────────────────────── */
@@ -270,29 +226,14 @@ static lv_obj_t* make_vu_pair(lv_obj_t* parent, int idx, const char* label,
     lv_obj_set_style_pad_all(cont, 0, 0);
     lv_obj_remove_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
 
-    // Left bar
-    lv_obj_t* barL = lv_bar_create(cont);
-    lv_obj_set_size(barL, 8, barH);
-    lv_obj_set_pos(barL, 8, 0);
-    lv_bar_set_range(barL, 0, 100);
-    lv_bar_set_value(barL, 0, LV_ANIM_OFF);
-    lv_obj_set_style_bg_color(barL, COL_VU_BG, 0);
-    lv_obj_set_style_bg_color(barL, lv_color_hex(0x00AA00), LV_PART_INDICATOR);
-    lv_obj_set_style_radius(barL, 1, 0);
-    lv_obj_set_style_radius(barL, 1, LV_PART_INDICATOR);
-    s_vuBarsL[idx] = barL;
-
-    // Right bar
-    lv_obj_t* barR = lv_bar_create(cont);
-    lv_obj_set_size(barR, 8, barH);
-    lv_obj_set_pos(barR, 20, 0);
-    lv_bar_set_range(barR, 0, 100);
-    lv_bar_set_value(barR, 0, LV_ANIM_OFF);
-    lv_obj_set_style_bg_color(barR, COL_VU_BG, 0);
-    lv_obj_set_style_bg_color(barR, lv_color_hex(0x00AA00), LV_PART_INDICATOR);
-    lv_obj_set_style_radius(barR, 1, 0);
-    lv_obj_set_style_radius(barR, 1, LV_PART_INDICATOR);
-    s_vuBarsR[idx] = barR;
+    // Stereo meter, polled by the shared VU meter timer
+    lv_obj_t* meter = vu_meter::create(cont, true, 4);
+    lv_obj_set_pos(meter, 8, 0);
+    lv_obj_set_size(meter, 20, barH);
+    vu_meter::set_track_color(meter, COL_VU_BG);
+    vu_meter::set_scale(meter, vu_scale);
+    vu_meter::set_source(meter, vu_level, (void*)(intptr_t)idx);
+    s_vuMeters[idx] = meter;
 
     // Label
     lv_obj_t* lbl = lv_label_create(cont);
@@ -333,9 +274,6 @@ lv_obj_t* Mixer_create(lv_obj_t* parent, App* a)
     s_thisApp = a;
     auto& engine = getMixerEngine();
 
-    // Reset VU decay
-    for (auto& d : s_vuDecay) { d[0] = 0; d[1] = 0; }
-
     // ── Root container ──
     lv_obj_t* cont = lv_obj_create(parent);
     lv_obj_set_size(cont, lv_pct(100), lv_pct(100));
@@ -549,8 +487,8 @@ lv_obj_t* Mixer_create(lv_obj_t* parent, App* a)
         });
     }
 
-    /* ── VU meter timer (60 Hz) ────────────────────────────────── */
-    s_vuTimer = lv_timer_create(vu_timer_cb, 16, nullptr);
+    /* ── Engine → GUI sync, on the meters' shared tick ──────────── */
+    vu_meter::add_tick_hook(sync_tick, nullptr);
 
     /* ── Sync initial GUI state from engine ────────────────────── */
     syncGuiFromEngine();
@@ -561,16 +499,12 @@ lv_obj_t* Mixer_create(lv_obj_t* parent, App* a)
 
 void Mixer_destroy(lv_obj_t* app_obj)
 {
-    // Stop VU timer
-    if (s_vuTimer) {
-        lv_timer_delete(s_vuTimer);
-        s_vuTimer = nullptr;
-    }
+    // Stop engine → GUI sync
+    vu_meter::remove_tick_hook(sync_tick, nullptr);
 
     // Clear GUI pointers (engine and pad logic keep running)
     s_thisApp = nullptr;
-    for (auto& p : s_vuBarsL) p = nullptr;
-    for (auto& p : s_vuBarsR) p = nullptr;
+    for (auto& p : s_vuMeters) p = nullptr;
     for (auto& p : s_vuLabels) p = nullptr;
     for (auto& row : s_routeButtons) for (auto& p : row) p = nullptr;
     for (auto& p : s_muteButtons) p = nullptr;
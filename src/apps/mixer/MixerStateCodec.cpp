@@ -0,0 +1,197 @@
+/**
+ * @file MixerStateCodec.cpp
+ * @brief mixer_state.json / mixer_state.bin encoding of AudioMixerEngine::State.
+ *
+ * Kept apart from the engine so it builds without the audio backends.
+ */
+
+#include "AudioMixerEngine.hpp"
+#include "pc_stubs/StateSnapshot.hpp"
+
+#include <ArduinoJson.h>
+
+namespace {
+
+// Snapshot tags (StateSnapshot::Kind::Mixer)
+enum : uint16_t {
+    TAG_ROUTE   = 1,   // record: in, out, enabled, volume
+    TAG_CHANNEL = 2,   // record: index, volume, muted, soloed
+    TAG_OUTPUT  = 3,   // record: index, volume, muted
+};
+
+enum : uint16_t {
+    TAG_ROUTE_IN = 1, TAG_ROUTE_OUT = 2, TAG_ROUTE_ENABLED = 3, TAG_ROUTE_VOLUME = 4,
+};
+
+enum : uint16_t {
+    TAG_INDEX = 1, TAG_VOLUME = 2, TAG_MUTED = 3, TAG_SOLOED = 4,
+};
+
+} // namespace
+
+/* ── JSON ────────────────────────────────────────────────────────────── */
+
+std::string AudioMixerEngine::stateToJson(const State& st)
+{
+    JsonDocument doc;
+
+    // Route matrix
+    JsonArray routesArr = doc["routes"].to<JsonArray>();
+    for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
+        for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+            JsonObject r = routesArr.add<JsonObject>();
+            r["in"] = i;
+            r["out"] = o;
+            r["enabled"] = st.routes[i][o].enabled;
+            r["volume"] = st.routes[i][o].volume;
+        }
+    }
+
+    // Channel state
+    JsonArray chArr = doc["channels"].to<JsonArray>();
+    for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
+        JsonObject ch = chArr.add<JsonObject>();
+        ch["volume"] = st.channels[i].volume;
+        ch["muted"] = st.channels[i].muted;
+        ch["soloed"] = st.channels[i].soloed;
+    }
+
+    // Output bus state
+    JsonArray outArr = doc["outputs"].to<JsonArray>();
+    for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+        JsonObject ob = outArr.add<JsonObject>();
+        ob["volume"] = st.outputs[o].volume;
+        ob["muted"] = st.outputs[o].muted;
+    }
+
+    std::string text;
+    serializeJsonPretty(doc, text);
+    return text;
+}
+
+bool AudioMixerEngine::stateFromJson(std::string_view text, State& st)
+{
+    JsonDocument doc;
+    if (deserializeJson(doc, text.data(), text.size())) return false;
+
+    // Route matrix
+    for (JsonObject r : doc["routes"].as<JsonArray>()) {
+        int i = r["in"] | 0;
+        int o = r["out"] | 0;
+        if (i >= 0 && i < MIXER_NUM_INPUTS && o >= 0 && o < MIXER_NUM_OUTPUTS) {
+            st.routes[i][o].enabled = r["enabled"] | false;
+            st.routes[i][o].volume  = r["volume"] | 1.0f;
+        }
+    }
+
+    // Channel state
+    int idx = 0;
+    for (JsonObject ch : doc["channels"].as<JsonArray>()) {
+        if (idx >= MIXER_NUM_INPUTS) break;
+        st.channels[idx].volume = ch["volume"] | 1.0f;
+        st.channels[idx].muted  = ch["muted"] | false;
+        st.channels[idx].soloed = ch["soloed"] | false;
+        idx++;
+    }
+
+    // Output bus state
+    idx = 0;
+    for (JsonObject ob : doc["outputs"].as<JsonArray>()) {
+        if (idx >= MIXER_NUM_OUTPUTS) break;
+        st.outputs[idx].volume = ob["volume"] | 1.0f;
+        st.outputs[idx].muted  = ob["muted"] | false;
+        idx++;
+    }
+    return true;
+}
+
+/* ── Snapshot ────────────────────────────────────────────────────────── */
+
+std::string AudioMixerEngine::stateToSnapshot(const State& st)
+{
+    StateSnapshot::Writer w(StateSnapshot::Kind::Mixer);
+
+    for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
+        for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+            size_t mark = w.beginRecord(TAG_ROUTE);
+            w.putI32(TAG_ROUTE_IN, i);
+            w.putI32(TAG_ROUTE_OUT, o);
+            w.putBool(TAG_ROUTE_ENABLED, st.routes[i][o].enabled);
+            w.putF32(TAG_ROUTE_VOLUME, st.routes[i][o].volume);
+            w.endRecord(mark);
+        }
+    }
+    for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
+        size_t mark = w.beginRecord(TAG_CHANNEL);
+        w.putI32(TAG_INDEX, i);
+        w.putF32(TAG_VOLUME, st.channels[i].volume);
+        w.putBool(TAG_MUTED, st.channels[i].muted);
+        w.putBool(TAG_SOLOED, st.channels[i].soloed);
+        w.endRecord(mark);
+    }
+    for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+        size_t mark = w.beginRecord(TAG_OUTPUT);
+        w.putI32(TAG_INDEX, o);
+        w.putF32(TAG_VOLUME, st.outputs[o].volume);
+        w.putBool(TAG_MUTED, st.outputs[o].muted);
+        w.endRecord(mark);
+    }
+    return w.finish();
+}
+
+bool AudioMixerEngine::stateFromSnapshot(std::string_view data, State& st)
+{
+    StateSnapshot::Reader r;
+    if (!StateSnapshot::open(data, StateSnapshot::Kind::Mixer, r)) return false;
+
+    StateSnapshot::Field f, rf;
+    while (r.next(f)) {
+        StateSnapshot::Reader rec = f.record();
+        switch (f.tag) {
+        case TAG_ROUTE: {
+            int i = -1, o = -1;
+            State::Route route{ 1.0f, false };
+            while (rec.next(rf)) {
+                switch (rf.tag) {
+                case TAG_ROUTE_IN:      i = rf.i32(-1); break;
+                case TAG_ROUTE_OUT:     o = rf.i32(-1); break;
+                case TAG_ROUTE_ENABLED: route.enabled = rf.boolean(); break;
+                case TAG_ROUTE_VOLUME:  route.volume = rf.f32(1.0f); break;
+                }
+            }
+            if (i >= 0 && i < MIXER_NUM_INPUTS && o >= 0 && o < MIXER_NUM_OUTPUTS) st.routes[i][o] = route;
+            break;
+        }
+        case TAG_CHANNEL: {
+            int i = -1;
+            State::Channel ch{ 1.0f, false, false };
+            while (rec.next(rf)) {
+                switch (rf.tag) {
+                case TAG_INDEX:  i = rf.i32(-1); break;
+                case TAG_VOLUME: ch.volume = rf.f32(1.0f); break;
+                case TAG_MUTED:  ch.muted = rf.boolean(); break;
+                case TAG_SOLOED: ch.soloed = rf.boolean(); break;
+                }
+            }
+            if (i >= 0 && i < MIXER_NUM_INPUTS) st.channels[i] = ch;
+            break;
+        }
+        case TAG_OUTPUT: {
+            int o = -1;
+            State::Output ob{ 1.0f, false };
+            while (rec.next(rf)) {
+                switch (rf.tag) {
+                case TAG_INDEX:  o = rf.i32(-1); break;
+                case TAG_VOLUME: ob.volume = rf.f32(1.0f); break;
+                case TAG_MUTED:  ob.muted = rf.boolean(); break;
+                }
+            }
+            if (o >= 0 && o < MIXER_NUM_OUTPUTS) st.outputs[o] = ob;
+            break;
+        }
+        default:
+            break;   // written by a newer version
+        }
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file LogBuffer.cpp
+ * @brief Chunked line arena with eviction by line count and memory.
+ */
+
+#include "LogBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+LogBuffer::LogBuffer(size_t maxLines, size_t maxBytes)
+    : maxLines_(std::max<size_t>(maxLines, 1))
+    , maxChunks_(std::max<size_t>(maxBytes / CHUNK_SIZE, 2))
+{
+}
+
+void LogBuffer::append(std::string_view text)
+{
+    const size_t len = std::min(text.size(), MAX_LINE_LENGTH);
+
+    // Lines never straddle chunks: skip the tail of the current one
+    size_t used = (size_t)(writeOff_ % CHUNK_SIZE);
+    if (used != 0 && CHUNK_SIZE - used < len) writeOff_ += CHUNK_SIZE - used;
+    if (writeOff_ == chunkBase_ + chunks_.size() * CHUNK_SIZE)
+        chunks_.push_back(std::make_unique<char[]>(CHUNK_SIZE));
+
+    char* dst = chunks_[(size_t)((writeOff_ - chunkBase_) / CHUNK_SIZE)].get()
+              + writeOff_ % CHUNK_SIZE;
+    memcpy(dst, text.data(), len);
+    lines_.push_back({ writeOff_, (uint32_t)len });
+    writeOff_ += len;
+
+    evict();
+}
+
+void LogBuffer::evict()
+{
+    while (lines_.size() > maxLines_) {
+        lines_.pop_front();
+        firstSeq_++;
+    }
+
+    // Over the memory cap: drop the oldest chunk and every line in it
+    while (chunks_.size() > maxChunks_) {
+        chunks_.pop_front();
+        chunkBase_ += CHUNK_SIZE;
+        while (!lines_.empty() && lines_.front().offset < chunkBase_) {
+            lines_.pop_front();
+            firstSeq_++;
+        }
+    }
+
+    // Free chunks that only held evicted lines (keep the one being written)
+    uint64_t oldest = lines_.empty() ? writeOff_ : lines_.front().offset;
+    while (chunks_.size() > 1 && oldest >= chunkBase_ + CHUNK_SIZE) {
+        chunks_.pop_front();
+        chunkBase_ += CHUNK_SIZE;
+    }
+}
+
+void LogBuffer::clear()
+{
+    firstSeq_ += lines_.size();
+    lines_.clear();
+    chunks_.clear();
+    chunkBase_ = writeOff_ = 0;
+}
+
+std::string_view LogBuffer::line(size_t index) const
+{
+    if (index >= lines_.size()) return {};
+    const Line& l = lines_[index];
+    const char* p = chunks_[(size_t)((l.offset - chunkBase_) / CHUNK_SIZE)].get()
+                  + l.offset % CHUNK_SIZE;
+    return { p, l.length };
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * @file LogBuffer.hpp
+ * @brief Line history for the Serial Monitor: byte arena + line index.
+ *
+ * Text lives in fixed-size chunks that are appended to and freed from the
+ * front, so a line never moves once stored and memory follows the amount
+ * of history actually kept. The index holds one (offset, length) pair per
+ * line. Appending and evicting are O(line length); reading any line is
+ * O(1). Nothing here touches LVGL.
+ *
+ * Lines are numbered by sequence: the first line ever appended is 0 and
+ * numbers are never reused, so a viewer can tell how many lines fell off
+ * the front between two looks (firstSeq() moved).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string_view>
+
+class LogBuffer {
+public:
+    static constexpr size_t DEFAULT_MAX_LINES = 1000000;
+    static constexpr size_t DEFAULT_MAX_BYTES = 64u * 1024 * 1024;
+    static constexpr size_t MAX_LINE_LENGTH   = 1024;   ///< longer lines are truncated
+
+    explicit LogBuffer(size_t maxLines = DEFAULT_MAX_LINES,
+                       size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /// Store one line (without its terminator); evicts the oldest as needed.
+    void append(std::string_view line);
+
+    void clear();
+
+    /// Lines currently held.
+    size_t size() const { return lines_.size(); }
+    bool empty() const { return lines_.empty(); }
+
+    /// Sequence number of line 0 (= lines evicted or cleared so far).
+    uint64_t firstSeq() const { return firstSeq_; }
+
+    /// Line @p index (0 = oldest held). Valid until the next append/clear.
+    std::string_view line(size_t index) const;
+
+    /// Bytes of chunk memory in use.
+    size_t memoryBytes() const { return chunks_.size() * CHUNK_SIZE; }
+
+private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    struct Line {
+        uint64_t offset;   // position in the virtual byte stream
+        uint32_t length;
+    };
+
+    void evict();
+
+    size_t maxLines_;
+    size_t maxChunks_;
+
+    std::deque<std::unique_ptr<char[]>> chunks_;
+    uint64_t chunkBase_ = 0;   // stream offset of chunks_.front()
+    uint64_t writeOff_  = 0;   // next free stream offset
+    std::deque<Line> lines_;
+    uint64_t firstSeq_  = 0;
+};
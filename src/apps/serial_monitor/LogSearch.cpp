@@ -0,0 +1,366 @@
+/**
+ * @file LogSearch.cpp
+ * @brief Trigram block index, prefiltered search and the worker thread.
+ */
+
+#include "LogSearch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <regex>
+
+namespace {
+
+char lower(char c)
+{
+    return (char)std::tolower((unsigned char)c);
+}
+
+std::string to_lower(std::string_view s)
+{
+    std::string out(s);
+    for (char& c : out) c = lower(c);
+    return out;
+}
+
+void lower_in_place(std::string& s)
+{
+    for (char& c : s) c = lower(c);
+}
+
+uint32_t trigram(const char* p)
+{
+    return ((uint32_t)(uint8_t)p[0] << 16) | ((uint32_t)(uint8_t)p[1] << 8) | (uint8_t)p[2];
+}
+
+} // namespace
+
+LogSearch::LogSearch(LogBuffer& log)
+    : log_(log)
+{
+    endSeq_     = log_.firstSeq() + log_.size();
+    indexedSeq_ = log_.firstSeq();
+    thread_ = std::thread(&LogSearch::threadFunc, this);
+}
+
+LogSearch::~LogSearch()
+{
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        running_ = false;
+    }
+    generation_++;
+    cv_.notify_one();
+    thread_.join();
+}
+
+// ── Writer side ──
+
+void LogSearch::append(std::string_view line)
+{
+    {
+        std::unique_lock<std::shared_mutex> lk(logMutex_);
+        log_.append(line);
+        endSeq_.store(log_.firstSeq() + log_.size(), std::memory_order_release);
+    }
+    // Pairs with the worker's predicate check so the wake-up is not lost
+    { std::lock_guard<std::mutex> lk(mutex_); }
+    cv_.notify_one();
+}
+
+void LogSearch::clear()
+{
+    std::unique_lock<std::shared_mutex> lk(logMutex_);
+    log_.clear();
+}
+
+uint64_t LogSearch::submit(const std::string& pattern, bool regex, uint64_t fromSeq)
+{
+    uint64_t gen;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        gen = ++generation_;
+        query_    = { gen, pattern, regex, fromSeq };
+        hasQuery_ = true;
+        hasResult_ = false;
+    }
+    cv_.notify_one();
+    return gen;
+}
+
+void LogSearch::cancel()
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    generation_++;
+    hasQuery_  = false;
+    hasResult_ = false;
+}
+
+bool LogSearch::takeResult(Result& out)
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (!hasResult_) return false;
+    hasResult_ = false;
+    if (result_.generation != generation_) return false;
+    out = std::move(result_);
+    return true;
+}
+
+// ── Worker ──
+
+void LogSearch::threadFunc()
+{
+    std::unique_lock<std::mutex> lk(mutex_);
+    for (;;) {
+        cv_.wait(lk, [this] {
+            return !running_ || hasQuery_
+                || indexedSeq_.load(std::memory_order_relaxed) < endSeq_.load(std::memory_order_acquire);
+        });
+        if (!running_) return;
+
+        // Queries first: a search must not wait behind an indexing backlog
+        if (hasQuery_) {
+            Query q = std::move(query_);
+            hasQuery_ = false;
+            lk.unlock();
+            run(q);
+            lk.lock();
+            continue;
+        }
+
+        lk.unlock();
+        indexBatch();
+        lk.lock();
+    }
+}
+
+uint64_t LogSearch::copyLines(uint64_t from, uint64_t to, std::vector<std::string>& out)
+{
+    std::shared_lock<std::shared_mutex> lk(logMutex_);
+    const uint64_t first = log_.firstSeq();
+    const uint64_t end   = first + log_.size();
+    heldFirstSeq_ = first;
+    from = std::max(from, first);
+    to   = std::max(std::min(to, end), from);
+
+    // Reuse the strings' storage across calls
+    out.resize((size_t)(to - from));
+    for (uint64_t s = from; s < to; s++) {
+        std::string_view l = log_.line((size_t)(s - first));
+        out[(size_t)(s - from)].assign(l.data(), l.size());
+    }
+    return from;
+}
+
+void LogSearch::indexBatch()
+{
+    const uint64_t from = indexedSeq_.load(std::memory_order_relaxed);
+    const uint64_t to   = std::min(endSeq_.load(std::memory_order_acquire), from + INDEX_BATCH);
+    const uint64_t base = copyLines(from, to, batch_);
+
+    for (size_t i = 0; i < batch_.size(); i++) {
+        const uint32_t block = (uint32_t)((base + i) / BLOCK_LINES);
+        std::string& l = batch_[i];
+        lower_in_place(l);
+        for (size_t p = 0; p + 3 <= l.size(); p++) {
+            std::vector<uint32_t>& list = postings_[trigram(l.data() + p)];
+            if (list.empty() || list.back() != block) list.push_back(block);
+        }
+    }
+    indexedSeq_.store(to, std::memory_order_relaxed);
+    prune(heldFirstSeq_);
+}
+
+void LogSearch::prune(uint64_t firstSeq)
+{
+    // Drop evicted blocks from the lists once enough have piled up
+    const uint32_t firstBlock = (uint32_t)(firstSeq / BLOCK_LINES);
+    if (firstBlock - prunedBlock_ < 1024) return;
+
+    for (auto it = postings_.begin(); it != postings_.end();) {
+        std::vector<uint32_t>& list = it->second;
+        list.erase(list.begin(), std::lower_bound(list.begin(), list.end(), firstBlock));
+        if (list.empty()) it = postings_.erase(it);
+        else ++it;
+    }
+    prunedBlock_ = firstBlock;
+}
+
+std::vector<uint32_t> LogSearch::candidateBlocks(const std::string& literal,
+                                                 uint32_t first, uint32_t last) const
+{
+    // Intersect the trigram lists, smallest first
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t p = 0; p + 3 <= literal.size(); p++) {
+        auto it = postings_.find(trigram(literal.data() + p));
+        if (it == postings_.end()) return {};
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](auto* a, auto* b) { return a->size() < b->size(); });
+
+    const std::vector<uint32_t>& head = *lists[0];
+    std::vector<uint32_t> blocks(std::lower_bound(head.begin(), head.end(), first),
+                                 std::upper_bound(head.begin(), head.end(), last));
+    std::vector<uint32_t> tmp;
+    for (size_t i = 1; i < lists.size() && !blocks.empty(); i++) {
+        tmp.clear();
+        std::set_intersection(blocks.begin(), blocks.end(),
+                              lists[i]->begin(), lists[i]->end(), std::back_inserter(tmp));
+        blocks.swap(tmp);
+    }
+    return blocks;
+}
+
+void LogSearch::run(const Query& q)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    Result r;
+    r.generation = q.generation;
+
+    std::regex re;
+    if (q.regex) {
+        try {
+            re = std::regex(q.pattern, std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+        } catch (const std::regex_error& e) {
+            r.error = e.what();
+        }
+    }
+    const std::string literal = q.regex ? requiredLiteral(q.pattern) : to_lower(q.pattern);
+
+    const uint64_t end     = endSeq_.load(std::memory_order_acquire);
+    const uint64_t indexed = std::min(indexedSeq_.load(std::memory_order_relaxed), end);
+    uint64_t from;
+    {
+        std::shared_lock<std::shared_mutex> lk(logMutex_);
+        from = std::max(q.fromSeq, log_.firstSeq());
+    }
+    r.fromSeq = from;
+    r.endSeq  = end;
+
+    std::vector<std::string> lines;
+    auto superseded = [&] { return generation_.load() != q.generation; };
+
+    // Test lines [a, b); false once the search was superseded or is full
+    auto scan = [&](uint64_t a, uint64_t b) {
+        const uint64_t base = copyLines(a, b, lines);
+        for (size_t i = 0; i < lines.size(); i++) {
+            bool hit;
+            if (q.regex) {
+                hit = std::regex_search(lines[i], re);
+            } else {
+                lower_in_place(lines[i]);
+                hit = lines[i].find(literal) != std::string::npos;
+            }
+            if (!hit) continue;
+            if (r.matches.size() == MAX_MATCHES) {
+                r.truncated = true;
+                return false;
+            }
+            r.matches.push_back(base + i);
+        }
+        return !superseded();
+    };
+
+    if (r.error.empty() && !q.pattern.empty()) {
+        bool more = true;
+        if (from < indexed) {
+            const uint32_t b0 = (uint32_t)(from / BLOCK_LINES);
+            const uint32_t b1 = (uint32_t)((indexed - 1) / BLOCK_LINES);
+            if (literal.size() >= 3) {
+                for (uint32_t b : candidateBlocks(literal, b0, b1)) {
+                    more = scan(std::max(from, (uint64_t)b * BLOCK_LINES),
+                                std::min(indexed, (uint64_t)(b + 1) * BLOCK_LINES));
+                    if (!more) break;
+                }
+            } else {
+                for (uint32_t b = b0; b <= b1 && more; b++) {
+                    more = scan(std::max(from, (uint64_t)b * BLOCK_LINES),
+                                std::min(indexed, (uint64_t)(b + 1) * BLOCK_LINES));
+                }
+            }
+        }
+        // Lines the indexer has not reached yet
+        for (uint64_t s = std::max(from, indexed); s < end && more; s += BLOCK_LINES)
+            more = scan(s, std::min(end, s + BLOCK_LINES));
+    }
+    if (superseded()) return;
+    if (r.truncated && !r.matches.empty()) r.endSeq = r.matches.back() + 1;
+
+    r.elapsedUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (r.generation != generation_) return;
+    result_    = std::move(r);
+    hasResult_ = true;
+}
+
+// ── Regex prefilter ──
+
+std::string LogSearch::requiredLiteral(const std::string& pattern)
+{
+    std::string best, run;
+    auto flush = [&] {
+        if (run.size() > best.size()) best = run;
+        run.clear();
+    };
+
+    int depth = 0;
+    for (size_t i = 0; i < pattern.size(); i++) {
+        char c = pattern[i];
+        char lit = 0;
+        switch (c) {
+        case '|':
+            if (depth == 0) return {};   // alternatives: nothing is required
+            flush();
+            break;
+        case '(': depth++; flush(); break;
+        case ')': depth--; flush(); break;
+        case '[':
+            // Skip the class, including a leading ']' or '^]'
+            i++;
+            if (i < pattern.size() && pattern[i] == '^') i++;
+            if (i < pattern.size() && pattern[i] == ']') i++;
+            while (i < pattern.size() && pattern[i] != ']') {
+                if (pattern[i] == '\\') i++;
+                i++;
+            }
+            flush();
+            break;
+        case '*': case '?': case '{':
+            // The previous atom may be absent
+            if (!run.empty()) run.pop_back();
+            flush();
+            if (c == '{') while (i < pattern.size() && pattern[i] != '}') i++;
+            break;
+        case '+': case '.': case '^': case '$':
+            flush();
+            break;
+        case '\\':
+            if (i + 1 >= pattern.size()) return {};
+            if (!std::isalnum((unsigned char)pattern[i + 1])) {
+                lit = pattern[++i];
+            } else if (std::strchr("dwsDWSbB123456789", pattern[i + 1])) {
+                i++;   // class, word boundary or backreference: one unknown atom
+                flush();
+            } else {
+                // \x41, \u00e9, \cX, \n, ...: would need decoding, scan everything
+                return {};
+            }
+            break;
+        default:
+            lit = c;
+            break;
+        }
+        if (lit) {
+            if (depth == 0) run += lower(lit);
+            else flush();
+        }
+    }
+    flush();
+    return best;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @file LogSearch.hpp
+ * @brief Background trigram index and search over a LogBuffer.
+ *
+ * The LVGL thread appends through LogSearch, which guards the buffer with a
+ * shared mutex; the worker only holds it shared while copying out a batch
+ * of lines, never while indexing or matching.
+ *
+ * Index: lines are grouped into blocks of BLOCK_LINES by sequence number,
+ * and each lower-cased byte trigram maps to the sorted list of blocks that
+ * contain it. A query intersects the lists of its literal's trigrams and
+ * only reads the candidate blocks; lines not indexed yet are scanned.
+ * Matching is case-insensitive for both substrings and regexes. For a
+ * regex, the longest run of literal characters it requires is used as the
+ * prefilter (none when it has a top-level '|').
+ *
+ * submit() never blocks: the worker picks up the newest query, drops a
+ * running one that was superseded, and leaves the result for takeResult().
+ * Passing fromSeq = the previous result's endSeq extends a search over
+ * lines that arrived since.
+ */
+
+#include "LogBuffer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class LogSearch {
+public:
+    struct Result {
+        uint64_t generation = 0;
+        uint64_t fromSeq    = 0;     ///< first line covered
+        uint64_t endSeq     = 0;     ///< one past the last line covered
+        std::vector<uint64_t> matches;   ///< sequence numbers, ascending
+        bool     truncated  = false; ///< stopped at MAX_MATCHES
+        std::string error;           ///< bad regex
+        uint32_t elapsedUs  = 0;
+    };
+
+    static constexpr size_t MAX_MATCHES = 100000;
+
+    explicit LogSearch(LogBuffer& log);
+    ~LogSearch();
+
+    LogSearch(const LogSearch&) = delete;
+    LogSearch& operator=(const LogSearch&) = delete;
+
+    /// Append a line to the buffer and queue it for indexing (writer thread).
+    void append(std::string_view line);
+
+    /// Clear the buffer (writer thread). Stale index entries age out.
+    void clear();
+
+    /// Start a search; returns its generation. Supersedes any earlier one.
+    uint64_t submit(const std::string& pattern, bool regex, uint64_t fromSeq = 0);
+
+    /// Drop the pending/running search, if any.
+    void cancel();
+
+    /// Fetch a finished search. Results of superseded searches are dropped.
+    bool takeResult(Result& out);
+
+    /// Lines indexed so far (sequence number of the next one to index).
+    uint64_t indexedSeq() const { return indexedSeq_.load(std::memory_order_relaxed); }
+
+    /// Literal text every match of @p pattern contains (lower-cased), or "".
+    static std::string requiredLiteral(const std::string& pattern);
+
+private:
+    static constexpr uint64_t BLOCK_LINES = 32;
+    static constexpr size_t   INDEX_BATCH = 4096;   // lines copied per lock hold
+
+    struct Query {
+        uint64_t    generation = 0;
+        std::string pattern;
+        bool        regex = false;
+        uint64_t    fromSeq = 0;
+    };
+
+    void threadFunc();
+    void indexBatch();
+    void prune(uint64_t firstSeq);
+    void run(const Query& q);
+    std::vector<uint32_t> candidateBlocks(const std::string& literal, uint32_t first, uint32_t last) const;
+
+    /// Copy lines [from, to) that are still held into @p out; returns the
+    /// sequence number of out[0].
+    uint64_t copyLines(uint64_t from, uint64_t to, std::vector<std::string>& out);
+
+    LogBuffer& log_;
+    mutable std::shared_mutex logMutex_;
+    std::atomic<uint64_t> endSeq_{0};
+
+    // Worker-only index state
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings_;
+    std::atomic<uint64_t> indexedSeq_{0};
+    uint32_t prunedBlock_ = 0;
+    uint64_t heldFirstSeq_ = 0;   // log_.firstSeq() at the last copyLines()
+    std::vector<std::string> batch_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool running_ = true;
+    bool hasQuery_ = false;
+    Query query_;
+    bool hasResult_ = false;
+    Result result_;
+    std::atomic<uint64_t> generation_{0};
+};
@@ -4,34 +4,59 @@
 #include "crosspad-gui/platform/IGuiPlatform.h"
 #include "crosspad_app.hpp"
 #include "uart/PcUart.hpp"
+#include "LogBuffer.hpp"
+#include "LogSearch.hpp"
 #include "lvgl.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <regex>
 #include <string>
 #include <vector>
-#include <deque>
 
 /* ── Layout constants ────────────────────────────────────────────────── */
 
-static constexpr int32_t MAX_DISPLAY_LINES = 200;
-static constexpr uint32_t POLL_INTERVAL_MS = 50;
+static constexpr uint32_t POLL_INTERVAL_MS   = 50;
+static constexpr uint32_t SEARCH_INTERVAL_MS = 10;   // result pickup while a search runs
+static constexpr size_t   NO_MATCH           = SIZE_MAX;
+static constexpr int32_t  ROW_SPACING        = 1;
 
 /* ── Per-instance state ──────────────────────────────────────────────── */
 
 struct SerialMonitorState {
     lv_obj_t* container     = nullptr;
-    lv_obj_t* outputLabel   = nullptr;
+    lv_obj_t* logView       = nullptr;
     lv_obj_t* inputTA       = nullptr;
     lv_obj_t* statusLabel   = nullptr;
     lv_obj_t* baudDropdown  = nullptr;
     lv_obj_t* clearBtn      = nullptr;
     lv_obj_t* autoScrollBtn = nullptr;
-    lv_obj_t* scrollArea    = nullptr;
+    lv_obj_t* filterTA      = nullptr;
+    lv_obj_t* regexBtn      = nullptr;
+    lv_obj_t* filterBtn     = nullptr;
+    lv_obj_t* matchLabel    = nullptr;
     lv_timer_t* pollTimer   = nullptr;
+    lv_timer_t* searchTimer = nullptr;
 
-    std::deque<std::string> lines;
+    LogBuffer log;
+    LogSearch search{log};         // all writes to log go through search
+    uint64_t  shownFirstSeq = 0;   // log.firstSeq() the view was laid out for
+    int32_t   rowHeight     = 12;
     bool autoScroll = true;
-    bool dirty      = false;   // text needs refresh
+
+    // Search: matches are sequence numbers of the lines covered so far
+    std::string query;
+    bool        regex      = false;
+    bool        filterOnly = false;   // show matching lines only
+    std::string literal;              // lower-cased query (substring mode)
+    std::regex  highlightRe;
+    bool        highlightOk = false;
+    std::vector<uint64_t> matches;
+    size_t      current     = NO_MATCH;
+    uint64_t    searchedEnd = 0;      // lines before this were searched
+    bool        searching   = false;
+    bool        truncated   = false;
 };
 
 /* ── Baud rate options ───────────────────────────────────────────────── */
@@ -60,24 +85,327 @@ static int findBaudIndex(PcUart::BaudRate rate) {
     return 4; // default 115200
 }
 
-/* ── Rebuild the displayed text ──────────────────────────────────────── */
+/* ── Toggle buttons ──────────────────────────────────────────────────── */
+
+static void setToggleStyle(lv_obj_t* btn, bool on)
+{
+    if (on) {
+        lv_obj_set_style_bg_color(btn, lv_color_hex(0xFF9900), 0);
+        lv_obj_set_style_text_color(lv_obj_get_child(btn, 0), lv_color_white(), 0);
+    } else {
+        lv_obj_set_style_bg_color(btn, lv_color_hex(0x333333), 0);
+        lv_obj_set_style_text_color(lv_obj_get_child(btn, 0), lv_color_hex(0x888888), 0);
+    }
+}
+
+static lv_obj_t* createToolButton(lv_obj_t* parent, int32_t w, const char* text,
+                                  lv_event_cb_t cb, SerialMonitorState* st)
+{
+    lv_obj_t* btn = lv_button_create(parent);
+    lv_obj_set_size(btn, w, 20);
+    lv_obj_set_style_radius(btn, 3, 0);
+    lv_obj_set_style_pad_all(btn, 0, 0);
+    lv_obj_t* lbl = lv_label_create(btn);
+    lv_label_set_text(lbl, text);
+    lv_obj_set_style_text_font(lbl, &lv_font_montserrat_10, 0);
+    lv_obj_center(lbl);
+    setToggleStyle(btn, false);
+    lv_obj_add_event_cb(btn, cb, LV_EVENT_CLICKED, st);
+    return btn;
+}
+
+/* ── Search helpers ──────────────────────────────────────────────────── */
+
+static bool filtering(const SerialMonitorState* st)
+{
+    return st->filterOnly && !st->query.empty();
+}
+
+/// Rows the view shows: every held line, or only the matches when filtering.
+static size_t rowCount(const SerialMonitorState* st)
+{
+    return filtering(st) ? st->matches.size() : st->log.size();
+}
+
+static uint64_t rowSeq(const SerialMonitorState* st, size_t row)
+{
+    return filtering(st) ? st->matches[row] : st->log.firstSeq() + row;
+}
+
+/// Paint match spans of one row (behind its text), plus a row bar for the
+/// current match.
+static void drawHighlights(SerialMonitorState* st, lv_layer_t* layer, const lv_area_t& rowArea,
+                           const char* text, size_t len, bool current)
+{
+    const lv_font_t* font = &lv_font_montserrat_10;
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+
+    if (current) {
+        dsc.bg_color = lv_color_hex(0x332200);
+        lv_draw_rect(layer, &dsc, &rowArea);
+    }
+
+    auto span = [&](size_t pos, size_t n) {
+        lv_area_t a = rowArea;
+        a.x1 = rowArea.x1 + lv_text_get_width(text, (uint32_t)pos, font, 0);
+        a.x2 = a.x1 + lv_text_get_width(text + pos, (uint32_t)n, font, 0) - 1;
+        if (a.x1 > rowArea.x2) return false;
+        dsc.bg_color = current ? lv_color_hex(0xAA6600) : lv_color_hex(0x554400);
+        lv_draw_rect(layer, &dsc, &a);
+        return true;
+    };
+
+    if (st->regex) {
+        if (!st->highlightOk) return;
+        for (std::cregex_iterator it(text, text + len, st->highlightRe), end; it != end; ++it) {
+            if (it->length(0) > 0 && !span((size_t)it->position(0), (size_t)it->length(0))) break;
+        }
+    } else if (!st->literal.empty()) {
+        std::string lower(text, len);
+        for (char& c : lower) c = (char)tolower((unsigned char)c);
+        for (size_t pos = lower.find(st->literal); pos != std::string::npos;
+             pos = lower.find(st->literal, pos + st->literal.size())) {
+            if (!span(pos, st->literal.size())) break;
+        }
+    }
+}
+
+/* ── Virtualized log view ────────────────────────────────────────────── */
+//
+// One scrollable object, no rows as children: it reports log height as its
+// content size and draws only the lines inside the viewport, so appending,
+// scrolling and auto-scroll cost the same with 10 or 1M lines of history.
+
+static void onLogViewEvent(lv_event_t* e)
+{
+    auto* st = static_cast<SerialMonitorState*>(lv_event_get_user_data(e));
+    lv_obj_t* view = (lv_obj_t*)lv_event_get_target(e);
+
+    if (lv_event_get_code(e) == LV_EVENT_GET_SELF_SIZE) {
+        auto* size = static_cast<lv_point_t*>(lv_event_get_param(e));
+        size->y = std::max<int32_t>(size->y, (int32_t)rowCount(st) * st->rowHeight);
+        return;
+    }
+
+    // LV_EVENT_DRAW_MAIN: background is already drawn by the object itself
+    lv_layer_t* layer = lv_event_get_layer(e);
+    lv_area_t content;
+    lv_obj_get_content_coords(view, &content);
+
+    const int32_t scrollY = lv_obj_get_scroll_y(view);
+    const size_t  count   = rowCount(st);
+    size_t first = (size_t)std::max<int32_t>(scrollY / st->rowHeight, 0);
+    size_t last  = std::min(count, (size_t)((scrollY + lv_area_get_height(&content)) / st->rowHeight + 1));
+
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    dsc.font       = &lv_font_montserrat_10;
+    dsc.color      = lv_color_hex(0x00FF66);
+    dsc.flag       = LV_TEXT_FLAG_EXPAND;   // one row per line, clipped at the edge
+    dsc.text_local = 1;                     // row text is copied out of the scratch buffer
+
+    const uint64_t currentSeq = st->current != NO_MATCH ? st->matches[st->current] : UINT64_MAX;
+
+    char row[LogBuffer::MAX_LINE_LENGTH + 1];
+    for (size_t i = first; i < last; i++) {
+        const uint64_t seq = rowSeq(st, i);
+        std::string_view text = st->log.line((size_t)(seq - st->log.firstSeq()));
+        memcpy(row, text.data(), text.size());
+        row[text.size()] = '\0';
+        dsc.text = row;
+
+        lv_area_t a = content;
+        a.y1 = content.y1 - scrollY + (int32_t)i * st->rowHeight;
+        a.y2 = a.y1 + st->rowHeight - 1;
+        if (filtering(st) || std::binary_search(st->matches.begin(), st->matches.end(), seq))
+            drawHighlights(st, layer, a, row, text.size(), seq == currentSeq);
+        lv_draw_label(layer, &dsc, &a);
+    }
+}
 
-static void rebuildOutputText(SerialMonitorState* st)
+/// Lay the view out for the current log contents after appends/evictions.
+static void refreshLogView(SerialMonitorState* st)
 {
-    if (!st->outputLabel) return;
+    if (!st->logView) return;
+
+    // Lines that fell off the front shift everything up; follow them so a
+    // user reading older history keeps seeing the same lines.
+    uint64_t evicted = st->log.firstSeq() - st->shownFirstSeq;
+    st->shownFirstSeq = st->log.firstSeq();
+
+    // Matches on evicted lines go too
+    auto keep = std::lower_bound(st->matches.begin(), st->matches.end(), st->log.firstSeq());
+    size_t dropped = (size_t)(keep - st->matches.begin());
+    if (dropped) {
+        st->matches.erase(st->matches.begin(), keep);
+        if (st->current != NO_MATCH)
+            st->current = st->current >= dropped ? st->current - dropped : NO_MATCH;
+    }
+    if (filtering(st)) evicted = dropped;
 
-    std::string text;
-    for (auto& line : st->lines) {
-        text += line;
-        text += '\n';
+    lv_obj_refresh_self_size(st->logView);
+    if (st->autoScroll) {
+        lv_obj_scroll_to_y(st->logView, LV_COORD_MAX, LV_ANIM_OFF);
+    } else if (evicted) {
+        lv_obj_scroll_by_bounded(st->logView, 0,
+                                 (int32_t)std::min<uint64_t>(evicted, INT32_MAX / st->rowHeight) * st->rowHeight,
+                                 LV_ANIM_OFF);
     }
+    lv_obj_invalidate(st->logView);
+}
+
+/* ── Search ──────────────────────────────────────────────────────────── */
+//
+// Queries run on LogSearch's worker; this side only submits, picks the
+// result up from a short timer that runs while one is outstanding, and
+// extends the search over lines that arrived since (see onPollTimer).
+
+static void updateMatchLabel(SerialMonitorState* st, const char* error = nullptr)
+{
+    if (!st->matchLabel) return;
+    char buf[32];
+    if (error) {
+        snprintf(buf, sizeof(buf), "bad regex");
+    } else if (st->query.empty()) {
+        buf[0] = '\0';
+    } else if (st->searching && st->matches.empty()) {
+        snprintf(buf, sizeof(buf), "...");
+    } else if (st->current != NO_MATCH) {
+        snprintf(buf, sizeof(buf), "%zu/%zu%s", st->current + 1, st->matches.size(),
+                 st->truncated ? "+" : "");
+    } else {
+        snprintf(buf, sizeof(buf), "%zu%s", st->matches.size(), st->truncated ? "+" : "");
+    }
+    lv_label_set_text(st->matchLabel, buf);
+    lv_obj_set_style_text_color(st->matchLabel,
+                                lv_color_hex(error ? 0xFF4444 : 0xAAAAAA), 0);
+}
 
-    lv_label_set_text(st->outputLabel, text.c_str());
-    st->dirty = false;
+static void submitSearch(SerialMonitorState* st, uint64_t fromSeq)
+{
+    st->search.submit(st->query, st->regex, fromSeq);
+    st->searching = true;
+    lv_timer_resume(st->searchTimer);
+}
 
-    if (st->autoScroll && st->scrollArea) {
-        lv_obj_scroll_to_y(st->scrollArea, LV_COORD_MAX, LV_ANIM_OFF);
+/// Start over with the current filter text and mode.
+static void restartSearch(SerialMonitorState* st)
+{
+    st->query = lv_textarea_get_text(st->filterTA);
+    st->matches.clear();
+    st->current     = NO_MATCH;
+    st->searchedEnd = 0;
+    st->truncated   = false;
+
+    if (st->query.empty()) {
+        st->search.cancel();
+        st->searching = false;
+        lv_timer_pause(st->searchTimer);
+    } else {
+        st->literal = st->query;
+        for (char& c : st->literal) c = (char)tolower((unsigned char)c);
+        st->highlightOk = false;
+        if (st->regex) {
+            try {
+                st->highlightRe = std::regex(st->query, std::regex::ECMAScript | std::regex::icase);
+                st->highlightOk = true;
+            } catch (const std::regex_error&) {
+            }
+        }
+        submitSearch(st, 0);
     }
+    updateMatchLabel(st);
+    refreshLogView(st);
+}
+
+static void onSearchTimer(lv_timer_t* t)
+{
+    auto* st = static_cast<SerialMonitorState*>(lv_timer_get_user_data(t));
+    LogSearch::Result r;
+    if (!st->search.takeResult(r)) return;
+
+    st->searching = false;
+    lv_timer_pause(st->searchTimer);
+    if (!r.error.empty()) {
+        printf("[SerialMonitor] Bad regex: %s\n", r.error.c_str());
+        st->searchedEnd = UINT64_MAX;   // nothing to extend until the query changes
+        updateMatchLabel(st, r.error.c_str());
+        return;
+    }
+
+    st->matches.insert(st->matches.end(), r.matches.begin(), r.matches.end());
+    st->searchedEnd = r.endSeq;
+    st->truncated   = r.truncated;
+    updateMatchLabel(st);
+    refreshLogView(st);
+}
+
+/// Continue the active search over lines appended since it last ran.
+static void extendSearch(SerialMonitorState* st)
+{
+    if (st->query.empty() || st->searching || st->truncated) return;
+    if (st->log.firstSeq() + st->log.size() > st->searchedEnd)
+        submitSearch(st, st->searchedEnd);
+}
+
+static void setAutoScroll(SerialMonitorState* st, bool on)
+{
+    st->autoScroll = on;
+    if (st->autoScrollBtn) setToggleStyle(st->autoScrollBtn, on);
+}
+
+/// Select match @p index and scroll it into the middle of the view.
+static void gotoMatch(SerialMonitorState* st, size_t index)
+{
+    if (index >= st->matches.size()) return;
+    st->current = index;
+    setAutoScroll(st, false);
+
+    size_t row = filtering(st) ? index : (size_t)(st->matches[index] - st->log.firstSeq());
+    int32_t y = (int32_t)row * st->rowHeight - lv_obj_get_content_height(st->logView) / 2;
+    lv_obj_scroll_to_y(st->logView, std::max<int32_t>(y, 0), LV_ANIM_OFF);
+    lv_obj_invalidate(st->logView);
+    updateMatchLabel(st);
+}
+
+static void onFilterChanged(lv_event_t* e)
+{
+    restartSearch(static_cast<SerialMonitorState*>(lv_event_get_user_data(e)));
+}
+
+static void onRegexClicked(lv_event_t* e)
+{
+    auto* st = static_cast<SerialMonitorState*>(lv_event_get_user_data(e));
+    st->regex = !st->regex;
+    setToggleStyle(st->regexBtn, st->regex);
+    restartSearch(st);
+}
+
+static void onFilterOnlyClicked(lv_event_t* e)
+{
+    auto* st = static_cast<SerialMonitorState*>(lv_event_get_user_data(e));
+    st->filterOnly = !st->filterOnly;
+    setToggleStyle(st->filterBtn, st->filterOnly);
+    lv_obj_refresh_self_size(st->logView);
+    if (st->current != NO_MATCH) gotoMatch(st, st->current);
+    else refreshLogView(st);
+}
+
+static void onNextMatch(lv_event_t* e)
+{
+    auto* st = static_cast<SerialMonitorState*>(lv_event_get_user_data(e));
+    if (st->matches.empty()) return;
+    gotoMatch(st, st->current == NO_MATCH || st->current + 1 >= st->matches.size()
+                  ? 0 : st->current + 1);
+}
+
+static void onPrevMatch(lv_event_t* e)
+{
+    auto* st = static_cast<SerialMonitorState*>(lv_event_get_user_data(e));
+    if (st->matches.empty()) return;
+    gotoMatch(st, st->current == NO_MATCH || st->current == 0
+                  ? st->matches.size() - 1 : st->current - 1);
 }
 
 /* ── Poll timer ──────────────────────────────────────────────────────── */
@@ -90,10 +418,13 @@ static void onPollTimer(lv_timer_t* t)
     // Update status
     if (st->statusLabel) {
         if (uart.isOpen()) {
-            char buf[64];
-            snprintf(buf, sizeof(buf), "%s @ %u",
-                     uart.getPortName().c_str(),
-                     static_cast<uint32_t>(uart.getBaudRate()));
+            char buf[96];
+            int len = snprintf(buf, sizeof(buf), "%s @ %u",
+                               uart.getPortName().c_str(),
+                               static_cast<uint32_t>(uart.getBaudRate()));
+            // Lines the UART ring overwrote before they were read
+            if (uint64_t dropped = uart.droppedLines(); dropped && len > 0 && (size_t)len < sizeof(buf))
+                snprintf(buf + len, sizeof(buf) - len, "  (%llu dropped)", (unsigned long long)dropped);
             lv_label_set_text(st->statusLabel, buf);
             lv_obj_set_style_text_color(st->statusLabel, lv_color_hex(0xFF9900), 0);
         } else {
@@ -102,20 +433,12 @@ static void onPollTimer(lv_timer_t* t)
         }
     }
 
-    // Read new lines
-    auto newLines = uart.readLines();
-    if (newLines.empty()) return;
+    // Read new lines straight out of the UART's ring
+    size_t n = uart.drainLines([st](std::string_view line, uint64_t) { st->search.append(line); });
+    if (n == 0) return;
 
-    for (auto& line : newLines) {
-        st->lines.push_back(std::move(line));
-    }
-
-    // Trim to max
-    while (st->lines.size() > MAX_DISPLAY_LINES) {
-        st->lines.pop_front();
-    }
-
-    rebuildOutputText(st);
+    extendSearch(st);
+    refreshLogView(st);
 }
 
 /* ── Input send callback ─────────────────────────────────────────────── */
@@ -135,10 +458,9 @@ static void onInputSend(lv_event_t* e)
         uart.write(msg);
 
         // Echo to output
-        st->lines.push_back(std::string("> ") + text);
-        while (st->lines.size() > MAX_DISPLAY_LINES)
-            st->lines.pop_front();
-        rebuildOutputText(st);
+        st->search.append(std::string("> ") + text);
+        extendSearch(st);
+        refreshLogView(st);
     }
 
     lv_textarea_set_text(st->inputTA, "");
@@ -149,9 +471,15 @@ static void onInputSend(lv_event_t* e)
 static void onClearClicked(lv_event_t* e)
 {
     auto* st = static_cast<SerialMonitorState*>(lv_event_get_user_data(e));
-    st->lines.clear();
-    if (st->outputLabel) {
-        lv_label_set_text(st->outputLabel, "");
+    st->search.clear();
+    st->shownFirstSeq = st->log.firstSeq();
+    st->matches.clear();
+    st->current = NO_MATCH;
+    updateMatchLabel(st);
+    if (st->logView) {
+        lv_obj_refresh_self_size(st->logView);
+        lv_obj_scroll_to_y(st->logView, 0, LV_ANIM_OFF);
+        lv_obj_invalidate(st->logView);
     }
 }
 
@@ -160,16 +488,7 @@ static void onClearClicked(lv_event_t* e)
 static void onAutoScrollClicked(lv_event_t* e)
 {
     auto* st = static_cast<SerialMonitorState*>(lv_event_get_user_data(e));
-    st->autoScroll = !st->autoScroll;
-
-    lv_obj_t* btn = (lv_obj_t*)lv_event_get_target(e);
-    if (st->autoScroll) {
-        lv_obj_set_style_bg_color(btn, lv_color_hex(0xFF9900), 0);
-        lv_obj_set_style_text_color(lv_obj_get_child(btn, 0), lv_color_white(), 0);
-    } else {
-        lv_obj_set_style_bg_color(btn, lv_color_hex(0x333333), 0);
-        lv_obj_set_style_text_color(lv_obj_get_child(btn, 0), lv_color_hex(0x888888), 0);
-    }
+    setAutoScroll(st, !st->autoScroll);
 }
 
 /* ── Baud rate change ────────────────────────────────────────────────── */
@@ -274,25 +593,57 @@ static lv_obj_t* lv_CreateSerialMonitor(lv_obj_t* parent, App* a)
     lv_obj_center(scrollLbl);
     lv_obj_add_event_cb(st->autoScrollBtn, onAutoScrollClicked, LV_EVENT_CLICKED, st);
 
-    // ── Scroll area for output ──
-    st->scrollArea = lv_obj_create(st->container);
-    lv_obj_set_size(st->scrollArea, LV_PCT(100), LV_SIZE_CONTENT);
-    lv_obj_set_flex_grow(st->scrollArea, 1);
-    lv_obj_set_style_bg_color(st->scrollArea, lv_color_hex(0x0A0A0A), 0);
-    lv_obj_set_style_border_width(st->scrollArea, 1, 0);
-    lv_obj_set_style_border_color(st->scrollArea, lv_color_hex(0x333333), 0);
-    lv_obj_set_style_pad_all(st->scrollArea, 4, 0);
-    lv_obj_set_style_radius(st->scrollArea, 2, 0);
-    lv_obj_add_flag(st->scrollArea, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_scrollbar_mode(st->scrollArea, LV_SCROLLBAR_MODE_AUTO);
-
-    // Output label (monospace-style, wrapping)
-    st->outputLabel = lv_label_create(st->scrollArea);
-    lv_label_set_text(st->outputLabel, "");
-    lv_obj_set_width(st->outputLabel, LV_PCT(100));
-    lv_obj_set_style_text_font(st->outputLabel, &lv_font_montserrat_10, 0);
-    lv_obj_set_style_text_color(st->outputLabel, lv_color_hex(0x00FF66), 0);
-    lv_label_set_long_mode(st->outputLabel, LV_LABEL_LONG_WRAP);
+    // ── Search row (filter + regex/filter toggles + prev/next) ──
+    lv_obj_t* searchRow = lv_obj_create(st->container);
+    lv_obj_set_size(searchRow, LV_PCT(100), 22);
+    lv_obj_set_style_bg_opa(searchRow, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(searchRow, 0, 0);
+    lv_obj_set_style_pad_all(searchRow, 0, 0);
+    lv_obj_remove_flag(searchRow, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_flex_flow(searchRow, LV_FLEX_FLOW_ROW);
+    lv_obj_set_style_pad_column(searchRow, 4, 0);
+    lv_obj_set_flex_align(searchRow, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+    st->filterTA = lv_textarea_create(searchRow);
+    lv_textarea_set_one_line(st->filterTA, true);
+    lv_textarea_set_placeholder_text(st->filterTA, "Find...");
+    lv_obj_set_flex_grow(st->filterTA, 1);
+    lv_obj_set_height(st->filterTA, 20);
+    lv_obj_set_style_text_font(st->filterTA, &lv_font_montserrat_10, 0);
+    lv_obj_set_style_bg_color(st->filterTA, lv_color_hex(0x1A1A1A), 0);
+    lv_obj_set_style_text_color(st->filterTA, lv_color_hex(0xDDDDDD), 0);
+    lv_obj_set_style_border_color(st->filterTA, lv_color_hex(0x444444), 0);
+    lv_obj_set_style_border_width(st->filterTA, 1, 0);
+    lv_obj_set_style_radius(st->filterTA, 3, 0);
+    lv_obj_set_style_pad_all(st->filterTA, 2, 0);
+    lv_obj_add_event_cb(st->filterTA, onFilterChanged, LV_EVENT_VALUE_CHANGED, st);
+    lv_obj_add_event_cb(st->filterTA, onNextMatch, LV_EVENT_READY, st);
+
+    st->matchLabel = lv_label_create(searchRow);
+    lv_label_set_text(st->matchLabel, "");
+    lv_obj_set_width(st->matchLabel, 56);
+    lv_obj_set_style_text_font(st->matchLabel, &lv_font_montserrat_10, 0);
+    lv_obj_set_style_text_align(st->matchLabel, LV_TEXT_ALIGN_RIGHT, 0);
+
+    st->regexBtn  = createToolButton(searchRow, 24, ".*", onRegexClicked, st);
+    st->filterBtn = createToolButton(searchRow, 20, LV_SYMBOL_LIST, onFilterOnlyClicked, st);
+    createToolButton(searchRow, 20, LV_SYMBOL_UP, onPrevMatch, st);
+    createToolButton(searchRow, 20, LV_SYMBOL_DOWN, onNextMatch, st);
+
+    // ── Log view (virtualized, see onLogViewEvent) ──
+    st->logView = lv_obj_create(st->container);
+    lv_obj_set_width(st->logView, LV_PCT(100));
+    lv_obj_set_flex_grow(st->logView, 1);
+    lv_obj_set_style_bg_color(st->logView, lv_color_hex(0x0A0A0A), 0);
+    lv_obj_set_style_border_width(st->logView, 1, 0);
+    lv_obj_set_style_border_color(st->logView, lv_color_hex(0x333333), 0);
+    lv_obj_set_style_pad_all(st->logView, 4, 0);
+    lv_obj_set_style_radius(st->logView, 2, 0);
+    lv_obj_add_flag(st->logView, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scrollbar_mode(st->logView, LV_SCROLLBAR_MODE_AUTO);
+    st->rowHeight = lv_font_get_line_height(&lv_font_montserrat_10) + ROW_SPACING;
+    lv_obj_add_event_cb(st->logView, onLogViewEvent, LV_EVENT_GET_SELF_SIZE, st);
+    lv_obj_add_event_cb(st->logView, onLogViewEvent, LV_EVENT_DRAW_MAIN, st);
 
     // ── Input row (text area + send button) ──
     lv_obj_t* inputRow = lv_obj_create(st->container);
@@ -336,6 +687,8 @@ static lv_obj_t* lv_CreateSerialMonitor(lv_obj_t* parent, App* a)
 
     // ── Poll timer ──
     st->pollTimer = lv_timer_create(onPollTimer, POLL_INTERVAL_MS, st);
+    st->searchTimer = lv_timer_create(onSearchTimer, SEARCH_INTERVAL_MS, st);
+    lv_timer_pause(st->searchTimer);
 
     printf("[SerialMonitor] App created\n");
     return st->container;
@@ -348,6 +701,9 @@ static void lv_DestroySerialMonitor(lv_obj_t* obj)
         if (st->pollTimer) {
             lv_timer_delete(st->pollTimer);
         }
+        if (st->searchTimer) {
+            lv_timer_delete(st->searchTimer);
+        }
         delete st;
     }
     printf("[SerialMonitor] App destroyed\n");
@@ -0,0 +1,103 @@
+/**
+ * @file AudioBroadcastTap.cpp
+ * @brief Broadcast audio ring with independent reader cursors.
+ */
+
+#include "AudioBroadcastTap.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+static uint32_t next_pow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+AudioBroadcastTap::AudioBroadcastTap(uint32_t capacityFrames)
+    : capacity_(next_pow2(std::max<uint32_t>(capacityFrames, 256)))
+    , ring_((size_t)capacity_ * 2)
+{
+}
+
+void AudioBroadcastTap::write(const int16_t* interleaved, uint32_t frames, uint32_t sampleRate)
+{
+    if (!hasReaders() || !interleaved || frames == 0) return;
+
+    if (sampleRate_.load(std::memory_order_relaxed) != sampleRate)
+        sampleRate_.store(sampleRate, std::memory_order_relaxed);
+
+    uint64_t pos = writePos_.load(std::memory_order_relaxed);
+    if (frames > capacity_) {
+        // Only the newest capacity_ frames can survive
+        interleaved += (size_t)(frames - capacity_) * 2;
+        pos += frames - capacity_;
+        frames = capacity_;
+    }
+
+    // Announce the overwrite first so readers can validate their copies
+    writeEnd_.store(pos + frames, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint32_t mask  = capacity_ - 1;
+    const uint32_t slot  = (uint32_t)(pos & mask);
+    const uint32_t first = std::min(frames, capacity_ - slot);
+    memcpy(&ring_[(size_t)slot * 2], interleaved, (size_t)first * 2 * sizeof(int16_t));
+    if (first < frames)
+        memcpy(&ring_[0], interleaved + (size_t)first * 2, (size_t)(frames - first) * 2 * sizeof(int16_t));
+
+    writePos_.store(pos + frames, std::memory_order_release);
+}
+
+AudioBroadcastTap::Cursor AudioBroadcastTap::attach()
+{
+    readers_.fetch_add(1);
+    Cursor c;
+    c.pos = writePos_.load(std::memory_order_acquire);
+    return c;
+}
+
+void AudioBroadcastTap::detach()
+{
+    readers_.fetch_sub(1);
+}
+
+uint64_t AudioBroadcastTap::available(const Cursor& c) const
+{
+    uint64_t w = writePos_.load(std::memory_order_acquire);
+    return w > c.pos ? w - c.pos : 0;
+}
+
+uint32_t AudioBroadcastTap::read(Cursor& c, int16_t* dst, uint32_t maxFrames)
+{
+    uint64_t w = writePos_.load(std::memory_order_acquire);
+    if (w <= c.pos || maxFrames == 0) return 0;
+
+    if (w - c.pos > capacity_) {
+        // Lapped: skip to the oldest frame still in the ring
+        c.dropped += (w - capacity_) - c.pos;
+        c.pos = w - capacity_;
+    }
+
+    uint32_t n = (uint32_t)std::min<uint64_t>(maxFrames, w - c.pos);
+    const uint32_t mask  = capacity_ - 1;
+    const uint32_t slot  = (uint32_t)(c.pos & mask);
+    const uint32_t first = std::min(n, capacity_ - slot);
+    memcpy(dst, &ring_[(size_t)slot * 2], (size_t)first * 2 * sizeof(int16_t));
+    if (first < n)
+        memcpy(dst + (size_t)first * 2, &ring_[0], (size_t)(n - first) * 2 * sizeof(int16_t));
+
+    // Frames older than end - capacity may have been overwritten mid-copy
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t end = writeEnd_.load(std::memory_order_relaxed);
+    if (end > capacity_ && end - capacity_ > c.pos) {
+        uint32_t lost = (uint32_t)std::min<uint64_t>(end - capacity_ - c.pos, n);
+        memmove(dst, dst + (size_t)lost * 2, (size_t)(n - lost) * 2 * sizeof(int16_t));
+        n        -= lost;
+        c.pos    += lost;
+        c.dropped += lost;
+    }
+
+    c.pos += n;
+    return n;
+}
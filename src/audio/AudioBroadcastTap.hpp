@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * @file AudioBroadcastTap.hpp
+ * @brief Single-producer, multi-reader ring of interleaved stereo int16 audio.
+ *
+ * The mixer thread write()s every chunk; any number of readers keep their
+ * own Cursor and read at their own pace. The producer never waits for
+ * readers and never allocates — a reader that falls more than capacity()
+ * frames behind is moved forward and the skipped frames are added to its
+ * drop counter. With no readers attached write() returns immediately.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class AudioBroadcastTap {
+public:
+    static constexpr uint32_t DEFAULT_CAPACITY = 32768;   // frames, ~0.7 s at 48 kHz
+
+    /// @param capacityFrames  rounded up to a power of two
+    explicit AudioBroadcastTap(uint32_t capacityFrames = DEFAULT_CAPACITY);
+
+    AudioBroadcastTap(const AudioBroadcastTap&) = delete;
+    AudioBroadcastTap& operator=(const AudioBroadcastTap&) = delete;
+
+    /// Per-reader position. Frame indices count from the tap's creation.
+    struct Cursor {
+        uint64_t pos     = 0;   ///< next frame to read
+        uint64_t dropped = 0;   ///< frames lost to overruns
+    };
+
+    // ── Producer (one thread) ──
+
+    void write(const int16_t* interleaved, uint32_t frames, uint32_t sampleRate);
+
+    // ── Readers (any thread, each with its own Cursor) ──
+
+    /// Register a reader positioned at the live edge.
+    Cursor attach();
+
+    /// Unregister a reader obtained from attach().
+    void detach();
+
+    /// Frames waiting for @p c (may exceed capacity() if it was lapped).
+    uint64_t available(const Cursor& c) const;
+
+    /// Copy up to @p maxFrames into @p dst; returns frames copied.
+    uint32_t read(Cursor& c, int16_t* dst, uint32_t maxFrames);
+
+    bool     hasReaders() const { return readers_.load(std::memory_order_relaxed) > 0; }
+    uint32_t capacity() const   { return capacity_; }
+    uint32_t sampleRate() const { return sampleRate_.load(std::memory_order_relaxed); }
+    uint64_t writePos() const   { return writePos_.load(std::memory_order_acquire); }
+
+private:
+    uint32_t capacity_;
+    std::vector<int16_t> ring_;
+
+    std::atomic<uint64_t> writeEnd_{0};   // advanced before slots are overwritten
+    std::atomic<uint64_t> writePos_{0};   // advanced after they are complete
+    std::atomic<uint32_t> sampleRate_{48000};
+    std::atomic<int>      readers_{0};
+};
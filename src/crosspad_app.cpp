@@ -15,7 +15,6 @@
 #include <atomic>
 #include <thread>
 #include <chrono>
-#include <fstream>
 #include <filesystem>
 #include <string>
 
@@ -23,6 +22,11 @@
 
 #include "pc_stubs/pc_platform.h"
 #include "pc_stubs/PcApp.hpp"
+#include "pc_stubs/PcDevicePrefs.hpp"
+#include "pc_stubs/PcPersistence.hpp"
+#include "pc_stubs/StateSnapshot.hpp"
+#include "remote/RemoteEvents.hpp"
+#include "remote/SharedMemory.hpp"
 #include "updater/PcUpdater.hpp"
 
 // crosspad-core
@@ -33,6 +37,7 @@
 
 // STM32 hardware emulator window
 #include "stm32_emu/Stm32EmuWindow.hpp"
+#include "widgets/VuMeter.hpp"
 
 // crosspad-gui
 #include "crosspad-gui/theme/crosspad_theme.h"
@@ -61,7 +66,7 @@
 #endif
 
 #include "uart/PcUart.hpp"
-#include <ArduinoJson.h>
+#include "uart/Telemetry.hpp"
 
 /* ── Constants ────────────────────────────────────────────────────────── */
 
@@ -95,57 +100,38 @@ static std::shared_ptr<MixerPadLogic> s_mixerPadLogic;
 /* ── Virtual USB/UART ─────────────────────────────────────────────────── */
 
 static PcUart pcUart;
+static telemetry::Dispatcher s_telemetry;
+static telemetry::Latest<telemetry::PerfCounters> s_devicePerf;
 
 /* ── Device Preferences ──────────────────────────────────────────────── */
 
-struct DevicePreferences {
-    std::string audioOut1;
-    std::string audioOut2;
-    std::string audioIn1;
-    std::string audioIn2;
-    std::string midiOut;
-    std::string midiIn;
-    std::string sdcardPath;
-    std::string uartPort;
-    uint32_t    uartBaud = 115200;
-};
-
 static DevicePreferences s_devicePrefs;
 
 static std::string getDevicePrefsPath() {
     const char* dir = pc_platform_get_profile_dir();
-    return std::string(dir) + "/device_preferences.json";
+    return std::string(dir) + "/device_preferences";
 }
 
 static std::string getMixerStatePath() {
     const char* dir = pc_platform_get_profile_dir();
-    return std::string(dir) + "/mixer_state.json";
+    return std::string(dir) + "/mixer_state";
 }
 
 static void loadDevicePrefs() {
-    std::string path = getDevicePrefsPath();
-    std::ifstream f(path);
-    if (!f.is_open()) {
-        printf("[DevPrefs] No saved preferences at %s\n", path.c_str());
-        return;
-    }
-
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, f);
-    if (err) {
-        printf("[DevPrefs] Parse error: %s\n", err.c_str());
+    std::string path;
+    DevicePreferences loaded;
+    const bool ok = StateSnapshot::readNewest(getDevicePrefsPath(), [&](const std::string& data) {
+        loaded = s_devicePrefs;
+        return loaded.parse(data);
+    }, &path);
+    if (!ok) {
+        if (path.empty())
+            printf("[DevPrefs] No saved preferences at %s.json\n", getDevicePrefsPath().c_str());
+        else
+            printf("[DevPrefs] Parse error in %s\n", path.c_str());
         return;
     }
-
-    if (doc["audio_out1"].is<const char*>()) s_devicePrefs.audioOut1 = doc["audio_out1"].as<const char*>();
-    if (doc["audio_out2"].is<const char*>()) s_devicePrefs.audioOut2 = doc["audio_out2"].as<const char*>();
-    if (doc["audio_in1"].is<const char*>())  s_devicePrefs.audioIn1  = doc["audio_in1"].as<const char*>();
-    if (doc["audio_in2"].is<const char*>())  s_devicePrefs.audioIn2  = doc["audio_in2"].as<const char*>();
-    if (doc["midi_out"].is<const char*>())   s_devicePrefs.midiOut   = doc["midi_out"].as<const char*>();
-    if (doc["midi_in"].is<const char*>())    s_devicePrefs.midiIn    = doc["midi_in"].as<const char*>();
-    if (doc["sdcard_path"].is<const char*>()) s_devicePrefs.sdcardPath = doc["sdcard_path"].as<const char*>();
-    if (doc["uart_port"].is<const char*>())  s_devicePrefs.uartPort   = doc["uart_port"].as<const char*>();
-    if (doc["uart_baud"].is<uint32_t>())     s_devicePrefs.uartBaud   = doc["uart_baud"].as<uint32_t>();
+    s_devicePrefs = loaded;
 
     printf("[DevPrefs] Loaded: out1='%s' out2='%s' in1='%s' in2='%s' midiOut='%s' midiIn='%s' sd='%s' uart='%s@%u'\n",
            s_devicePrefs.audioOut1.c_str(), s_devicePrefs.audioOut2.c_str(),
@@ -156,25 +142,10 @@ static void loadDevicePrefs() {
 }
 
 static void saveDevicePrefs() {
-    std::string path = getDevicePrefsPath();
-    JsonDocument doc;
-    doc["audio_out1"] = s_devicePrefs.audioOut1;
-    doc["audio_out2"] = s_devicePrefs.audioOut2;
-    doc["audio_in1"]  = s_devicePrefs.audioIn1;
-    doc["audio_in2"]  = s_devicePrefs.audioIn2;
-    doc["midi_out"]    = s_devicePrefs.midiOut;
-    doc["midi_in"]     = s_devicePrefs.midiIn;
-    doc["sdcard_path"] = s_devicePrefs.sdcardPath;
-    doc["uart_port"]   = s_devicePrefs.uartPort;
-    doc["uart_baud"]   = s_devicePrefs.uartBaud;
-
-    std::ofstream f(path);
-    if (!f.is_open()) {
-        printf("[DevPrefs] Failed to write %s\n", path.c_str());
-        return;
-    }
-    serializeJsonPretty(doc, f);
-    printf("[DevPrefs] Saved to %s\n", path.c_str());
+    // Copy now; serialize and write on the persistence worker
+    const bool binary = pc_platform_options().binaryState;
+    PcPersistence::getInstance().schedule(getDevicePrefsPath() + StateSnapshot::extension(binary),
+        [prefs = s_devicePrefs, binary] { return binary ? prefs.toSnapshot() : prefs.toJson(); });
 }
 
 /* ── Audio/MIDI device enumeration helpers ───────────────────────────── */
@@ -270,13 +241,27 @@ static int findMidiPortByName(const std::string& name, bool isOutput) {
 
 static void LoadMainScreen(lv_obj_t* parent);
 
+/// Runs the app's create function and names its root "app:<name>", so
+/// remote queries can be scoped to one app.
+static lv_obj_t* pc_app_create_named(lv_obj_t* parent, App* app)
+{
+    lv_obj_t* root = app->realCreate(parent, app);
+    if (root) lv_obj_set_name(root, (std::string("app:") + app->queryName).c_str());
+    return root;
+}
+
 /// PC app factory — creates App instances for the orchestrator
 static crosspad_gui::ILvglApp* pc_app_factory(
     lv_obj_t* container, const char* name, const char* icon,
     lv_obj_t* (*createLVGL)(lv_obj_t*, App*),
     void (*destroyLVGL)(lv_obj_t*))
 {
-    return new App(container, name, icon, createLVGL, destroyLVGL);
+    if (!createLVGL || !name) return new App(container, name, icon, createLVGL, destroyLVGL);
+
+    App* app = new App(container, name, icon, pc_app_create_named, destroyLVGL);
+    app->realCreate = createLVGL;
+    app->queryName  = name;
+    return app;
 }
 
 static void InitializeOrchestrator() {
@@ -361,7 +346,10 @@ void crosspad_app_init()
     /* Overlay layer on lv_layer_top(), positioned over the LCD area. */
     lv_obj_t* overlayLayer = lv_obj_create(lv_layer_top());
     lv_obj_remove_style_all(overlayLayer);
-    lv_obj_set_pos(overlayLayer, (Stm32EmuWindow::WIN_W - 320) / 2, 20);
+    if (pc_platform_options().lcdOnly)
+        lv_obj_set_pos(overlayLayer, 0, 0);
+    else
+        lv_obj_set_pos(overlayLayer, (Stm32EmuWindow::WIN_W - 320) / 2, 20);
     lv_obj_set_size(overlayLayer, 320, 240);
     lv_obj_remove_flag(overlayLayer, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
     crosspad_gui::setOverlayParent(overlayLayer);
@@ -370,6 +358,9 @@ void crosspad_app_init()
     // Initialize STM32 message handler
     stm32Handler.init(crosspad::getPadManager(), status);
 
+    // MIDI traffic → remote subscribers (no-op until someone subscribes)
+    midi.setMonitor(remote::publish_midi);
+
     // Auto-connect MIDI from saved preferences or fall back to "CrossPad" keyword
     {
         int outPort = findMidiPortByName(s_devicePrefs.midiOut, true);
@@ -393,6 +384,7 @@ void crosspad_app_init()
         uint8_t padIdx = pm.getPadForMidiNote(note);
         if (padIdx < 16) {
             pm.handlePadPress(padIdx, velocity);
+            remote::notify(remote::TOPIC_PAD);
         } else {
             pm.handleMidiNoteOn(channel, note, velocity);
         }
@@ -403,6 +395,7 @@ void crosspad_app_init()
         uint8_t padIdx = pm.getPadForMidiNote(note);
         if (padIdx < 16) {
             pm.handlePadRelease(padIdx);
+            remote::notify(remote::TOPIC_PAD);
         } else {
             pm.handleMidiNoteOff(channel, note);
         }
@@ -442,6 +435,11 @@ void crosspad_app_init()
         jp.setConnected(EmuJackPanel::MIDI_OUT, midi.isOutputOpen());
         jp.setConnected(EmuJackPanel::MIDI_IN, midi.isInputOpen());
     }, 3000, nullptr);
+
+    // Bulk SysEx retransmit timers
+    lv_timer_create([](lv_timer_t*) {
+        midi.update(lv_tick_get());
+    }, 20, nullptr);
 #endif
 
 #ifdef USE_AUDIO
@@ -512,12 +510,15 @@ void crosspad_app_init()
     // Register mixer pad logic globally (always available)
     s_mixerPadLogic = std::make_shared<MixerPadLogic>(s_mixerEngine);
     s_mixerPadLogic->setOnStateChanged([]() {
-        // Save mixer state on every pad-driven change
-        s_mixerEngine.saveState(getMixerStatePath());
+        // Save mixer state on every pad-driven change (debounced, off-thread)
+        pc_platform_save_mixer_state();
     });
     crosspad::getPadManager().registerPadLogic("Mixer", s_mixerPadLogic);
     crosspad::getPadManager().setActivePadLogic("Mixer");
 
+    // Tapped output → remote shared memory (no-op until a client enables it)
+    s_mixerEngine.setTapSink(remote::publish_audio);
+
     // Start the mixer engine (replaces the old default synth-only audio thread)
     s_mixerEngine.start();
 
@@ -663,6 +664,14 @@ void crosspad_app_init()
             }
             jp.setDeviceList(EmuJackPanel::USB, usbPorts, currentIdx);
 
+            // Binary frames share the port with the log text
+            s_telemetry.on<telemetry::PerfCounters>([](const telemetry::PerfCounters& m, uint64_t ts) {
+                s_devicePerf.store(m, ts);
+            });
+            pcUart.setOnFrameReceived([](uint8_t type, const uint8_t* payload, size_t len, uint64_t ts) {
+                s_telemetry.dispatch(type, payload, len, ts);
+            });
+
             // Auto-connect: saved port first, then VID/PID detection
             bool connected = false;
             auto baud = static_cast<PcUart::BaudRate>(s_devicePrefs.uartBaud);
@@ -838,55 +847,55 @@ void crosspad_app_init()
     }
 
 #ifdef USE_AUDIO
-    // ── VU meter timer: feed levels to jack panel bars + main VU meter ──
-    static crosspad::PeakMeter s_vuMeter(238);    // main VU (slower decay)
-    static crosspad::PeakMeter s_jpOut1(230);      // jack panel OUT1
-    static crosspad::PeakMeter s_jpOut2(230);      // jack panel OUT2
-    static crosspad::PeakMeter s_jpIn1(230);       // jack panel IN1
-    static crosspad::PeakMeter s_jpIn2(230);       // jack panel IN2
-
-    lv_timer_create([](lv_timer_t*) {
+    // ── Jack panel VU meters: polled by the shared meter timer ──
+    {
         auto& jp = stm32Emu.getJackPanel();
+        auto outLevel = [](void* ctx, int16_t& l, int16_t& r) {
+            static_cast<PcAudioOutput*>(ctx)->getOutputLevel(l, r);
+        };
+        auto inLevel = [](void* ctx, int16_t& l, int16_t& r) {
+            auto* in = static_cast<PcAudioInput*>(ctx);
+            if (in->isOpen()) in->getInputLevel(l, r);
+            else l = r = 0;
+        };
+        jp.setLevelSource(EmuJackPanel::AUDIO_OUT1, outLevel, &pcAudio);
+        jp.setLevelSource(EmuJackPanel::AUDIO_OUT2, outLevel, &pcAudio2);
+        jp.setLevelSource(EmuJackPanel::AUDIO_IN1,  inLevel,  &pcAudioIn1);
+        jp.setLevelSource(EmuJackPanel::AUDIO_IN2,  inLevel,  &pcAudioIn2);
+    }
 
-        // OUT1 levels → main VU meter + jack panel
-        {
-            int16_t rawL, rawR;
-            pcAudio.getOutputLevel(rawL, rawR);
-            s_vuMeter.update(rawL, rawR);
-            crosspad_gui::vu_set_levels(s_vuMeter.left(), s_vuMeter.right());
-            s_jpOut1.update(rawL, rawR);
-            jp.setLevel(EmuJackPanel::AUDIO_OUT1, s_jpOut1.left(), s_jpOut1.right());
-        }
+    // ── Main VU meter + remote level feed (on the shared meter tick) ──
+    static crosspad::PeakMeter s_vuMeter(238);    // main VU (slower decay)
 
-        // OUT2 levels → jack panel
-        {
-            int16_t rawL, rawR;
-            pcAudio2.getOutputLevel(rawL, rawR);
-            s_jpOut2.update(rawL, rawR);
-            jp.setLevel(EmuJackPanel::AUDIO_OUT2, s_jpOut2.left(), s_jpOut2.right());
-        }
+    vu_meter::add_tick_hook([](void*) {
+        static int32_t s_shownL = -1, s_shownR = -1;
 
-        // IN1 levels → jack panel
-        if (pcAudioIn1.isOpen()) {
-            int16_t rawL, rawR;
-            pcAudioIn1.getInputLevel(rawL, rawR);
-            s_jpIn1.update(rawL, rawR);
-            jp.setLevel(EmuJackPanel::AUDIO_IN1, s_jpIn1.left(), s_jpIn1.right());
-        }
+        int16_t rawL, rawR;
+        pcAudio2.getOutputLevel(rawL, rawR);
+        remote::publish_levels(1, rawL, rawR);
 
-        // IN2 levels → jack panel
-        if (pcAudioIn2.isOpen()) {
-            int16_t rawL, rawR;
-            pcAudioIn2.getInputLevel(rawL, rawR);
-            s_jpIn2.update(rawL, rawR);
-            jp.setLevel(EmuJackPanel::AUDIO_IN2, s_jpIn2.left(), s_jpIn2.right());
-        }
-    }, 16, nullptr);
+        pcAudio.getOutputLevel(rawL, rawR);
+        remote::publish_levels(0, rawL, rawR);
+        s_vuMeter.update(rawL, rawR);
+
+        // Only touch the main VU widget when the decayed level moved
+        if (s_vuMeter.left() == s_shownL && s_vuMeter.right() == s_shownR) return;
+        s_shownL = s_vuMeter.left();
+        s_shownR = s_vuMeter.right();
+        crosspad_gui::vu_set_levels(s_vuMeter.left(), s_vuMeter.right());
+    }, nullptr);
 #endif
 
     // ── USB/UART periodic reconnect (5s) — auto-detect CrossPad by VID/PID ──
     lv_timer_create([](lv_timer_t*) {
         if (pcUart.isOpen()) return;          // already connected
+        if (!pcUart.getPortName().empty()) {
+            // Reader lost the port (unplugged): release it before retrying
+            printf("[USB] Lost %s\n", pcUart.getPortName().c_str());
+            pcUart.close();
+            stm32Emu.getJackPanel().setConnected(EmuJackPanel::USB, false);
+            crosspad::removePlatformCapability(crosspad::Capability::Usb);
+        }
         if (!pc_platform_get_usb_autoconnect()) return;
 
         auto crosspadPorts = PcUart::findPortsByVidPid(
@@ -919,6 +928,7 @@ void crosspad_app_go_home()
 void crosspad_app_update_pad_icon()
 {
     std::string active = crosspad::getPadManager().getActivePadLogic();
+    remote::notify(remote::TOPIC_APP);
 
     if (active == "Mixer") {
         crosspad_gui::statusbar_add_icon("pad_logic", LV_SYMBOL_SHUFFLE,
@@ -955,13 +965,20 @@ AudioMixerEngine& getMixerEngine()
 
 void pc_platform_save_mixer_state()
 {
-    s_mixerEngine.saveState(getMixerStatePath());
+    const bool binary = pc_platform_options().binaryState;
+    PcPersistence::getInstance().schedule(getMixerStatePath() + StateSnapshot::extension(binary),
+        [state = s_mixerEngine.captureState(), binary] {
+            return binary ? AudioMixerEngine::stateToSnapshot(state) : AudioMixerEngine::stateToJson(state);
+        });
 }
 #else
 PcAudioOutput* pc_platform_get_audio_output(int /*index*/) { return nullptr; }
 void pc_platform_save_mixer_state() {}
 #endif
 
-/* ── UART accessor ────────────────────────────────────────────────────── */
+/* ── UART / emulator accessors ────────────────────────────────────────── */
 
 PcUart& pc_platform_get_uart() { return pcUart; }
+telemetry::Dispatcher& pc_platform_get_telemetry() { return s_telemetry; }
+const telemetry::Latest<telemetry::PerfCounters>& pc_platform_get_device_perf() { return s_devicePerf; }
+Stm32EmuWindow& crosspad_app_get_emu_window() { return stm32Emu; }
@@ -10,6 +10,13 @@
  */
 
 class PcUart;
+class Stm32EmuWindow;
+
+namespace telemetry {
+class Dispatcher;
+struct PerfCounters;
+template <typename Msg> class Latest;
+}
 
 void crosspad_app_init();
 
@@ -21,3 +28,12 @@ void crosspad_app_update_pad_icon();
 
 /// Access the global PcUart instance (virtual USB/UART)
 PcUart& pc_platform_get_uart();
+
+/// Binary telemetry frames received on that port are routed through this
+telemetry::Dispatcher& pc_platform_get_telemetry();
+
+/// Last PerfCounters message the device sent
+const telemetry::Latest<telemetry::PerfCounters>& pc_platform_get_device_perf();
+
+/// Access the emulated device body (encoder, keyboard capture, pads)
+Stm32EmuWindow& crosspad_app_get_emu_window();
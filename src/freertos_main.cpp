@@ -20,9 +20,44 @@
 #include "stm32_emu/Stm32EmuWindow.hpp"
 #include "crosspad_app.hpp"
 #include "remote/RemoteControl.hpp"
+#include "remote/RemoteEvents.hpp"
+#include "pc_stubs/pc_platform.h"
 
+#include <atomic>
 #include <cstdio>
 
+/* ── LVGL task wake-up ───────────────────────────────────────────────── */
+
+// remote::wake() runs on host threads (remote server, RtMidi, audio, stream
+// workers) that must not call FreeRTOS APIs. It only raises a flag; the tick
+// hook turns it into a task notification, so a wake-up lands within a tick.
+static TaskHandle_t      s_lvglTask = nullptr;
+static std::atomic<bool> s_wakePending{false};
+
+static void request_lvgl_wake()
+{
+    s_wakePending.store(true, std::memory_order_release);
+}
+
+// SDL calls this for every event it queues: while LVGL's SDL timer pumps
+// the OS queue, and on whichever thread SDL_PushEvent()s (audio hot-plug,
+// user events). Never filters anything out.
+static int sdl_wake_watch(void* userdata, SDL_Event* event)
+{
+    (void)userdata;
+    (void)event;
+    request_lvgl_wake();
+    return 1;
+}
+
+// Longest single block in the LVGL loop. Keeps pdMS_TO_TICKS() (ms times
+// the tick rate) from overflowing for LVGL timers due far in the future.
+static constexpr uint32_t MAX_BLOCK_MS = 60 * 1000;
+
+#ifdef _MSC_VER
+static HANDLE s_tickEvent = nullptr;   // set by the tick hook, idle hook waits on it
+#endif
+
 /* ── FreeRTOS hooks (required by kernel config) ───────────────────────── */
 
 extern "C" {
@@ -33,10 +68,13 @@ void vApplicationMallocFailedHook(void)
     for (;;);
 }
 
+// Hand the host CPU back until the next tick while every task is blocked.
+// POSIX port: the tick is a SIGALRM sent to the running task's thread,
+// which pause() returns from. Win32 port: the tick hook sets an event.
 #ifdef _MSC_VER
-void vApplicationIdleHook(void) { Sleep(1); }
+void vApplicationIdleHook(void) { WaitForSingleObject(s_tickEvent, INFINITE); }
 #else
-void vApplicationIdleHook(void) { usleep(1000); }
+void vApplicationIdleHook(void) { pause(); }
 #endif
 
 void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
@@ -45,7 +83,14 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
     for (;;);
 }
 
-void vApplicationTickHook(void) {}
+void vApplicationTickHook(void)
+{
+    if (s_lvglTask && s_wakePending.exchange(false, std::memory_order_acq_rel))
+        vTaskNotifyGiveFromISR(s_lvglTask, NULL);
+#ifdef _MSC_VER
+    SetEvent(s_tickEvent);
+#endif
+}
 
 } // extern "C"
 
@@ -56,16 +101,39 @@ static void lvgl_task(void* pvParameters)
     (void)pvParameters;
     printf("Starting LVGL task\n");
     lv_init();
-    lv_display_t* disp = sdl_hal_init(Stm32EmuWindow::WIN_W, Stm32EmuWindow::WIN_H);
+
+    const PcRunOptions& opts = pc_platform_options();
+    lv_display_t* disp;
+    if (!opts.headless) {
+        disp = sdl_hal_init(Stm32EmuWindow::WIN_W, Stm32EmuWindow::WIN_H);
+    } else if (opts.lcdOnly) {
+        disp = headless_hal_init(Stm32EmuWindow::LCD_W, Stm32EmuWindow::LCD_H);
+    } else {
+        disp = headless_hal_init(Stm32EmuWindow::WIN_W, Stm32EmuWindow::WIN_H);
+    }
+
+    // LVGL ticks follow the simulation clock (virtual time for tests)
+    lv_tick_set_cb(pc_time_ms);
     crosspad_app_init();
 
-    // Start remote control server (TCP localhost:19840) for MCP integration
+    // Start remote control server (TCP localhost:19840 or --port) for MCP integration
     remote::start(disp);
+    remote::set_wake_hook(request_lvgl_wake);
+    if (!opts.headless) SDL_AddEventWatch(sdl_wake_watch, nullptr);
 
     while (true) {
-        lv_timer_handler();
+        // Commands first, so their effects render in the same turn
         remote::process_pending();
-        vTaskDelay(pdMS_TO_TICKS(5));
+        uint32_t idle = lv_timer_handler();
+
+        // Sleep until the next LVGL timer or remote deadline, or until woken
+        // by a command, a change notification or a worker (no std::min here:
+        // Windows.h defines min/max macros).
+        uint32_t due = remote::next_due_ms();
+        if (idle < due) due = idle;
+        if (due == 0) due = 1;
+        if (due > MAX_BLOCK_MS && due != LV_NO_TIMER_READY) due = MAX_BLOCK_MS;
+        ulTaskNotifyTake(pdTRUE, due == LV_NO_TIMER_READY ? portMAX_DELAY : pdMS_TO_TICKS(due));
     }
 }
 
@@ -73,10 +141,13 @@ static void lvgl_task(void* pvParameters)
 
 int main(int argc, char** argv)
 {
-    (void)argc;
-    (void)argv;
+    pc_platform_parse_args(argc, argv);
+
+#ifdef _MSC_VER
+    s_tickEvent = CreateEvent(NULL, FALSE, FALSE, NULL);   // auto-reset
+#endif
 
-    if (xTaskCreate(lvgl_task, "LVGL", 8192, NULL, 1, NULL) != pdPASS) {
+    if (xTaskCreate(lvgl_task, "LVGL", 8192, NULL, 1, &s_lvglTask) != pdPASS) {
         printf("Error creating LVGL task\n");
     }
 
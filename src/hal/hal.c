@@ -32,3 +32,159 @@ lv_display_t * sdl_hal_init(int32_t w, int32_t h)
 
   return disp;
 }
+
+/**********************
+ *   HEADLESS DISPLAY
+ **********************/
+
+#define HEADLESS_QUEUE_LEN 32
+
+typedef struct {
+  int32_t x;
+  int32_t y;
+  bool pressed;
+} headless_ptr_evt_t;
+
+typedef struct {
+  uint32_t key;
+  bool pressed;
+} headless_key_evt_t;
+
+static bool s_headless = false;
+
+static lv_indev_t * s_ptr_indev;
+static headless_ptr_evt_t s_ptr_queue[HEADLESS_QUEUE_LEN];
+static uint32_t s_ptr_head, s_ptr_count;
+static headless_ptr_evt_t s_ptr_state;
+
+static lv_indev_t * s_key_indev;
+static headless_key_evt_t s_key_queue[HEADLESS_QUEUE_LEN];
+static uint32_t s_key_head, s_key_count;
+static headless_key_evt_t s_key_state;
+
+static lv_indev_t * s_enc_indev;
+static int32_t s_enc_diff;
+static bool s_enc_pressed;
+
+static void headless_flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+  /* Direct mode into our own buffer: nothing to copy, nothing to present */
+  LV_UNUSED(area);
+  LV_UNUSED(px_map);
+  lv_display_flush_ready(disp);
+}
+
+static void headless_pointer_read(lv_indev_t * indev, lv_indev_data_t * data)
+{
+  LV_UNUSED(indev);
+  if(s_ptr_count > 0) {
+    s_ptr_state = s_ptr_queue[s_ptr_head];
+    s_ptr_head = (s_ptr_head + 1) % HEADLESS_QUEUE_LEN;
+    s_ptr_count--;
+  }
+  data->point.x = s_ptr_state.x;
+  data->point.y = s_ptr_state.y;
+  data->state = s_ptr_state.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  data->continue_reading = s_ptr_count > 0;
+}
+
+static void headless_keypad_read(lv_indev_t * indev, lv_indev_data_t * data)
+{
+  LV_UNUSED(indev);
+  if(s_key_count > 0) {
+    s_key_state = s_key_queue[s_key_head];
+    s_key_head = (s_key_head + 1) % HEADLESS_QUEUE_LEN;
+    s_key_count--;
+  }
+  data->key = s_key_state.key;
+  data->state = s_key_state.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  data->continue_reading = s_key_count > 0;
+}
+
+static void headless_encoder_read(lv_indev_t * indev, lv_indev_data_t * data)
+{
+  LV_UNUSED(indev);
+  data->enc_diff = (int16_t)s_enc_diff;
+  data->state = s_enc_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  s_enc_diff = 0;
+}
+
+lv_display_t * headless_hal_init(int32_t w, int32_t h)
+{
+  lv_group_set_default(lv_group_create());
+
+  lv_display_t * disp = lv_display_create(w, h);
+  lv_display_set_color_format(disp, LV_COLOR_FORMAT_ARGB8888);
+
+  /* One full-screen buffer in direct mode: it always holds the whole frame,
+   * exactly like the SDL driver, so screenshots and streams read it as is. */
+  lv_draw_buf_t * buf = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_ARGB8888, LV_STRIDE_AUTO);
+  lv_display_set_draw_buffers(disp, buf, NULL);
+  lv_display_set_render_mode(disp, LV_DISPLAY_RENDER_MODE_DIRECT);
+  lv_display_set_flush_cb(disp, headless_flush_cb);
+  lv_display_set_default(disp);
+
+  s_ptr_indev = lv_indev_create();
+  lv_indev_set_type(s_ptr_indev, LV_INDEV_TYPE_POINTER);
+  lv_indev_set_read_cb(s_ptr_indev, headless_pointer_read);
+  lv_indev_set_display(s_ptr_indev, disp);
+  lv_indev_set_group(s_ptr_indev, lv_group_get_default());
+
+  s_enc_indev = lv_indev_create();
+  lv_indev_set_type(s_enc_indev, LV_INDEV_TYPE_ENCODER);
+  lv_indev_set_read_cb(s_enc_indev, headless_encoder_read);
+  lv_indev_set_display(s_enc_indev, disp);
+  lv_indev_set_group(s_enc_indev, lv_group_get_default());
+
+  s_key_indev = lv_indev_create();
+  lv_indev_set_type(s_key_indev, LV_INDEV_TYPE_KEYPAD);
+  lv_indev_set_read_cb(s_key_indev, headless_keypad_read);
+  lv_indev_set_display(s_key_indev, disp);
+  lv_indev_set_group(s_key_indev, lv_group_get_default());
+
+  s_headless = true;
+  LV_LOG_USER("Headless display %dx%d", (int)w, (int)h);
+  return disp;
+}
+
+bool hal_is_headless(void)
+{
+  return s_headless;
+}
+
+void headless_pointer_input(int32_t x, int32_t y, bool pressed)
+{
+  if(!s_ptr_indev) return;
+  if(s_ptr_count == HEADLESS_QUEUE_LEN) lv_indev_read(s_ptr_indev);
+  headless_ptr_evt_t * e = &s_ptr_queue[(s_ptr_head + s_ptr_count) % HEADLESS_QUEUE_LEN];
+  e->x = x;
+  e->y = y;
+  e->pressed = pressed;
+  s_ptr_count++;
+  lv_indev_read(s_ptr_indev);
+}
+
+void headless_key_input(uint32_t key, bool pressed)
+{
+  if(!s_key_indev) return;
+  if(s_key_count == HEADLESS_QUEUE_LEN) lv_indev_read(s_key_indev);
+  headless_key_evt_t * e = &s_key_queue[(s_key_head + s_key_count) % HEADLESS_QUEUE_LEN];
+  e->key = key;
+  e->pressed = pressed;
+  s_key_count++;
+  lv_indev_read(s_key_indev);
+}
+
+void headless_encoder_rotate(int32_t diff)
+{
+  if(!s_enc_indev) return;
+  s_enc_diff += diff;
+  lv_indev_read(s_enc_indev);
+}
+
+void headless_encoder_button(bool pressed)
+{
+  if(!s_enc_indev) return;
+  s_enc_pressed = pressed;
+  lv_indev_read(s_enc_indev);
+}
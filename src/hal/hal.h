@@ -7,6 +7,7 @@
 #define LV_VSCODE_HAL_H
 
 #include "lvgl/lvgl.h"
+#include <stdbool.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -33,6 +34,28 @@ extern "C" {
  */
 lv_display_t * sdl_hal_init(int32_t w, int32_t h);
 
+/**
+ * Headless HAL: an LVGL display backed by an in-memory ARGB8888
+ * framebuffer (direct render mode, no SDL window) plus virtual pointer,
+ * keypad and encoder input devices fed by the headless_* functions below.
+ */
+lv_display_t * headless_hal_init(int32_t w, int32_t h);
+
+/** true after headless_hal_init() */
+bool hal_is_headless(void);
+
+/** Queue a pointer state (display coordinates) and process it immediately. */
+void headless_pointer_input(int32_t x, int32_t y, bool pressed);
+
+/** Queue a key press/release (LV_KEY_* or a character) and process it. */
+void headless_key_input(uint32_t key, bool pressed);
+
+/** Rotate the virtual encoder indev by @p diff steps and process it. */
+void headless_encoder_rotate(int32_t diff);
+
+/** Press/release the virtual encoder indev button and process it. */
+void headless_encoder_button(bool pressed);
+
 /**********************
  *      MACROS
  **********************/
@@ -13,7 +13,10 @@
 
 // ── Construction / Destruction ───────────────────────────────────────────
 
-PcMidi::PcMidi() = default;
+PcMidi::PcMidi()
+    : bulk_([this](const uint8_t* data, size_t size) { sendSysEx(data, size); })
+{
+}
 
 PcMidi::~PcMidi()
 {
@@ -246,6 +249,7 @@ void PcMidi::sendNoteOn(uint8_t note, uint8_t velocity, uint8_t channel)
     std::lock_guard<std::mutex> lock(outMutex_);
     try {
         midiOut_->sendMessage(&msg);
+        if (monitorCb_) monitorCb_(true, msg.data(), msg.size());
         printf("[MIDI OUT] NoteOn  ch=%u note=%u vel=%u\n",
                (channel & 0x0F) + 1, note, velocity);
     } catch (RtMidiError& e) {
@@ -267,6 +271,7 @@ void PcMidi::sendNoteOff(uint8_t note, uint8_t velocity, uint8_t channel)
     std::lock_guard<std::mutex> lock(outMutex_);
     try {
         midiOut_->sendMessage(&msg);
+        if (monitorCb_) monitorCb_(true, msg.data(), msg.size());
         printf("[MIDI OUT] NoteOff ch=%u note=%u vel=%u\n",
                (channel & 0x0F) + 1, note, velocity);
     } catch (RtMidiError& e) {
@@ -288,6 +293,7 @@ void PcMidi::sendControlChange(uint8_t cc, uint8_t value, uint8_t channel)
     std::lock_guard<std::mutex> lock(outMutex_);
     try {
         midiOut_->sendMessage(&msg);
+        if (monitorCb_) monitorCb_(true, msg.data(), msg.size());
         printf("[MIDI OUT] CC     ch=%u cc=%u val=%u\n",
                (channel & 0x0F) + 1, cc, value);
     } catch (RtMidiError& e) {
@@ -296,6 +302,20 @@ void PcMidi::sendControlChange(uint8_t cc, uint8_t value, uint8_t channel)
     }
 }
 
+void PcMidi::sendSysEx(const uint8_t* data, size_t size)
+{
+    if (!outputOpen_ || !midiOut_ || size < 2) return;
+
+    std::lock_guard<std::mutex> lock(outMutex_);
+    try {
+        midiOut_->sendMessage(data, size);
+        if (monitorCb_) monitorCb_(true, data, size);
+    } catch (RtMidiError& e) {
+        printf("[MIDI OUT] SysEx send error: %s\n", e.what());
+        outputOpen_ = false;  // trigger reconnect timer
+    }
+}
+
 // ── crosspad::IMidiOutput overrides ──────────────────────────────────────
 
 void PcMidi::sendNoteOn(uint8_t note, uint8_t channel)
@@ -325,6 +345,11 @@ void PcMidi::setHandleControlChange(ControlChangeCallback cb)
     ccCb_ = std::move(cb);
 }
 
+void PcMidi::setMonitor(MonitorCallback cb)
+{
+    monitorCb_ = std::move(cb);
+}
+
 void PcMidi::setHandleSystemExclusive(SysExCallback cb)
 {
     sysExCb_ = std::move(cb);
@@ -378,6 +403,13 @@ bool PcMidi::isKeywordConnected() const
     return autoConnectFound_ && (outputOpen_ || inputOpen_);
 }
 
+// ── Bulk SysEx transfer ──────────────────────────────────────────────────
+
+void PcMidi::update(uint32_t nowMs)
+{
+    bulk_.poll(nowMs);
+}
+
 // ── RtMidi callback (static → instance dispatch) ─────────────────────────
 
 void PcMidi::rtMidiCallback(double timestamp, std::vector<unsigned char>* message, void* userData)
@@ -391,12 +423,16 @@ void PcMidi::handleMidiMessage(double timestamp, std::vector<unsigned char>& mes
 {
     (void)timestamp;
 
+    if (monitorCb_) monitorCb_(false, message.data(), message.size());
+
     uint8_t status  = message[0];
     uint8_t type    = status & 0xF0;
     uint8_t channel = status & 0x0F;
 
     // SysEx (F0 ... F7)
     if (status == 0xF0) {
+        if (bulk_.handleSysEx(message.data(), message.size()))
+            return;
         if (sysExCb_) {
             sysExCb_(message.data(), static_cast<unsigned>(message.size()));
         }
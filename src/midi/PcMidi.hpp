@@ -14,6 +14,8 @@
 #include <crosspad/midi/IMidiOutput.hpp>
 #include <RtMidi.h>
 
+#include "SysExTransfer.hpp"
+
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -28,6 +30,7 @@ public:
     using NoteOffCallback       = std::function<void(uint8_t channel, uint8_t note, uint8_t velocity)>;
     using ControlChangeCallback = std::function<void(uint8_t channel, uint8_t cc, uint8_t value)>;
     using SysExCallback         = std::function<void(uint8_t* data, unsigned size)>;
+    using MonitorCallback       = std::function<void(bool out, const uint8_t* data, size_t size)>;
 
     PcMidi();
     ~PcMidi();
@@ -69,6 +72,9 @@ public:
     void sendNoteOff(uint8_t note, uint8_t velocity, uint8_t channel);
     void sendControlChange(uint8_t cc, uint8_t value, uint8_t channel);
 
+    /// Send a complete SysEx message (must start with F0 and end with F7).
+    void sendSysEx(const uint8_t* data, size_t size);
+
     // ── crosspad::IMidiOutput overrides ──────────────────────────────────
 
     void sendNoteOn(uint8_t note, uint8_t channel) override;   // velocity = 127
@@ -81,6 +87,10 @@ public:
     void setHandleControlChange(ControlChangeCallback cb);
     void setHandleSystemExclusive(SysExCallback cb);
 
+    /// Observe every message sent or received (RtMidi thread for input).
+    /// Set before begin(); keep it cheap and non-blocking.
+    void setMonitor(MonitorCallback cb);
+
     // ── Port management ──────────────────────────────────────────────────
 
     unsigned int getOutputPortCount() const;
@@ -97,6 +107,20 @@ public:
     /// Returns true if the last beginAutoConnect() found a port matching the keyword.
     bool isKeywordConnected() const;
 
+    // ── Bulk SysEx transfer ──────────────────────────────────────────────
+
+    /**
+     * @brief Chunked SysEx transfer engine bound to this port pair.
+     *
+     * Incoming transfer packets are consumed before the regular SysEx
+     * handler sees them. Reception requires a SysEx handler to be set
+     * (RtMidi drops SysEx otherwise) and a buffer via setReceiveBuffer().
+     */
+    SysExTransfer& bulkTransfer() { return bulk_; }
+
+    /// Drive bulk transfer retransmit timers. Call periodically.
+    void update(uint32_t nowMs);
+
 private:
     std::unique_ptr<RtMidiOut> midiOut_;
     std::unique_ptr<RtMidiIn>  midiIn_;
@@ -116,10 +140,13 @@ private:
     NoteOffCallback       noteOffCb_;
     ControlChangeCallback ccCb_;
     SysExCallback         sysExCb_;
+    MonitorCallback       monitorCb_;
 
     // Thread safety for output
     std::mutex outMutex_;
 
+    SysExTransfer bulk_;
+
     // RtMidi static callback (dispatches to instance)
     static void rtMidiCallback(double timestamp, std::vector<unsigned char>* message, void* userData);
     void handleMidiMessage(double timestamp, std::vector<unsigned char>& message);
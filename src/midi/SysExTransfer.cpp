@@ -0,0 +1,514 @@
+/**
+ * @file SysExTransfer.cpp
+ * @brief Chunked SysEx bulk transfer — packetizer, sliding window, reassembly
+ */
+
+#include "SysExTransfer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr size_t HEADER_LEN = 6;    // F0 7D 43 50 cmd id
+constexpr size_t SEQ_LEN    = 3;    // 21-bit sequence number
+constexpr size_t CRC_LEN    = 3;    // 16-bit CRC in 7-bit groups
+constexpr size_t BEGIN_LEN  = 5 + 2 + 1;
+
+inline void put7(uint8_t* out, uint32_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value & 0x7F);
+        value >>= 7;
+    }
+}
+
+inline uint32_t get7(const uint8_t* in, size_t bytes)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; i++)
+        value |= static_cast<uint32_t>(in[i] & 0x7F) << (7 * i);
+    return value;
+}
+
+struct Crc16Table {
+    uint16_t t[256];
+    Crc16Table()
+    {
+        for (int i = 0; i < 256; i++) {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (int b = 0; b < 8; b++)
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                     : static_cast<uint16_t>(crc << 1);
+            t[i] = crc;
+        }
+    }
+};
+
+const Crc16Table s_crcTable;
+
+} // namespace
+
+// ── Codec helpers ────────────────────────────────────────────────────────
+
+size_t SysExTransfer::encodedSize(size_t rawSize)
+{
+    return rawSize + (rawSize + 6) / 7;
+}
+
+size_t SysExTransfer::encode7(const uint8_t* in, size_t len, uint8_t* out)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 7) {
+        size_t group = std::min<size_t>(7, len - i);
+        uint8_t msb = 0;
+        for (size_t j = 0; j < group; j++) {
+            msb |= static_cast<uint8_t>((in[i + j] >> 7) << j);
+            out[o + 1 + j] = in[i + j] & 0x7F;
+        }
+        out[o] = msb;
+        o += group + 1;
+    }
+    return o;
+}
+
+size_t SysExTransfer::decode7(const uint8_t* in, size_t len, uint8_t* out)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 8) {
+        size_t group = std::min<size_t>(8, len - i);
+        if (group < 2) break;
+        uint8_t msb = in[i];
+        for (size_t j = 0; j + 1 < group; j++)
+            out[o++] = static_cast<uint8_t>((in[i + 1 + j] & 0x7F) | (((msb >> j) & 1) << 7));
+    }
+    return o;
+}
+
+uint16_t SysExTransfer::crc16(const uint8_t* data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+        crc = static_cast<uint16_t>((crc << 8) ^ s_crcTable.t[((crc >> 8) ^ data[i]) & 0xFF]);
+    return crc;
+}
+
+// ── Construction ─────────────────────────────────────────────────────────
+
+SysExTransfer::SysExTransfer(SendFn send)
+    : SysExTransfer(std::move(send), Config{})
+{
+}
+
+SysExTransfer::SysExTransfer(SendFn send, const Config& config)
+    : send_(std::move(send)), cfg_(config)
+{
+    cfg_.chunkSize = std::max<uint16_t>(1, std::min<uint16_t>(cfg_.chunkSize, 0x3FFF));
+    cfg_.window    = std::max<uint8_t>(1, std::min<uint8_t>(cfg_.window, 0x7F));
+    txBuf_.resize(HEADER_LEN + SEQ_LEN + encodedSize(cfg_.chunkSize) + CRC_LEN + 1);
+}
+
+// ── Sending ──────────────────────────────────────────────────────────────
+
+bool SysExTransfer::send(const uint8_t* data, size_t size, SendDoneCallback done)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tx_.active || !data || size == 0) return false;
+
+    uint32_t numChunks = static_cast<uint32_t>((size + cfg_.chunkSize - 1) / cfg_.chunkSize);
+    if (numChunks > 0x1FFFFF || size > 0xFFFFFFFFull) return false;
+
+    tx_ = TxState{};
+    tx_.active    = true;
+    tx_.id        = nextTxId_;
+    tx_.data      = data;
+    tx_.size      = size;
+    tx_.numChunks = numChunks;
+    tx_.lastProgressMs = nowMs_;
+    tx_.done      = std::move(done);
+    nextTxId_ = (nextTxId_ + 1) & 0x7F;
+
+    sendBegin();
+    return true;
+}
+
+void SysExTransfer::cancelSend()
+{
+    SendDoneCallback done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!tx_.active) return;
+        sendAbort(tx_.id, ABORT_CANCELLED);
+        tx_.active = false;
+        stats_.transfersAborted++;
+        done = std::move(tx_.done);
+    }
+    if (done) done(false);
+}
+
+bool SysExTransfer::isSending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tx_.active;
+}
+
+size_t SysExTransfer::bytesAcked() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::min(tx_.size, static_cast<size_t>(tx_.base) * cfg_.chunkSize);
+}
+
+void SysExTransfer::fillWindow()
+{
+    while (tx_.next < tx_.numChunks && tx_.next < tx_.base + cfg_.window)
+        sendData(tx_.next++);
+}
+
+// ── Receiving ────────────────────────────────────────────────────────────
+
+void SysExTransfer::setReceiveBuffer(uint8_t* buffer, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    rxBuffer_   = buffer;
+    rxCapacity_ = buffer ? capacity : 0;
+    rx_.active    = false;
+    rx_.numChunks = 0;
+}
+
+void SysExTransfer::setOnReceived(ReceiveCallback cb)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    onReceived_ = std::move(cb);
+}
+
+SysExTransfer::Stats SysExTransfer::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// ── Packet output ────────────────────────────────────────────────────────
+
+size_t SysExTransfer::writeHeader(uint8_t cmd, uint8_t id)
+{
+    uint8_t* p = txBuf_.data();
+    p[0] = 0xF0;
+    p[1] = MANUFACTURER_ID;
+    p[2] = SIG_0;
+    p[3] = SIG_1;
+    p[4] = cmd;
+    p[5] = id & 0x7F;
+    return HEADER_LEN;
+}
+
+void SysExTransfer::emit(size_t len)
+{
+    txBuf_[len++] = 0xF7;
+    if (send_) send_(txBuf_.data(), len);
+}
+
+void SysExTransfer::sendBegin()
+{
+    size_t o = writeHeader(CMD_BEGIN, tx_.id);
+    uint8_t* p = txBuf_.data();
+    put7(p + o, static_cast<uint32_t>(tx_.size), 5);   // 35 bits, upper bits zero
+    o += 5;
+    put7(p + o, cfg_.chunkSize, 2);
+    o += 2;
+    p[o++] = cfg_.window;
+    emit(o);
+}
+
+void SysExTransfer::sendData(uint32_t seq)
+{
+    size_t offset = static_cast<size_t>(seq) * cfg_.chunkSize;
+    size_t len    = std::min<size_t>(cfg_.chunkSize, tx_.size - offset);
+    const uint8_t* src = tx_.data + offset;
+
+    size_t o = writeHeader(CMD_DATA, tx_.id);
+    uint8_t* p = txBuf_.data();
+    put7(p + o, seq, SEQ_LEN);
+    o += SEQ_LEN;
+    o += encode7(src, len, p + o);
+    put7(p + o, crc16(src, len), CRC_LEN);
+    o += CRC_LEN;
+    emit(o);
+    stats_.packetsSent++;
+}
+
+void SysExTransfer::sendAck(uint8_t id, uint32_t next)
+{
+    size_t o = writeHeader(CMD_ACK, id);
+    put7(txBuf_.data() + o, next, SEQ_LEN);
+    emit(o + SEQ_LEN);
+}
+
+void SysExTransfer::sendNak(uint8_t id, uint32_t seq)
+{
+    size_t o = writeHeader(CMD_NAK, id);
+    put7(txBuf_.data() + o, seq, SEQ_LEN);
+    emit(o + SEQ_LEN);
+}
+
+void SysExTransfer::sendAbort(uint8_t id, uint8_t reason)
+{
+    size_t o = writeHeader(CMD_ABORT, id);
+    txBuf_[o++] = reason & 0x7F;
+    emit(o);
+}
+
+void SysExTransfer::sendReject(uint8_t id, uint8_t reason)
+{
+    size_t o = writeHeader(CMD_REJECT, id);
+    txBuf_[o++] = reason & 0x7F;
+    emit(o);
+}
+
+// ── Packet input ─────────────────────────────────────────────────────────
+
+bool SysExTransfer::handleSysEx(const uint8_t* data, size_t size)
+{
+    if (!data || size < HEADER_LEN + 1) return false;
+    if (data[0] != 0xF0 || data[1] != MANUFACTURER_ID || data[2] != SIG_0 || data[3] != SIG_1)
+        return false;
+    if (data[size - 1] != 0xF7) return true;   // ours, but truncated — drop
+
+    uint8_t cmd = data[4];
+    uint8_t id  = data[5];
+    const uint8_t* p = data + HEADER_LEN;
+    size_t n = size - HEADER_LEN - 1;
+
+    // Deferred callbacks (run without the lock held)
+    bool rxCompleted = false;
+    bool txFinished  = false;
+    bool txOk        = false;
+    const uint8_t* rxData = nullptr;
+    size_t rxSize = 0;
+    ReceiveCallback  receivedCb;
+    SendDoneCallback doneCb;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (cmd) {
+        case CMD_BEGIN:
+            onBegin(id, p, n);
+            break;
+        case CMD_DATA:
+            onData(id, p, n, rxCompleted);
+            if (rxCompleted) {
+                rxData = rxBuffer_;
+                rxSize = rx_.size;
+                receivedCb = onReceived_;
+            }
+            break;
+        case CMD_ACK:
+            if (n >= SEQ_LEN) {
+                onAck(id, get7(p, SEQ_LEN), txFinished);
+                txOk = txFinished;
+            }
+            break;
+        case CMD_NAK:
+            if (n >= SEQ_LEN) onNak(id, get7(p, SEQ_LEN));
+            break;
+        case CMD_ABORT:
+            if (rx_.active && id == rx_.id) {
+                rx_.active = false;
+                stats_.transfersAborted++;
+            }
+            break;
+        case CMD_REJECT:
+            if (tx_.active && id == tx_.id) {
+                printf("[SysEx] Transfer %u rejected by peer (reason %u)\n", id, n ? p[0] : 0);
+                tx_.active = false;
+                stats_.transfersAborted++;
+                txFinished = true;
+            }
+            break;
+        default:
+            break;
+        }
+        if (txFinished) doneCb = std::move(tx_.done);
+    }
+
+    if (rxCompleted && receivedCb) receivedCb(rxData, rxSize);
+    if (txFinished && doneCb) doneCb(txOk);
+    return true;
+}
+
+void SysExTransfer::onBegin(uint8_t id, const uint8_t* p, size_t n)
+{
+    if (n < BEGIN_LEN) return;
+
+    size_t   size   = get7(p, 5);
+    uint16_t chunk  = static_cast<uint16_t>(get7(p + 5, 2));
+    uint8_t  window = p[7];
+
+    // Retransmitted BEGIN (our ACK got lost) — just re-acknowledge
+    if (rx_.active && id == rx_.id && size == rx_.size && chunk == rx_.chunkSize) {
+        sendAck(id, rx_.next);
+        return;
+    }
+
+    if (!rxBuffer_) {
+        sendReject(id, ABORT_NO_BUFFER);
+        return;
+    }
+    if (size == 0 || chunk == 0 || size > rxCapacity_) {
+        printf("[SysEx] Rejecting transfer %u: %zu bytes (capacity %zu)\n", id, size, rxCapacity_);
+        sendReject(id, ABORT_TOO_LARGE);
+        return;
+    }
+
+    rx_.active    = true;
+    rx_.id        = id;
+    rx_.size      = size;
+    rx_.chunkSize = chunk;
+    rx_.window    = std::max<uint8_t>(1, window);
+    rx_.numChunks = static_cast<uint32_t>((size + chunk - 1) / chunk);
+    rx_.next      = 0;
+    rx_.sinceAck  = 0;
+    rx_.lastNak   = UINT32_MAX;
+    rx_.received.assign(rx_.numChunks, 0);   // reuses capacity across transfers
+
+    sendAck(id, 0);
+}
+
+void SysExTransfer::onData(uint8_t id, const uint8_t* p, size_t n, bool& completed)
+{
+    if (id != rx_.id || n < SEQ_LEN + CRC_LEN) return;
+    if (!rx_.active) {
+        // Final ACK of a finished transfer was lost — repeat it
+        if (rx_.numChunks && rx_.next == rx_.numChunks) {
+            stats_.duplicates++;
+            sendAck(id, rx_.next);
+        }
+        return;
+    }
+
+    uint32_t seq = get7(p, SEQ_LEN);
+    if (seq >= rx_.numChunks) return;
+
+    size_t offset   = static_cast<size_t>(seq) * rx_.chunkSize;
+    size_t expected = std::min<size_t>(rx_.chunkSize, rx_.size - offset);
+    size_t encLen   = n - SEQ_LEN - CRC_LEN;
+    if (encLen != encodedSize(expected)) {
+        stats_.crcErrors++;
+        sendNak(id, seq);
+        return;
+    }
+
+    if (seq < rx_.next || rx_.received[seq]) {
+        // Sender didn't see our ACK — repeat it
+        stats_.duplicates++;
+        sendAck(id, rx_.next);
+        return;
+    }
+    if (seq >= rx_.next + rx_.window) return;   // outside window, sender will resend
+
+    // Decode straight into the reassembly buffer — no staging copy
+    uint8_t* dst = rxBuffer_ + offset;
+    decode7(p + SEQ_LEN, encLen, dst);
+    uint16_t crc = static_cast<uint16_t>(get7(p + SEQ_LEN + encLen, CRC_LEN));
+    if (crc16(dst, expected) != crc) {
+        stats_.crcErrors++;
+        sendNak(id, seq);
+        return;
+    }
+
+    stats_.packetsReceived++;
+    rx_.received[seq] = 1;
+
+    // Gap in front of this packet — ask for the missing one once
+    if (seq > rx_.next && rx_.lastNak != rx_.next) {
+        rx_.lastNak = rx_.next;
+        sendNak(id, rx_.next);
+    }
+
+    uint32_t before = rx_.next;
+    while (rx_.next < rx_.numChunks && rx_.received[rx_.next])
+        rx_.next++;
+    rx_.sinceAck += rx_.next - before;
+
+    if (rx_.next == rx_.numChunks) {
+        sendAck(id, rx_.next);
+        rx_.active = false;
+        stats_.transfersReceived++;
+        completed = true;
+        return;
+    }
+
+    uint32_t ackEvery = std::max<uint32_t>(1, rx_.window / 2);
+    if (rx_.sinceAck >= ackEvery) {
+        rx_.sinceAck = 0;
+        sendAck(id, rx_.next);
+    }
+}
+
+void SysExTransfer::onAck(uint8_t id, uint32_t next, bool& finished)
+{
+    if (!tx_.active || id != tx_.id) return;
+    if (next > tx_.next) return;   // acknowledges something never sent
+
+    if (!tx_.begun) {
+        tx_.begun = true;
+        tx_.lastProgressMs = nowMs_;
+        tx_.retries = 0;
+    }
+    if (next > tx_.base) {
+        tx_.base = next;
+        tx_.lastProgressMs = nowMs_;
+        tx_.retries = 0;
+    }
+
+    if (tx_.base == tx_.numChunks) {
+        tx_.active = false;
+        stats_.transfersSent++;
+        finished = true;
+        return;
+    }
+    fillWindow();
+}
+
+void SysExTransfer::onNak(uint8_t id, uint32_t seq)
+{
+    if (!tx_.active || !tx_.begun || id != tx_.id) return;
+    stats_.naksReceived++;
+    if (seq >= tx_.base && seq < tx_.next) {
+        sendData(seq);
+        stats_.retransmits++;
+    }
+}
+
+// ── Timers ───────────────────────────────────────────────────────────────
+
+void SysExTransfer::poll(uint32_t nowMs)
+{
+    SendDoneCallback done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        nowMs_ = nowMs;
+        if (!tx_.active || nowMs - tx_.lastProgressMs < cfg_.retransmitMs) return;
+
+        if (tx_.retries >= cfg_.maxRetries) {
+            printf("[SysEx] Transfer %u timed out at %u/%u packets\n",
+                   tx_.id, tx_.base, tx_.numChunks);
+            sendAbort(tx_.id, ABORT_TIMEOUT);
+            tx_.active = false;
+            stats_.transfersAborted++;
+            done = std::move(tx_.done);
+        } else {
+            tx_.retries++;
+            tx_.lastProgressMs = nowMs;
+            if (!tx_.begun) {
+                sendBegin();
+            } else {
+                // Go-back-N: resend everything still in flight
+                for (uint32_t seq = tx_.base; seq < tx_.next; seq++) {
+                    sendData(seq);
+                    stats_.retransmits++;
+                }
+            }
+        }
+    }
+    if (done) done(false);
+}
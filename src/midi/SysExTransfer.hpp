@@ -0,0 +1,196 @@
+#pragma once
+
+/**
+ * @file SysExTransfer.hpp
+ * @brief Chunked, flow-controlled SysEx bulk transfer (kit uploads, preset
+ *        dumps, firmware blobs).
+ *
+ * A single large SysEx message overruns the device's receive buffer, so big
+ * payloads are split into short packets:
+ *
+ *   F0 7D 43 50 <cmd> <id> <fields...> F7
+ *
+ *   BEGIN  02  id  size[5]  chunk[2]  window        sender   -> receiver
+ *   DATA   01  id  seq[3]   payload(7-bit)  crc[3]  sender   -> receiver
+ *   ACK    03  id  next[3]                          receiver -> sender
+ *   NAK    04  id  seq[3]                           receiver -> sender
+ *   ABORT  05  id  reason                           sender   -> receiver
+ *   REJECT 06  id  reason                           receiver -> sender
+ *
+ * All multi-byte fields are little-endian groups of 7 bits. DATA payloads use
+ * the usual MIDI 8-to-7 packing (one MSB byte per 7 data bytes) and carry a
+ * CRC-16/CCITT of the decoded bytes.
+ *
+ * The sender keeps at most @c window packets in flight. ACKs are cumulative
+ * ("everything below @c next arrived"); NAKs request a single packet again.
+ * If no progress is made for @c retransmitMs the whole window is resent, up
+ * to @c maxRetries times before the transfer is aborted.
+ *
+ * The receiver decodes each packet straight into a caller-owned buffer at
+ * seq * chunkSize — there is no intermediate reassembly copy and no
+ * per-packet allocation.
+ *
+ * Threading: all entry points are mutex-protected, so handleSysEx() may run
+ * on the RtMidi callback thread while poll() runs on the LVGL thread. The
+ * SendFn is called with the lock held and must not synchronously feed data
+ * back into the same instance (real MIDI ports never do).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class SysExTransfer {
+public:
+    /// Raw SysEx output (complete F0 ... F7 message).
+    using SendFn = std::function<void(const uint8_t* data, size_t size)>;
+
+    /// Outgoing transfer finished (ok = receiver acknowledged every packet).
+    using SendDoneCallback = std::function<void(bool ok)>;
+
+    /// Incoming transfer complete — @p data points into the receive buffer.
+    using ReceiveCallback = std::function<void(const uint8_t* data, size_t size)>;
+
+    struct Config {
+        uint16_t chunkSize    = 256;   ///< Decoded bytes per DATA packet (max 16383)
+        uint8_t  window       = 8;     ///< Max unacknowledged packets in flight
+        uint32_t retransmitMs = 250;   ///< Resend window after this long without progress
+        uint8_t  maxRetries   = 8;     ///< Abort after this many timeouts in a row
+    };
+
+    struct Stats {
+        uint32_t packetsSent     = 0;
+        uint32_t retransmits     = 0;
+        uint32_t naksReceived    = 0;
+        uint32_t packetsReceived = 0;
+        uint32_t crcErrors       = 0;
+        uint32_t duplicates      = 0;
+        uint32_t transfersSent     = 0;
+        uint32_t transfersReceived = 0;
+        uint32_t transfersAborted  = 0;
+    };
+
+    static constexpr uint8_t MANUFACTURER_ID = 0x7D;   // non-commercial
+    static constexpr uint8_t SIG_0 = 0x43;             // 'C'
+    static constexpr uint8_t SIG_1 = 0x50;             // 'P'
+
+    explicit SysExTransfer(SendFn send);
+    SysExTransfer(SendFn send, const Config& config);
+
+    SysExTransfer(const SysExTransfer&) = delete;
+    SysExTransfer& operator=(const SysExTransfer&) = delete;
+
+    // ── Sending ──────────────────────────────────────────────────────────
+
+    /**
+     * @brief Start sending @p size bytes. The data is NOT copied and must
+     *        stay valid until @p done fires.
+     * @return false if a transfer is already in progress or size is 0
+     */
+    bool send(const uint8_t* data, size_t size, SendDoneCallback done = nullptr);
+
+    /// Abort the outgoing transfer (notifies the peer).
+    void cancelSend();
+
+    bool isSending() const;
+
+    /// Number of bytes acknowledged so far by the receiver.
+    size_t bytesAcked() const;
+
+    // ── Receiving ────────────────────────────────────────────────────────
+
+    /**
+     * @brief Provide the preallocated reassembly buffer. Incoming transfers
+     *        larger than @p capacity are rejected with REJECT.
+     */
+    void setReceiveBuffer(uint8_t* buffer, size_t capacity);
+
+    void setOnReceived(ReceiveCallback cb);
+
+    // ── Pumping ──────────────────────────────────────────────────────────
+
+    /**
+     * @brief Feed an incoming SysEx message.
+     * @return true if the message belonged to the transfer protocol
+     *         (caller should not process it further)
+     */
+    bool handleSysEx(const uint8_t* data, size_t size);
+
+    /// Drive retransmit timers. Call periodically (e.g. every 10–50 ms).
+    void poll(uint32_t nowMs);
+
+    Stats getStats() const;
+
+    // ── Codec helpers (exposed for tests) ────────────────────────────────
+
+    static size_t encodedSize(size_t rawSize);
+    static size_t encode7(const uint8_t* in, size_t len, uint8_t* out);
+    static size_t decode7(const uint8_t* in, size_t len, uint8_t* out);
+    static uint16_t crc16(const uint8_t* data, size_t len);
+
+private:
+    enum Cmd : uint8_t { CMD_DATA = 1, CMD_BEGIN = 2, CMD_ACK = 3, CMD_NAK = 4, CMD_ABORT = 5, CMD_REJECT = 6 };
+
+    enum AbortReason : uint8_t { ABORT_CANCELLED = 0, ABORT_TOO_LARGE = 1, ABORT_TIMEOUT = 2, ABORT_NO_BUFFER = 3 };
+
+    struct TxState {
+        bool           active    = false;
+        bool           begun     = false;    // BEGIN acknowledged
+        uint8_t        id        = 0;
+        const uint8_t* data      = nullptr;
+        size_t         size      = 0;
+        uint32_t       numChunks = 0;
+        uint32_t       base      = 0;        // oldest unacknowledged seq
+        uint32_t       next      = 0;        // next never-sent seq
+        uint32_t       lastProgressMs = 0;
+        uint8_t        retries   = 0;
+        SendDoneCallback done;
+    };
+
+    struct RxState {
+        bool     active    = false;
+        uint8_t  id        = 0;
+        size_t   size      = 0;
+        uint16_t chunkSize = 0;
+        uint8_t  window    = 0;
+        uint32_t numChunks = 0;
+        uint32_t next      = 0;              // lowest seq not yet received
+        uint32_t sinceAck  = 0;              // in-order packets since last ACK
+        uint32_t lastNak   = UINT32_MAX;     // avoid NAK storms for the same gap
+        std::vector<uint8_t> received;       // one flag per chunk (capacity reused)
+    };
+
+    // Packet builders (write into txBuf_, then call send_)
+    void sendBegin();
+    void sendData(uint32_t seq);
+    void sendAck(uint8_t id, uint32_t next);
+    void sendNak(uint8_t id, uint32_t seq);
+    void sendAbort(uint8_t id, uint8_t reason);
+    void sendReject(uint8_t id, uint8_t reason);
+    void emit(size_t len);
+    size_t writeHeader(uint8_t cmd, uint8_t id);
+
+    void fillWindow();
+    void onBegin(uint8_t id, const uint8_t* p, size_t n);
+    void onData(uint8_t id, const uint8_t* p, size_t n, bool& completed);
+    void onAck(uint8_t id, uint32_t next, bool& finished);
+    void onNak(uint8_t id, uint32_t seq);
+
+    SendFn send_;
+    Config cfg_;
+
+    mutable std::mutex mutex_;
+    TxState tx_;
+    RxState rx_;
+    uint8_t nextTxId_ = 0;
+    uint32_t nowMs_   = 0;
+
+    uint8_t* rxBuffer_   = nullptr;
+    size_t   rxCapacity_ = 0;
+    ReceiveCallback onReceived_;
+
+    std::vector<uint8_t> txBuf_;   // reused packet buffer
+    Stats stats_;
+};
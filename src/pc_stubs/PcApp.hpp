@@ -31,4 +31,9 @@ public:
     crosspad::PadLedController& ledController();
     CrosspadStatus& status();
     CrosspadSettings& settings();
+
+    // Set by the PC app factory: the app's own create function, wrapped so
+    // its root object gets the name "app:<queryName>" (remote "query").
+    lv_obj_t* (*realCreate)(lv_obj_t*, App*) = nullptr;
+    const char* queryName = nullptr;
 };
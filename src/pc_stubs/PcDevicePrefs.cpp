@@ -0,0 +1,97 @@
+/**
+ * @file PcDevicePrefs.cpp
+ * @brief device_preferences JSON and snapshot encoding.
+ */
+
+#include "PcDevicePrefs.hpp"
+#include "StateSnapshot.hpp"
+
+#include <ArduinoJson.h>
+
+namespace {
+
+// Snapshot tags (StateSnapshot::Kind::Devices)
+enum : uint16_t {
+    TAG_AUDIO_OUT1  = 1,
+    TAG_AUDIO_OUT2  = 2,
+    TAG_AUDIO_IN1   = 3,
+    TAG_AUDIO_IN2   = 4,
+    TAG_MIDI_OUT    = 5,
+    TAG_MIDI_IN     = 6,
+    TAG_SDCARD_PATH = 7,
+    TAG_UART_PORT   = 8,
+    TAG_UART_BAUD   = 9,   // u32
+};
+
+} // namespace
+
+std::string DevicePreferences::toJson() const
+{
+    JsonDocument doc;
+    doc["audio_out1"] = audioOut1;
+    doc["audio_out2"] = audioOut2;
+    doc["audio_in1"]  = audioIn1;
+    doc["audio_in2"]  = audioIn2;
+    doc["midi_out"]    = midiOut;
+    doc["midi_in"]     = midiIn;
+    doc["sdcard_path"] = sdcardPath;
+    doc["uart_port"]   = uartPort;
+    doc["uart_baud"]   = uartBaud;
+
+    std::string text;
+    serializeJsonPretty(doc, text);
+    return text;
+}
+
+std::string DevicePreferences::toSnapshot() const
+{
+    StateSnapshot::Writer w(StateSnapshot::Kind::Devices);
+    w.putString(TAG_AUDIO_OUT1, audioOut1);
+    w.putString(TAG_AUDIO_OUT2, audioOut2);
+    w.putString(TAG_AUDIO_IN1, audioIn1);
+    w.putString(TAG_AUDIO_IN2, audioIn2);
+    w.putString(TAG_MIDI_OUT, midiOut);
+    w.putString(TAG_MIDI_IN, midiIn);
+    w.putString(TAG_SDCARD_PATH, sdcardPath);
+    w.putString(TAG_UART_PORT, uartPort);
+    w.putU32(TAG_UART_BAUD, uartBaud);
+    return w.finish();
+}
+
+bool DevicePreferences::parse(std::string_view data)
+{
+    if (StateSnapshot::isSnapshot(data)) {
+        StateSnapshot::Reader r;
+        if (!StateSnapshot::open(data, StateSnapshot::Kind::Devices, r)) return false;
+        StateSnapshot::Field f;
+        while (r.next(f)) {
+            switch (f.tag) {
+            case TAG_AUDIO_OUT1:  audioOut1  = f.str(); break;
+            case TAG_AUDIO_OUT2:  audioOut2  = f.str(); break;
+            case TAG_AUDIO_IN1:   audioIn1   = f.str(); break;
+            case TAG_AUDIO_IN2:   audioIn2   = f.str(); break;
+            case TAG_MIDI_OUT:    midiOut    = f.str(); break;
+            case TAG_MIDI_IN:     midiIn     = f.str(); break;
+            case TAG_SDCARD_PATH: sdcardPath = f.str(); break;
+            case TAG_UART_PORT:   uartPort   = f.str(); break;
+            case TAG_UART_BAUD:   uartBaud   = f.u32(uartBaud); break;
+            default:              break;   // written by a newer version
+            }
+        }
+        return true;
+    }
+
+    JsonDocument doc;
+    if (deserializeJson(doc, data.data(), data.size())) return false;
+
+    if (doc["audio_out1"].is<const char*>()) audioOut1 = doc["audio_out1"].as<const char*>();
+    if (doc["audio_out2"].is<const char*>()) audioOut2 = doc["audio_out2"].as<const char*>();
+    if (doc["audio_in1"].is<const char*>())  audioIn1  = doc["audio_in1"].as<const char*>();
+    if (doc["audio_in2"].is<const char*>())  audioIn2  = doc["audio_in2"].as<const char*>();
+    if (doc["midi_out"].is<const char*>())   midiOut   = doc["midi_out"].as<const char*>();
+    if (doc["midi_in"].is<const char*>())    midiIn    = doc["midi_in"].as<const char*>();
+    if (doc["sdcard_path"].is<const char*>()) sdcardPath = doc["sdcard_path"].as<const char*>();
+    if (doc["uart_port"].is<const char*>())  uartPort   = doc["uart_port"].as<const char*>();
+    if (doc["uart_baud"].is<uint32_t>())     uartBaud   = doc["uart_baud"].as<uint32_t>();
+    return true;
+}
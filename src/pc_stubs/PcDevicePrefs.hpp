@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * @file PcDevicePrefs.hpp
+ * @brief Audio/MIDI/UART device and SD card choices, persisted in
+ *        <profile>/device_preferences.json (or .bin, see StateSnapshot).
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+struct DevicePreferences {
+    std::string audioOut1;
+    std::string audioOut2;
+    std::string audioIn1;
+    std::string audioIn2;
+    std::string midiOut;
+    std::string midiIn;
+    std::string sdcardPath;
+    std::string uartPort;
+    uint32_t    uartBaud = 115200;
+
+    std::string toJson() const;
+    std::string toSnapshot() const;
+
+    /// Load either format; fields missing from @p data keep their value.
+    /// @return false if @p data is neither
+    bool parse(std::string_view data);
+};
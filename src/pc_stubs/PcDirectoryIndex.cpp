@@ -0,0 +1,541 @@
+/**
+ * @file PcDirectoryIndex.cpp
+ * @brief Directory scanning worker, listing cache and inotify invalidation.
+ */
+
+#include "PcDirectoryIndex.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+uint32_t get_le32(const uint8_t* p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+bool is_wav(const std::string& name)
+{
+    if (name.size() < 4) return false;
+    const char* ext = name.c_str() + name.size() - 4;
+    return ext[0] == '.' && std::tolower((unsigned char)ext[1]) == 'w' &&
+           std::tolower((unsigned char)ext[2]) == 'a' && std::tolower((unsigned char)ext[3]) == 'v';
+}
+
+int64_t to_unix_seconds(fs::file_time_type t)
+{
+    using namespace std::chrono;
+    const auto sys = system_clock::now() +
+                     duration_cast<system_clock::duration>(t - fs::file_time_type::clock::now());
+    return duration_cast<seconds>(sys.time_since_epoch()).count();
+}
+
+} // namespace
+
+PcDirectoryIndex::PcDirectoryIndex()
+{
+#ifdef __linux__
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ >= 0 && pipe2(wakePipe_, O_CLOEXEC) == 0) {
+        watcher_ = std::thread(&PcDirectoryIndex::watchLoop, this);
+    } else {
+        printf("[DirIndex] inotify unavailable, validating listings by mtime\n");
+        if (inotifyFd_ >= 0) ::close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+#endif
+    worker_ = std::thread(&PcDirectoryIndex::workerLoop, this);
+}
+
+PcDirectoryIndex::~PcDirectoryIndex()
+{
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    worker_.join();
+
+#ifdef __linux__
+    if (watcher_.joinable()) {
+        const char c = 0;
+        (void)!::write(wakePipe_[1], &c, 1);
+        watcher_.join();
+        ::close(wakePipe_[0]);
+        ::close(wakePipe_[1]);
+    }
+    if (inotifyFd_ >= 0) ::close(inotifyFd_);
+#endif
+}
+
+PcDirectoryIndex& PcDirectoryIndex::getInstance()
+{
+    static PcDirectoryIndex instance;
+    return instance;
+}
+
+/* ── Lookups ─────────────────────────────────────────────────────────── */
+
+PcDirectoryIndex::ListingPtr PcDirectoryIndex::list(const std::string& dir)
+{
+    const std::string key = normalize(dir);
+    const FileTime mtime = dirMtime(key);
+
+    std::unique_lock<std::mutex> lk(mutex_);
+    Node& n = nodes_[key];
+    n.lastUsed = ++useTick_;
+    if (freshLocked(n, mtime)) {
+        stats_.hits++;
+        return n.listing;
+    }
+
+    stats_.misses++;
+    const uint64_t scans = n.scans;
+    enqueueLocked(key, n, true);
+    n.pins++;
+    cv_.wait(lk, [&] { return n.scans != scans || !running_; });
+    n.pins--;
+    return n.listing ? n.listing : std::make_shared<Listing>();
+}
+
+PcDirectoryIndex::ListingPtr PcDirectoryIndex::cached(const std::string& dir)
+{
+    const std::string key = normalize(dir);
+    const FileTime mtime = dirMtime(key);
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto it = nodes_.find(key);
+    if (it == nodes_.end() || !freshLocked(it->second, mtime)) return nullptr;
+    it->second.lastUsed = ++useTick_;
+    stats_.hits++;
+    return it->second.listing;
+}
+
+void PcDirectoryIndex::requestPage(const std::string& dir, size_t offset, size_t count, PageCallback done)
+{
+    const std::string key = normalize(dir);
+    const FileTime mtime = dirMtime(key);
+
+    std::unique_lock<std::mutex> lk(mutex_);
+    Node& n = nodes_[key];
+    n.lastUsed = ++useTick_;
+    if (freshLocked(n, mtime)) {
+        stats_.hits++;
+        ListingPtr listing = n.listing;
+        lk.unlock();
+        done(makePage(*listing, offset, count));
+        return;
+    }
+
+    stats_.misses++;
+    n.pages.push_back({ offset, count, std::move(done) });
+    enqueueLocked(key, n, true);
+}
+
+void PcDirectoryIndex::prefetch(const std::string& dir)
+{
+    const std::string key = normalize(dir);
+    const FileTime mtime = dirMtime(key);
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    Node& n = nodes_[key];
+    if (!freshLocked(n, mtime)) enqueueLocked(key, n, false);
+}
+
+bool PcDirectoryIndex::freshLocked(const Node& n, const FileTime& mtime) const
+{
+    // Watched directories are trusted until inotify says otherwise
+    return n.listing && n.valid && (n.watch >= 0 || n.mtime == mtime);
+}
+
+void PcDirectoryIndex::enqueueLocked(const std::string& dir, Node& n, bool urgent)
+{
+    if (n.queued) {
+        // Someone is waiting now: move a queued prefetch to the front
+        if (urgent) {
+            auto it = std::find(queue_.begin(), queue_.end(), dir);
+            if (it != queue_.end() && it != queue_.begin()) {
+                queue_.erase(it);
+                queue_.push_front(dir);
+            }
+        }
+        return;
+    }
+    n.queued = true;
+    if (urgent) queue_.push_front(dir);
+    else        queue_.push_back(dir);
+    cv_.notify_all();
+}
+
+PcDirectoryIndex::Page PcDirectoryIndex::makePage(const Listing& l, size_t offset, size_t count)
+{
+    Page page;
+    page.offset = offset;
+    page.total  = l.entries.size();
+    page.exists = l.exists;
+    if (offset < page.total) {
+        const size_t end = offset + std::min(count, page.total - offset);
+        page.entries.assign(l.entries.begin() + offset, l.entries.begin() + end);
+    }
+    return page;
+}
+
+/* ── Invalidation ────────────────────────────────────────────────────── */
+
+void PcDirectoryIndex::invalidate(const std::string& dir)
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (dir.empty()) {
+        for (auto& [key, n] : nodes_) invalidateLocked(key, n);
+        return;
+    }
+    const std::string key = normalize(dir);
+    auto it = nodes_.find(key);
+    if (it != nodes_.end()) invalidateLocked(key, it->second);
+}
+
+void PcDirectoryIndex::invalidateLocked(const std::string& dir, Node& n)
+{
+    n.changes++;
+    n.valid = false;
+    stats_.invalidations++;
+
+    // Keep directories someone has looked at warm
+    if (n.listing) enqueueLocked(dir, n, false);
+}
+
+void PcDirectoryIndex::watchRoot(const std::string& root)
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    root_ = normalize(root);
+#ifdef __linux__
+    for (const auto& [wd, dir] : watches_) inotify_rm_watch(inotifyFd_, wd);
+#endif
+    watches_.clear();
+    details_.clear();
+    for (auto& [key, n] : nodes_) {
+        n.watch = -1;
+        n.valid = false;
+        n.changes++;
+        n.listing.reset();
+    }
+}
+
+void PcDirectoryIndex::evictLocked()
+{
+    while (nodes_.size() > MAX_CACHED_DIRS) {
+        auto oldest = nodes_.end();
+        for (auto it = nodes_.begin(); it != nodes_.end(); ++it) {
+            const Node& n = it->second;
+            if (n.queued || n.pins || !n.pages.empty()) continue;   // someone still needs it
+            if (oldest == nodes_.end() || n.lastUsed < oldest->second.lastUsed) oldest = it;
+        }
+        if (oldest == nodes_.end()) return;
+
+        if (oldest->second.watch >= 0) {
+#ifdef __linux__
+            inotify_rm_watch(inotifyFd_, oldest->second.watch);
+#endif
+            watches_.erase(oldest->second.watch);
+        }
+        nodes_.erase(oldest);   // a pending DetailJob notices and gives up
+    }
+}
+
+/* ── Worker ──────────────────────────────────────────────────────────── */
+
+void PcDirectoryIndex::workerLoop()
+{
+    std::unique_lock<std::mutex> lk(mutex_);
+    for (;;) {
+        cv_.wait(lk, [&] { return !running_ || !queue_.empty() || !details_.empty(); });
+        if (!running_) return;
+
+        if (!queue_.empty()) runScanLocked(lk);
+        else                 runDetailsLocked(lk);
+    }
+}
+
+void PcDirectoryIndex::runScanLocked(std::unique_lock<std::mutex>& lk)
+{
+    auto belowRoot = [this](const std::string& dir) {
+        return !root_.empty() && dir.compare(0, root_.size(), root_) == 0 &&
+               (dir.size() == root_.size() || dir[root_.size()] == '/');
+    };
+
+    const std::string dir = std::move(queue_.front());
+    queue_.pop_front();
+    Node& n = nodes_[dir];   // queued: not evicted until we are done
+    const uint64_t changes = n.changes;
+    const bool watch = n.watch < 0 && inotifyFd_ >= 0 && belowRoot(dir);
+    lk.unlock();
+
+    // Watch before scanning, so a change during the scan is not missed
+    const int wd = watch ? addWatch(dir) : -1;
+    const FileTime mtime = dirMtime(dir);
+    auto listing = std::make_shared<Listing>(scan(dir));
+
+    lk.lock();
+    if (wd >= 0) {
+        if (belowRoot(dir)) {
+            n.watch = wd;
+            watches_[wd] = dir;
+        } else {
+#ifdef __linux__
+            inotify_rm_watch(inotifyFd_, wd);   // watchRoot() moved meanwhile
+#endif
+        }
+    }
+    n.listing = listing;
+    n.mtime   = mtime;
+    n.queued  = false;
+    n.valid   = n.changes == changes;
+    n.scans++;
+    stats_.scans++;
+    if (!n.valid) enqueueLocked(dir, n, false);   // changed while scanning
+    std::vector<PendingPage> pages = std::move(n.pages);
+    n.pages.clear();
+    if (listing->exists && !listing->entries.empty())
+        details_.push_back({ dir, listing, nullptr });   // copied when it starts
+
+    // Folders come first; queue the first few for the next click
+    size_t prefetched = 0;
+    for (const Entry& e : listing->entries) {
+        if (!e.isFolder || prefetched == MAX_PREFETCH_DIRS) break;
+        Node& child = nodes_[e.path];
+        if (!child.listing && !child.queued) {
+            child.lastUsed = useTick_;
+            enqueueLocked(e.path, child, false);
+            prefetched++;
+        }
+    }
+    evictLocked();   // may erase n
+    cv_.notify_all();
+
+    if (!pages.empty()) {
+        lk.unlock();
+        for (PendingPage& p : pages) p.done(makePage(*listing, p.offset, p.count));
+        lk.lock();
+    }
+}
+
+void PcDirectoryIndex::runDetailsLocked(std::unique_lock<std::mutex>& lk)
+{
+    DetailJob job = std::move(details_.front());
+    details_.pop_front();
+
+    for (;;) {
+        // Give up once the listing was rescanned, dropped or evicted
+        auto it = nodes_.find(job.dir);
+        if (it == nodes_.end() || it->second.listing != job.base) return;
+
+        // Scans first: park the job where it is
+        if (!queue_.empty()) {
+            details_.push_front(std::move(job));
+            return;
+        }
+        lk.unlock();
+
+        if (!job.work) job.work = std::make_shared<Listing>(*job.base);
+        std::vector<Entry>& entries = job.work->entries;
+        const size_t end = std::min(entries.size(), job.pos + DETAIL_SLICE);
+        for (; job.pos < end; job.pos++) {
+            Entry& e = entries[job.pos];
+            std::error_code ec;
+            if (job.durations) {
+                if (!e.isFolder && is_wav(e.name)) e.durationMs = wavDurationMs(e.path);
+                continue;
+            }
+            if (!e.isFolder) {
+                const uintmax_t size = fs::file_size(e.path, ec);
+                if (!ec) e.size = size;
+            }
+            const fs::file_time_type t = fs::last_write_time(e.path, ec);
+            if (!ec) e.mtime = to_unix_seconds(t);
+        }
+        const bool phaseDone = job.pos == entries.size();
+        if (phaseDone) {
+            if (job.durations) {
+                job.work->durationsKnown = true;
+            } else {
+                job.work->detailsKnown = true;
+                job.work->durationsKnown =
+                    std::none_of(entries.begin(), entries.end(),
+                                 [](const Entry& e) { return !e.isFolder && is_wav(e.name); });
+            }
+        }
+
+        lk.lock();
+        if (!phaseDone) continue;
+
+        // Publish this phase
+        it = nodes_.find(job.dir);
+        if (it == nodes_.end() || it->second.listing != job.base) return;
+        auto published = std::make_shared<Listing>(*job.work);
+        it->second.listing = published;
+        if (job.durations || published->durationsKnown) return;
+
+        job.base      = std::move(published);
+        job.pos       = 0;
+        job.durations = true;
+    }
+}
+
+PcDirectoryIndex::Listing PcDirectoryIndex::scan(const std::string& dir)
+{
+    Listing l;
+
+    std::error_code ec;
+    fs::directory_iterator it(dir, ec);
+    if (ec) return l;
+    l.exists = true;
+
+    // Names and kinds only: the kind comes with the directory entry on
+    // most filesystems, so nothing here stat()s
+    for (; !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        const fs::directory_entry& de = *it;
+        std::error_code eec;
+        Entry e;
+        e.name = de.path().filename().string();
+        e.path = de.path().string();
+        for (char& c : e.path) {
+            if (c == '\\') c = '/';
+        }
+        e.isFolder = de.is_directory(eec);
+        l.entries.push_back(std::move(e));
+    }
+
+    std::sort(l.entries.begin(), l.entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.isFolder != b.isFolder) return a.isFolder;
+        return a.name < b.name;
+    });
+    l.detailsKnown = l.durationsKnown = l.entries.empty();
+    return l;
+}
+
+PcDirectoryIndex::FileTime PcDirectoryIndex::dirMtime(const std::string& dir)
+{
+    std::error_code ec;
+    const FileTime t = fs::last_write_time(dir, ec);
+    return ec ? FileTime::min() : t;
+}
+
+/* ── inotify ─────────────────────────────────────────────────────────── */
+
+int PcDirectoryIndex::addWatch(const std::string& dir)
+{
+#ifdef __linux__
+    return inotify_add_watch(inotifyFd_, dir.c_str(),
+                             IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+                             IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+#else
+    (void)dir;
+    return -1;
+#endif
+}
+
+void PcDirectoryIndex::watchLoop()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buf[16384];
+    pollfd fds[2] = { { inotifyFd_, POLLIN, 0 }, { wakePipe_[0], POLLIN, 0 } };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents) return;
+
+        const ssize_t len = ::read(inotifyFd_, buf, sizeof(buf));
+        if (len <= 0) continue;
+
+        std::lock_guard<std::mutex> lk(mutex_);
+        for (const char* p = buf; p < buf + len;) {
+            const auto* ev = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                // Events were lost: nothing watched can be trusted
+                for (const auto& [wd, dir] : watches_) invalidateLocked(dir, nodes_[dir]);
+                continue;
+            }
+            auto it = watches_.find(ev->wd);
+            if (it == watches_.end()) continue;
+
+            Node& n = nodes_[it->second];
+            invalidateLocked(it->second, n);
+            if (ev->mask & IN_IGNORED) {
+                // Directory gone (or unwatched): fall back to mtime checks
+                n.watch = -1;
+                watches_.erase(it);
+            }
+        }
+    }
+#endif
+}
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+PcDirectoryIndex::Stats PcDirectoryIndex::stats() const
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    Stats s = stats_;
+    s.dirs    = nodes_.size();
+    s.watches = watches_.size();
+    return s;
+}
+
+std::string PcDirectoryIndex::normalize(const std::string& dir)
+{
+    std::string out = dir;
+    for (char& c : out) {
+        if (c == '\\') c = '/';
+    }
+    while (out.size() > 1 && out.back() == '/') out.pop_back();
+    return out;
+}
+
+uint32_t PcDirectoryIndex::wavDurationMs(const std::string& path)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return 0;
+
+    uint8_t riff[12];
+    uint32_t byteRate = 0;
+    uint64_t ms = 0;
+    if (fread(riff, 1, sizeof(riff), f) == sizeof(riff) &&
+        memcmp(riff, "RIFF", 4) == 0 && memcmp(riff + 8, "WAVE", 4) == 0) {
+        uint8_t chunk[8];
+        while (fread(chunk, 1, sizeof(chunk), f) == sizeof(chunk)) {
+            const uint32_t size = get_le32(chunk + 4);
+            long skip = long(size) + long(size & 1);   // chunks are word-aligned
+            if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+                uint8_t fmt[16];
+                if (fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt)) break;
+                byteRate = get_le32(fmt + 8);
+                skip -= 16;
+            } else if (memcmp(chunk, "data", 4) == 0) {
+                if (byteRate) ms = uint64_t(size) * 1000 / byteRate;
+                break;
+            }
+            if (fseek(f, skip, SEEK_CUR) != 0) break;
+        }
+    }
+    fclose(f);
+    return static_cast<uint32_t>(std::min<uint64_t>(ms, UINT32_MAX));
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+/**
+ * @file PcDirectoryIndex.hpp
+ * @brief Cached directory listings for the virtual SD card, scanned on a
+ *        worker thread.
+ *
+ * A listing holds everything the file browsers need per entry (kind, size,
+ * mtime, WAV duration), sorted folders first, then by name. Listings are
+ * cached per directory, up to MAX_CACHED_DIRS (least recently used ones are
+ * dropped, with their watches):
+ *
+ *  - below the root given to watchRoot() (the mounted SD card) they stay
+ *    valid until inotify reports a change in that directory (Linux);
+ *  - elsewhere, and on other systems, a hit costs one stat() of the
+ *    directory, whose mtime changes when entries are added, removed or
+ *    renamed.
+ *
+ * A directory that changes while cached is rescanned in the background,
+ * and listing a directory also queues its first MAX_PREFETCH_DIRS
+ * subfolders, so stepping into one is usually a hit.
+ *
+ * A scan only reads the directory (names and kinds), so a miss costs about
+ * what a plain directory walk does. Sizes and mtimes (one stat() per entry)
+ * and then WAV durations (one header read per WAV) are filled in by detail
+ * passes after the listing has been handed out. They run only while no scan
+ * is queued, in slices of DETAIL_SLICE entries, so a scan someone waits for
+ * never sits behind them for long.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PcDirectoryIndex {
+public:
+    struct Entry {
+        std::string name;
+        std::string path;            ///< full path, forward slashes
+        bool        isFolder   = false;
+        uint64_t    size       = 0;  ///< bytes (files), once detailsKnown
+        int64_t     mtime      = 0;  ///< seconds since the Unix epoch, once detailsKnown
+        uint32_t    durationMs = 0;  ///< WAV files, once durationsKnown
+    };
+
+    struct Listing {
+        std::vector<Entry> entries;
+        bool exists         = false;
+        bool detailsKnown   = false;   ///< sizes and mtimes filled in
+        bool durationsKnown = false;
+    };
+    using ListingPtr = std::shared_ptr<const Listing>;
+
+    struct Page {
+        std::vector<Entry> entries;   ///< [offset, offset + count) of the listing
+        size_t offset = 0;
+        size_t total  = 0;
+        bool   exists = false;
+    };
+    using PageCallback = std::function<void(const Page&)>;
+
+    static constexpr size_t MAX_PREFETCH_DIRS = 16;
+    static constexpr size_t MAX_CACHED_DIRS   = 128;
+    static constexpr size_t DETAIL_SLICE      = 64;   ///< entries between checks for scans
+
+    PcDirectoryIndex();
+    ~PcDirectoryIndex();
+
+    PcDirectoryIndex(const PcDirectoryIndex&) = delete;
+    PcDirectoryIndex& operator=(const PcDirectoryIndex&) = delete;
+
+    /// Process-wide instance.
+    static PcDirectoryIndex& getInstance();
+
+    /// Up-to-date listing of @p dir; scans on the worker and waits on a miss
+    /// (for the names only: details may still be coming).
+    ListingPtr list(const std::string& dir);
+
+    /// Up-to-date listing of @p dir, or nullptr (never blocks, never scans).
+    ListingPtr cached(const std::string& dir);
+
+    /// Hand @p count entries from @p offset to @p done: at once on a hit,
+    /// otherwise from the worker thread once the scan is done. Not used by
+    /// the GUI yet (IFileSystem::listDirectory() is synchronous).
+    void requestPage(const std::string& dir, size_t offset, size_t count, PageCallback done);
+
+    /// Scan @p dir in the background unless it is cached.
+    void prefetch(const std::string& dir);
+
+    /// Drop the listing of @p dir (every listing if empty).
+    void invalidate(const std::string& dir = {});
+
+    /// Watch directories below @p root for changes; "" stops watching.
+    /// Every cached listing is dropped.
+    void watchRoot(const std::string& root);
+
+    struct Stats {
+        uint64_t hits          = 0;
+        uint64_t misses        = 0;
+        uint64_t scans         = 0;
+        uint64_t invalidations = 0;
+        size_t   dirs          = 0;   ///< directories currently cached
+        size_t   watches       = 0;   ///< of which watched by inotify
+    };
+    Stats stats() const;
+
+    /// Forward slashes, no trailing slash.
+    static std::string normalize(const std::string& dir);
+
+    /// Playing time of a PCM WAV file from its header, 0 if not one.
+    static uint32_t wavDurationMs(const std::string& path);
+
+private:
+    using FileTime = std::filesystem::file_time_type;
+
+    struct PendingPage {
+        size_t offset;
+        size_t count;
+        PageCallback done;
+    };
+
+    struct Node {
+        ListingPtr listing;
+        FileTime   mtime;               // of the directory, at scan time
+        bool       valid   = false;     // listing matches the disk
+        bool       queued  = false;     // scan queued or running
+        int        watch   = -1;        // inotify descriptor
+        int        pins    = 0;         // list() calls waiting on it; not evicted
+        uint64_t   changes = 0;         // invalidations; a scan racing one is redone
+        uint64_t   scans   = 0;
+        uint64_t   lastUsed = 0;
+        std::vector<PendingPage> pages;
+    };
+
+    // Sizes/mtimes, then durations, for one published listing
+    struct DetailJob {
+        std::string dir;
+        ListingPtr  base;                 // dropped once the node moves on
+        std::shared_ptr<Listing> work;
+        size_t      pos       = 0;
+        bool        durations = false;    // second phase
+    };
+
+    bool freshLocked(const Node& n, const FileTime& mtime) const;
+    void enqueueLocked(const std::string& dir, Node& n, bool urgent);
+    void invalidateLocked(const std::string& dir, Node& n);
+    void evictLocked();
+    void runScanLocked(std::unique_lock<std::mutex>& lk);
+    void runDetailsLocked(std::unique_lock<std::mutex>& lk);
+    static Page makePage(const Listing& l, size_t offset, size_t count);
+    static Listing scan(const std::string& dir);
+    static FileTime dirMtime(const std::string& dir);
+
+    void workerLoop();
+    int  addWatch(const std::string& dir);   // worker; -1 if not below root
+    void watchLoop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;     // worker and list() waiters
+    std::map<std::string, Node> nodes_;
+    std::deque<std::string> queue_;      // scans: waited-for ones first
+    std::deque<DetailJob> details_;      // only while queue_ is empty
+    std::string root_;
+    uint64_t useTick_ = 0;
+    Stats stats_;
+    bool running_ = true;
+    std::thread worker_;
+
+    // inotify (Linux)
+    std::map<int, std::string> watches_;
+    int inotifyFd_ = -1;
+    int wakePipe_[2] = { -1, -1 };
+    std::thread watcher_;
+};
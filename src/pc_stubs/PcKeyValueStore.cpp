@@ -0,0 +1,249 @@
+/**
+ * @file PcKeyValueStore.cpp
+ * @brief preferences.json / .bin loading and write-behind saving.
+ */
+
+#include "PcKeyValueStore.hpp"
+#include "StateSnapshot.hpp"
+#include "pc_stubs/pc_platform.h"
+
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+namespace {
+
+// Snapshot tags (StateSnapshot::Kind::Settings)
+enum : uint16_t {
+    TAG_ENTRY = 1,        // record:
+    TAG_ENTRY_KEY = 1,    //   string "ns/key"
+    TAG_ENTRY_VALUE = 2,  //   i32
+};
+
+std::string make_key(const char* ns, const char* key)
+{
+    return std::string(ns) + "/" + key;
+}
+
+std::string resolve_profile_dir()
+{
+    const std::string& custom = pc_platform_options().profileDir;
+    if (!custom.empty()) return custom;
+#ifdef _MSC_VER
+    const char* userProfile = std::getenv("USERPROFILE");
+    if (userProfile) return std::string(userProfile) + "/.crosspad";
+#endif
+    const char* home = std::getenv("HOME");
+    if (home) return std::string(home) + "/.crosspad";
+    return ".crosspad";
+}
+
+} // namespace
+
+PcKeyValueStore::PcKeyValueStore(PcPersistence& persistence)
+    : persistence_(persistence)
+{
+}
+
+PcKeyValueStore::~PcKeyValueStore()
+{
+    // The scheduled serializer refers to this store
+    if (!filePath_.empty()) persistence_.flush(filePath_);
+}
+
+/* ── Open / load ─────────────────────────────────────────────────────── */
+
+bool PcKeyValueStore::init()
+{
+    const std::string dir = resolve_profile_dir();
+
+    // Ensure ~/.crosspad/ and ~/.crosspad/cache/ exist
+    std::filesystem::create_directories(dir + "/cache");
+
+    if (!open(dir, pc_platform_options().binaryState)) return false;
+    printf("[KVStore] Profile dir: %s\n", profileDir_.c_str());
+    return true;
+}
+
+bool PcKeyValueStore::open(const std::string& profileDir, bool binary)
+{
+    if (!filePath_.empty()) return false;
+
+    profileDir_ = profileDir;
+    binary_     = binary;
+    filePath_   = profileDir_ + "/preferences" + StateSnapshot::extension(binary);
+    std::error_code ec;
+    std::filesystem::create_directories(profileDir_, ec);
+
+    load();
+    return true;
+}
+
+void PcKeyValueStore::load()
+{
+    std::string path;
+    std::map<std::string, int32_t> loaded;
+    const bool ok = StateSnapshot::readNewest(profileDir_ + "/preferences", [&](const std::string& data) {
+        loaded.clear();
+        return decode(data, loaded);
+    }, &path);
+    if (!ok) {
+        if (!path.empty()) printf("[KVStore] Failed to parse %s\n", path.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    store_ = std::move(loaded);
+    printf("[KVStore] Loaded %zu keys from %s\n", store_.size(), path.c_str());
+}
+
+bool PcKeyValueStore::decode(std::string_view data, std::map<std::string, int32_t>& out)
+{
+    if (StateSnapshot::isSnapshot(data)) {
+        StateSnapshot::Reader r;
+        if (!StateSnapshot::open(data, StateSnapshot::Kind::Settings, r)) return false;
+        StateSnapshot::Field f;
+        while (r.next(f)) {
+            if (f.tag != TAG_ENTRY) continue;
+            std::string_view key;
+            int32_t value = 0;
+            bool hasValue = false;
+            StateSnapshot::Reader entry = f.record();
+            StateSnapshot::Field ef;
+            while (entry.next(ef)) {
+                if (ef.tag == TAG_ENTRY_KEY) key = ef.str();
+                else if (ef.tag == TAG_ENTRY_VALUE) { value = ef.i32(); hasValue = true; }
+            }
+            if (!key.empty() && hasValue) out[std::string(key)] = value;
+        }
+        return true;
+    }
+
+    JsonDocument doc;
+    if (deserializeJson(doc, data.data(), data.size())) return false;
+    for (JsonPair kv : doc.as<JsonObject>()) {
+        out[kv.key().c_str()] = kv.value().as<int32_t>();
+    }
+    return true;
+}
+
+std::string PcKeyValueStore::encode(const std::map<std::string, int32_t>& entries, bool binary)
+{
+    if (binary) {
+        StateSnapshot::Writer w(StateSnapshot::Kind::Settings);
+        for (const auto& [key, value] : entries) {
+            size_t mark = w.beginRecord(TAG_ENTRY);
+            w.putString(TAG_ENTRY_KEY, key);
+            w.putI32(TAG_ENTRY_VALUE, value);
+            w.endRecord(mark);
+        }
+        return w.finish();
+    }
+
+    JsonDocument doc;
+    for (const auto& [key, value] : entries) {
+        doc[key] = value;
+    }
+    std::string text;
+    serializeJsonPretty(doc, text);
+    return text;
+}
+
+/* ── Reads and writes (memory only) ──────────────────────────────────── */
+
+void PcKeyValueStore::saveBool(const char* ns, const char* key, bool value)
+{
+    set(ns, key, value ? 1 : 0);
+}
+
+void PcKeyValueStore::saveU8(const char* ns, const char* key, uint8_t value)
+{
+    set(ns, key, value);
+}
+
+void PcKeyValueStore::saveI32(const char* ns, const char* key, int32_t value)
+{
+    set(ns, key, value);
+}
+
+bool PcKeyValueStore::readBool(const char* ns, const char* key, bool defaultVal)
+{
+    int32_t v;
+    return get(ns, key, v) ? (v != 0) : defaultVal;
+}
+
+uint8_t PcKeyValueStore::readU8(const char* ns, const char* key, uint8_t defaultVal)
+{
+    int32_t v;
+    return get(ns, key, v) ? static_cast<uint8_t>(v) : defaultVal;
+}
+
+int32_t PcKeyValueStore::readI32(const char* ns, const char* key, int32_t defaultVal)
+{
+    int32_t v;
+    return get(ns, key, v) ? v : defaultVal;
+}
+
+void PcKeyValueStore::eraseAll()
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (store_.empty()) return;
+    store_.clear();
+    markDirtyLocked();
+}
+
+void PcKeyValueStore::set(const char* ns, const char* key, int32_t value)
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto [it, inserted] = store_.try_emplace(make_key(ns, key), value);
+    if (!inserted) {
+        if (it->second == value) return;
+        it->second = value;
+    }
+    markDirtyLocked();
+}
+
+bool PcKeyValueStore::get(const char* ns, const char* key, int32_t& value) const
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto it = store_.find(make_key(ns, key));
+    if (it == store_.end()) return false;
+    value = it->second;
+    return true;
+}
+
+void PcKeyValueStore::markDirtyLocked()
+{
+    // Saves before open() have nowhere to go yet
+    if (dirty_ || filePath_.empty()) return;
+    dirty_ = true;
+    persistence_.schedule(filePath_, [this] { return serialize(); }, FLUSH_DELAY_MS);
+}
+
+/* ── Persistence ─────────────────────────────────────────────────────── */
+
+std::string PcKeyValueStore::serialize()
+{
+    std::map<std::string, int32_t> entries;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        entries = store_;
+        dirty_ = false;
+        snapshots_++;
+    }
+    return encode(entries, binary_);
+}
+
+bool PcKeyValueStore::sync()
+{
+    if (filePath_.empty()) return false;
+    return persistence_.flush(filePath_);
+}
+
+uint32_t PcKeyValueStore::snapshotsWritten() const
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    return snapshots_;
+}
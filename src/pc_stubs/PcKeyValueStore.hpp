@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * @file PcKeyValueStore.hpp
+ * @brief IKeyValueStore backed by <profile>/preferences.json, written behind.
+ *
+ * With --state-format=binary the file is preferences.bin instead, a
+ * StateSnapshot. Either format is loaded, whichever was written last.
+ *
+ * Saves only update the in-memory map (a save that does not change the
+ * value is free). The first change schedules a write on PcPersistence,
+ * FLUSH_DELAY_MS later; the whole map is serialized then, on its worker,
+ * and atomically replaces preferences.json. Saving every setting in a row
+ * therefore costs one file write, off the caller's thread.
+ *
+ * Call sync() before the process exits (the simulator exits with
+ * _exit(), which skips destructors): it blocks until the file on disk
+ * matches memory. All methods are thread-safe.
+ */
+
+#include "crosspad/settings/IKeyValueStore.hpp"
+#include "PcPersistence.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+class PcKeyValueStore : public crosspad::IKeyValueStore {
+public:
+    static constexpr uint32_t FLUSH_DELAY_MS = 250;
+
+    explicit PcKeyValueStore(PcPersistence& persistence = PcPersistence::getInstance());
+    ~PcKeyValueStore();
+
+    PcKeyValueStore(const PcKeyValueStore&) = delete;
+    PcKeyValueStore& operator=(const PcKeyValueStore&) = delete;
+
+    /// Open the profile directory from the run options (~/.crosspad by default).
+    bool init() override;
+
+    /// Load <profileDir>/preferences.json or .bin; save in the @p binary
+    /// snapshot format or as JSON.
+    bool open(const std::string& profileDir, bool binary = false);
+
+    void saveBool(const char* ns, const char* key, bool value) override;
+    void saveU8(const char* ns, const char* key, uint8_t value) override;
+    void saveI32(const char* ns, const char* key, int32_t value) override;
+
+    bool    readBool(const char* ns, const char* key, bool defaultVal) override;
+    uint8_t readU8(const char* ns, const char* key, uint8_t defaultVal) override;
+    int32_t readI32(const char* ns, const char* key, int32_t defaultVal) override;
+
+    void eraseAll() override;
+
+    /// Write pending changes now and wait for them to reach the disk.
+    /// @return false if the last write failed
+    bool sync();
+
+    /// Snapshots serialized since open().
+    uint32_t snapshotsWritten() const;
+
+    const std::string& getProfileDir() const { return profileDir_; }
+
+    /// File contents for @p entries, as a snapshot or as JSON.
+    static std::string encode(const std::map<std::string, int32_t>& entries, bool binary);
+
+    /// Parse either format into @p out. @return false if @p data is neither
+    static bool decode(std::string_view data, std::map<std::string, int32_t>& out);
+
+private:
+    void set(const char* ns, const char* key, int32_t value);
+    bool get(const char* ns, const char* key, int32_t& value) const;
+    void markDirtyLocked();
+    std::string serialize();   // persistence worker
+
+    void load();
+
+    PcPersistence& persistence_;
+    std::string profileDir_;
+    std::string filePath_;
+    bool binary_ = false;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, int32_t> store_;
+    bool dirty_ = false;             // a write is scheduled
+    uint32_t snapshots_ = 0;
+};
@@ -0,0 +1,81 @@
+/**
+ * @file PcOptions.cpp
+ * @brief Simulator command-line options.
+ */
+
+#include "pc_stubs/pc_platform.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static PcRunOptions s_options;
+
+static bool parse_port(const char* text, uint16_t& out)
+{
+    char* end = nullptr;
+    long v = strtol(text, &end, 10);
+    if (!*text || *end || v < 0 || v > 65535) {
+        printf("[PC] Invalid port: %s\n", text);
+        return false;
+    }
+    out = (uint16_t)v;
+    return true;
+}
+
+static void set_headless(const char* mode)
+{
+    s_options.headless = true;
+    s_options.lcdOnly  = strcmp(mode, "lcd") == 0;
+}
+
+static void parse_state_format(const char* v)
+{
+    if (strcmp(v, "binary") == 0)    s_options.binaryState = true;
+    else if (strcmp(v, "json") == 0) s_options.binaryState = false;
+    else printf("[PC] Unknown state format '%s' (json, binary)\n", v);
+}
+
+/// "--name=value" → value, or nullptr if @p arg is not that option.
+static const char* option_value(const char* arg, const char* name)
+{
+    size_t n = strlen(name);
+    return (strncmp(arg, name, n) == 0 && arg[n] == '=') ? arg + n + 1 : nullptr;
+}
+
+PcRunOptions& pc_platform_options()
+{
+    return s_options;
+}
+
+void pc_platform_parse_args(int argc, char** argv)
+{
+    // Environment first, so explicit arguments override it
+    if (const char* v = getenv("CROSSPAD_HEADLESS")) {
+        if (*v && strcmp(v, "0") != 0) set_headless(v);
+    }
+    if (const char* v = getenv("CROSSPAD_REMOTE_PORT")) parse_port(v, s_options.remotePort);
+    if (const char* v = getenv("CROSSPAD_PROFILE_DIR")) s_options.profileDir = v;
+    if (const char* v = getenv("CROSSPAD_PORT_FILE"))   s_options.portFile = v;
+    if (const char* v = getenv("CROSSPAD_STATE_FORMAT")) parse_state_format(v);
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* v;
+        if (strcmp(arg, "--headless") == 0) {
+            set_headless("");
+        } else if ((v = option_value(arg, "--headless"))) {
+            set_headless(v);
+        } else if ((v = option_value(arg, "--port"))) {
+            parse_port(v, s_options.remotePort);
+        } else if ((v = option_value(arg, "--profile-dir"))) {
+            s_options.profileDir = v;
+        } else if ((v = option_value(arg, "--port-file"))) {
+            s_options.portFile = v;
+        } else if ((v = option_value(arg, "--state-format"))) {
+            parse_state_format(v);
+        } else {
+            printf("[PC] Ignoring unknown option: %s\n", arg);
+        }
+    }
+}
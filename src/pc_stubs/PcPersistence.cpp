@@ -0,0 +1,156 @@
+/**
+ * @file PcPersistence.cpp
+ * @brief Debounced state-file writer thread and atomic file replacement.
+ */
+
+#include "PcPersistence.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+PcPersistence::PcPersistence()
+{
+    worker_ = std::thread(&PcPersistence::workerLoop, this);
+}
+
+PcPersistence::~PcPersistence()
+{
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+PcPersistence& PcPersistence::getInstance()
+{
+    static PcPersistence instance;
+    return instance;
+}
+
+/* ── Caller side ─────────────────────────────────────────────────────── */
+
+void PcPersistence::schedule(const std::string& path, Serializer serialize, uint32_t debounceMs)
+{
+    const Clock::time_point now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto [it, inserted] = pending_.try_emplace(path);
+        Pending& p = it->second;
+        if (inserted) p.deadline = now + std::chrono::milliseconds(MAX_DELAY_MS);
+        p.serialize = std::move(serialize);
+        p.due       = std::min(now + std::chrono::milliseconds(debounceMs), p.deadline);
+        stats_.scheduled++;
+    }
+    cv_.notify_all();
+}
+
+bool PcPersistence::busyWith(const std::string& path) const
+{
+    if (path.empty()) return !pending_.empty() || !writing_.empty();
+    return pending_.count(path) || writing_ == path;
+}
+
+bool PcPersistence::flush(const std::string& path)
+{
+    std::unique_lock<std::mutex> lk(mutex_);
+    for (auto& [file, p] : pending_) {
+        if (path.empty() || file == path) p.due = Clock::time_point::min();
+    }
+    cv_.notify_all();
+    cv_.wait(lk, [&] { return !busyWith(path); });
+
+    return path.empty() ? failed_.empty() : !failed_.count(path);
+}
+
+PcPersistence::Stats PcPersistence::stats() const
+{
+    std::lock_guard<std::mutex> lk(mutex_);
+    return stats_;
+}
+
+/* ── Worker ──────────────────────────────────────────────────────────── */
+
+void PcPersistence::workerLoop()
+{
+    std::unique_lock<std::mutex> lk(mutex_);
+    for (;;) {
+        if (pending_.empty()) {
+            if (!running_) return;
+            cv_.wait(lk);
+            continue;
+        }
+
+        auto next = std::min_element(pending_.begin(), pending_.end(),
+                                     [](const auto& a, const auto& b) { return a.second.due < b.second.due; });
+        if (running_ && next->second.due > Clock::now()) {
+            // Woken early by schedule() or flush()
+            cv_.wait_until(lk, next->second.due);
+            continue;
+        }
+
+        const std::string path = next->first;
+        Serializer serialize = std::move(next->second.serialize);
+        pending_.erase(next);
+        writing_ = path;
+
+        lk.unlock();
+        const bool ok = writeAtomically(path, serialize());
+        lk.lock();
+
+        writing_.clear();
+        if (ok) {
+            failed_.erase(path);
+            stats_.written++;
+        } else {
+            failed_.insert(path);
+            stats_.failed++;
+        }
+        cv_.notify_all();
+    }
+}
+
+bool PcPersistence::writeAtomically(const std::string& path, const std::string& data)
+{
+    const std::string tmpPath = path + ".tmp";
+    FILE* f = fopen(tmpPath.c_str(), "wb");
+    if (!f) {
+        printf("[Persist] Failed to write %s\n", tmpPath.c_str());
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size() && fflush(f) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(f)) == 0;
+#else
+    ok = ok && fsync(fileno(f)) == 0;
+#endif
+    ok = (fclose(f) == 0) && ok;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmpPath, path, ec);
+    if (!ok || ec) {
+        printf("[Persist] Failed to write %s\n", path.c_str());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+#ifndef _WIN32
+    // Make the rename itself durable
+    std::string dirPath = std::filesystem::path(path).parent_path().string();
+    int dir = ::open(dirPath.empty() ? "." : dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        fsync(dir);
+        ::close(dir);
+    }
+#endif
+    return true;
+}
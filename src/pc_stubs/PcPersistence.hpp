@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file PcPersistence.hpp
+ * @brief Background writer for the simulator's state files.
+ *
+ * Callers take a cheap snapshot of their state on their own thread and
+ * schedule() a serializer that captures it; serialization and file I/O
+ * then happen on one worker thread, so UI code never waits for the disk.
+ *
+ * Writes are debounced per file: scheduling a file that already has a
+ * write pending replaces the serializer (the newest snapshot wins) and
+ * pushes the write back, up to MAX_DELAY_MS after the first request so a
+ * continuous stream of changes still reaches the disk. Every file is
+ * replaced atomically (temp file, fsync, rename).
+ *
+ * The simulator exits with _exit(), which skips destructors: call flush()
+ * (pc_platform_sync_state()) first.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+class PcPersistence {
+public:
+    /// Produces the file contents; runs on the worker thread.
+    using Serializer = std::function<std::string()>;
+
+    static constexpr uint32_t DEFAULT_DEBOUNCE_MS = 250;
+    static constexpr uint32_t MAX_DELAY_MS        = 2000;
+
+    PcPersistence();
+    ~PcPersistence();   // writes everything still pending
+
+    PcPersistence(const PcPersistence&) = delete;
+    PcPersistence& operator=(const PcPersistence&) = delete;
+
+    /// Process-wide instance.
+    static PcPersistence& getInstance();
+
+    /// Write @p path with @p serialize once @p debounceMs pass without
+    /// another schedule() of the same path.
+    void schedule(const std::string& path, Serializer serialize,
+                  uint32_t debounceMs = DEFAULT_DEBOUNCE_MS);
+
+    /// Write @p path now (every pending file if empty) and wait for it.
+    /// @return false if the write failed
+    bool flush(const std::string& path = {});
+
+    struct Stats {
+        uint64_t scheduled = 0;
+        uint64_t written   = 0;
+        uint64_t failed    = 0;
+    };
+    Stats stats() const;
+
+    /// Replace @p path with @p data: write a temp file, fsync, rename.
+    static bool writeAtomically(const std::string& path, const std::string& data);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        Serializer serialize;
+        Clock::time_point due;
+        Clock::time_point deadline;   // MAX_DELAY_MS after the first request
+    };
+
+    void workerLoop();
+    bool busyWith(const std::string& path) const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;   // worker and flush() waiters
+    std::map<std::string, Pending> pending_;
+    std::set<std::string> failed_;   // files whose last write failed
+    std::string writing_;            // file the worker is writing
+    Stats stats_;
+    bool running_ = true;
+    std::thread worker_;
+};
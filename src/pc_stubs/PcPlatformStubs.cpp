@@ -8,11 +8,8 @@
 
 #include <cstdint>
 #include <cstdio>
-#include <chrono>
 #include <string>
 #include <vector>
-#include <map>
-#include <fstream>
 #include <filesystem>
 
 #ifdef USE_FREERTOS
@@ -23,8 +20,6 @@
 #include "lvgl.h"
 #include "src/misc/lv_timer_private.h"
 
-#include <ArduinoJson.h>
-
 // crosspad-core interfaces (BEFORE Windows.h to avoid ERROR macro conflict)
 #include "crosspad/platform/CrosspadPlatformInit.hpp"
 #include "crosspad/platform/PlatformServices.hpp"
@@ -53,6 +48,9 @@
 
 // PC platform API
 #include "pc_stubs/pc_platform.h"
+#include "pc_stubs/PcKeyValueStore.hpp"
+#include "pc_stubs/PcDirectoryIndex.hpp"
+#include "remote/RemoteEvents.hpp"
 
 // crosspad-gui interfaces
 #include "crosspad-gui/platform/IGuiPlatform.h"
@@ -74,22 +72,16 @@ lv_obj_t* status_c = nullptr;
 std::string pc_platform_resolve_sdcard_path(const std::string& virtualPath);
 
 // =============================================================================
-// PcClock — IClock via std::chrono
+// PcClock — IClock via the simulation clock (real or virtual)
 // =============================================================================
 
 namespace {
 
 class PcClock : public IClock {
 public:
-    PcClock() : start_(std::chrono::steady_clock::now()) {}
-
     int64_t getTimeUs() override {
-        auto now = std::chrono::steady_clock::now();
-        return std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count();
+        return (int64_t)pc_time_us();
     }
-
-private:
-    std::chrono::steady_clock::time_point start_;
 };
 
 // =============================================================================
@@ -101,7 +93,11 @@ public:
     void begin() override {}
 
     void setPixel(uint16_t idx, RgbColor color) override {
-        if (idx < PIXEL_COUNT) pixels_[idx] = color;
+        if (idx >= PIXEL_COUNT) return;
+        RgbColor& px = pixels_[idx];
+        if (px.R == color.R && px.G == color.G && px.B == color.B) return;
+        px = color;
+        remote::notify(remote::TOPIC_LED);
     }
 
     void refresh() override {}
@@ -117,120 +113,13 @@ private:
     RgbColor pixels_[PIXEL_COUNT]{};
 };
 
-// =============================================================================
-// PcKeyValueStore — IKeyValueStore backed by ~/.crosspad/preferences.json
-// =============================================================================
-
-class PcKeyValueStore : public IKeyValueStore {
-public:
-    bool init() override {
-        profileDir_ = resolveProfileDir();
-        filePath_ = profileDir_ + "/preferences.json";
-
-        // Ensure ~/.crosspad/ and ~/.crosspad/cache/ exist
-        std::filesystem::create_directories(profileDir_);
-        std::filesystem::create_directories(profileDir_ + "/cache");
-
-        load();
-        printf("[KVStore] Profile dir: %s\n", profileDir_.c_str());
-        return true;
-    }
-
-    void saveBool(const char* ns, const char* key, bool value) override {
-        store_[makeKey(ns, key)] = value ? 1 : 0;
-        flush();
-    }
-
-    void saveU8(const char* ns, const char* key, uint8_t value) override {
-        store_[makeKey(ns, key)] = value;
-        flush();
-    }
-
-    void saveI32(const char* ns, const char* key, int32_t value) override {
-        store_[makeKey(ns, key)] = value;
-        flush();
-    }
-
-    bool readBool(const char* ns, const char* key, bool defaultVal) override {
-        auto it = store_.find(makeKey(ns, key));
-        return it != store_.end() ? (it->second != 0) : defaultVal;
-    }
-
-    uint8_t readU8(const char* ns, const char* key, uint8_t defaultVal) override {
-        auto it = store_.find(makeKey(ns, key));
-        return it != store_.end() ? static_cast<uint8_t>(it->second) : defaultVal;
-    }
-
-    int32_t readI32(const char* ns, const char* key, int32_t defaultVal) override {
-        auto it = store_.find(makeKey(ns, key));
-        return it != store_.end() ? it->second : defaultVal;
-    }
-
-    void eraseAll() override {
-        store_.clear();
-        flush();
-    }
-
-    const std::string& getProfileDir() const { return profileDir_; }
-
-private:
-    std::map<std::string, int32_t> store_;
-    std::string profileDir_;
-    std::string filePath_;
-
-    std::string makeKey(const char* ns, const char* key) {
-        return std::string(ns) + "/" + key;
-    }
-
-    static std::string resolveProfileDir() {
-#ifdef _MSC_VER
-        const char* userProfile = std::getenv("USERPROFILE");
-        if (userProfile) return std::string(userProfile) + "/.crosspad";
-#endif
-        const char* home = std::getenv("HOME");
-        if (home) return std::string(home) + "/.crosspad";
-        return ".crosspad";
-    }
-
-    void load() {
-        std::ifstream f(filePath_);
-        if (!f.is_open()) return;
-
-        JsonDocument doc;
-        DeserializationError err = deserializeJson(doc, f);
-        if (err) {
-            printf("[KVStore] Failed to parse %s: %s\n", filePath_.c_str(), err.c_str());
-            return;
-        }
-
-        for (JsonPair kv : doc.as<JsonObject>()) {
-            store_[kv.key().c_str()] = kv.value().as<int32_t>();
-        }
-        printf("[KVStore] Loaded %zu keys from %s\n", store_.size(), filePath_.c_str());
-    }
-
-    void flush() {
-        JsonDocument doc;
-        for (auto it = store_.begin(); it != store_.end(); ++it) {
-            doc[it->first] = it->second;
-        }
-
-        std::ofstream f(filePath_);
-        if (!f.is_open()) {
-            printf("[KVStore] Failed to write %s\n", filePath_.c_str());
-            return;
-        }
-        serializeJsonPretty(doc, f);
-    }
-};
-
 // =============================================================================
 // PcGuiPlatform — IGuiPlatform for desktop
 // =============================================================================
 
 class PcGuiPlatform : public crosspad_gui::IGuiPlatform {
 public:
-    PcGuiPlatform() : start_(std::chrono::steady_clock::now()) {
+    PcGuiPlatform() {
         initAssetPath();
     }
 
@@ -265,9 +154,7 @@ public:
     }
 
     uint32_t millis() override {
-        auto now = std::chrono::steady_clock::now();
-        return static_cast<uint32_t>(
-            std::chrono::duration_cast<std::chrono::milliseconds>(now - start_).count());
+        return pc_time_ms();
     }
 
     const char* assetPathPrefix() override {
@@ -284,6 +171,7 @@ public:
 
     void sendPowerOff() override {
         printf("[PC] Power off requested (exiting)\n");
+        pc_platform_sync_state();
         fflush(stdout);
         // _exit() skips CRT cleanup (atexit, thread join, static destructors)
         // which avoids abort() when detached std::threads are still running.
@@ -292,7 +180,6 @@ public:
     }
 
 private:
-    std::chrono::steady_clock::time_point start_;
     std::string assetPrefix_ = "C:/";
 
     void initAssetPath() {
@@ -373,7 +260,7 @@ private:
 };
 
 // =============================================================================
-// PcFileSystem — IFileSystem using Win32 / POSIX
+// PcFileSystem — IFileSystem over the cached PcDirectoryIndex
 // =============================================================================
 
 class PcFileSystem : public crosspad_gui::IFileSystem {
@@ -381,20 +268,18 @@ public:
     bool listDirectory(const std::string& path, std::vector<crosspad_gui::FileItem>& outEntries) override {
         outEntries.clear();
 
-        // Resolve virtual SD card paths to real filesystem paths
+        // Resolve virtual SD card paths to real filesystem paths. The GUI
+        // expects an answer now: a cached listing costs no disk access, a
+        // miss waits for the index worker (which then prefetches subfolders).
         std::string resolvedPath = pc_platform_resolve_sdcard_path(path);
+        PcDirectoryIndex::ListingPtr listing = PcDirectoryIndex::getInstance().list(resolvedPath);
 
-        std::error_code ec;
-        for (auto& entry : std::filesystem::directory_iterator(resolvedPath, ec)) {
-            if (ec) break;
+        outEntries.reserve(listing->entries.size());
+        for (const PcDirectoryIndex::Entry& entry : listing->entries) {
             crosspad_gui::FileItem item;
-            item.path = entry.path().string();
-            item.name = entry.path().filename().string();
-            item.isFolder = entry.is_directory(ec);
-            // Normalize backslashes to forward slashes for LVGL
-            for (char& c : item.path) {
-                if (c == '\\') c = '/';
-            }
+            item.path = entry.path;   // forward slashes already, for LVGL
+            item.name = entry.name;
+            item.isFolder = entry.isFolder;
             outEntries.push_back(std::move(item));
         }
         return !outEntries.empty();
@@ -535,6 +420,11 @@ void pc_platform_save_settings() {
     }
 }
 
+// Block until every state file matches memory (before _exit())
+void pc_platform_sync_state() {
+    PcPersistence::getInstance().flush();
+}
+
 // Get user profile directory (~/.crosspad)
 const char* pc_platform_get_profile_dir() {
     return s_kvStore.getProfileDir().c_str();
@@ -595,6 +485,15 @@ void pc_platform_set_sdcard_path(const std::string& path) {
         printf("[SDCard] Unmounted\n");
     }
 
+    // Listings below the card stay cached until inotify reports a change;
+    // index the folders the browsers open first in the background
+    PcDirectoryIndex& index = PcDirectoryIndex::getInstance();
+    index.watchRoot(s_sdcardRoot);
+    if (!s_sdcardRoot.empty()) {
+        index.prefetch(s_sdcardRoot + "/crosspad/kits");
+        index.prefetch(s_sdcardRoot + "/crosspad/recordings");
+    }
+
     // Update CrosspadStatus — drives status bar SD icon (status_bar.cpp checks stm32.sdDetected)
     status.stm32.sdDetected = !s_sdcardRoot.empty();
     status.sdCardDetected   = !s_sdcardRoot.empty();
@@ -0,0 +1,61 @@
+/**
+ * @file PcSimClock.cpp
+ * @brief Real/virtual simulation clock behind pc_time_*().
+ */
+
+#include "pc_stubs/pc_platform.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+const std::chrono::steady_clock::time_point s_start = std::chrono::steady_clock::now();
+
+std::atomic<bool>     s_virtual{false};
+std::atomic<uint64_t> s_virtualUs{0};   // current time while virtual
+std::atomic<int64_t>  s_offsetUs{0};    // added to the real clock after resuming
+
+int64_t real_elapsed_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - s_start).count();
+}
+
+} // namespace
+
+uint64_t pc_time_us()
+{
+    if (s_virtual.load(std::memory_order_acquire))
+        return s_virtualUs.load(std::memory_order_acquire);
+    return (uint64_t)(real_elapsed_us() + s_offsetUs.load(std::memory_order_relaxed));
+}
+
+uint32_t pc_time_ms()
+{
+    return (uint32_t)(pc_time_us() / 1000);
+}
+
+void pc_time_set_virtual(bool enabled)
+{
+    if (enabled == s_virtual.load()) return;
+    if (enabled) {
+        s_virtualUs.store(pc_time_us());
+        s_virtual.store(true, std::memory_order_release);
+    } else {
+        // Continue from the virtual reading so time never runs backwards
+        s_offsetUs.store((int64_t)s_virtualUs.load() - real_elapsed_us());
+        s_virtual.store(false, std::memory_order_release);
+    }
+}
+
+bool pc_time_is_virtual()
+{
+    return s_virtual.load(std::memory_order_acquire);
+}
+
+void pc_time_advance_us(uint64_t us)
+{
+    if (s_virtual.load(std::memory_order_acquire))
+        s_virtualUs.fetch_add(us, std::memory_order_acq_rel);
+}
@@ -0,0 +1,288 @@
+/**
+ * @file StateSnapshot.cpp
+ * @brief Snapshot encoder/decoder, CRC-32 and single-read file loading.
+ */
+
+#include "StateSnapshot.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+constexpr char MAGIC[4] = { 'C', 'P', 'S', 'N' };
+
+struct Crc32Table {
+    uint32_t t[256];
+    Crc32Table()
+    {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int b = 0; b < 8; b++)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            t[i] = crc;
+        }
+    }
+};
+
+const Crc32Table s_crcTable;
+
+void put_le16(uint8_t* p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put_le32(uint8_t* p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint16_t get_le16(const char* p)
+{
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    return static_cast<uint16_t>(b[0] | (b[1] << 8));
+}
+
+uint32_t get_le32(const char* p)
+{
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+/// LEB128: 7 bits per byte, low bits first, high bit set on all but the last.
+size_t put_varint(uint8_t* out, uint32_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+bool get_varint(std::string_view data, size_t& pos, uint32_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 35 && pos < data.size(); shift += 7) {
+        const uint8_t b = static_cast<uint8_t>(data[pos++]);
+        v |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+constexpr size_t MAX_VARINT = 5;
+
+} // namespace
+
+uint32_t StateSnapshot::crc32(const uint8_t* data, size_t len, uint32_t crc)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+        crc = (crc >> 8) ^ s_crcTable.t[(crc ^ data[i]) & 0xFF];
+    return ~crc;
+}
+
+/* ── Writer ──────────────────────────────────────────────────────────── */
+
+StateSnapshot::Writer::Writer(Kind kind)
+{
+    buf_.reserve(256);
+    buf_.resize(HEADER_SIZE);
+    buf_[8] = static_cast<char>(kind);
+}
+
+void StateSnapshot::Writer::putField(uint16_t tag, const void* data, size_t len)
+{
+    uint8_t head[2 * MAX_VARINT];
+    size_t n = put_varint(head, tag);
+    n += put_varint(head + n, static_cast<uint32_t>(len));
+    buf_.append(reinterpret_cast<const char*>(head), n);
+    if (len) buf_.append(static_cast<const char*>(data), len);
+}
+
+void StateSnapshot::Writer::putU32(uint16_t tag, uint32_t v)
+{
+    uint8_t b[MAX_VARINT];
+    putField(tag, b, put_varint(b, v));
+}
+
+void StateSnapshot::Writer::putI32(uint16_t tag, int32_t v)
+{
+    // Zigzag, so small negative numbers stay short too
+    putU32(tag, (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31));
+}
+
+void StateSnapshot::Writer::putF32(uint16_t tag, float v)
+{
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    uint8_t b[4];
+    put_le32(b, bits);
+    putField(tag, b, sizeof(b));
+}
+
+void StateSnapshot::Writer::putBool(uint16_t tag, bool v)
+{
+    const uint8_t b = v ? 1 : 0;
+    putField(tag, &b, 1);
+}
+
+void StateSnapshot::Writer::putString(uint16_t tag, std::string_view s)
+{
+    putField(tag, s.data(), s.size());
+}
+
+size_t StateSnapshot::Writer::beginRecord(uint16_t tag)
+{
+    // One length byte for now; endRecord() makes room if it needs more
+    putField(tag, nullptr, 0);
+    return buf_.size();
+}
+
+void StateSnapshot::Writer::endRecord(size_t mark)
+{
+    uint8_t len[MAX_VARINT];
+    const size_t n = put_varint(len, static_cast<uint32_t>(buf_.size() - mark));
+    buf_.replace(mark - 1, 1, reinterpret_cast<const char*>(len), n);
+}
+
+std::string StateSnapshot::Writer::finish()
+{
+    auto* h = reinterpret_cast<uint8_t*>(&buf_[0]);
+    const size_t len = buf_.size() - HEADER_SIZE;
+    memcpy(h, MAGIC, sizeof(MAGIC));
+    put_le16(h + 4, VERSION);
+    put_le16(h + 6, VERSION);   // minVersion
+    put_le32(h + 12, static_cast<uint32_t>(len));
+    put_le32(h + 16, crc32(h + HEADER_SIZE, len));
+    return std::move(buf_);
+}
+
+/* ── Reader ──────────────────────────────────────────────────────────── */
+
+uint32_t StateSnapshot::Field::u32(uint32_t def) const
+{
+    size_t pos = 0;
+    uint32_t v;
+    return get_varint(value, pos, v) && pos == value.size() ? v : def;
+}
+
+int32_t StateSnapshot::Field::i32(int32_t def) const
+{
+    size_t pos = 0;
+    uint32_t v;
+    if (!get_varint(value, pos, v) || pos != value.size()) return def;
+    return static_cast<int32_t>((v >> 1) ^ (0u - (v & 1)));
+}
+
+float StateSnapshot::Field::f32(float def) const
+{
+    if (value.size() != 4) return def;
+    const uint32_t bits = get_le32(value.data());
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+bool StateSnapshot::Field::boolean(bool def) const
+{
+    return value.size() == 1 ? value[0] != 0 : def;
+}
+
+StateSnapshot::Reader StateSnapshot::Field::record() const
+{
+    return Reader(value);
+}
+
+bool StateSnapshot::Reader::next(Field& f)
+{
+    size_t pos = pos_;
+    uint32_t tag, len;
+    if (!get_varint(data_, pos, tag) || !get_varint(data_, pos, len) || tag > 0xFFFF ||
+        len > data_.size() - pos) {
+        pos_ = data_.size();
+        return false;
+    }
+    f.tag   = static_cast<uint16_t>(tag);
+    f.value = data_.substr(pos, len);
+    pos_ = pos + len;
+    return true;
+}
+
+bool StateSnapshot::isSnapshot(std::string_view data)
+{
+    return data.size() >= sizeof(MAGIC) && memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool StateSnapshot::open(std::string_view data, Kind kind, Reader& out)
+{
+    if (data.size() < HEADER_SIZE || !isSnapshot(data)) return false;
+
+    const uint16_t minVersion = get_le16(data.data() + 6);
+    const uint32_t len        = get_le32(data.data() + 12);
+    const uint32_t crc        = get_le32(data.data() + 16);
+    if (static_cast<uint8_t>(data[8]) != static_cast<uint8_t>(kind)) return false;
+    if (minVersion > VERSION) {
+        printf("[Snapshot] Written by a newer version (needs v%u, this is v%u)\n", minVersion, VERSION);
+        return false;
+    }
+    if (len != data.size() - HEADER_SIZE) return false;
+
+    std::string_view payload = data.substr(HEADER_SIZE);
+    if (crc32(reinterpret_cast<const uint8_t*>(payload.data()), payload.size()) != crc) {
+        printf("[Snapshot] CRC mismatch\n");
+        return false;
+    }
+    out = Reader(payload);
+    return true;
+}
+
+/* ── Files ───────────────────────────────────────────────────────────── */
+
+bool StateSnapshot::readFile(const std::string& path, std::string& data)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    const long size = ok ? ftell(f) : -1;
+    ok = size >= 0 && fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        data.resize(static_cast<size_t>(size));
+        ok = fread(&data[0], 1, data.size(), f) == data.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+bool StateSnapshot::readNewest(const std::string& stem, const ParseFn& parse, std::string* path)
+{
+    const std::string json = stem + extension(false);
+    const std::string bin  = stem + extension(true);
+
+    std::error_code ecJson, ecBin;
+    const auto tJson = std::filesystem::last_write_time(json, ecJson);
+    const auto tBin  = std::filesystem::last_write_time(bin, ecBin);
+    if (path) path->clear();
+    if (ecJson && ecBin) return false;
+
+    // Newest first; the other one only if it exists too
+    const bool binFirst = ecJson || (!ecBin && tBin >= tJson);
+    const std::string* order[2] = { binFirst ? &bin : &json, binFirst ? &json : &bin };
+    const int count = (ecJson || ecBin) ? 1 : 2;
+
+    std::string data;
+    for (int i = 0; i < count; i++) {
+        if (readFile(*order[i], data) && parse(data)) {
+            if (path) *path = *order[i];
+            return true;
+        }
+        if (i + 1 < count) printf("[Snapshot] Could not load %s, trying %s\n", order[i]->c_str(), order[i + 1]->c_str());
+    }
+    if (path) *path = *order[0];
+    return false;
+}
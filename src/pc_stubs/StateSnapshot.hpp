@@ -0,0 +1,125 @@
+#pragma once
+
+/**
+ * @file StateSnapshot.hpp
+ * @brief Compact binary format for the simulator's state files.
+ *
+ * An alternative to the pretty-printed JSON of preferences, mixer state and
+ * device preferences (--state-format=binary). JSON stays the default and
+ * is always readable: loaders look at the content, not the extension, and
+ * take whichever of <stem>.json / <stem>.bin was written last, so switching
+ * the format back and forth imports the newer file. If the newer one does
+ * not load (CRC or parse error), the older one is used instead.
+ *
+ * Layout (little-endian):
+ *
+ *   "CPSN" | version u16 | minVersion u16 | kind u8 | 0 0 0 | length u32 | crc32 u32
+ *   payload: length bytes of fields, tag varint | size varint | value
+ *
+ * Values are integers (LEB128 varints, zigzag for i32), f32 (4 bytes),
+ * bool (1 byte), strings (raw bytes) or records (nested fields), so a
+ * typical field costs two bytes of framing. Readers skip tags they do not
+ * know and keep defaults for missing ones, so adding a field does not need
+ * a new version.
+ * minVersion is the oldest reader that can still load the file; bump it
+ * only when the meaning of an existing tag changes.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class StateSnapshot {
+public:
+    static constexpr uint16_t VERSION     = 1;
+    static constexpr size_t   HEADER_SIZE = 20;
+
+    enum class Kind : uint8_t {
+        Settings = 1,
+        Mixer    = 2,
+        Devices  = 3,
+    };
+
+    // ── Encoding ──
+
+    class Writer {
+    public:
+        explicit Writer(Kind kind);
+
+        void putU32(uint16_t tag, uint32_t v);
+        void putI32(uint16_t tag, int32_t v);
+        void putF32(uint16_t tag, float v);
+        void putBool(uint16_t tag, bool v);
+        void putString(uint16_t tag, std::string_view s);
+
+        /// Fields put until endRecord() form the value of @p tag.
+        size_t beginRecord(uint16_t tag);
+        void   endRecord(size_t mark);
+
+        /// Fill in the header and hand out the file contents.
+        std::string finish();
+
+    private:
+        void putField(uint16_t tag, const void* data, size_t len);
+
+        std::string buf_;
+    };
+
+    // ── Decoding ──
+
+    class Reader;
+
+    struct Field {
+        uint16_t tag = 0;
+        std::string_view value;
+
+        uint32_t u32(uint32_t def = 0) const;
+        int32_t  i32(int32_t def = 0) const;
+        float    f32(float def = 0.0f) const;
+        bool     boolean(bool def = false) const;
+        std::string_view str() const { return value; }
+        Reader   record() const;
+    };
+
+    class Reader {
+    public:
+        Reader() = default;
+        explicit Reader(std::string_view fields) : data_(fields) {}
+
+        /// Next field, or false at the end (or on a truncated field).
+        bool next(Field& f);
+
+    private:
+        std::string_view data_;
+        size_t pos_ = 0;
+    };
+
+    /// Check header, kind, version and CRC of @p data.
+    /// @return a reader over the payload (which points into @p data)
+    static bool open(std::string_view data, Kind kind, Reader& out);
+
+    /// Whether @p data starts like a snapshot (as opposed to JSON text).
+    static bool isSnapshot(std::string_view data);
+
+    // ── Files ──
+
+    /// ".bin" or ".json"
+    static const char* extension(bool binary) { return binary ? ".bin" : ".json"; }
+
+    /// Read a whole file with one read.
+    static bool readFile(const std::string& path, std::string& data);
+
+    /// Parses one file's content; false if it is corrupt or unreadable.
+    using ParseFn = std::function<bool(const std::string& data)>;
+
+    /// Load <stem>.json or <stem>.bin, whichever was written last, falling
+    /// back to the other one if @p parse rejects it.
+    /// @param path  receives the file that was loaded, or on failure the
+    ///              newest one tried ("" if neither exists) (optional)
+    /// @return false if no file exists or none parsed
+    static bool readNewest(const std::string& stem, const ParseFn& parse, std::string* path = nullptr);
+
+    static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+};
@@ -19,6 +19,9 @@ void pc_platform_init(void);
 #ifdef __cplusplus
 }
 
+#include <cstdint>
+#include <string>
+
 namespace crosspad { class IAudioOutput; }
 namespace crosspad { class IAudioInput; }
 namespace crosspad { class ISynthEngine; }
@@ -44,25 +47,30 @@ crosspad::ISynthEngine* pc_platform_get_synth_engine();
 /// Initialize PC HTTP client (WinHTTP on Windows, no-op on other platforms)
 void pc_http_client_init();
 
-/// Save current CrosspadSettings to ~/.crosspad/preferences.json
+/// Save current CrosspadSettings to ~/.crosspad/preferences.json (written
+/// in the background shortly after)
 void pc_platform_save_settings();
 
+/// Wait until all saved state (settings, mixer, device preferences) is on
+/// disk. Call before _exit().
+void pc_platform_sync_state();
+
 /// Read whether auto-update check is enabled (default: true)
 bool pc_platform_get_auto_check_updates();
 
-/// Set whether auto-update check is enabled (persisted immediately)
+/// Set whether auto-update check is enabled (persisted)
 void pc_platform_set_auto_check_updates(bool enabled);
 
 /// Read whether pre-releases should be shown (default: false)
 bool pc_platform_get_show_prereleases();
 
-/// Set whether pre-releases should be shown (persisted immediately)
+/// Set whether pre-releases should be shown (persisted)
 void pc_platform_set_show_prereleases(bool enabled);
 
 /// Read whether USB/UART auto-connect is enabled (default: true)
 bool pc_platform_get_usb_autoconnect();
 
-/// Set whether USB/UART auto-connect is enabled (persisted immediately)
+/// Set whether USB/UART auto-connect is enabled (persisted)
 void pc_platform_set_usb_autoconnect(bool enabled);
 
 /// Get user profile directory path (~/.crosspad)
@@ -77,7 +85,8 @@ class PcAudioOutput;
 /// Get a PC audio output by index (0=OUT1, 1=OUT2). Returns nullptr if invalid.
 PcAudioOutput* pc_platform_get_audio_output(int index);
 
-/// Save the current mixer state to ~/.crosspad/mixer_state.json
+/// Save the current mixer state to ~/.crosspad/mixer_state.json (snapshot
+/// now, written in the background)
 void pc_platform_save_mixer_state();
 
 // ── Virtual SD card ──────────────────────────────────────────────────────
@@ -97,4 +106,47 @@ const std::string& pc_platform_get_sdcard_path();
 /// if SD card is not mounted or path doesn't start with "/crosspad".
 std::string pc_platform_resolve_sdcard_path(const std::string& virtualPath);
 
+// ── Runtime options (command line / environment) ─────────────────────────
+//
+// Every option also has an environment variable (CROSSPAD_HEADLESS=1|lcd,
+// CROSSPAD_REMOTE_PORT, CROSSPAD_PROFILE_DIR, CROSSPAD_PORT_FILE) so test
+// runners can start several isolated instances; the command line wins.
+
+struct PcRunOptions {
+    bool headless = false;         ///< --headless: in-memory display, no SDL window
+    bool lcdOnly  = false;         ///< --headless=lcd: render only the 320x240 LCD
+    uint16_t remotePort = 19840;   ///< --port=N: remote control TCP port, 0 = ephemeral
+    std::string profileDir;        ///< --profile-dir=PATH: "" = ~/.crosspad
+    std::string portFile;          ///< --port-file=PATH: write the bound port here
+    bool binaryState = false;      ///< --state-format=binary: save state as StateSnapshot files
+};
+
+/// Options parsed by pc_platform_parse_args() (defaults until then).
+PcRunOptions& pc_platform_options();
+
+/// Parse the simulator command line into pc_platform_options().
+void pc_platform_parse_args(int argc, char** argv);
+
+// ── Simulation clock ─────────────────────────────────────────────────────
+//
+// Single time source for LVGL ticks, IClock and IGuiPlatform::millis().
+// In real mode it follows std::chrono::steady_clock; in virtual mode it
+// stands still and only moves through pc_time_advance_us(), so tests can
+// run a long UI scenario instantly and reproducibly. Never goes backwards
+// when switching modes. Thread-safe.
+
+/// Microseconds since start-up (real or virtual).
+uint64_t pc_time_us();
+
+/// Milliseconds since start-up (real or virtual). Usable as an lv_tick cb.
+uint32_t pc_time_ms();
+
+/// Freeze (true) or resume (false) the clock.
+void pc_time_set_virtual(bool enabled);
+
+bool pc_time_is_virtual();
+
+/// Move virtual time forward. Ignored in real mode.
+void pc_time_advance_us(uint64_t us);
+
 #endif
@@ -0,0 +1,122 @@
+/**
+ * @file AudioStream.cpp
+ * @brief Tap reader/packetizer for remote audio_stream listeners (pump thread).
+ */
+
+#include "AudioStream.hpp"
+#include "ImageCodec.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace remote {
+
+void AudioStream::add(const ConnectionPtr& conn, const std::string& source,
+                      AudioBroadcastTap* tap, uint32_t packetFrames)
+{
+    remove(conn->id(), source);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Listener l;
+    l.conn         = conn;
+    l.connId       = conn->id();
+    l.source       = source;
+    l.tap          = tap;
+    l.cursor       = tap->attach();
+    l.packetFrames = std::max<uint32_t>(packetFrames, 16);
+    listeners_.push_back(std::move(l));
+
+    if (!running_) {
+        running_ = true;
+        thread_  = std::thread(&AudioStream::threadFunc, this);
+    }
+}
+
+bool AudioStream::remove(uint32_t connId, const std::string& source, Stats* out)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool found = false;
+    for (auto it = listeners_.begin(); it != listeners_.end();) {
+        if (it->connId == connId && (source.empty() || it->source == source)) {
+            if (out) {
+                out->packets       += it->stats.packets;
+                out->frames        += it->stats.frames;
+                out->droppedFrames += it->stats.droppedFrames;
+            }
+            it->tap->detach();
+            it = listeners_.erase(it);
+            found = true;
+        } else {
+            ++it;
+        }
+    }
+    return found;
+}
+
+void AudioStream::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& l : listeners_) l.tap->detach();
+        listeners_.clear();
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void AudioStream::threadFunc()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        for (auto it = listeners_.begin(); it != listeners_.end();) {
+            if (pump(*it)) {
+                ++it;
+            } else {
+                it->tap->detach();
+                it = listeners_.erase(it);
+            }
+        }
+        cv_.wait_for(lock, std::chrono::milliseconds(PUMP_INTERVAL_MS),
+                     [this] { return !running_; });
+    }
+}
+
+bool AudioStream::pump(Listener& l)
+{
+    auto conn = l.conn.lock();
+    if (!conn || !conn->isOpen()) return false;
+
+    pcm_.resize((size_t)l.packetFrames * 2);
+    while (l.tap->available(l.cursor) >= l.packetFrames) {
+        // Slow client: leave the audio in the ring; an overrun is counted
+        // as dropped frames rather than queued without bound.
+        if (conn->pendingBytes() > MAX_BACKLOG) break;
+
+        uint64_t before = l.cursor.dropped;
+        uint32_t n = l.tap->read(l.cursor, pcm_.data(), l.packetFrames);
+        if (n == 0) break;
+        l.stats.droppedFrames += l.cursor.dropped - before;
+
+        char head[192];
+        snprintf(head, sizeof(head),
+                 "{\"event\":\"audio\",\"source\":\"%s\",\"seq\":%llu,\"pos\":%llu,\"frames\":%u,"
+                 "\"rate\":%u,\"channels\":2,\"dropped\":%llu,\"data\":\"",
+                 l.source.c_str(), (unsigned long long)l.stats.packets,
+                 (unsigned long long)(l.cursor.pos - n), n, l.tap->sampleRate(),
+                 (unsigned long long)l.cursor.dropped);
+        line_ = head;
+        base64_append(line_, reinterpret_cast<const uint8_t*>(pcm_.data()),
+                      (size_t)n * 2 * sizeof(int16_t));
+        line_ += "\"}";
+        conn->pushEvent(std::move(line_));
+        line_.clear();
+
+        l.stats.packets++;
+        l.stats.frames += n;
+    }
+    return true;
+}
+
+} // namespace remote
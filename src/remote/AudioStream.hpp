@@ -0,0 +1,92 @@
+#pragma once
+
+/**
+ * @file AudioStream.hpp
+ * @brief Pushes raw PCM from mixer taps to remote listeners.
+ *
+ * Each listener owns a cursor on an AudioBroadcastTap, so any number of
+ * analyzers can follow the same or different sources without touching the
+ * mixer thread. A pump thread reads every few milliseconds and pushes one
+ * event line per packet:
+ *
+ *   {"event":"audio","source":"out1","seq":12,"pos":245760,"frames":256,
+ *    "rate":48000,"channels":2,"dropped":0,"data":"<base64 s16le>"}
+ *
+ * "seq" counts packets per listener; "pos" is the tap frame index of the
+ * first frame, so a gap between pos + frames and the next pos is audio the
+ * listener missed. "dropped" is the running total of such frames. A client
+ * that stops reading stops being fed (its backlog is capped) and the lost
+ * audio shows up in "dropped" instead of unbounded queueing.
+ */
+
+#include "RemoteServer.hpp"
+#include "audio/AudioBroadcastTap.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace remote {
+
+class AudioStream {
+public:
+    struct Stats {
+        uint64_t packets       = 0;
+        uint64_t frames        = 0;
+        uint64_t droppedFrames = 0;
+    };
+
+    AudioStream() = default;
+    ~AudioStream() { stop(); }
+
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    /**
+     * @brief Start (or restart) streaming @p source to @p conn.
+     * @param tap           tap to follow; must outlive the listener
+     * @param packetFrames  frames per event line
+     */
+    void add(const ConnectionPtr& conn, const std::string& source,
+             AudioBroadcastTap* tap, uint32_t packetFrames);
+
+    /// Stop streaming @p source ("" = every source) to @p connId.
+    /// @return false if nothing matched; @p out receives summed counters.
+    bool remove(uint32_t connId, const std::string& source, Stats* out = nullptr);
+
+    /// Drop every listener and join the pump thread.
+    void stop();
+
+private:
+    struct Listener {
+        std::weak_ptr<Connection> conn;
+        uint32_t connId;
+        std::string source;
+        AudioBroadcastTap* tap;
+        AudioBroadcastTap::Cursor cursor;
+        uint32_t packetFrames;
+        Stats    stats;
+    };
+
+    void threadFunc();
+    bool pump(Listener& l);   // false once the connection is gone
+
+    static constexpr uint32_t PUMP_INTERVAL_MS = 5;
+    static constexpr size_t   MAX_BACKLOG      = 1024 * 1024;   // bytes per connection
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool running_ = false;
+    std::vector<Listener> listeners_;
+
+    // Pump scratch, reused across packets
+    std::vector<int16_t> pcm_;
+    std::string line_;
+};
+
+} // namespace remote
@@ -0,0 +1,296 @@
+/**
+ * @file FrameStream.cpp
+ * @brief Dirty-rectangle frame encoder/distributor (worker thread).
+ */
+
+#include "FrameStream.hpp"
+#include "ImageCodec.hpp"
+#include "RemoteEvents.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "lvgl/src/libs/lz4/lz4.h"
+
+namespace remote {
+
+bool FrameStream::parseEncoding(const char* name, Encoding& out)
+{
+    if (strcmp(name, "raw") == 0)      out = Encoding::Raw;
+    else if (strcmp(name, "lz4") == 0) out = Encoding::Lz4;
+    else if (strcmp(name, "qoi") == 0) out = Encoding::Qoi;
+    else return false;
+    return true;
+}
+
+const char* FrameStream::encodingName(Encoding enc)
+{
+    switch (enc) {
+    case Encoding::Raw: return "raw";
+    case Encoding::Lz4: return "lz4";
+    case Encoding::Qoi: return "qoi";
+    }
+    return "?";
+}
+
+FrameStream::~FrameStream()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void FrameStream::startWorker()
+{
+    // mutex_ held by caller
+    if (running_) return;
+    running_ = true;
+    for (size_t i = 0; i < POOL_SIZE; i++) free_.push_back(std::make_unique<Frame>());
+    thread_ = std::thread(&FrameStream::threadFunc, this);
+}
+
+void FrameStream::addViewer(const ConnectionPtr& conn, Encoding enc, const Rect& clip)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    startWorker();
+
+    Viewer v = { conn, conn->id(), enc, clip, true, conn->eventStats().dropped, nextGen_++ };
+    auto it = std::find_if(viewers_.begin(), viewers_.end(),
+                           [&](const Viewer& x) { return x.connId == v.connId; });
+    if (it != viewers_.end()) *it = v;
+    else viewers_.push_back(v);
+
+    viewerCount_ = viewers_.size();
+    wantKey_ = true;
+}
+
+bool FrameStream::removeViewer(uint32_t connId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(viewers_.begin(), viewers_.end(),
+                           [&](const Viewer& x) { return x.connId == connId; });
+    if (it == viewers_.end()) return false;
+    viewers_.erase(it);
+    viewerCount_ = viewers_.size();
+    return true;
+}
+
+FrameStream::Stats FrameStream::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FrameStream::submit(const uint8_t* fb, int stride, int fbW, int fbH,
+                         const Rect* rects, size_t count, bool key, uint32_t timeMs)
+{
+    std::unique_ptr<Frame> frame;
+    uint32_t seq;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        seq = nextSeq_++;
+        stats_.frames++;
+        if (free_.empty()) {
+            // Encoder is behind: drop, and resync everyone with a keyframe
+            stats_.pooled++;
+            for (auto& v : viewers_) v.needKey = true;
+            wantKey_ = true;
+            return;
+        }
+        frame = std::move(free_.back());
+        free_.pop_back();
+    }
+
+    frame->seq    = seq;
+    frame->timeMs = timeMs;
+    frame->key    = key;
+    frame->rects.clear();
+    frame->offsets.clear();
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        Rect r = rects[i];
+        int x2 = std::min(r.x + r.w, fbW), y2 = std::min(r.y + r.h, fbH);
+        r.x = std::max(r.x, 0);
+        r.y = std::max(r.y, 0);
+        r.w = x2 - r.x;
+        r.h = y2 - r.y;
+        if (r.w <= 0 || r.h <= 0) continue;
+        frame->rects.push_back(r);
+        frame->offsets.push_back(total);
+        total += (size_t)r.w * r.h * 4;
+    }
+    frame->pixels.resize(total);   // capacity is kept across frames
+
+    // The only work on the LVGL thread: one memcpy per row
+    for (size_t i = 0; i < frame->rects.size(); i++) {
+        const Rect& r = frame->rects[i];
+        uint8_t* dst = frame->pixels.data() + frame->offsets[i];
+        size_t rowBytes = (size_t)r.w * 4;
+        for (int y = 0; y < r.h; y++) {
+            memcpy(dst + y * rowBytes, fb + (size_t)(r.y + y) * stride + (size_t)r.x * 4, rowBytes);
+        }
+    }
+    if (key) wantKey_ = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(frame));
+    }
+    cv_.notify_one();
+}
+
+void FrameStream::threadFunc()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+        if (!running_) break;
+
+        auto frame = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        deliver(*frame);
+        lock.lock();
+
+        free_.push_back(std::move(frame));
+    }
+}
+
+void FrameStream::deliver(Frame& frame)
+{
+    std::vector<Viewer> viewers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        viewers = viewers_;
+    }
+
+    std::string line;
+    Stats delta;
+    bool anyNeedKey = false;
+    bool resync = false;
+
+    for (auto& v : viewers) {
+        auto conn = v.conn.lock();
+        if (!conn || !conn->isOpen()) {
+            removeViewer(v.connId);
+            continue;
+        }
+
+        // A viewer that lost events must resync from a keyframe
+        uint64_t dropped = conn->eventStats().dropped;
+        if (dropped != v.lastDropped || conn->pendingBytes() > MAX_BACKLOG) {
+            v.lastDropped = dropped;
+            if (!v.needKey) resync = true;
+            v.needKey = true;
+        }
+        if (v.needKey && (!frame.key || conn->pendingBytes() > MAX_BACKLOG)) {
+            delta.skipped++;
+            anyNeedKey = true;
+            continue;
+        }
+
+        encodeFor(frame, v, line);
+        if (line.empty()) continue;   // nothing inside this viewer's clip
+        delta.bytesOut += line.size();
+        delta.sent++;
+        v.needKey = false;
+        conn->pushEvent(std::move(line));
+        line.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& v : viewers) {
+        for (auto& cur : viewers_) {
+            // Skip viewers reconfigured by addViewer() in the meantime
+            if (cur.connId != v.connId || cur.gen != v.gen) continue;
+            cur.needKey     = v.needKey;
+            cur.lastDropped = v.lastDropped;
+        }
+    }
+    stats_.sent     += delta.sent;
+    stats_.skipped  += delta.skipped;
+    stats_.bytesOut += delta.bytesOut;
+    if (anyNeedKey) wantKey_ = true;
+
+    // Newly out of sync: have the LVGL thread send a keyframe now rather
+    // than at its next timer. Viewers still backlogged retry at that pace.
+    if (resync) remote::wake();
+}
+
+void FrameStream::encodeFor(const Frame& frame, const Viewer& v, std::string& line)
+{
+    char head[160];
+    snprintf(head, sizeof(head),
+             "{\"event\":\"frame\",\"seq\":%u,\"t\":%u,\"key\":%s,\"w\":%d,\"h\":%d,\"enc\":\"%s\",\"rects\":[",
+             frame.seq, frame.timeMs, frame.key ? "true" : "false",
+             v.clip.w, v.clip.h, encodingName(v.enc));
+    line = head;
+
+    size_t emitted = 0;
+    for (size_t i = 0; i < frame.rects.size(); i++) {
+        const Rect& r = frame.rects[i];
+
+        // Clip to the viewer's region
+        int x1 = std::max(r.x, v.clip.x), y1 = std::max(r.y, v.clip.y);
+        int x2 = std::min(r.x + r.w, v.clip.x + v.clip.w);
+        int y2 = std::min(r.y + r.h, v.clip.y + v.clip.h);
+        if (x2 <= x1 || y2 <= y1) continue;
+        int w = x2 - x1, h = y2 - y1;
+
+        const uint8_t* src = frame.pixels.data() + frame.offsets[i]
+                           + ((size_t)(y1 - r.y) * r.w + (x1 - r.x)) * 4;
+        int srcStride = r.w * 4;
+        size_t rawSize = (size_t)w * h * 4;
+
+        const uint8_t* payload;
+        size_t payloadSize;
+
+        if (v.enc == Encoding::Qoi) {
+            packed_.clear();
+            qoi_encode(src, w, h, srcStride, packed_);
+            payload = packed_.data();
+            payloadSize = packed_.size();
+        } else {
+            // Tighten rows when clipped horizontally
+            if (w != r.w) {
+                tight_.resize(rawSize);
+                for (int y = 0; y < h; y++)
+                    memcpy(tight_.data() + (size_t)y * w * 4, src + (size_t)y * srcStride, (size_t)w * 4);
+                src = tight_.data();
+            }
+            if (v.enc == Encoding::Lz4) {
+                packed_.resize((size_t)LZ4_compressBound((int)rawSize));
+                int n = LZ4_compress_default((const char*)src, (char*)packed_.data(),
+                                             (int)rawSize, (int)packed_.size());
+                payload = packed_.data();
+                payloadSize = n > 0 ? (size_t)n : 0;
+            } else {
+                payload = src;
+                payloadSize = rawSize;
+            }
+        }
+
+        char rh[96];
+        snprintf(rh, sizeof(rh), "%s{\"x\":%d,\"y\":%d,\"w\":%d,\"h\":%d,\"size\":%zu,\"data\":\"",
+                 emitted ? "," : "", x1 - v.clip.x, y1 - v.clip.y, w, h, rawSize);
+        line += rh;
+        base64_append(line, payload, payloadSize);
+        line += "\"}";
+        emitted++;
+    }
+
+    // Keyframes are sent even when empty so the viewer can clear its state
+    if (!emitted && !frame.key) {
+        line.clear();
+        return;
+    }
+    line += "]}";
+}
+
+} // namespace remote
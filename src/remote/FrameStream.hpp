@@ -0,0 +1,125 @@
+#pragma once
+
+/**
+ * @file FrameStream.hpp
+ * @brief Incremental framebuffer streaming for remote viewers.
+ *
+ * The LVGL thread hands over the areas flushed in each frame; they are
+ * memcpy'd into a pooled frame and encoded (raw / LZ4 / QOI) on a worker
+ * thread, then pushed to every viewer as one event line:
+ *
+ *   {"event":"frame","seq":12,"t":4711,"key":false,"w":320,"h":240,
+ *    "enc":"lz4","rects":[{"x":0,"y":0,"w":64,"h":20,"size":5120,"data":"..."}]}
+ *
+ * Rect coordinates are relative to the viewer's clip region; pixels are
+ * BGRA8888, rows tightly packed ("size" is the decoded byte count).
+ * A viewer that falls behind skips frames and then receives a keyframe
+ * covering its whole region, so it never has to replay deltas.
+ */
+
+#include "RemoteServer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace remote {
+
+struct Rect {
+    int x, y, w, h;
+};
+
+class FrameStream {
+public:
+    enum class Encoding : uint8_t { Raw, Lz4, Qoi };
+
+    static bool        parseEncoding(const char* name, Encoding& out);
+    static const char* encodingName(Encoding enc);
+
+    struct Stats {
+        uint64_t frames   = 0;  ///< frames submitted by the LVGL thread
+        uint64_t pooled   = 0;  ///< frames dropped because the encoder was busy
+        uint64_t sent     = 0;  ///< frame events queued to viewers
+        uint64_t skipped  = 0;  ///< per-viewer skips (backlog / waiting for key)
+        uint64_t bytesOut = 0;  ///< encoded payload bytes (before base64)
+    };
+
+    FrameStream() = default;
+    ~FrameStream();
+
+    FrameStream(const FrameStream&) = delete;
+    FrameStream& operator=(const FrameStream&) = delete;
+
+    /// Add or reconfigure a viewer; it is sent a keyframe next.
+    void addViewer(const ConnectionPtr& conn, Encoding enc, const Rect& clip);
+    bool removeViewer(uint32_t connId);
+
+    bool hasViewers() const { return viewerCount_.load(std::memory_order_relaxed) > 0; }
+
+    /// A viewer is waiting for a full frame (LVGL thread polls this).
+    bool wantsKeyframe() const { return wantKey_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Copy @p rects out of the framebuffer and queue them (LVGL thread).
+     * @param fb      framebuffer base (BGRA8888)
+     * @param stride  framebuffer row stride in bytes
+     * @param key     rects cover the whole screen
+     */
+    void submit(const uint8_t* fb, int stride, int fbW, int fbH,
+                const Rect* rects, size_t count, bool key, uint32_t timeMs);
+
+    Stats getStats() const;
+
+private:
+    struct Frame {
+        uint32_t seq = 0;
+        uint32_t timeMs = 0;
+        bool     key = false;
+        std::vector<Rect>    rects;
+        std::vector<size_t>  offsets;   // into pixels, per rect
+        std::vector<uint8_t> pixels;    // tightly packed BGRA per rect
+    };
+
+    struct Viewer {
+        std::weak_ptr<Connection> conn;
+        uint32_t connId;
+        Encoding enc;
+        Rect     clip;
+        bool     needKey;
+        uint64_t lastDropped;
+        uint32_t gen;         // bumped by addViewer()
+    };
+
+    void startWorker();
+    void threadFunc();
+    void deliver(Frame& frame);
+    void encodeFor(const Frame& frame, const Viewer& v, std::string& line);
+
+    static constexpr size_t POOL_SIZE   = 3;
+    static constexpr size_t MAX_BACKLOG = 2 * 1024 * 1024;   // bytes queued per viewer
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool running_ = false;
+
+    std::vector<std::unique_ptr<Frame>> free_;
+    std::deque<std::unique_ptr<Frame>>  queue_;
+    std::vector<Viewer> viewers_;
+    std::atomic<size_t> viewerCount_{0};
+    std::atomic<bool>   wantKey_{false};
+    uint32_t nextSeq_ = 1;
+    uint32_t nextGen_ = 1;
+    Stats    stats_;
+
+    // Worker scratch, reused across frames
+    std::vector<uint8_t> tight_;
+    std::vector<uint8_t> packed_;
+};
+
+} // namespace remote
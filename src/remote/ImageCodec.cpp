@@ -0,0 +1,215 @@
+/**
+ * @file ImageCodec.cpp
+ * @brief Base64 and QOI encoders.
+ */
+
+#include "ImageCodec.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// stb_image_write for PNG encoding (single-header, public domain)
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define STBI_WRITE_NO_STDIO
+#include "stb_image_write.h"
+
+namespace remote {
+
+/* ── Base64 ──────────────────────────────────────────────────────────── */
+
+static const char b64_table[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+void base64_append(std::string& out, const uint8_t* data, size_t len) {
+    size_t pos = out.size();
+    out.resize(pos + ((len + 2) / 3) * 4);
+    char* p = &out[pos];
+
+    size_t i = 0;
+    for (; i + 2 < len; i += 3) {
+        uint32_t n = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+        *p++ = b64_table[(n >> 18) & 0x3F];
+        *p++ = b64_table[(n >> 12) & 0x3F];
+        *p++ = b64_table[(n >> 6) & 0x3F];
+        *p++ = b64_table[n & 0x3F];
+    }
+    if (i < len) {
+        uint32_t n = (uint32_t)data[i] << 16;
+        if (i + 1 < len) n |= (uint32_t)data[i + 1] << 8;
+        *p++ = b64_table[(n >> 18) & 0x3F];
+        *p++ = b64_table[(n >> 12) & 0x3F];
+        *p++ = (i + 1 < len) ? b64_table[(n >> 6) & 0x3F] : '=';
+        *p++ = '=';
+    }
+}
+
+/* ── QOI ─────────────────────────────────────────────────────────────── */
+
+namespace {
+
+constexpr uint8_t QOI_OP_INDEX = 0x00;
+constexpr uint8_t QOI_OP_DIFF  = 0x40;
+constexpr uint8_t QOI_OP_LUMA  = 0x80;
+constexpr uint8_t QOI_OP_RUN   = 0xC0;
+constexpr uint8_t QOI_OP_RGB   = 0xFE;
+constexpr uint8_t QOI_OP_RGBA  = 0xFF;
+
+struct Rgba {
+    uint8_t r, g, b, a;
+    bool operator==(const Rgba& o) const { return r == o.r && g == o.g && b == o.b && a == o.a; }
+};
+
+inline int qoi_hash(const Rgba& c) {
+    return (c.r * 3 + c.g * 5 + c.b * 7 + c.a * 11) & 63;
+}
+
+inline void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+} // namespace
+
+void qoi_encode(const uint8_t* bgra, int w, int h, int stride, std::vector<uint8_t>& out) {
+    // Worst case: 5 bytes per pixel + header + end marker
+    size_t start = out.size();
+    out.resize(start + 14 + (size_t)w * h * 5 + 8);
+    uint8_t* p = out.data() + start;
+
+    memcpy(p, "qoif", 4);
+    put_be32(p + 4, (uint32_t)w);
+    put_be32(p + 8, (uint32_t)h);
+    p[12] = 4;   // channels
+    p[13] = 0;   // sRGB
+    p += 14;
+
+    Rgba index[64] = {};
+    Rgba prev = { 0, 0, 0, 255 };
+    int run = 0;
+
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = bgra + (size_t)y * stride;
+        for (int x = 0; x < w; x++) {
+            Rgba px = { row[x * 4 + 2], row[x * 4 + 1], row[x * 4 + 0], row[x * 4 + 3] };
+
+            if (px == prev) {
+                if (++run == 62) {
+                    *p++ = QOI_OP_RUN | (run - 1);
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                *p++ = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+
+            int hash = qoi_hash(px);
+            if (index[hash] == px) {
+                *p++ = QOI_OP_INDEX | hash;
+            } else {
+                index[hash] = px;
+                if (px.a == prev.a) {
+                    int8_t vr = (int8_t)(px.r - prev.r);
+                    int8_t vg = (int8_t)(px.g - prev.g);
+                    int8_t vb = (int8_t)(px.b - prev.b);
+                    int8_t vg_r = (int8_t)(vr - vg);
+                    int8_t vg_b = (int8_t)(vb - vg);
+
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        *p++ = QOI_OP_DIFF | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2);
+                    } else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+                        *p++ = QOI_OP_LUMA | (vg + 32);
+                        *p++ = (uint8_t)(((vg_r + 8) << 4) | (vg_b + 8));
+                    } else {
+                        *p++ = QOI_OP_RGB;
+                        *p++ = px.r;
+                        *p++ = px.g;
+                        *p++ = px.b;
+                    }
+                } else {
+                    *p++ = QOI_OP_RGBA;
+                    *p++ = px.r;
+                    *p++ = px.g;
+                    *p++ = px.b;
+                    *p++ = px.a;
+                }
+            }
+            prev = px;
+        }
+    }
+    if (run > 0) *p++ = QOI_OP_RUN | (run - 1);
+
+    static const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(p, padding, sizeof(padding));
+    p += sizeof(padding);
+
+    out.resize((size_t)(p - out.data()));
+}
+
+/* ── PNG (via stb_image_write) ───────────────────────────────────────── */
+
+static void stbi_write_cb(void* context, void* data, int size) {
+    auto* out = static_cast<std::vector<uint8_t>*>(context);
+    auto* bytes = static_cast<const uint8_t*>(data);
+    out->insert(out->end(), bytes, bytes + size);
+}
+
+// stb reads these globals on every call; set them once, before any thread
+// can encode, and never change them afterwards.
+static const bool s_pngFastInit = [] {
+    stbi_write_png_compression_level = 2;
+    stbi_write_force_png_filter = 1;   // SUB
+    return true;
+}();
+
+void png_encode(const uint8_t* bgra, int w, int h, int stride, std::vector<uint8_t>& out) {
+    (void)s_pngFastInit;
+
+    // stb_image_write expects RGB
+    thread_local std::vector<uint8_t> rgb;
+    rgb.resize((size_t)w * h * 3);
+    uint8_t* d = rgb.data();
+    for (int y = 0; y < h; y++) {
+        const uint8_t* s = bgra + (size_t)y * stride;
+        for (int x = 0; x < w; x++, s += 4, d += 3) {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+    }
+    stbi_write_png_to_func(stbi_write_cb, &out, w, h, 3, rgb.data(), w * 3);
+}
+
+/* ── Box-filter thumbnail ────────────────────────────────────────────── */
+
+void box_downscale(const uint8_t* bgra, int w, int h, int stride, int factor,
+                   std::vector<uint8_t>& out, int& outW, int& outH) {
+    // A box never exceeds the image, so the result is at least 1x1
+    factor = std::max(1, std::min(factor, std::min(w, h)));
+    outW = w / factor;
+    outH = h / factor;
+    out.resize((size_t)outW * outH * 4);
+
+    const uint32_t area = (uint32_t)(factor * factor);
+    uint8_t* d = out.data();
+    for (int oy = 0; oy < outH; oy++) {
+        for (int ox = 0; ox < outW; ox++, d += 4) {
+            uint32_t sum[4] = { 0, 0, 0, 0 };
+            for (int y = 0; y < factor; y++) {
+                const uint8_t* s = bgra + (size_t)(oy * factor + y) * stride + (size_t)ox * factor * 4;
+                for (int x = 0; x < factor; x++, s += 4) {
+                    sum[0] += s[0];
+                    sum[1] += s[1];
+                    sum[2] += s[2];
+                    sum[3] += s[3];
+                }
+            }
+            for (int c = 0; c < 4; c++) d[c] = (uint8_t)((sum[c] + area / 2) / area);
+        }
+    }
+}
+
+} // namespace remote
@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * @file ImageCodec.hpp
+ * @brief Small image/text encoders shared by screenshot and frame streaming.
+ *
+ * Pixel input is BGRA8888 (LVGL ARGB8888 / SDL_PIXELFORMAT_ARGB8888 on
+ * little-endian), with an explicit row stride in bytes. Encoders append to
+ * the output container so callers can reuse buffers across frames.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace remote {
+
+/// Append the base64 encoding of @p data to @p out.
+void base64_append(std::string& out, const uint8_t* data, size_t len);
+
+inline std::string base64_encode(const uint8_t* data, size_t len) {
+    std::string out;
+    base64_append(out, data, len);
+    return out;
+}
+
+/**
+ * @brief Encode BGRA pixels as QOI (https://qoiformat.org), RGBA channels.
+ *
+ * QOI is a single-pass, table-free codec: several times faster than PNG at
+ * a comparable size for UI content, which makes it suitable per-frame.
+ */
+void qoi_encode(const uint8_t* bgra, int w, int h, int stride, std::vector<uint8_t>& out);
+
+/**
+ * @brief Encode BGRA pixels as a 24-bit PNG with speed-oriented settings.
+ *
+ * Uses zlib level 2 and a fixed SUB filter instead of stb's per-row filter
+ * search — several times faster than the defaults for a slightly larger file.
+ */
+void png_encode(const uint8_t* bgra, int w, int h, int stride, std::vector<uint8_t>& out);
+
+/**
+ * @brief Downscale by an integer @p factor, averaging each factor×factor box.
+ *
+ * Output is tightly packed BGRA of (w / factor) × (h / factor); trailing
+ * rows/columns that do not fill a whole box are dropped. @p factor is
+ * clamped to [1, min(w, h)], so a non-empty image never yields 0×0.
+ */
+void box_downscale(const uint8_t* bgra, int w, int h, int stride, int factor,
+                   std::vector<uint8_t>& out, int& outW, int& outH);
+
+} // namespace remote
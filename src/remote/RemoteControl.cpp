@@ -9,20 +9,16 @@
 #include <cstring>
 #include <string>
 #include <vector>
-#include <queue>
+#include <memory>
 #include <mutex>
-#include <thread>
-#include <atomic>
 #include <functional>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
 
-// SDL2 for framebuffer capture and event injection
+// SDL2 for event injection
 #include <SDL2/SDL.h>
 
-// stb_image_write for PNG encoding (single-header, public domain)
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#define STBI_WRITE_NO_STDIO
-#include "stb_image_write.h"
-
 // LVGL SDL driver internals — window/renderer access
 #include "lvgl/src/drivers/sdl/lv_sdl_window.h"
 
@@ -36,217 +32,293 @@
 #include "pc_stubs/pc_platform.h"
 #include "crosspad-gui/platform/IGuiPlatform.h"
 
-// Winsock for TCP server
-#ifdef _WIN32
-#  ifndef WIN32_LEAN_AND_MEAN
-#    define WIN32_LEAN_AND_MEAN
-#  endif
-#  include <winsock2.h>
-#  include <ws2tcpip.h>
-#  pragma comment(lib, "ws2_32.lib")
-   typedef SOCKET socket_t;
-#  define CLOSE_SOCKET closesocket
-#  define SOCKET_INVALID INVALID_SOCKET
-#else
-#  include <sys/socket.h>
-#  include <netinet/in.h>
-#  include <unistd.h>
-   typedef int socket_t;
-#  define CLOSE_SOCKET close
-#  define SOCKET_INVALID (-1)
+#include "RemoteServer.hpp"
+#include "RemoteEvents.hpp"
+#include "FrameStream.hpp"
+#include "WidgetQuery.hpp"
+#include "ImageCodec.hpp"
+#include "WorkQueue.hpp"
+#include "SharedMemory.hpp"
+#include "AudioStream.hpp"
+
+#include "stm32_emu/Stm32EmuWindow.hpp"
+#include "crosspad_app.hpp"
+#include "uart/Telemetry.hpp"
+#include "hal/hal.h"
+
+#ifdef USE_AUDIO
+#include "apps/mixer/AudioMixerEngine.hpp"
 #endif
 
-/* ── Base64 encoder ──────────────────────────────────────────────────── */
-
-static const char b64_table[] =
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-static std::string base64_encode(const uint8_t* data, size_t len) {
-    std::string out;
-    out.reserve(((len + 2) / 3) * 4);
-    for (size_t i = 0; i < len; i += 3) {
-        uint32_t n = (uint32_t)data[i] << 16;
-        if (i + 1 < len) n |= (uint32_t)data[i + 1] << 8;
-        if (i + 2 < len) n |= (uint32_t)data[i + 2];
-        out.push_back(b64_table[(n >> 18) & 0x3F]);
-        out.push_back(b64_table[(n >> 12) & 0x3F]);
-        out.push_back((i + 1 < len) ? b64_table[(n >> 6) & 0x3F] : '=');
-        out.push_back((i + 2 < len) ? b64_table[n & 0x3F] : '=');
-    }
-    return out;
-}
-
-/* ── Simple JSON helpers (no dependency) ─────────────────────────────── */
+#ifdef USE_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
 
-static std::string json_string(const std::string& key, const std::string& val) {
-    return "\"" + key + "\":\"" + val + "\"";
-}
+#include <ArduinoJson.h>
 
-static std::string json_bool(const std::string& key, bool val) {
-    return "\"" + key + "\":" + (val ? "true" : "false");
-}
+/* ── JSON response helpers ────────────────────────────────────────────── */
 
-static std::string json_int(const std::string& key, int val) {
-    return "\"" + key + "\":" + std::to_string(val);
+static void reply_ok(JsonObject resp) {
+    resp["ok"] = true;
 }
 
-/// Extract a string value for a key from a JSON-like string (very simple parser)
-static std::string json_get_string(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\"";
-    auto pos = json.find(search);
-    if (pos == std::string::npos) return "";
-    pos = json.find(':', pos + search.size());
-    if (pos == std::string::npos) return "";
-    pos = json.find('"', pos + 1);
-    if (pos == std::string::npos) return "";
-    auto end = json.find('"', pos + 1);
-    if (end == std::string::npos) return "";
-    return json.substr(pos + 1, end - pos - 1);
+static void reply_error(JsonObject resp, const char* error) {
+    resp["ok"] = false;
+    resp["error"] = error;
 }
 
-/// Extract an int value for a key from a JSON-like string
-static int json_get_int(const std::string& json, const std::string& key, int dflt = 0) {
-    std::string search = "\"" + key + "\"";
-    auto pos = json.find(search);
-    if (pos == std::string::npos) return dflt;
-    pos = json.find(':', pos + search.size());
-    if (pos == std::string::npos) return dflt;
-    // Skip whitespace
-    pos++;
-    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    try { return std::stoi(json.substr(pos)); } catch (...) { return dflt; }
+static void reply_error(JsonObject resp, const std::string& error) {
+    resp["ok"] = false;
+    resp["error"] = error;
 }
 
-/* ── PNG writer (via stb_image_write) ─────────────────────────────────── */
-
-static void stbi_write_cb(void* context, void* data, int size) {
-    auto* out = static_cast<std::vector<uint8_t>*>(context);
-    auto* bytes = static_cast<const uint8_t*>(data);
-    out->insert(out->end(), bytes, bytes + size);
-}
-
-/// Convert BGRA pixels (SDL_PIXELFORMAT_ARGB8888 on little-endian) to PNG.
-static std::vector<uint8_t> pixels_to_png(const uint8_t* bgra, int w, int h) {
-    // Convert BGRA → RGB for stb_image_write (which expects RGB)
-    std::vector<uint8_t> rgb(w * h * 3);
-    for (int i = 0; i < w * h; i++) {
-        rgb[i * 3 + 0] = bgra[i * 4 + 2]; // R
-        rgb[i * 3 + 1] = bgra[i * 4 + 1]; // G
-        rgb[i * 3 + 2] = bgra[i * 4 + 0]; // B
-    }
-
-    std::vector<uint8_t> png;
-    png.reserve(w * h); // rough estimate
-    stbi_write_png_to_func(stbi_write_cb, &png, w, h, 3, rgb.data(), w * 3);
-    return png;
+/// Read an int that may also be sent as a JSON bool (settings toggles)
+static int json_int_or_bool(JsonVariantConst v, int dflt) {
+    if (v.is<bool>()) return v.as<bool>() ? 1 : 0;
+    return v | dflt;
 }
 
 /* ── State ───────────────────────────────────────────────────────────── */
 
-static constexpr uint16_t PORT = 19840;
-
 static lv_display_t* s_disp = nullptr;
-static std::thread s_serverThread;
-static std::atomic<bool> s_running{false};
-static socket_t s_listenSocket = SOCKET_INVALID;
+static remote::Server s_server;
+static remote::SharedMemory s_shm;
 
-// Command queue: commands are received on TCP thread, executed on LVGL thread
+// Command queue: requests are parsed on the server thread and executed on
+// the LVGL thread. Each carries its own completion — the responder writes
+// the reply straight to the originating connection, so any number of
+// requests (from any number of clients) can be in flight at once.
 struct PendingCommand {
-    std::string request;
+    JsonDocument request;
+    std::weak_ptr<remote::Connection> conn;
     std::function<void(const std::string&)> respond;
 };
 
 static std::mutex s_queueMutex;
-static std::queue<PendingCommand> s_commandQueue;
+static std::vector<PendingCommand> s_commandQueue;
+
+// Reused on the LVGL thread for every response (keeps its capacity)
+static JsonDocument s_respDoc;
+static std::string s_respBuf;
+
+// Replies finished from inside another command (wait_for/play_macro
+// completing during step) must not reuse the in-flight response.
+static JsonDocument s_lateDoc;
+static std::string s_lateBuf;
 
-// Response storage for synchronous command processing
-static std::mutex s_responseMutex;
-static std::string s_pendingResponse;
-static bool s_responseReady = false;
+// Command currently being dispatched by process_pending(). Handlers that
+// reply later (wait_for) take over its responder and set s_replyDeferred.
+static PendingCommand* s_dispatching = nullptr;
+static bool s_replyDeferred = false;
+static bool s_inBatch = false;
+
+static void fill_subscription_stats(JsonObject resp);
 
 /* ── Command handlers (run on LVGL thread) ───────────────────────────── */
 
-static std::string handle_screenshot(const std::string& json = "") {
-    if (!s_disp) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "no display") + "}";
+/// Resolve the "region" request field: "lcd", {"x","y","w","h"} or
+/// absent/"full" for the whole window. Clamped to the screen.
+/// @return nullptr on success, otherwise an error string
+static const char* resolve_region(JsonVariantConst region, remote::Rect& rect) {
+    if (!s_disp) return "no display";
+    int scrW = lv_display_get_horizontal_resolution(s_disp);
+    int scrH = lv_display_get_vertical_resolution(s_disp);
+
+    rect = { 0, 0, scrW, scrH };
+    if (region.is<JsonObjectConst>()) {
+        rect = { region["x"] | 0, region["y"] | 0, region["w"] | 0, region["h"] | 0 };
+    } else {
+        const char* name = region | "full";
+        if (strcmp(name, "lcd") == 0) {
+            rect = { Stm32EmuWindow::lcdX(), Stm32EmuWindow::lcdY(),
+                     Stm32EmuWindow::LCD_W, Stm32EmuWindow::LCD_H };
+        } else if (strcmp(name, "full") != 0) {
+            return "unknown region (lcd, full or {x,y,w,h})";
+        }
     }
 
-    SDL_Window* window = lv_sdl_window_get_window(s_disp);
-    SDL_Renderer* renderer = (SDL_Renderer*)lv_sdl_window_get_renderer(s_disp);
-    if (!window || !renderer) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "no SDL window/renderer") + "}";
-    }
-
-    // Check if "lcd_only" region requested
-    std::string region = json_get_string(json, "region");
-    bool lcdOnly = (region == "lcd");
-
-    int w, h;
-    SDL_Rect* captureRect = nullptr;
-    SDL_Rect lcdRect;
-
-    if (lcdOnly) {
-        // LCD position within the window (must match Stm32EmuWindow layout)
-        static constexpr int LCD_W = 320;
-        static constexpr int LCD_H = 240;
-        static constexpr int WIN_W = 490;
-        static constexpr int LCD_X = (WIN_W - LCD_W) / 2; // 85
-        static constexpr int LCD_Y = 40;
-
-        lcdRect = { LCD_X, LCD_Y, LCD_W, LCD_H };
-        captureRect = &lcdRect;
-        w = LCD_W;
-        h = LCD_H;
-    } else {
-        SDL_GetWindowSize(window, &w, &h);
+    int x2 = std::min(rect.x + rect.w, scrW), y2 = std::min(rect.y + rect.h, scrH);
+    rect.x = std::max(rect.x, 0);
+    rect.y = std::max(rect.y, 0);
+    rect.w = x2 - rect.x;
+    rect.h = y2 - rect.y;
+    if (rect.w <= 0 || rect.h <= 0) return "empty region";
+    return nullptr;
+}
+
+/// The rendered frame. DIRECT render mode: the active draw buffer always
+/// holds the whole screen, so captures never need an SDL readback.
+static const lv_draw_buf_t* framebuffer() {
+    return s_disp ? lv_display_get_buf_active(s_disp) : nullptr;
+}
+
+/// Copy @p r out of the framebuffer as tightly packed BGRA rows.
+static bool copy_framebuffer(const remote::Rect& r, uint8_t* dst) {
+    const lv_draw_buf_t* fb = framebuffer();
+    if (!fb || !fb->data) return false;
+
+    size_t rowBytes = (size_t)r.w * 4;
+    const uint8_t* src = fb->data + (size_t)r.y * fb->header.stride + (size_t)r.x * 4;
+    for (int y = 0; y < r.h; y++) {
+        memcpy(dst + y * rowBytes, src, rowBytes);
+        src += fb->header.stride;
     }
+    return true;
+}
+
+/* ── Screenshot ─────────────────────────────────────────────────────── */
 
-    // ARGB8888: on little-endian memory layout is [B, G, R, A] per pixel.
-    std::vector<uint8_t> pixels(w * h * 4);
-    if (SDL_RenderReadPixels(renderer, captureRect, SDL_PIXELFORMAT_ARGB8888,
-                             pixels.data(), w * 4) != 0) {
-        return "{" + json_bool("ok", false) + "," +
-               json_string("error", SDL_GetError()) + "}";
+enum class ShotFormat { Png, Raw, Qoi, Thumb };
+
+struct ShotJob {
+    remote::BufferPool::Buffer pixels;   // tight BGRA, w*h*4
+    int         w = 0;
+    int         h = 0;
+    ShotFormat  format = ShotFormat::Png;
+    int         scale = 4;               // thumbnail box size
+    std::string file;
+};
+
+static remote::WorkQueue  s_encoder;
+static remote::BufferPool s_shotPool;
+
+static const char* shot_format_name(ShotFormat f) {
+    switch (f) {
+    case ShotFormat::Png:   return "png";
+    case ShotFormat::Raw:   return "bgra8888";
+    case ShotFormat::Qoi:   return "qoi";
+    case ShotFormat::Thumb: return "png";
     }
+    return "?";
+}
 
-    // Encode to PNG
-    auto png = pixels_to_png(pixels.data(), w, h);
+/// Encode @p job into @p bytes and fill the metadata fields of @p resp.
+/// Runs on the encoder worker (or the LVGL thread inside batch).
+static bool encode_shot(const ShotJob& job, JsonObject resp, std::vector<uint8_t>& bytes) {
+    const uint8_t* px = job.pixels->data();
+    int w = job.w, h = job.h;
+
+    bytes.clear();
+    switch (job.format) {
+    case ShotFormat::Png:
+        remote::png_encode(px, w, h, w * 4, bytes);
+        break;
+    case ShotFormat::Raw:
+        bytes.assign(px, px + (size_t)w * h * 4);
+        break;
+    case ShotFormat::Qoi:
+        remote::qoi_encode(px, w, h, w * 4, bytes);
+        break;
+    case ShotFormat::Thumb: {
+        thread_local std::vector<uint8_t> small;
+        remote::box_downscale(px, w, h, w * 4, job.scale, small, w, h);
+        remote::png_encode(small.data(), w, h, w * 4, bytes);
+        break;
+    }
+    }
 
-    // Check if caller wants to save to file
-    std::string filePath = json_get_string(json, "file");
-    if (!filePath.empty()) {
-        FILE* f = fopen(filePath.c_str(), "wb");
-        if (f) {
-            fwrite(png.data(), 1, png.size(), f);
-            fclose(f);
-            return "{" + json_bool("ok", true) + "," +
-                   json_int("width", w) + "," +
-                   json_int("height", h) + "," +
-                   json_string("format", "png") + "," +
-                   json_string("file", filePath) + "," +
-                   json_int("size", (int)png.size()) + "}";
-        } else {
-            return "{" + json_bool("ok", false) + "," +
-                   json_string("error", "cannot write file: " + filePath) + "}";
+    if (!job.file.empty()) {
+        FILE* f = fopen(job.file.c_str(), "wb");
+        if (!f) {
+            reply_error(resp, "cannot write file: " + job.file);
+            return false;
         }
+        fwrite(bytes.data(), 1, bytes.size(), f);
+        fclose(f);
+    }
+
+    reply_ok(resp);
+    resp["width"]  = w;
+    resp["height"] = h;
+    resp["format"] = shot_format_name(job.format);
+    resp["size"]   = bytes.size();
+    if (!job.file.empty()) resp["file"] = job.file;
+    return true;
+}
+
+/// {"cmd":"screenshot","format":"png","region":"lcd","scale":4,"file":"..."}
+///
+/// format: png (default, fast zlib level) | raw (BGRA8888) | qoi |
+///         thumb (box-filtered 1/scale, PNG; scale capped at the region's smaller side)
+/// region: "lcd" | "full" (default) | {"x","y","w","h"}
+///
+/// The LVGL thread only copies the region into a pooled buffer; encoding and
+/// base64 run on a worker, so the reply may overtake later pipelined
+/// requests — match it by "id". Inside batch the encode runs inline.
+static void handle_screenshot(JsonObjectConst req, JsonObject resp) {
+    remote::Rect rect;
+    if (const char* err = resolve_region(req["region"], rect)) {
+        reply_error(resp, err);
+        return;
+    }
+
+    ShotJob job;
+    const char* fmt = req["format"] | "png";
+    if (strcmp(fmt, "png") == 0)        job.format = ShotFormat::Png;
+    else if (strcmp(fmt, "raw") == 0)   job.format = ShotFormat::Raw;
+    else if (strcmp(fmt, "qoi") == 0)   job.format = ShotFormat::Qoi;
+    else if (strcmp(fmt, "thumb") == 0) job.format = ShotFormat::Thumb;
+    else {
+        reply_error(resp, std::string("unknown format: ") + fmt);
+        return;
+    }
+    job.scale = std::clamp(req["scale"] | 4, 1, 16);
+    job.file  = req["file"] | "";
+    job.w = rect.w;
+    job.h = rect.h;
+
+    // The only work done on the LVGL thread
+    job.pixels = s_shotPool.acquire((size_t)rect.w * rect.h * 4);
+    if (!copy_framebuffer(rect, job.pixels->data())) {
+        reply_error(resp, "no framebuffer");
+        return;
     }
 
-    // Return inline base64 PNG (much smaller than BMP)
-    std::string b64 = base64_encode(png.data(), png.size());
+    if (!s_dispatching || s_inBatch) {
+        std::vector<uint8_t> bytes;
+        if (encode_shot(job, resp, bytes) && job.file.empty()) {
+            resp["encoding"] = "base64";
+            resp["data"]     = remote::base64_encode(bytes.data(), bytes.size());
+        }
+        return;
+    }
 
-    return "{" + json_bool("ok", true) + "," +
-           json_int("width", w) + "," +
-           json_int("height", h) + "," +
-           json_string("format", "png") + "," +
-           json_string("encoding", "base64") + "," +
-           json_string("data", b64) + "}";
+    JsonDocument id;
+    if (!req["id"].isNull()) id.set(req["id"]);
+    auto respond = std::move(s_dispatching->respond);
+    s_replyDeferred = true;
+
+    s_encoder.post([job = std::move(job), id = std::move(id), respond = std::move(respond)]() {
+        thread_local std::vector<uint8_t> bytes;
+        JsonDocument doc;
+        JsonObject meta = doc.to<JsonObject>();
+        if (!id.isNull()) meta["id"] = id.as<JsonVariantConst>();
+        bool ok = encode_shot(job, meta, bytes);
+
+        std::string line;
+        serializeJson(doc, line);
+        if (ok && job.file.empty()) {
+            // Splice the payload in directly instead of copying it through
+            // the document: {...,"encoding":"base64","data":"..."}
+            line.pop_back();
+            line.reserve(line.size() + (bytes.size() + 2) / 3 * 4 + 40);
+            line += ",\"encoding\":\"base64\",\"data\":\"";
+            remote::base64_append(line, bytes.data(), bytes.size());
+            line += "\"}";
+        }
+        if (respond) respond(line);
+    });
 }
 
-static std::string handle_click(const std::string& json) {
-    int x = json_get_int(json, "x", -1);
-    int y = json_get_int(json, "y", -1);
-    if (x < 0 || y < 0) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "missing x/y") + "}";
+/* ── Input injection (shared by the input commands and play_macro) ───── */
+
+static void inject_click(int x, int y) {
+    if (hal_is_headless()) {
+        // Virtual pointer: press + release, processed right away
+        headless_pointer_input(x, y, true);
+        headless_pointer_input(x, y, false);
+        return;
     }
 
     // Get window ID
@@ -281,31 +353,16 @@ static std::string handle_click(const std::string& json) {
     ev.button.y = y;
     ev.button.clicks = 1;
     SDL_PushEvent(&ev);
-
-    return "{" + json_bool("ok", true) + "," + json_int("x", x) + "," + json_int("y", y) + "}";
-}
-
-static std::string handle_pad_press(const std::string& json) {
-    int pad = json_get_int(json, "pad", -1);
-    int vel = json_get_int(json, "velocity", 127);
-    if (pad < 0 || pad > 15) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "invalid pad (0-15)") + "}";
-    }
-    crosspad::getPadManager().handlePadPress(pad, vel);
-    return "{" + json_bool("ok", true) + "," + json_int("pad", pad) + "," + json_int("velocity", vel) + "}";
 }
 
-static std::string handle_pad_release(const std::string& json) {
-    int pad = json_get_int(json, "pad", -1);
-    if (pad < 0 || pad > 15) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "invalid pad (0-15)") + "}";
+static void inject_encoder_rotate(int delta) {
+    if (hal_is_headless()) {
+        // Same two consumers as the SDL wheel: device encoder + LVGL group
+        crosspad_app_get_emu_window().handleEncoderWheel(delta);
+        headless_encoder_rotate(delta);
+        return;
     }
-    crosspad::getPadManager().handlePadRelease(pad);
-    return "{" + json_bool("ok", true) + "," + json_int("pad", pad) + "}";
-}
 
-static std::string handle_encoder_rotate(const std::string& json) {
-    int delta = json_get_int(json, "delta", 0);
     SDL_Window* window = lv_sdl_window_get_window(s_disp);
     Uint32 windowId = SDL_GetWindowID(window);
 
@@ -314,11 +371,15 @@ static std::string handle_encoder_rotate(const std::string& json) {
     ev.wheel.windowID = windowId;
     ev.wheel.y = delta;
     SDL_PushEvent(&ev);
-
-    return "{" + json_bool("ok", true) + "," + json_int("delta", delta) + "}";
 }
 
-static std::string handle_encoder_press(bool pressed) {
+static void inject_encoder_button(bool pressed) {
+    if (hal_is_headless()) {
+        crosspad_app_get_emu_window().handleEncoderPress(pressed);
+        headless_encoder_button(pressed);
+        return;
+    }
+
     SDL_Window* window = lv_sdl_window_get_window(s_disp);
     Uint32 windowId = SDL_GetWindowID(window);
 
@@ -330,14 +391,41 @@ static std::string handle_encoder_press(bool pressed) {
     ev.button.x = 0;
     ev.button.y = 0;
     SDL_PushEvent(&ev);
+}
 
-    return "{" + json_bool("ok", true) + "}";
+/// SDL keycode → LVGL key, mirroring the SDL keyboard driver.
+static uint32_t sdl_key_to_lv(int keycode) {
+    switch (keycode) {
+    case SDLK_RIGHT:     return LV_KEY_RIGHT;
+    case SDLK_LEFT:      return LV_KEY_LEFT;
+    case SDLK_UP:        return LV_KEY_UP;
+    case SDLK_DOWN:      return LV_KEY_DOWN;
+    case SDLK_ESCAPE:    return LV_KEY_ESC;
+    case SDLK_BACKSPACE: return LV_KEY_BACKSPACE;
+    case SDLK_DELETE:    return LV_KEY_DEL;
+    case SDLK_KP_ENTER:
+    case SDLK_RETURN:    return LV_KEY_ENTER;
+    case SDLK_TAB:       return LV_KEY_NEXT;
+    case SDLK_PAGEDOWN:  return LV_KEY_NEXT;
+    case SDLK_PAGEUP:    return LV_KEY_PREV;
+    case SDLK_HOME:      return LV_KEY_HOME;
+    case SDLK_END:       return LV_KEY_END;
+    default:             return (uint32_t)keycode;
+    }
 }
 
-static std::string handle_key(const std::string& json) {
-    int keycode = json_get_int(json, "keycode", 0);
-    if (keycode == 0) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "missing keycode") + "}";
+static void inject_key(int keycode) {
+    if (hal_is_headless()) {
+        // Keyboard capture first (pad keys), like the SDL event watcher
+        auto& kb = crosspad_app_get_emu_window().getKeyboardCapture();
+        if (!kb.handleKey(keycode, true, false)) {
+            uint32_t key = sdl_key_to_lv(keycode);
+            headless_key_input(key, true);
+            headless_key_input(key, false);
+        } else {
+            kb.handleKey(keycode, false, false);
+        }
+        return;
     }
 
     SDL_Window* window = lv_sdl_window_get_window(s_disp);
@@ -353,221 +441,353 @@ static std::string handle_key(const std::string& json) {
     ev.type = SDL_KEYUP;
     ev.key.state = SDL_RELEASED;
     SDL_PushEvent(&ev);
+}
+
+static void inject_pad(int pad, int velocity, bool pressed) {
+    if (pressed) crosspad::getPadManager().handlePadPress(pad, velocity);
+    else         crosspad::getPadManager().handlePadRelease(pad);
+    remote::notify(remote::TOPIC_PAD);
+}
+
+/* ── Input commands ──────────────────────────────────────────────────── */
+
+static void handle_click(JsonObjectConst req, JsonObject resp) {
+    int x = req["x"] | -1;
+    int y = req["y"] | -1;
+    if (x < 0 || y < 0) {
+        reply_error(resp, "missing x/y");
+        return;
+    }
+
+    inject_click(x, y);
+    reply_ok(resp);
+    resp["x"] = x;
+    resp["y"] = y;
+}
+
+static void handle_pad_press(JsonObjectConst req, JsonObject resp) {
+    int pad = req["pad"] | -1;
+    int vel = req["velocity"] | 127;
+    if (pad < 0 || pad > 15) {
+        reply_error(resp, "invalid pad (0-15)");
+        return;
+    }
+    inject_pad(pad, vel, true);
+    reply_ok(resp);
+    resp["pad"] = pad;
+    resp["velocity"] = vel;
+}
+
+static void handle_pad_release(JsonObjectConst req, JsonObject resp) {
+    int pad = req["pad"] | -1;
+    if (pad < 0 || pad > 15) {
+        reply_error(resp, "invalid pad (0-15)");
+        return;
+    }
+    inject_pad(pad, 0, false);
+    reply_ok(resp);
+    resp["pad"] = pad;
+}
 
-    return "{" + json_bool("ok", true) + "," + json_int("keycode", keycode) + "}";
+static void handle_encoder_rotate(JsonObjectConst req, JsonObject resp) {
+    int delta = req["delta"] | 0;
+    inject_encoder_rotate(delta);
+    reply_ok(resp);
+    resp["delta"] = delta;
+}
+
+static void handle_encoder_press(JsonObjectConst, JsonObject resp) {
+    inject_encoder_button(true);
+    reply_ok(resp);
+}
+
+static void handle_encoder_release(JsonObjectConst, JsonObject resp) {
+    inject_encoder_button(false);
+    reply_ok(resp);
+}
+
+static void handle_key(JsonObjectConst req, JsonObject resp) {
+    int keycode = req["keycode"] | 0;
+    if (keycode == 0) {
+        reply_error(resp, "missing keycode");
+        return;
+    }
+
+    inject_key(keycode);
+    reply_ok(resp);
+    resp["keycode"] = keycode;
+}
+
+static void handle_ping(JsonObjectConst, JsonObject resp) {
+    reply_ok(resp);
+    resp["cmd"] = "ping";
+}
+
+/* ── Render timing ────────────────────────────────────────────────────── */
+
+// Wall-clock cost of LVGL refreshes (REFR_START → REFR_READY) and flushed
+// area since the window was last reset. "stats" reports it; only a
+// "reset": true request starts a new window, so clients reading stats
+// do not cut each other's measurements short.
+struct RenderStats {
+    std::chrono::steady_clock::time_point windowStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point refrStart;
+    uint32_t refreshes = 0;
+    uint64_t totalUs   = 0;
+    uint32_t maxUs     = 0;
+    uint64_t pixels    = 0;
+};
+
+static RenderStats s_render;
+
+static void on_refr_start(lv_event_t*) {
+    s_render.refrStart = std::chrono::steady_clock::now();
+}
+
+static void render_refresh_done() {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - s_render.refrStart).count();
+    s_render.refreshes++;
+    s_render.totalUs += (uint64_t)us;
+    s_render.maxUs = std::max(s_render.maxUs, (uint32_t)us);
+}
+
+static void fill_render_stats(JsonObject resp, bool reset) {
+    auto now = std::chrono::steady_clock::now();
+    JsonObject r = resp["render"].to<JsonObject>();
+    r["window_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - s_render.windowStart).count();
+    r["refreshes"] = s_render.refreshes;
+    r["avg_us"]    = s_render.refreshes ? (uint32_t)(s_render.totalUs / s_render.refreshes) : 0;
+    r["max_us"]    = s_render.maxUs;
+    r["pixels"]    = s_render.pixels;
+
+    if (!reset) return;
+    s_render = RenderStats();
+    s_render.windowStart = now;
 }
 
 /* ── Stats handler ────────────────────────────────────────────────────── */
 
-static std::string handle_stats() {
+static void handle_stats(JsonObjectConst req, JsonObject resp) {
     auto& pm = crosspad::getPadManager();
     auto* settings = crosspad::CrosspadSettings::getInstance();
     auto& guiPlatform = crosspad_gui::getGuiPlatform();
 
-    std::string out = "{" + json_bool("ok", true);
+    reply_ok(resp);
 
     // Platform capabilities
     {
         uint32_t caps = (uint32_t)crosspad::getPlatformCapabilities();
-        out += "," + json_int("capabilities_raw", (int)caps);
+        resp["capabilities_raw"] = caps;
 
         // Readable list
-        std::string capList = "[";
-        const char* names[] = {"Midi","AudioOut","AudioIn","Synth","Pads","Leds",
-                               "Encoder","Display","Persistence","Vibration","WiFi",
-                               "Bluetooth","Usb","Imu","Stm32","Sequencer"};
-        bool first = true;
+        static const char* names[] = {"Midi","AudioOut","AudioIn","Synth","Pads","Leds",
+                                      "Encoder","Display","Persistence","Vibration","WiFi",
+                                      "Bluetooth","Usb","Imu","Stm32","Sequencer"};
+        JsonArray capList = resp["capabilities"].to<JsonArray>();
         for (int i = 0; i < 16; i++) {
-            if (caps & (1u << i)) {
-                if (!first) capList += ",";
-                capList += "\""; capList += names[i]; capList += "\"";
-                first = false;
-            }
+            if (caps & (1u << i)) capList.add(names[i]);
         }
-        capList += "]";
-        out += ",\"capabilities\":" + capList;
     }
 
     // Pad state
     {
-        std::string pads = "[";
+        JsonArray pads = resp["pads"].to<JsonArray>();
         for (int i = 0; i < 16; i++) {
-            if (i > 0) pads += ",";
             auto color = pm.getPadColor(i);
-            pads += "{";
-            pads += json_bool("pressed", pm.isPadPressed(i)) + ",";
-            pads += json_bool("playing", pm.isPadPlaying(i)) + ",";
-            pads += json_int("note", pm.getPadNote(i)) + ",";
-            pads += json_int("channel", pm.getPadChannel(i)) + ",";
-            pads += json_int("r", color.R) + ",";
-            pads += json_int("g", color.G) + ",";
-            pads += json_int("b", color.B);
-            pads += "}";
+            JsonObject p = pads.add<JsonObject>();
+            p["pressed"] = pm.isPadPressed(i);
+            p["playing"] = pm.isPadPlaying(i);
+            p["note"]    = pm.getPadNote(i);
+            p["channel"] = pm.getPadChannel(i);
+            p["r"] = color.R;
+            p["g"] = color.G;
+            p["b"] = color.B;
         }
-        pads += "]";
-        out += ",\"pads\":" + pads;
     }
 
     // Active pad logic
     {
         std::string logic = pm.getActivePadLogic();
-        out += "," + json_string("active_pad_logic", logic.empty() ? "none" : logic);
+        resp["active_pad_logic"] = logic.empty() ? std::string("none") : logic;
 
-        auto registered = pm.getRegisteredPadLogics();
-        std::string regList = "[";
-        for (size_t i = 0; i < registered.size(); i++) {
-            if (i > 0) regList += ",";
-            regList += "\"" + registered[i] + "\"";
-        }
-        regList += "]";
-        out += ",\"registered_pad_logics\":" + regList;
+        JsonArray regList = resp["registered_pad_logics"].to<JsonArray>();
+        for (const auto& name : pm.getRegisteredPadLogics()) regList.add(name);
     }
 
     // Apps
     {
         auto& reg = crosspad::AppRegistry::getInstance();
-        out += "," + json_int("app_count", (int)reg.getAppCount());
+        resp["app_count"] = (int)reg.getAppCount();
 
-        std::string appList = "[";
+        JsonArray appList = resp["apps"].to<JsonArray>();
         const auto* apps = reg.getApps();
-        for (size_t i = 0; i < reg.getAppCount(); i++) {
-            if (i > 0) appList += ",";
-            appList += "\""; appList += apps[i].name; appList += "\"";
-        }
-        appList += "]";
-        out += ",\"apps\":" + appList;
+        for (size_t i = 0; i < reg.getAppCount(); i++) appList.add(apps[i].name);
     }
 
     // Heap stats
     {
         auto heap = guiPlatform.getHeapStats();
-        out += ",\"heap\":{";
-        out += json_int("sram_free", (int)heap.sram_free) + ",";
-        out += json_int("sram_total", (int)heap.sram_total) + ",";
-        out += json_int("psram_free", (int)heap.psram_free) + ",";
-        out += json_int("psram_total", (int)heap.psram_total);
-        out += "}";
+        JsonObject h = resp["heap"].to<JsonObject>();
+        h["sram_free"]   = heap.sram_free;
+        h["sram_total"]  = heap.sram_total;
+        h["psram_free"]  = heap.psram_free;
+        h["psram_total"] = heap.psram_total;
     }
 
     // Settings summary
     if (settings) {
-        out += ",\"settings\":{";
-        out += json_int("lcd_brightness", settings->LCDbrightness) + ",";
-        out += json_int("rgb_brightness", settings->RGBbrightness) + ",";
-        out += json_int("theme_color", settings->themeColorIndex) + ",";
-        out += json_bool("audio_engine", settings->AudioEngineEnabled) + ",";
-        out += json_int("kit", settings->Kit) + ",";
-        out += json_int("perf_stats_flags", settings->perfStatsFlags);
-        out += "}";
+        JsonObject st = resp["settings"].to<JsonObject>();
+        st["lcd_brightness"]   = settings->LCDbrightness;
+        st["rgb_brightness"]   = settings->RGBbrightness;
+        st["theme_color"]      = settings->themeColorIndex;
+        st["audio_engine"]     = settings->AudioEngineEnabled;
+        st["kit"]              = settings->Kit;
+        st["perf_stats_flags"] = settings->perfStatsFlags;
+    }
+
+    // Local transports
+    {
+        JsonObject tr = resp["transports"].to<JsonObject>();
+        tr["tcp_port"] = s_server.port();
+        tr["unix"]     = s_server.unixSocketPath();
+        tr["shm"]      = s_shm.isOpen() ? s_shm.name() : std::string();
     }
 
-    out += "}";
-    return out;
+    // Display backend
+    {
+        const auto& opts = pc_platform_options();
+        resp["display"] = !opts.headless ? "sdl" : (opts.lcdOnly ? "headless_lcd" : "headless");
+    }
+
+    // Binary telemetry from the device on the USB/UART port
+    {
+        auto& tel = pc_platform_get_telemetry();
+        JsonObject d = resp["device_telemetry"].to<JsonObject>();
+        d["unhandled_frames"] = tel.unhandled();
+        d["size_errors"]      = tel.sizeErrors();
+
+        telemetry::PerfCounters perf;
+        uint64_t receivedUs;
+        if (pc_platform_get_device_perf().load(perf, receivedUs)) {
+            const uint64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            JsonObject p = d["perf"].to<JsonObject>();
+            p["age_ms"]          = (nowUs - receivedUs) / 1000;
+            p["free_heap"]       = perf.freeHeap;
+            p["cpu_load0"]       = perf.cpuLoad[0] / 100.0f;
+            p["cpu_load1"]       = perf.cpuLoad[1] / 100.0f;
+            p["audio_underruns"] = perf.audioUnderruns;
+            p["max_loop_us"]     = perf.maxLoopUs;
+        }
+    }
+
+    // Refresh cost since the last {"cmd":"stats","reset":true}
+    fill_render_stats(resp, req["reset"] | false);
+
+    // Push stream counters for the requesting connection
+    fill_subscription_stats(resp);
 }
 
 /* ── Settings read handler ───────────────────────────────────────────── */
 
-static std::string handle_settings_get(const std::string& json) {
+static void handle_settings_get(JsonObjectConst req, JsonObject resp) {
     auto* settings = crosspad::CrosspadSettings::getInstance();
     if (!settings) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "settings not initialized") + "}";
+        reply_error(resp, "settings not initialized");
+        return;
     }
 
-    std::string category = json_get_string(json, "category");
+    std::string category = req["category"] | "";
+    bool all = category.empty() || category == "all";
 
-    std::string out = "{" + json_bool("ok", true);
+    reply_ok(resp);
 
-    if (category.empty() || category == "all" || category == "display") {
-        out += ",\"display\":{";
-        out += json_int("lcd_brightness", settings->LCDbrightness) + ",";
-        out += json_int("theme_color", settings->themeColorIndex) + ",";
-        out += json_int("rgb_brightness", settings->RGBbrightness) + ",";
-        out += json_int("perf_stats_flags", settings->perfStatsFlags);
-        out += "}";
+    if (all || category == "display") {
+        JsonObject o = resp["display"].to<JsonObject>();
+        o["lcd_brightness"]   = settings->LCDbrightness;
+        o["theme_color"]      = settings->themeColorIndex;
+        o["rgb_brightness"]   = settings->RGBbrightness;
+        o["perf_stats_flags"] = settings->perfStatsFlags;
     }
 
-    if (category.empty() || category == "all" || category == "keypad") {
+    if (all || category == "keypad") {
         auto& kp = settings->keypad;
-        out += ",\"keypad\":{";
-        out += json_bool("enable", kp.enableKeypad) + ",";
-        out += json_bool("note_off_release", kp.noteOffOnRelease) + ",";
-        out += json_bool("inactive_lights", kp.inactiveLights) + ",";
-        out += json_bool("lights_on_note_on", kp.lightsOnNoteOn) + ",";
-        out += json_bool("lights_on_note_off", kp.lightsOnNoteOff) + ",";
-        out += json_bool("upper_fn", kp.upperRowFunctions) + ",";
-        out += json_bool("eco_mode", kp.ecoMode) + ",";
-        out += json_bool("send_stm", kp.send2STM) + ",";
-        out += json_bool("send_ble", kp.send2BLE) + ",";
-        out += json_bool("send_usb", kp.send2USB) + ",";
-        out += json_bool("send_cc", kp.sendCC);
-        out += "}";
-    }
-
-    if (category.empty() || category == "all" || category == "vibration") {
+        JsonObject o = resp["keypad"].to<JsonObject>();
+        o["enable"]             = kp.enableKeypad;
+        o["note_off_release"]   = kp.noteOffOnRelease;
+        o["inactive_lights"]    = kp.inactiveLights;
+        o["lights_on_note_on"]  = kp.lightsOnNoteOn;
+        o["lights_on_note_off"] = kp.lightsOnNoteOff;
+        o["upper_fn"]           = kp.upperRowFunctions;
+        o["eco_mode"]           = kp.ecoMode;
+        o["send_stm"]           = kp.send2STM;
+        o["send_ble"]           = kp.send2BLE;
+        o["send_usb"]           = kp.send2USB;
+        o["send_cc"]            = kp.sendCC;
+    }
+
+    if (all || category == "vibration") {
         auto& vib = settings->vibration;
-        out += ",\"vibration\":{";
-        out += json_bool("enable", vib.enable) + ",";
-        out += json_bool("on_touch", vib.enableVibrationOnTouch) + ",";
-        out += json_bool("on_error", vib.enableVibrationOnError) + ",";
-        out += json_bool("audio_reactive", vib.enableAudioToVibe) + ",";
-        out += json_int("in_min", vib.inputMin) + ",";
-        out += json_int("in_max", vib.inputMax) + ",";
-        out += json_int("out_min", vib.outputMin) + ",";
-        out += json_int("out_max", vib.outputMax);
-        out += "}";
-    }
-
-    if (category.empty() || category == "all" || category == "wireless") {
+        JsonObject o = resp["vibration"].to<JsonObject>();
+        o["enable"]         = vib.enable;
+        o["on_touch"]       = vib.enableVibrationOnTouch;
+        o["on_error"]       = vib.enableVibrationOnError;
+        o["audio_reactive"] = vib.enableAudioToVibe;
+        o["in_min"]         = vib.inputMin;
+        o["in_max"]         = vib.inputMax;
+        o["out_min"]        = vib.outputMin;
+        o["out_max"]        = vib.outputMax;
+    }
+
+    if (all || category == "wireless") {
         auto& w = settings->wireless;
-        out += ",\"wireless\":{";
-        out += json_bool("wifi", w.enableWiFi) + ",";
-        out += json_bool("ble", w.enableBLE) + ",";
-        out += json_bool("osc", w.enableOSC) + ",";
-        out += json_bool("osc_server", w.enableOSCServer) + ",";
-        out += json_bool("udp", w.enableUDP) + ",";
-        out += json_bool("tcp", w.enableTCP) + ",";
-        out += json_bool("web_server", w.enableWebServer);
-        out += "}";
-    }
-
-    if (category.empty() || category == "all" || category == "audio") {
-        auto& mfx = settings->masterFX;
-        out += ",\"master_fx\":{";
-        out += json_bool("mute", mfx.mute) + ",";
-        out += json_int("in_volume", mfx.inVolume) + ",";
-        out += json_int("out_volume", mfx.outVolume) + ",";
-        out += json_bool("delay_bypass", mfx.delay.bypass) + ",";
-        out += json_bool("reverb_bypass", mfx.reverb.bypass) + ",";
-        out += json_bool("distortion_bypass", mfx.distortion.bypass) + ",";
-        out += json_bool("chorus_bypass", mfx.chorus.bypass) + ",";
-        out += json_bool("flanger_bypass", mfx.flanger.bypass);
-        out += "}";
+        JsonObject o = resp["wireless"].to<JsonObject>();
+        o["wifi"]       = w.enableWiFi;
+        o["ble"]        = w.enableBLE;
+        o["osc"]        = w.enableOSC;
+        o["osc_server"] = w.enableOSCServer;
+        o["udp"]        = w.enableUDP;
+        o["tcp"]        = w.enableTCP;
+        o["web_server"] = w.enableWebServer;
     }
 
-    if (category.empty() || category == "all" || category == "system") {
-        out += ",\"system\":{";
-        out += json_int("kit", settings->Kit) + ",";
-        out += json_bool("audio_engine", settings->AudioEngineEnabled);
-        out += "}";
+    if (all || category == "audio") {
+        auto& mfx = settings->masterFX;
+        JsonObject o = resp["master_fx"].to<JsonObject>();
+        o["mute"]              = mfx.mute;
+        o["in_volume"]         = mfx.inVolume;
+        o["out_volume"]        = mfx.outVolume;
+        o["delay_bypass"]      = mfx.delay.bypass;
+        o["reverb_bypass"]     = mfx.reverb.bypass;
+        o["distortion_bypass"] = mfx.distortion.bypass;
+        o["chorus_bypass"]     = mfx.chorus.bypass;
+        o["flanger_bypass"]    = mfx.flanger.bypass;
     }
 
-    out += "}";
-    return out;
+    if (all || category == "system") {
+        JsonObject o = resp["system"].to<JsonObject>();
+        o["kit"]          = settings->Kit;
+        o["audio_engine"] = settings->AudioEngineEnabled;
+    }
 }
 
 /* ── Settings write handler ──────────────────────────────────────────── */
 
-static std::string handle_settings_set(const std::string& json) {
+static void handle_settings_set(JsonObjectConst req, JsonObject resp) {
     auto* settings = crosspad::CrosspadSettings::getInstance();
     if (!settings) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "settings not initialized") + "}";
+        reply_error(resp, "settings not initialized");
+        return;
     }
 
-    std::string key = json_get_string(json, "key");
-    int value = json_get_int(json, "value", -9999);
+    std::string key = req["key"] | "";
+    int value = json_int_or_bool(req["value"], -9999);
 
     if (key.empty()) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "missing key") + "}";
+        reply_error(resp, "missing key");
+        return;
     }
 
     // Map key names to settings fields
@@ -602,187 +822,1121 @@ static std::string handle_settings_set(const std::string& json) {
     else if (key == "master_fx.out_volume") { settings->masterFX.outVolume = (uint8_t)value; found = true; }
 
     if (!found) {
-        return "{" + json_bool("ok", false) + "," + json_string("error", "unknown key: " + key) + "}";
+        reply_error(resp, "unknown key: " + key);
+        return;
     }
 
     // Auto-save after setting change
     pc_platform_save_settings();
 
-    return "{" + json_bool("ok", true) + "," + json_string("key", key) + "," + json_int("value", value) + "}";
+    reply_ok(resp);
+    resp["key"] = key;
+    resp["value"] = value;
 }
 
-static std::string dispatch_command(const std::string& json) {
-    std::string cmd = json_get_string(json, "cmd");
+/* ── wait_for: server-side conditions ─────────────────────────────────── */
+
+enum class WaitType { PadPlaying, PadPressed, App, Peak, ScreenChanged };
+
+struct Waiter {
+    WaitType type;
+    int      pad = 0;
+    bool     want = true;
+    std::string app;
+    int      output = 0;
+    int      threshold = 0;
+    remote::Rect rect = {};
+    uint64_t baseline = 0;
+
+    uint32_t topics = 0;        // change notifications that can satisfy it
+    uint32_t startMs = 0;
+    uint32_t timeoutMs = 0;
+    JsonDocument id;
+    std::function<void(const std::string&)> respond;
+};
+
+static constexpr size_t   MAX_WAITERS        = 64;
+static constexpr uint32_t DEFAULT_WAIT_MS    = 5000;
+static constexpr uint32_t MAX_WAIT_MS        = 120000;
 
-    if (cmd == "ping") {
-        return "{" + json_bool("ok", true) + "," + json_string("cmd", "ping") + "}";
+static std::vector<Waiter> s_waiters;
+
+/// FNV-1a over the region's rows, read in place from the framebuffer.
+static uint64_t screen_hash(const Waiter& w) {
+    const lv_draw_buf_t* fb = framebuffer();
+    if (!fb || !fb->data) return 0;
+
+    uint64_t h = 1469598103934665603ull;
+    for (int y = 0; y < w.rect.h; y++) {
+        const uint8_t* p = fb->data + (size_t)(w.rect.y + y) * fb->header.stride + (size_t)w.rect.x * 4;
+        for (size_t i = 0; i < (size_t)w.rect.w * 4; i++) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
     }
-    if (cmd == "screenshot") {
-        return handle_screenshot(json);
+    return h;
+}
+
+static bool waiter_met(Waiter& w) {
+    switch (w.type) {
+    case WaitType::PadPlaying:
+        return crosspad::getPadManager().isPadPlaying(w.pad) == w.want;
+    case WaitType::PadPressed:
+        return crosspad::getPadManager().isPadPressed(w.pad) == w.want;
+    case WaitType::App:
+        return crosspad::getPadManager().getActivePadLogic() == w.app;
+    case WaitType::Peak:
+        return remote::output_peak(w.output) > w.threshold;
+    case WaitType::ScreenChanged:
+        return screen_hash(w) != w.baseline;
     }
-    if (cmd == "click") {
-        return handle_click(json);
+    return false;
+}
+
+static void waiter_fill_result(const Waiter& w, JsonObject resp, bool met, uint32_t now) {
+    if (!w.id.isNull()) resp["id"] = w.id.as<JsonVariantConst>();
+    resp["ok"]  = met;
+    resp["met"] = met;
+    resp["elapsed_ms"] = lv_tick_diff(now, w.startMs);
+    if (!met) resp["error"] = "timeout";
+    if (w.type == WaitType::Peak) resp["peak"] = remote::output_peak(w.output);
+}
+
+static void waiter_finish(Waiter& w, bool met, uint32_t now) {
+    s_lateDoc.clear();
+    waiter_fill_result(w, s_lateDoc.to<JsonObject>(), met, now);
+    s_lateBuf.clear();
+    serializeJson(s_lateDoc, s_lateBuf);
+    if (w.respond) w.respond(s_lateBuf);
+}
+
+/// Re-evaluate waiters touched by @p changes; expire the rest on timeout.
+static void service_waiters(uint32_t changes) {
+    if (s_waiters.empty()) return;
+    uint32_t now = lv_tick_get();
+
+    for (size_t i = 0; i < s_waiters.size();) {
+        Waiter& w = s_waiters[i];
+        bool met = (changes & w.topics) && waiter_met(w);
+        if (met || lv_tick_diff(now, w.startMs) >= w.timeoutMs) {
+            waiter_finish(w, met, now);
+            s_waiters.erase(s_waiters.begin() + i);
+        } else {
+            i++;
+        }
     }
-    if (cmd == "pad_press") {
-        return handle_pad_press(json);
+}
+
+/// Ms until the earliest waiter times out (UINT32_MAX: none).
+static uint32_t waiters_due_ms(uint32_t now) {
+    uint32_t due = UINT32_MAX;
+    for (const auto& w : s_waiters) {
+        uint32_t elapsed = lv_tick_diff(now, w.startMs);
+        due = std::min(due, elapsed >= w.timeoutMs ? 0 : w.timeoutMs - elapsed);
     }
-    if (cmd == "pad_release") {
-        return handle_pad_release(json);
+    return due;
+}
+
+/// {"cmd":"wait_for","condition":{"type":"pad_playing","pad":3},"timeout_ms":2000}
+///
+/// Condition types:
+///   pad_playing  {pad, playing=true}   — PadManager::isPadPlaying
+///   pad_pressed  {pad, pressed=true}   — PadManager::isPadPressed
+///   app          {name}                — active app (the pad logic it claims)
+///   peak         {output=0, threshold} — OUT1/OUT2 peak (int16) above threshold
+///   screen_changed {region}            — pixel hash differs from when registered
+///
+/// Replies once: {"ok":true,"met":true,...} or {"ok":false,"met":false,"error":"timeout"}.
+static void handle_wait_for(JsonObjectConst req, JsonObject resp) {
+    if (!s_dispatching || s_inBatch) {
+        reply_error(resp, "wait_for cannot run inside batch");
+        return;
     }
-    if (cmd == "encoder_rotate") {
-        return handle_encoder_rotate(json);
+    if (s_waiters.size() >= MAX_WAITERS) {
+        reply_error(resp, "too many pending wait_for requests");
+        return;
     }
-    if (cmd == "encoder_press") {
-        return handle_encoder_press(true);
+
+    JsonObjectConst cond = req["condition"];
+    const char* type = cond["type"] | "";
+
+    Waiter w;
+    if (strcmp(type, "pad_playing") == 0 || strcmp(type, "pad_pressed") == 0) {
+        bool playing = strcmp(type, "pad_playing") == 0;
+        w.type = playing ? WaitType::PadPlaying : WaitType::PadPressed;
+        w.pad  = cond["pad"] | -1;
+        w.want = cond[playing ? "playing" : "pressed"] | true;
+        // Pad grid redraws too, which covers presses that bypass our hooks
+        w.topics = remote::TOPIC_PAD | remote::TOPIC_LED | remote::TOPIC_DISPLAY;
+        if (w.pad < 0 || w.pad > 15) {
+            reply_error(resp, "invalid pad (0-15)");
+            return;
+        }
+    } else if (strcmp(type, "app") == 0) {
+        w.type = WaitType::App;
+        w.app  = cond["name"] | "";
+        w.topics = remote::TOPIC_APP;
+    } else if (strcmp(type, "peak") == 0) {
+        w.type = WaitType::Peak;
+        w.output    = cond["output"] | 0;
+        w.threshold = cond["threshold"] | 0;
+        w.topics = remote::TOPIC_METER;
+    } else if (strcmp(type, "screen_changed") == 0) {
+        w.type = WaitType::ScreenChanged;
+        if (const char* err = resolve_region(cond["region"], w.rect)) {
+            reply_error(resp, err);
+            return;
+        }
+        w.topics = remote::TOPIC_DISPLAY;
+        w.baseline = screen_hash(w);
+    } else {
+        reply_error(resp, std::string("unknown condition type: ") + type);
+        return;
     }
-    if (cmd == "encoder_release") {
-        return handle_encoder_press(false);
+
+    w.startMs   = lv_tick_get();
+    w.timeoutMs = std::min<uint32_t>(req["timeout_ms"] | DEFAULT_WAIT_MS, MAX_WAIT_MS);
+
+    // Already true? Answer right away.
+    if (w.type != WaitType::ScreenChanged && waiter_met(w)) {
+        waiter_fill_result(w, resp, true, w.startMs);
+        return;
     }
-    if (cmd == "key") {
-        return handle_key(json);
+
+    // Defer: take over this request's responder
+    JsonVariantConst id = req["id"];
+    if (!id.isNull()) w.id.set(id);
+    w.respond = std::move(s_dispatching->respond);
+    s_replyDeferred = true;
+    s_waiters.push_back(std::move(w));
+}
+
+/* ── Push subscriptions ──────────────────────────────────────────────── */
+
+struct TopicName {
+    const char* name;
+    uint32_t    bit;
+};
+
+static const TopicName s_topicNames[] = {
+    { "pad",      remote::TOPIC_PAD },
+    { "led",      remote::TOPIC_LED },
+    { "app",      remote::TOPIC_APP },
+    { "midi_in",  remote::TOPIC_MIDI_IN },
+    { "midi_out", remote::TOPIC_MIDI_OUT },
+    { "meter",    remote::TOPIC_METER },
+};
+
+struct Subscriber {
+    std::weak_ptr<remote::Connection> conn;
+    uint32_t connId;
+    uint32_t topics;
+    uint32_t meterIntervalMs;
+    uint32_t lastMeterMs;
+    bool     meterDirty;
+};
+
+static constexpr uint32_t DEFAULT_METER_HZ = 10;
+
+static std::vector<Subscriber> s_subscribers;
+static uint32_t s_subTopics = 0;    // union of all subscriptions
+
+// Last state pushed to subscribers; diffed when the matching topic fires
+struct PadSnapshot {
+    bool pressed;
+    bool playing;
+};
+static PadSnapshot s_padSnap[16];
+static uint32_t    s_ledSnap[16];
+static std::string s_appSnap;
+
+static JsonDocument s_eventDoc;
+static std::string  s_eventBuf;
+static uint32_t     s_eventSeq = 0;
+
+static uint32_t led_rgb(uint16_t idx) {
+    auto c = pc_get_led_color(idx);
+    return ((uint32_t)c.R << 16) | ((uint32_t)c.G << 8) | c.B;
+}
+
+static void snapshot_state() {
+    auto& pm = crosspad::getPadManager();
+    for (int i = 0; i < 16; i++) {
+        s_padSnap[i] = { pm.isPadPressed(i), pm.isPadPlaying(i) };
+        s_ledSnap[i] = led_rgb(i);
     }
-    if (cmd == "stats") {
-        return handle_stats();
+    s_appSnap = pm.getActivePadLogic();
+}
+
+static void update_subscribed_topics() {
+    s_subTopics = 0;
+    for (auto& sub : s_subscribers) s_subTopics |= sub.topics;
+    remote::set_midi_tap(s_subTopics & (remote::TOPIC_MIDI_IN | remote::TOPIC_MIDI_OUT));
+}
+
+static Subscriber* find_subscriber(uint32_t connId) {
+    for (auto& sub : s_subscribers)
+        if (sub.connId == connId) return &sub;
+    return nullptr;
+}
+
+/// Start an event record: {"event":name,"seq":n,"t":ms,...}
+static JsonObject begin_event(const char* name) {
+    s_eventDoc.clear();
+    JsonObject ev = s_eventDoc.to<JsonObject>();
+    ev["event"] = name;
+    ev["seq"]   = ++s_eventSeq;
+    ev["t"]     = lv_tick_get();
+    return ev;
+}
+
+/// Serialize the current event once and queue it on every matching subscriber.
+static void emit_event(uint32_t topic) {
+    s_eventBuf.clear();
+    serializeJson(s_eventDoc, s_eventBuf);
+    for (auto& sub : s_subscribers) {
+        if (!(sub.topics & topic)) continue;
+        if (auto c = sub.conn.lock()) c->pushEvent(std::string(s_eventBuf));
     }
-    if (cmd == "settings_get") {
-        return handle_settings_get(json);
+}
+
+static void publish_pad_events() {
+    auto& pm = crosspad::getPadManager();
+    for (int i = 0; i < 16; i++) {
+        PadSnapshot now = { pm.isPadPressed(i), pm.isPadPlaying(i) };
+        if (now.pressed == s_padSnap[i].pressed && now.playing == s_padSnap[i].playing) continue;
+        s_padSnap[i] = now;
+
+        JsonObject ev = begin_event("pad");
+        ev["pad"]     = i;
+        ev["pressed"] = now.pressed;
+        ev["playing"] = now.playing;
+        emit_event(remote::TOPIC_PAD);
     }
-    if (cmd == "settings_set") {
-        return handle_settings_set(json);
+}
+
+static void publish_led_events() {
+    for (int i = 0; i < 16; i++) {
+        uint32_t rgb = led_rgb(i);
+        if (rgb == s_ledSnap[i]) continue;
+        s_ledSnap[i] = rgb;
+
+        JsonObject ev = begin_event("led");
+        ev["led"] = i;
+        ev["rgb"] = rgb;
+        emit_event(remote::TOPIC_LED);
     }
+}
+
+static void publish_app_event() {
+    std::string app = crosspad::getPadManager().getActivePadLogic();
+    if (app == s_appSnap) return;
+    s_appSnap = app;
 
-    return "{" + json_bool("ok", false) + "," + json_string("error", "unknown command: " + cmd) + "}";
+    JsonObject ev = begin_event("app");
+    ev["name"] = app;
+    emit_event(remote::TOPIC_APP);
 }
 
-/* ── TCP server thread ───────────────────────────────────────────────── */
+static void publish_midi_events() {
+    remote::MidiRecord recs[64];
+    uint32_t dropped = 0;
+    size_t n;
+    while ((n = remote::drain_midi(recs, 64, dropped)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            const auto& r = recs[i];
+            JsonObject ev = begin_event(r.out ? "midi_out" : "midi_in");
+            JsonArray data = ev["data"].to<JsonArray>();
+            for (uint8_t b = 0; b < r.len; b++) data.add(r.data[b]);
+            if (r.size > r.len) ev["size"] = r.size;      // SysEx: head only
+            if (dropped) {
+                ev["dropped"] = dropped;
+                dropped = 0;
+            }
+            emit_event(r.out ? remote::TOPIC_MIDI_OUT : remote::TOPIC_MIDI_IN);
+        }
+    }
+}
 
-static void handle_client(socket_t client) {
-    // Set receive timeout
-    #ifdef _WIN32
-    DWORD timeout = 30000; // 30s
-    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
-    #endif
+static void publish_meter_events(bool changed) {
+    uint32_t now = lv_tick_get();
+    bool built = false;
+
+    for (auto& sub : s_subscribers) {
+        if (!(sub.topics & remote::TOPIC_METER)) continue;
+        sub.meterDirty |= changed;
+        if (!sub.meterDirty || lv_tick_diff(now, sub.lastMeterMs) < sub.meterIntervalMs) continue;
+
+        // Build once per turn, only if some subscriber is due
+        if (!built) {
+            JsonObject ev = begin_event("meter");
+            for (int out = 0; out < 2; out++) {
+                int16_t l, r;
+                remote::output_levels(out, l, r);
+                JsonArray lr = ev[out == 0 ? "out1" : "out2"].to<JsonArray>();
+                lr.add(l);
+                lr.add(r);
+            }
+            s_eventBuf.clear();
+            serializeJson(s_eventDoc, s_eventBuf);
+            built = true;
+        }
+        sub.lastMeterMs = now;
+        sub.meterDirty  = false;
+        if (auto c = sub.conn.lock()) c->pushEvent(std::string(s_eventBuf));
+    }
+}
 
-    std::string buffer;
-    char chunk[4096];
+/// Ms until a rate-limited meter update is due (UINT32_MAX: none pending).
+static uint32_t meter_due_ms(uint32_t now) {
+    uint32_t due = UINT32_MAX;
+    for (const auto& sub : s_subscribers) {
+        if (!(sub.topics & remote::TOPIC_METER) || !sub.meterDirty) continue;
+        uint32_t elapsed = lv_tick_diff(now, sub.lastMeterMs);
+        due = std::min(due, elapsed >= sub.meterIntervalMs ? 0 : sub.meterIntervalMs - elapsed);
+    }
+    return due;
+}
 
-    while (s_running) {
-        int n = recv(client, chunk, sizeof(chunk) - 1, 0);
-        if (n <= 0) break;
-        chunk[n] = '\0';
-        buffer.append(chunk, n);
+/// Diff observable state against what subscribers last saw (LVGL thread).
+static void publish_events(uint32_t changes) {
+    if (s_subscribers.empty()) return;
+
+    // Drop subscribers whose connection went away
+    size_t before = s_subscribers.size();
+    s_subscribers.erase(std::remove_if(s_subscribers.begin(), s_subscribers.end(),
+        [](const Subscriber& sub) {
+            auto c = sub.conn.lock();
+            return !c || !c->isOpen();
+        }), s_subscribers.end());
+    if (s_subscribers.size() != before) update_subscribed_topics();
+    if (s_subscribers.empty()) return;
+
+    using namespace remote;
+    if ((s_subTopics & TOPIC_PAD) && (changes & (TOPIC_PAD | TOPIC_LED | TOPIC_DISPLAY)))
+        publish_pad_events();
+    if ((s_subTopics & TOPIC_LED) && (changes & TOPIC_LED))
+        publish_led_events();
+    if ((s_subTopics & TOPIC_APP) && (changes & TOPIC_APP))
+        publish_app_event();
+    if (changes & (TOPIC_MIDI_IN | TOPIC_MIDI_OUT))
+        publish_midi_events();
+    if (s_subTopics & TOPIC_METER)
+        publish_meter_events(changes & TOPIC_METER);
+}
 
-        // Process complete lines (newline-delimited JSON)
-        size_t pos;
-        while ((pos = buffer.find('\n')) != std::string::npos) {
-            std::string line = buffer.substr(0, pos);
-            buffer.erase(0, pos + 1);
+static void fill_subscription_stats(JsonObject resp) {
+    auto conn = s_dispatching ? s_dispatching->conn.lock() : nullptr;
+    if (!conn) return;
+    Subscriber* sub = find_subscriber(conn->id());
+    if (!sub) return;
+
+    auto st = conn->eventStats();
+    JsonObject o = resp["subscription"].to<JsonObject>();
+    JsonArray topics = o["topics"].to<JsonArray>();
+    for (const auto& t : s_topicNames)
+        if (sub->topics & t.bit) topics.add(t.name);
+    o["queued"]  = st.queued;
+    o["sent"]    = st.sent;
+    o["dropped"] = st.dropped;
+    o["depth"]   = st.depth;
+}
 
-            if (line.empty()) continue;
+/// {"cmd":"subscribe","topics":["pad","led","app","midi_in","midi_out","meter"],
+///  "meter_hz":10,"queue":1024}
+///
+/// Turns on push events for this connection; omitted "topics" means all.
+/// Events are lines of the form {"event":"pad","seq":n,"t":ms,...} and are
+/// interleaved with ordinary replies. "seq" is global across topics.
+static void handle_subscribe(JsonObjectConst req, JsonObject resp) {
+    auto conn = s_dispatching ? s_dispatching->conn.lock() : nullptr;
+    if (!conn) {
+        reply_error(resp, "no connection");
+        return;
+    }
+
+    uint32_t topics = 0;
+    JsonArrayConst list = req["topics"];
+    if (list.isNull()) {
+        for (const auto& t : s_topicNames) topics |= t.bit;
+    }
+    for (JsonVariantConst v : list) {
+        const char* name = v | "";
+        const TopicName* found = nullptr;
+        for (const auto& t : s_topicNames)
+            if (strcmp(t.name, name) == 0) found = &t;
+        if (!found) {
+            reply_error(resp, std::string("unknown topic: ") + name);
+            return;
+        }
+        topics |= found->bit;
+    }
+
+    uint32_t hz = std::clamp<uint32_t>(req["meter_hz"] | DEFAULT_METER_HZ, 1, 60);
+    uint32_t queue = req["queue"] | 0;
+    if (queue) conn->setEventCapacity(queue);
+
+    if (s_subscribers.empty()) snapshot_state();
+
+    Subscriber* sub = find_subscriber(conn->id());
+    if (!sub && topics) {
+        s_subscribers.push_back({ conn, conn->id(), 0, 0, 0, true });
+        sub = &s_subscribers.back();
+    }
+    if (sub) {
+        sub->topics = topics;
+        sub->meterIntervalMs = 1000 / hz;
+    }
+
+    reply_ok(resp);
+    fill_subscription_stats(resp);
 
-            // Commands that need SDL/LVGL context must run on LVGL thread
-            std::string cmd = json_get_string(line, "cmd");
-            if (cmd == "ping") {
-                // ping can respond immediately
-                std::string resp = dispatch_command(line) + "\n";
-                send(client, resp.c_str(), (int)resp.size(), 0);
-            } else {
-                // Queue for LVGL thread, wait for response
-                std::unique_lock<std::mutex> lock(s_responseMutex);
-                s_responseReady = false;
+    if (!topics) {
+        s_subscribers.erase(std::remove_if(s_subscribers.begin(), s_subscribers.end(),
+            [&](const Subscriber& s) { return s.connId == conn->id(); }), s_subscribers.end());
+    }
+    update_subscribed_topics();
+}
+
+/// {"cmd":"unsubscribe"} — stop push events; replies with final counters.
+static void handle_unsubscribe(JsonObjectConst, JsonObject resp) {
+    JsonDocument none;
+    none["topics"].to<JsonArray>();
+    handle_subscribe(none.as<JsonObjectConst>(), resp);
+}
+
+/* ── Frame streaming ─────────────────────────────────────────────────── */
 
-                {
-                    std::lock_guard<std::mutex> qlock(s_queueMutex);
-                    s_commandQueue.push({line, nullptr});
-                }
+static constexpr size_t MAX_FRAME_RECTS = 32;
 
-                // Busy wait for response (with timeout)
-                lock.unlock();
-                int waitMs = 0;
-                while (!s_responseReady && s_running && waitMs < 10000) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
-                    waitMs += 5;
-                }
+static remote::FrameStream s_frames;
+static std::vector<remote::Rect> s_dirtyRects;   // flushed during this refresh
 
-                lock.lock();
-                std::string resp = s_responseReady ? s_pendingResponse :
-                    ("{" + json_bool("ok", false) + "," + json_string("error", "timeout") + "}");
-                lock.unlock();
+static void on_flush_start(lv_event_t* e) {
+    auto* a = static_cast<const lv_area_t*>(lv_event_get_param(e));
+    s_render.pixels += (uint64_t)lv_area_get_size(a);
+    if (!s_frames.hasViewers() && !s_shm.isOpen()) return;
+    s_dirtyRects.push_back({ a->x1, a->y1, a->x2 - a->x1 + 1, a->y2 - a->y1 + 1 });
+}
 
-                resp += "\n";
-                send(client, resp.c_str(), (int)resp.size(), 0);
+static void submit_frame(bool key) {
+    const lv_draw_buf_t* buf = framebuffer();
+    if (!buf) return;
+
+    int w = lv_display_get_horizontal_resolution(s_disp);
+    int h = lv_display_get_vertical_resolution(s_disp);
+
+    if (key || s_dirtyRects.size() > MAX_FRAME_RECTS) {
+        // Keyframe, or too fragmented to be worth per-rect headers
+        remote::Rect box = { 0, 0, w, h };
+        if (!key) {
+            int x1 = w, y1 = h, x2 = 0, y2 = 0;
+            for (const auto& r : s_dirtyRects) {
+                x1 = std::min(x1, r.x);
+                y1 = std::min(y1, r.y);
+                x2 = std::max(x2, r.x + r.w);
+                y2 = std::max(y2, r.y + r.h);
             }
+            box = { x1, y1, x2 - x1, y2 - y1 };
         }
+        s_dirtyRects.assign(1, box);
     }
 
-    CLOSE_SOCKET(client);
+    s_frames.submit(buf->data, (int)buf->header.stride, w, h,
+                    s_dirtyRects.data(), s_dirtyRects.size(), key, lv_tick_get());
+    s_dirtyRects.clear();
 }
 
-static void server_thread_func() {
-#ifdef _WIN32
-    WSADATA wsa;
-    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
-        printf("[Remote] WSAStartup failed\n");
+/// Copy the dirty part of the LCD into shared memory.
+static void publish_shm_frame() {
+    const lv_draw_buf_t* buf = framebuffer();
+    if (!buf) return;
+
+    const remote::Rect lcd = { Stm32EmuWindow::lcdX(), Stm32EmuWindow::lcdY(),
+                               Stm32EmuWindow::LCD_W, Stm32EmuWindow::LCD_H };
+    remote::Rect clipped[MAX_FRAME_RECTS];
+    size_t n = 0;
+    for (const auto& r : s_dirtyRects) {
+        int x1 = std::max(r.x, lcd.x), x2 = std::min(r.x + r.w, lcd.x + lcd.w);
+        int y1 = std::max(r.y, lcd.y), y2 = std::min(r.y + r.h, lcd.y + lcd.h);
+        if (x1 >= x2 || y1 >= y2) continue;
+        if (n == MAX_FRAME_RECTS) {
+            // Too fragmented: republish the whole LCD
+            clipped[0] = { 0, 0, lcd.w, lcd.h };
+            n = 1;
+            break;
+        }
+        clipped[n++] = { x1 - lcd.x, y1 - lcd.y, x2 - x1, y2 - y1 };
+    }
+
+    const uint32_t stride = buf->header.stride;
+    const uint8_t* origin = buf->data + (size_t)lcd.y * stride + (size_t)lcd.x * 4;
+    s_shm.publishFrame(origin, (int)stride, clipped, n, lv_tick_get());
+}
+
+static void on_refr_ready(lv_event_t*) {
+    render_refresh_done();
+    if (s_dirtyRects.empty()) return;
+    if (s_shm.isOpen()) publish_shm_frame();
+    if (s_frames.hasViewers()) submit_frame(s_frames.wantsKeyframe());
+    s_dirtyRects.clear();
+}
+
+/// {"cmd":"stream_frames","enable":true,"encoding":"lz4","region":"lcd"}
+///
+/// Pushes {"event":"frame",...} lines with the areas LVGL flushed each
+/// refresh (see FrameStream.hpp). encoding: raw | lz4 (default) | qoi.
+/// "enable":false stops the stream and returns counters.
+static void handle_stream_frames(JsonObjectConst req, JsonObject resp) {
+    auto conn = s_dispatching ? s_dispatching->conn.lock() : nullptr;
+    if (!conn || !s_disp) {
+        reply_error(resp, "no connection or display");
+        return;
+    }
+
+    if (!(req["enable"] | true)) {
+        s_frames.removeViewer(conn->id());
+        reply_ok(resp);
+        auto st = s_frames.getStats();
+        resp["frames"]  = st.frames;
+        resp["sent"]    = st.sent;
+        resp["skipped"] = st.skipped + st.pooled;
+        resp["bytes"]   = st.bytesOut;
+        return;
+    }
+
+    remote::FrameStream::Encoding enc = remote::FrameStream::Encoding::Lz4;
+    const char* encName = req["encoding"] | "lz4";
+    if (!remote::FrameStream::parseEncoding(encName, enc)) {
+        reply_error(resp, std::string("unknown encoding: ") + encName);
+        return;
+    }
+
+    remote::Rect clip;
+    if (const char* err = resolve_region(req["region"], clip)) {
+        reply_error(resp, err);
+        return;
+    }
+
+    s_frames.addViewer(conn, enc, clip);
+
+    reply_ok(resp);
+    resp["width"]    = clip.w;
+    resp["height"]   = clip.h;
+    resp["encoding"] = remote::FrameStream::encodingName(enc);
+    resp["format"]   = "bgra8888";
+}
+
+/* ── Shared memory ───────────────────────────────────────────────────── */
+
+static std::string shm_name() {
+    return "/crosspad-" + std::to_string(s_server.port());
+}
+
+/// {"cmd":"shm","enable":true,"audio_frames":65536}
+///
+/// Maps the shared-memory region (see SharedMemory.hpp) and publishes the
+/// LCD on every refresh plus the mixer tap output. Replies with the name
+/// and layout so clients can map it; "enable":false removes it.
+static void handle_shm(JsonObjectConst req, JsonObject resp) {
+    if (!(req["enable"] | true)) {
+        remote::set_audio_target(nullptr);
+        s_shm.close();
+        reply_ok(resp);
         return;
     }
+
+    if (!s_shm.isOpen()) {
+        uint32_t frames = req["audio_frames"] | 65536u;
+        if (!s_shm.open(shm_name(), Stm32EmuWindow::LCD_W, Stm32EmuWindow::LCD_H, frames)) {
+            reply_error(resp, "failed to create shared memory");
+            return;
+        }
+        remote::set_audio_target(&s_shm);
+        publish_shm_frame();   // first publication is always full
+    }
+
+    const remote::ShmHeader* h = s_shm.header();
+    reply_ok(resp);
+    resp["name"]           = s_shm.name();
+    resp["size"]           = s_shm.size();
+    resp["version"]        = h->version;
+    resp["fb_offset"]      = h->fbOffset;
+    resp["width"]          = h->fbWidth;
+    resp["height"]         = h->fbHeight;
+    resp["stride"]         = h->fbStride;
+    resp["format"]         = "bgra8888";
+    resp["audio_offset"]   = h->audioOffset;
+    resp["audio_capacity"] = h->audioCapacity;
+    resp["audio_rate"]     = h->audioRate.load();
+}
+
+/* ── Audio streaming ─────────────────────────────────────────────────── */
+
+static remote::AudioStream s_audio;
+
+/// Map an audio_stream source name to its mixer tap (nullptr if unknown).
+static AudioBroadcastTap* resolve_tap(const char* source) {
+#ifdef USE_AUDIO
+    auto& mixer = getMixerEngine();
+    if (strcmp(source, "in1") == 0)   return &mixer.inputTap(MixerInput::IN1);
+    if (strcmp(source, "in2") == 0)   return &mixer.inputTap(MixerInput::IN2);
+    if (strcmp(source, "synth") == 0) return &mixer.inputTap(MixerInput::SYNTH);
+    if (strcmp(source, "out1") == 0)  return &mixer.outputTap(MixerOutput::OUT1);
+    if (strcmp(source, "out2") == 0)  return &mixer.outputTap(MixerOutput::OUT2);
+#else
+    (void)source;
 #endif
+    return nullptr;
+}
+
+/// {"cmd":"audio_stream","source":"out1","frames":256}
+///
+/// Pushes {"event":"audio",...} packets of interleaved s16le stereo from a
+/// mixer tap (see AudioStream.hpp). Sources: in1, in2, synth (pre-fader)
+/// and out1, out2. "enable":false stops one source (or all if omitted) and
+/// returns the packet / frame / drop counters.
+static void handle_audio_stream(JsonObjectConst req, JsonObject resp) {
+    auto conn = s_dispatching ? s_dispatching->conn.lock() : nullptr;
+    if (!conn) {
+        reply_error(resp, "no connection");
+        return;
+    }
+
+    if (!(req["enable"] | true)) {
+        remote::AudioStream::Stats st;
+        s_audio.remove(conn->id(), req["source"] | "", &st);
+        reply_ok(resp);
+        resp["packets"] = st.packets;
+        resp["frames"]  = st.frames;
+        resp["dropped"] = st.droppedFrames;
+        resp["queue_dropped"] = conn->eventStats().dropped;
+        return;
+    }
 
-    s_listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (s_listenSocket == SOCKET_INVALID) {
-        printf("[Remote] Failed to create socket\n");
+    const char* source = req["source"] | "out1";
+    AudioBroadcastTap* tap = resolve_tap(source);
+    if (!tap) {
+        reply_error(resp, std::string("unknown audio source: ") + source);
         return;
     }
 
-    // Allow reuse
-    int reuse = 1;
-    setsockopt(s_listenSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+    uint32_t frames = req["frames"] | 256u;
+    frames = std::min<uint32_t>(std::max<uint32_t>(frames, 16), 8192);
+    s_audio.add(conn, source, tap, frames);
+
+    reply_ok(resp);
+    resp["source"]   = source;
+    resp["frames"]   = frames;
+    resp["rate"]     = tap->sampleRate();
+    resp["channels"] = 2;
+    resp["format"]   = "s16le";
+}
+
+/* ── Input macros ────────────────────────────────────────────────────── */
+
+enum class MacroOp : uint8_t { PadPress, PadRelease, Click, Encoder, EncoderPress, EncoderRelease, Key };
+
+struct MacroEvent {
+    uint64_t atUs;      // offset from macro start
+    MacroOp  op;
+    int16_t  a = 0;     // pad / x / delta / keycode
+    int16_t  b = 0;     // velocity / y
+};
+
+struct Macro {
+    std::vector<MacroEvent> events;
+    size_t   next     = 0;
+    uint32_t repeat   = 1;      // passes left, including the current one
+    uint64_t lengthUs = 0;      // one pass
+    uint64_t startUs  = 0;      // current pass
+    uint64_t played   = 0;
+    uint64_t lateMaxUs = 0;
+    uint64_t lateSumUs = 0;
+    bool     active   = false;
+    JsonDocument id;            // deferred reply ("wait":true)
+    std::function<void(const std::string&)> respond;
+};
+
+static constexpr size_t   MAX_MACRO_EVENTS = 200000;
+static constexpr uint32_t MAX_MACRO_REPEAT = 10000;
+
+static Macro s_macro;
+
+static void macro_fill_stats(JsonObject resp) {
+    resp["played"]      = s_macro.played;
+    resp["late_max_us"] = s_macro.lateMaxUs;
+    resp["late_avg_us"] = s_macro.played ? s_macro.lateSumUs / s_macro.played : 0;
+}
+
+/// End the macro; answers a deferred play_macro with the timing stats.
+static void macro_finish(bool aborted) {
+    if (s_macro.respond) {
+        s_lateDoc.clear();
+        JsonObject resp = s_lateDoc.to<JsonObject>();
+        if (!s_macro.id.isNull()) resp["id"] = s_macro.id.as<JsonVariantConst>();
+        reply_ok(resp);
+        resp["aborted"] = aborted;
+        macro_fill_stats(resp);
+        s_lateBuf.clear();
+        serializeJson(s_lateDoc, s_lateBuf);
+        s_macro.respond(s_lateBuf);
+    }
+    s_macro.active = false;
+    s_macro.respond = nullptr;
+    s_macro.id.clear();
+    s_macro.events.clear();
+    s_macro.events.shrink_to_fit();
+}
+
+/// Play every event that is due. @return ms until the next one (UINT32_MAX: idle).
+static uint32_t macro_run() {
+    if (!s_macro.active) return UINT32_MAX;
 
-    struct sockaddr_in addr = {};
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // localhost only
-    addr.sin_port = htons(PORT);
+    uint64_t now = pc_time_us();
+    for (;;) {
+        if (s_macro.next == s_macro.events.size()) {
+            if (--s_macro.repeat == 0) {
+                macro_finish(false);
+                return UINT32_MAX;
+            }
+            s_macro.next = 0;
+            s_macro.startUs += s_macro.lengthUs;
+        }
 
-    if (bind(s_listenSocket, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
-        printf("[Remote] Failed to bind port %d\n", PORT);
-        CLOSE_SOCKET(s_listenSocket);
-        s_listenSocket = SOCKET_INVALID;
+        const MacroEvent& ev = s_macro.events[s_macro.next];
+        uint64_t due = s_macro.startUs + ev.atUs;
+        if (due > now) return (uint32_t)std::min<uint64_t>((due - now + 999) / 1000, UINT32_MAX - 1);
+
+        switch (ev.op) {
+        case MacroOp::PadPress:       inject_pad(ev.a, ev.b, true); break;
+        case MacroOp::PadRelease:     inject_pad(ev.a, 0, false); break;
+        case MacroOp::Click:          inject_click(ev.a, ev.b); break;
+        case MacroOp::Encoder:        inject_encoder_rotate(ev.a); break;
+        case MacroOp::EncoderPress:   inject_encoder_button(true); break;
+        case MacroOp::EncoderRelease: inject_encoder_button(false); break;
+        case MacroOp::Key:            inject_key(ev.a); break;
+        }
+
+        uint64_t late = now - due;
+        s_macro.lateMaxUs = std::max(s_macro.lateMaxUs, late);
+        s_macro.lateSumUs += late;
+        s_macro.played++;
+        s_macro.next++;
+    }
+}
+
+/// Parse one {"t":12.5,"type":"pad_press",...} entry.
+static const char* macro_parse_event(JsonObjectConst e, MacroEvent& out) {
+    double t = e["t"] | -1.0;
+    if (t < 0) return "event needs t >= 0 (ms)";
+    out.atUs = (uint64_t)(t * 1000.0 + 0.5);
+
+    const char* type = e["type"] | "";
+    if (strcmp(type, "pad_press") == 0 || strcmp(type, "pad_release") == 0) {
+        out.op = type[4] == 'p' ? MacroOp::PadPress : MacroOp::PadRelease;
+        out.a  = (int16_t)(e["pad"] | -1);
+        out.b  = (int16_t)std::clamp(e["velocity"] | 127, 0, 127);
+        if (out.a < 0 || out.a > 15) return "invalid pad (0-15)";
+    } else if (strcmp(type, "click") == 0) {
+        out.op = MacroOp::Click;
+        out.a  = (int16_t)(e["x"] | -1);
+        out.b  = (int16_t)(e["y"] | -1);
+        if (out.a < 0 || out.b < 0) return "click needs x/y";
+    } else if (strcmp(type, "encoder") == 0) {
+        out.op = MacroOp::Encoder;
+        out.a  = (int16_t)(e["delta"] | 0);
+    } else if (strcmp(type, "encoder_press") == 0) {
+        out.op = MacroOp::EncoderPress;
+    } else if (strcmp(type, "encoder_release") == 0) {
+        out.op = MacroOp::EncoderRelease;
+    } else if (strcmp(type, "key") == 0) {
+        out.op = MacroOp::Key;
+        out.a  = (int16_t)(e["keycode"] | 0);
+        if (out.a == 0) return "key needs keycode";
+    } else {
+        return "unknown event type";
+    }
+    return nullptr;
+}
+
+/// {"cmd":"play_macro","events":[{"t":0,"type":"pad_press","pad":0,"velocity":100},
+///  {"t":1,"type":"pad_release","pad":0},...],"repeat":1,"wait":false}
+///
+/// Uploads a timed input sequence that the LVGL loop replays on the
+/// simulation clock ("t" in ms from start, fractions allowed), so the
+/// timing no longer depends on the network. Event types: pad_press {pad,
+/// velocity}, pad_release {pad}, click {x,y}, encoder {delta},
+/// encoder_press, encoder_release, key {keycode}. "repeat" loops the
+/// sequence; each pass lasts "length_ms" (default: last event time).
+/// With "wait":true the reply comes at the end, with lateness stats.
+/// {"cmd":"play_macro","stop":true} aborts; no events just reports status.
+static void handle_play_macro(JsonObjectConst req, JsonObject resp) {
+    if (req["stop"] | false) {
+        bool was = s_macro.active;
+        if (was) {
+            resp["stopped"] = true;
+            macro_fill_stats(resp);
+            macro_finish(true);
+        }
+        reply_ok(resp);
+        if (!was) resp["stopped"] = false;
         return;
     }
 
-    if (listen(s_listenSocket, 2) != 0) {
-        printf("[Remote] Failed to listen\n");
-        CLOSE_SOCKET(s_listenSocket);
-        s_listenSocket = SOCKET_INVALID;
+    JsonArrayConst list = req["events"];
+    if (list.isNull()) {
+        reply_ok(resp);
+        resp["active"] = s_macro.active;
+        if (s_macro.active) macro_fill_stats(resp);
+        return;
+    }
+    if (s_macro.active) {
+        reply_error(resp, "a macro is already playing");
+        return;
+    }
+    if (list.size() == 0 || list.size() > MAX_MACRO_EVENTS) {
+        reply_error(resp, "events must hold 1-200000 entries");
         return;
     }
 
-    printf("[Remote] Listening on 127.0.0.1:%d\n", PORT);
+    std::vector<MacroEvent> events;
+    events.reserve(list.size());
+    for (JsonObjectConst e : list) {
+        MacroEvent ev;
+        if (const char* err = macro_parse_event(e, ev)) {
+            reply_error(resp, std::string(err) + " at event " + std::to_string(events.size()));
+            return;
+        }
+        events.push_back(ev);
+    }
+    // Ties keep upload order
+    std::stable_sort(events.begin(), events.end(),
+                     [](const MacroEvent& l, const MacroEvent& r) { return l.atUs < r.atUs; });
 
-    while (s_running) {
-        // Use select() with timeout so we can check s_running
-        fd_set readfds;
-        FD_ZERO(&readfds);
-        FD_SET(s_listenSocket, &readfds);
-        struct timeval tv = {1, 0}; // 1 second timeout
+    bool wait = req["wait"] | false;
+    if (wait && (!s_dispatching || s_inBatch)) {
+        reply_error(resp, "play_macro wait cannot run inside batch");
+        return;
+    }
 
-        int sel = select((int)s_listenSocket + 1, &readfds, nullptr, nullptr, &tv);
-        if (sel <= 0) continue;
+    s_macro.events    = std::move(events);
+    s_macro.next      = 0;
+    s_macro.repeat    = std::clamp<uint32_t>(req["repeat"] | 1u, 1, MAX_MACRO_REPEAT);
+    s_macro.lengthUs  = std::max<uint64_t>((uint64_t)((req["length_ms"] | 0.0) * 1000.0),
+                                           s_macro.events.back().atUs);
+    s_macro.startUs   = pc_time_us();
+    s_macro.played    = 0;
+    s_macro.lateMaxUs = 0;
+    s_macro.lateSumUs = 0;
+    s_macro.active    = true;
+
+    size_t count = s_macro.events.size();
+    uint32_t repeat = s_macro.repeat;
+    uint64_t totalUs = s_macro.lengthUs * (repeat - 1) + s_macro.events.back().atUs;
+
+    if (wait) {
+        JsonVariantConst id = req["id"];
+        if (!id.isNull()) s_macro.id.set(id);
+        s_macro.respond = std::move(s_dispatching->respond);
+        s_replyDeferred = true;
+    } else {
+        reply_ok(resp);
+        resp["events"]      = count;
+        resp["repeat"]      = repeat;
+        resp["duration_ms"] = totalUs / 1000.0;
+    }
+
+    macro_run();   // t = 0 events go out in this turn
+}
+
+/* ── Virtual time ────────────────────────────────────────────────────── */
+
+static constexpr uint32_t MAX_STEP_MS = 10 * 60 * 1000;
 
-        socket_t client = accept(s_listenSocket, nullptr, nullptr);
-        if (client == SOCKET_INVALID) continue;
+/// {"cmd":"clock","mode":"virtual"} — freeze the simulation clock (LVGL
+/// ticks, IClock, millis()); "real" resumes it. No mode just reports.
+static void handle_clock(JsonObjectConst req, JsonObject resp) {
+    const char* mode = req["mode"] | "";
+    if (strcmp(mode, "virtual") == 0) {
+        pc_time_set_virtual(true);
+    } else if (strcmp(mode, "real") == 0) {
+        pc_time_set_virtual(false);
+    } else if (*mode) {
+        reply_error(resp, "mode must be virtual or real");
+        return;
+    }
+    reply_ok(resp);
+    resp["mode"]   = pc_time_is_virtual() ? "virtual" : "real";
+    resp["now_ms"] = pc_time_ms();
+}
 
-        // Handle one client at a time (simple for MCP use case)
-        handle_client(client);
+/// {"cmd":"step","ms":1000} — advance virtual time by @p ms, running every
+/// LVGL timer, animation, macro event and refresh that falls due on the way.
+/// Time jumps straight to the next due one, so idle stretches cost nothing.
+static void handle_step(JsonObjectConst req, JsonObject resp) {
+    if (!pc_time_is_virtual()) {
+        reply_error(resp, "step requires virtual time (clock {\"mode\":\"virtual\"})");
+        return;
     }
 
-    CLOSE_SOCKET(s_listenSocket);
-    s_listenSocket = SOCKET_INVALID;
+    uint32_t remaining = std::min<uint32_t>(req["ms"] | 0u, MAX_STEP_MS);
+    uint32_t runs = 0;
 
-#ifdef _WIN32
-    WSACleanup();
+    uint32_t idle = std::min(lv_timer_handler(), macro_run());   // whatever is already due
+    while (remaining > 0) {
+        uint32_t adv = std::min(remaining, std::max<uint32_t>(idle, 1));
+        pc_time_advance_us((uint64_t)adv * 1000);
+#ifdef USE_FREERTOS
+        // Let FreeRTOS delays/timeouts expire on the same timeline
+        xTaskCatchUpTicks(pdMS_TO_TICKS(adv));
 #endif
+        remaining -= adv;
+        idle = std::min(macro_run(), lv_timer_handler());
+        runs++;
+
+        // wait_for timeouts and conditions follow virtual time too;
+        // re-raise the changes so subscribers still see them afterwards.
+        uint32_t changes = remote::take_changes();
+        service_waiters(changes);
+        remote::notify(changes);
+    }
 
-    printf("[Remote] Server stopped\n");
+    reply_ok(resp);
+    resp["now_ms"]     = pc_time_ms();
+    resp["timer_runs"] = runs;
+}
+
+/* ── Widget tree ─────────────────────────────────────────────────────── */
+
+static remote::WidgetQuery s_query;
+
+/// {"cmd":"query","type":"label","text_contains":"Mix","app":"Mixer",
+///  "depth":8,"limit":16,"after":"s.0.3"} — matching objects with type,
+/// coordinates, text, value and state flags (see WidgetQuery.hpp).
+static void handle_query(JsonObjectConst req, JsonObject resp) {
+    if (const char* err = s_query.run(req, resp)) {
+        reply_error(resp, err);
+        return;
+    }
+    reply_ok(resp);
+}
+
+/* ── Dispatch ────────────────────────────────────────────────────────── */
+
+using CommandHandler = void (*)(JsonObjectConst req, JsonObject resp);
+
+struct CommandEntry {
+    const char*    name;
+    CommandHandler handler;
+};
+
+static void handle_batch(JsonObjectConst req, JsonObject resp);
+
+static const CommandEntry s_commands[] = {
+    { "ping",            handle_ping },
+    { "screenshot",      handle_screenshot },
+    { "click",           handle_click },
+    { "pad_press",       handle_pad_press },
+    { "pad_release",     handle_pad_release },
+    { "encoder_rotate",  handle_encoder_rotate },
+    { "encoder_press",   handle_encoder_press },
+    { "encoder_release", handle_encoder_release },
+    { "key",             handle_key },
+    { "stats",           handle_stats },
+    { "settings_get",    handle_settings_get },
+    { "settings_set",    handle_settings_set },
+    { "batch",           handle_batch },
+    { "wait_for",        handle_wait_for },
+    { "subscribe",       handle_subscribe },
+    { "unsubscribe",     handle_unsubscribe },
+    { "stream_frames",   handle_stream_frames },
+    { "shm",             handle_shm },
+    { "audio_stream",    handle_audio_stream },
+    { "clock",           handle_clock },
+    { "step",            handle_step },
+    { "query",           handle_query },
+    { "play_macro",      handle_play_macro },
+};
+
+static void dispatch_command(JsonObjectConst req, JsonObject resp) {
+    // Echo the request id first so clients can match pipelined replies
+    JsonVariantConst id = req["id"];
+    if (!id.isNull()) resp["id"] = id;
+
+    const char* cmd = req["cmd"] | "";
+    for (const auto& entry : s_commands) {
+        if (strcmp(entry.name, cmd) == 0) {
+            entry.handler(req, resp);
+            return;
+        }
+    }
+    reply_error(resp, std::string("unknown command: ") + cmd);
+}
+
+/// {"cmd":"batch","commands":[{...},{...}]} — runs every command in this
+/// LVGL-thread turn and returns {"ok":true,"results":[{...},{...}]}.
+static void handle_batch(JsonObjectConst req, JsonObject resp) {
+    JsonArrayConst commands = req["commands"];
+    if (commands.isNull()) {
+        reply_error(resp, "missing commands array");
+        return;
+    }
+
+    reply_ok(resp);
+    s_inBatch = true;
+    JsonArray results = resp["results"].to<JsonArray>();
+    for (JsonObjectConst sub : commands) {
+        JsonObject r = results.add<JsonObject>();
+        const char* cmd = sub["cmd"] | "";
+        if (strcmp(cmd, "batch") == 0) {
+            reply_error(r, "nested batch not allowed");
+            continue;
+        }
+        dispatch_command(sub, r);
+    }
+    s_inBatch = false;
+    resp["count"] = results.size();
+}
+
+/* ── Server callbacks (server thread) ────────────────────────────────── */
+
+static void on_client_line(const remote::ConnectionPtr& conn, std::string&& line) {
+    PendingCommand pc;
+    DeserializationError err = deserializeJson(pc.request, line);
+    if (err || !pc.request.is<JsonObject>()) {
+        JsonDocument resp;
+        reply_error(resp.to<JsonObject>(), std::string("bad request: ") + (err ? err.c_str() : "not an object"));
+        std::string out;
+        serializeJson(resp, out);
+        conn->send(out);
+        return;
+    }
+
+    const char* cmd = pc.request["cmd"] | "";
+    if (strcmp(cmd, "ping") == 0) {
+        // ping can respond immediately
+        JsonDocument resp;
+        dispatch_command(pc.request.as<JsonObjectConst>(), resp.to<JsonObject>());
+        std::string out;
+        serializeJson(resp, out);
+        conn->send(out);
+        return;
+    }
+
+    // Queue for LVGL thread; the reply is written when the command completes.
+    // Later lines from the same client are queued behind it (pipelining).
+    std::weak_ptr<remote::Connection> weak = conn;
+    pc.conn = weak;
+    pc.respond = [weak, hold = conn->holdOpen()](const std::string& resp) {
+        if (auto c = weak.lock()) c->send(resp);
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        s_commandQueue.push_back(std::move(pc));
+    }
+    remote::wake();
 }
 
 /* ── Public API ──────────────────────────────────────────────────────── */
@@ -791,38 +1945,104 @@ namespace remote {
 
 void start(lv_display_t* disp) {
     s_disp = disp;
-    s_running = true;
-    s_serverThread = std::thread(server_thread_func);
-    printf("[Remote] Control server starting on port %d\n", PORT);
-}
 
-void stop() {
-    s_running = false;
-    if (s_listenSocket != SOCKET_INVALID) {
-        CLOSE_SOCKET(s_listenSocket);
-        s_listenSocket = SOCKET_INVALID;
+    // Finished renders wake screen_changed waiters
+    if (disp) {
+        lv_display_add_event_cb(disp, [](lv_event_t*) {
+            notify(TOPIC_DISPLAY);
+        }, LV_EVENT_RENDER_READY, nullptr);
+
+        // Dirty-rect capture for stream_frames, refresh timing for stats
+        lv_display_add_event_cb(disp, on_refr_start, LV_EVENT_REFR_START, nullptr);
+        lv_display_add_event_cb(disp, on_flush_start, LV_EVENT_FLUSH_START, nullptr);
+        lv_display_add_event_cb(disp, on_refr_ready, LV_EVENT_REFR_READY, nullptr);
+
+        // Any invalidated area may change what a widget query returns
+        lv_display_add_event_cb(disp, [](lv_event_t*) {
+            s_query.invalidate();
+        }, LV_EVENT_INVALIDATE_AREA, nullptr);
+    }
+
+    // Local AF_UNIX listener: CROSSPAD_REMOTE_SOCKET overrides, "" disables
+    if (const char* path = getenv("CROSSPAD_REMOTE_SOCKET")) {
+        s_server.setUnixSocketPath(path);
+    } else {
+#ifdef _WIN32
+        const char* dir = getenv("TEMP");
+#else
+        const char* dir = getenv("XDG_RUNTIME_DIR");
+        if (!dir) dir = getenv("TMPDIR");
+#endif
+        std::string base = dir ? dir : "/tmp";
+        s_server.setUnixSocketPath(base + "/crosspad-{port}.sock");
     }
-    if (s_serverThread.joinable()) {
-        s_serverThread.join();
+
+    const PcRunOptions& opts = pc_platform_options();
+    printf("[Remote] Control server starting on port %d\n", opts.remotePort);
+    if (!s_server.start(opts.remotePort, on_client_line)) return;
+
+    // Report the bound port (ephemeral with --port=0) for test runners.
+    // Written to a temp name and renamed so readers never see a partial file.
+    if (!opts.portFile.empty()) {
+        std::string tmp = opts.portFile + ".tmp";
+        if (FILE* f = fopen(tmp.c_str(), "w")) {
+            fprintf(f, "%u\n", (unsigned)s_server.port());
+            fclose(f);
+            std::remove(opts.portFile.c_str());
+            std::rename(tmp.c_str(), opts.portFile.c_str());
+        } else {
+            printf("[Remote] Cannot write port file %s\n", opts.portFile.c_str());
+        }
     }
+}
+
+void stop() {
+    if (s_macro.active) macro_finish(true);
+    s_server.stop();
+    s_audio.stop();
+    remote::set_audio_target(nullptr);
+    s_shm.close();
     printf("[Remote] Control server stopped\n");
 }
 
+uint32_t next_due_ms() {
+    uint32_t now = lv_tick_get();
+    uint32_t due = macro_run();
+    due = std::min(due, waiters_due_ms(now));
+    due = std::min(due, meter_due_ms(now));
+    return due;
+}
+
 void process_pending() {
-    std::lock_guard<std::mutex> lock(s_queueMutex);
-    while (!s_commandQueue.empty()) {
-        auto cmd = std::move(s_commandQueue.front());
-        s_commandQueue.pop();
-
-        std::string response = dispatch_command(cmd.request);
-
-        // Signal response to waiting TCP thread
-        {
-            std::lock_guard<std::mutex> rlock(s_responseMutex);
-            s_pendingResponse = response;
-            s_responseReady = true;
-        }
+    macro_run();
+
+    // Take the whole batch so the server thread never waits on a handler
+    static std::vector<PendingCommand> batch;
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        batch.swap(s_commandQueue);
+    }
+
+    for (auto& cmd : batch) {
+        s_respDoc.clear();
+        s_dispatching = &cmd;
+        s_replyDeferred = false;
+        dispatch_command(cmd.request.as<JsonObjectConst>(), s_respDoc.to<JsonObject>());
+        s_dispatching = nullptr;
+        if (s_replyDeferred) continue;
+
+        s_respBuf.clear();
+        serializeJson(s_respDoc, s_respBuf);
+        if (cmd.respond) cmd.respond(s_respBuf);
     }
+    batch.clear();
+
+    uint32_t changes = take_changes();
+    service_waiters(changes);
+    publish_events(changes);
+
+    // New or lagging frame viewers need a full frame even if nothing redraws
+    if (s_frames.hasViewers() && s_frames.wantsKeyframe()) submit_frame(true);
 }
 
 } // namespace remote
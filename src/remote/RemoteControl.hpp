@@ -4,15 +4,25 @@
  * @file RemoteControl.hpp
  * @brief Lightweight TCP server for external control of the CrossPad simulator.
  *
- * Listens on localhost:19840, accepts JSON commands over TCP.
- * Runs in a background thread, dispatches commands to LVGL/SDL on the main thread.
+ * Listens on localhost:19840 (--port=N / CROSSPAD_REMOTE_PORT; 0 picks a
+ * free port, written to --port-file) and on a Unix-domain socket
+ * ($XDG_RUNTIME_DIR, $TMPDIR or /tmp, %TEMP% on Windows, as
+ * crosspad-<port>.sock; CROSSPAD_REMOTE_SOCKET overrides, "" disables), and
+ * accepts JSON commands from any number of clients. A poll()-driven
+ * background thread does all socket I/O and dispatches commands to LVGL/SDL
+ * on the main thread.
  *
  * Protocol: newline-delimited JSON.
- * Request:  {"cmd":"screenshot"}\n
- * Response: {"ok":true,"data":"base64..."}\n
+ * Request:  {"id":7,"cmd":"screenshot"}\n
+ * Response: {"id":7,"ok":true,"data":"base64..."}\n
+ *
+ * "id" is optional (number or string) and echoed back verbatim. Clients may
+ * pipeline: send several requests without waiting, then match replies by id.
  *
  * Commands:
- *   screenshot              — capture SDL framebuffer, return base64 BMP
+ *   screenshot {format,region,scale,file}
+ *                           — capture the framebuffer; png (default) / raw /
+ *                             qoi / thumb, encoded off the LVGL thread
  *   click {x,y}             — inject mouse click at (x,y) in window coords
  *   pad_press {pad,vel}     — press pad (0-15), velocity 0-127
  *   pad_release {pad}       — release pad
@@ -20,7 +30,47 @@
  *   encoder_press            — press encoder button
  *   encoder_release          — release encoder button
  *   key {keycode}           — inject SDL keypress
+ *   stats                   — pads, apps, capabilities, heap, settings summary
+ *   settings_get {category} — read settings (display/keypad/vibration/...)
+ *   settings_set {key,value}— write one setting
+ *   batch {commands:[...]}  — run several commands in one LVGL turn,
+ *                             returns {"results":[...]} in the same order
+ *   wait_for {condition,timeout_ms}
+ *                           — reply once the condition holds or on timeout;
+ *                             pad_playing/pad_pressed {pad}, app {name},
+ *                             peak {output,threshold}, screen_changed {region}
+ *   subscribe {topics,meter_hz,queue}
+ *                           — push {"event":...} lines for pad, led, app,
+ *                             midi_in, midi_out and meter (decimated);
+ *                             bounded per-connection queue, drop-oldest
+ *   unsubscribe             — stop pushing; returns queue counters
+ *   stream_frames {enable,encoding,region}
+ *                           — push {"event":"frame"} lines with the dirty
+ *                             rects of every refresh (raw/lz4/qoi BGRA)
+ *   shm {enable,audio_frames}
+ *                           — publish the LCD (seqlock) and tap audio ring
+ *                             in shared memory; replies with name and layout
+ *   audio_stream {source,frames,enable}
+ *                           — push {"event":"audio"} s16le stereo packets
+ *                             from in1/in2/synth/out1/out2 with seq, pos
+ *                             and dropped-frame counters
+ *   clock {mode}            — "virtual" freezes the simulation clock,
+ *                             "real" resumes it; replies with now_ms
+ *   step {ms}               — advance virtual time, running every due LVGL
+ *                             timer/animation and wait_for timeout on the way
+ *   query {type,name,text,text_contains,app,root,depth,limit,after}
+ *                           — matching LVGL objects as JSON (type, coords,
+ *                             text, value, flags); cached until the next
+ *                             invalidation
+ *   play_macro {events,repeat,length_ms,wait,stop}
+ *                           — replay a timed pad/click/encoder/key sequence
+ *                             from the LVGL loop on the simulation clock;
+ *                             reports lateness stats
  *   ping                    — health check
+ *
+ * Under --headless there is no SDL window: click, key and encoder commands
+ * drive virtual LVGL input devices instead. With --headless=lcd the display
+ * is just the LCD, so click/region coordinates are LCD coordinates.
  */
 
 #include "lvgl/lvgl.h"
@@ -29,7 +79,7 @@ namespace remote {
 
 /// Start the remote control TCP server on a background thread.
 /// @param disp  The main LVGL display (for screenshot capture).
-/// Call once after sdl_hal_init().
+/// Call once after sdl_hal_init() / headless_hal_init().
 void start(lv_display_t* disp);
 
 /// Stop the server and join the background thread.
@@ -39,4 +89,10 @@ void stop();
 /// Safe to call from lv_timer callback.
 void process_pending();
 
+/// Run due macro events; returns ms until the remote layer next needs a
+/// turn without being woken (macro events, wait_for timeouts, rate-limited
+/// meter events), UINT32_MAX if never. The LVGL task sleeps no longer than
+/// this; everything else arrives through remote::wake().
+uint32_t next_due_ms();
+
 } // namespace remote
@@ -0,0 +1,103 @@
+/**
+ * @file RemoteEvents.cpp
+ * @brief Lock-free change mask, meter snapshot and MIDI tap for the remote control layer.
+ */
+
+#include "RemoteEvents.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace remote {
+
+static std::atomic<uint32_t> s_changed{0};
+static std::atomic<uint32_t> s_levels[2] = {};   // (L << 16) | R
+static std::atomic<void (*)()> s_wakeHook{nullptr};
+
+void notify(uint32_t topics) {
+    // Only the first change since the last take needs to wake the loop
+    if (s_changed.fetch_or(topics, std::memory_order_release) == 0 && topics)
+        wake();
+}
+
+uint32_t take_changes() {
+    return s_changed.exchange(0, std::memory_order_acquire);
+}
+
+void set_wake_hook(void (*fn)()) {
+    s_wakeHook.store(fn, std::memory_order_release);
+}
+
+void wake() {
+    if (auto fn = s_wakeHook.load(std::memory_order_acquire)) fn();
+}
+
+void publish_levels(int output, int16_t left, int16_t right) {
+    if (output < 0 || output > 1) return;
+    uint32_t packed = ((uint32_t)(uint16_t)left << 16) | (uint16_t)right;
+    if (s_levels[output].exchange(packed, std::memory_order_relaxed) != packed)
+        notify(TOPIC_METER);
+}
+
+void output_levels(int output, int16_t& left, int16_t& right) {
+    uint32_t packed = (output == 0 || output == 1)
+                    ? s_levels[output].load(std::memory_order_relaxed) : 0;
+    left  = (int16_t)(packed >> 16);
+    right = (int16_t)(packed & 0xFFFF);
+}
+
+int16_t output_peak(int output) {
+    int16_t l, r;
+    output_levels(output, l, r);
+    return std::max(l, r);
+}
+
+// ── MIDI tap ──
+
+static constexpr size_t MIDI_RING = 256;
+
+static std::atomic<bool> s_midiTap{false};
+static std::mutex  s_midiMutex;
+static MidiRecord  s_midiRing[MIDI_RING];
+static size_t      s_midiHead  = 0;   // next write
+static size_t      s_midiCount = 0;
+static uint32_t    s_midiDropped = 0;
+
+void set_midi_tap(bool enabled) {
+    s_midiTap.store(enabled, std::memory_order_relaxed);
+}
+
+void publish_midi(bool out, const uint8_t* msg, size_t size) {
+    if (!s_midiTap.load(std::memory_order_relaxed) || !msg || size == 0) return;
+
+    MidiRecord rec;
+    rec.out  = out;
+    rec.len  = (uint8_t)std::min<size_t>(size, sizeof(rec.data));
+    rec.size = (uint32_t)size;
+    memcpy(rec.data, msg, rec.len);
+
+    {
+        std::lock_guard<std::mutex> lock(s_midiMutex);
+        s_midiRing[s_midiHead] = rec;
+        s_midiHead = (s_midiHead + 1) % MIDI_RING;
+        if (s_midiCount == MIDI_RING) s_midiDropped++;
+        else s_midiCount++;
+    }
+    notify(out ? TOPIC_MIDI_OUT : TOPIC_MIDI_IN);
+}
+
+size_t drain_midi(MidiRecord* dst, size_t max, uint32_t& dropped) {
+    std::lock_guard<std::mutex> lock(s_midiMutex);
+    size_t n = std::min(max, s_midiCount);
+    size_t tail = (s_midiHead + MIDI_RING - s_midiCount) % MIDI_RING;
+    for (size_t i = 0; i < n; i++)
+        dst[i] = s_midiRing[(tail + i) % MIDI_RING];
+    s_midiCount -= n;
+    dropped += s_midiDropped;
+    s_midiDropped = 0;
+    return n;
+}
+
+} // namespace remote
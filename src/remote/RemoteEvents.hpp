@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * @file RemoteEvents.hpp
+ * @brief Change notifications from the simulator into the remote control layer.
+ *
+ * Producers (pad/LED code, app switching, the VU timer, the display) call
+ * notify() whenever something observable changed. It only ORs a bit into an
+ * atomic mask, so it is safe and cheap from any thread — including audio and
+ * RtMidi callbacks. The LVGL thread collects the mask once per turn and
+ * re-evaluates only what could have changed (wait_for conditions, push
+ * subscriptions, etc.).
+ *
+ * The LVGL thread sleeps until its next timer is due; wake() cuts that
+ * sleep short. notify() wakes it on the first change of a turn, and other
+ * producers (queued remote commands, worker threads with results) call
+ * wake() directly.
+ *
+ * No LVGL/SDL dependency — safe to include from platform stubs.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace remote {
+
+enum Topic : uint32_t {
+    TOPIC_PAD      = 1u << 0,   ///< pad pressed/released/playing
+    TOPIC_LED      = 1u << 1,   ///< LED strip pixel changed
+    TOPIC_APP      = 1u << 2,   ///< app / active pad logic switched
+    TOPIC_MIDI_IN  = 1u << 3,
+    TOPIC_MIDI_OUT = 1u << 4,
+    TOPIC_METER    = 1u << 5,   ///< new output levels published
+    TOPIC_DISPLAY  = 1u << 6,   ///< LVGL finished a refresh
+};
+
+/// Mark @p topics as changed. Thread-safe, lock-free.
+void notify(uint32_t topics);
+
+/// Fetch and clear the changed-topics mask (LVGL thread).
+uint32_t take_changes();
+
+/// Install the function wake() calls (the LVGL task's main loop).
+void set_wake_hook(void (*fn)());
+
+/// Ask the LVGL thread for a turn as soon as possible. Thread-safe,
+/// lock-free; a no-op until a hook is installed.
+void wake();
+
+/// Publish the latest output peak levels (int16 amplitude, 0–32767).
+/// Called by the VU timer; also raises TOPIC_METER.
+void publish_levels(int output, int16_t left, int16_t right);
+
+/// Latest published peak for @p output (0 or 1), max of L/R.
+int16_t output_peak(int output);
+
+/// Latest published L/R levels for @p output (0 or 1).
+void output_levels(int output, int16_t& left, int16_t& right);
+
+// ── MIDI tap ──
+
+/// One MIDI message seen by PcMidi. SysEx is summarised (size + head).
+struct MidiRecord {
+    bool     out;       ///< true = sent, false = received
+    uint8_t  len;       ///< valid bytes in data[]
+    uint8_t  data[3];
+    uint32_t size;      ///< full message length
+};
+
+/// Enable recording (off by default so MIDI traffic costs nothing).
+void set_midi_tap(bool enabled);
+
+/// Record a MIDI message from any thread; raises TOPIC_MIDI_IN/OUT.
+/// Bounded ring — the oldest record is dropped when full.
+void publish_midi(bool out, const uint8_t* msg, size_t size);
+
+/// Move up to @p max records into @p dst (LVGL thread).
+/// @param dropped  incremented by records lost since the last drain
+size_t drain_midi(MidiRecord* dst, size_t max, uint32_t& dropped);
+
+} // namespace remote
@@ -0,0 +1,488 @@
+/**
+ * @file RemoteServer.cpp
+ * @brief poll()-based multi-client line server (Winsock / BSD sockets).
+ */
+
+#include "RemoteServer.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#  if __has_include(<afunix.h>)
+#    include <afunix.h>
+#    define HAVE_AF_UNIX 1
+#  endif
+#  pragma comment(lib, "ws2_32.lib")
+   typedef SOCKET socket_t;
+#  define CLOSE_SOCKET closesocket
+#  define SOCKET_INVALID INVALID_SOCKET
+#  define poll WSAPoll
+#  define SEND_FLAGS 0
+   static bool would_block() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+   static void set_nonblocking(socket_t s) { u_long on = 1; ioctlsocket(s, FIONBIO, &on); }
+#else
+#  include <sys/socket.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <arpa/inet.h>
+#  include <sys/un.h>
+#  include <poll.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <cerrno>
+   typedef int socket_t;
+#  define CLOSE_SOCKET close
+#  define SOCKET_INVALID (-1)
+#  define SEND_FLAGS MSG_NOSIGNAL
+#  define HAVE_AF_UNIX 1
+   static bool would_block() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+   static void set_nonblocking(socket_t s) { fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK); }
+#endif
+
+namespace remote {
+
+static inline socket_t to_sock(uintptr_t s) { return (socket_t)s; }
+static inline uintptr_t from_sock(socket_t s) { return (uintptr_t)s; }
+static const uintptr_t INVALID = from_sock(SOCKET_INVALID);
+
+/* ── Connection ──────────────────────────────────────────────────────── */
+
+void Connection::send(const std::string& line)
+{
+    bool needWake = false;
+    {
+        std::lock_guard<std::mutex> lock(outMutex_);
+        if (!open_.load(std::memory_order_relaxed)) return;
+
+        bool idle = (outPos_ == outBuf_.size());
+        if (idle) {
+            outBuf_.clear();
+            outPos_ = 0;
+        } else if (outBuf_.size() - outPos_ + line.size() >= MAX_PENDING_BYTES) {
+            // Not reading its replies: drop it rather than grow without bound
+            printf("[Remote] Client #%u has %zu reply bytes pending, closing\n", id_, outBuf_.size() - outPos_);
+            open_.store(false, std::memory_order_release);
+            outBuf_.clear();
+            outPos_ = 0;
+            events_.clear();
+            eventBytes_ = 0;
+            overflowed_ = true;
+        }
+
+        if (overflowed_) {
+            needWake = true;   // the server thread closes it
+        } else {
+            outBuf_ += line;
+            outBuf_ += '\n';
+
+            // Fast path: socket was idle, write from the caller's thread
+            if (idle && !flushLocked()) needWake = true;
+            if (outPos_ != outBuf_.size()) needWake = true;
+        }
+    }
+    if (needWake && server_) server_->wake();
+}
+
+void Connection::pushEvent(std::string&& line)
+{
+    bool needWake = false;
+    {
+        std::lock_guard<std::mutex> lock(outMutex_);
+        if (!open_.load(std::memory_order_relaxed)) return;
+
+        if (events_.size() >= eventCap_) {
+            eventBytes_ -= events_.front().size() + 1;
+            events_.pop_front();
+            evStats_.dropped++;
+        }
+        eventBytes_ += line.size() + 1;
+        events_.push_back(std::move(line));
+        evStats_.queued++;
+
+        // Same fast path as send(): only when the socket buffer is empty
+        if (outPos_ == outBuf_.size() && !flushLocked()) needWake = true;
+        if (outPos_ != outBuf_.size() || !events_.empty()) needWake = true;
+    }
+    if (needWake && server_) server_->wake();
+}
+
+void Connection::setEventCapacity(size_t maxEvents)
+{
+    std::lock_guard<std::mutex> lock(outMutex_);
+    eventCap_ = maxEvents ? maxEvents : 1;
+    while (events_.size() > eventCap_) {
+        eventBytes_ -= events_.front().size() + 1;
+        events_.pop_front();
+        evStats_.dropped++;
+    }
+}
+
+Connection::EventStats Connection::eventStats() const
+{
+    std::lock_guard<std::mutex> lock(outMutex_);
+    EventStats st = evStats_;
+    st.depth = events_.size();
+    return st;
+}
+
+size_t Connection::pendingBytes() const
+{
+    std::lock_guard<std::mutex> lock(outMutex_);
+    return outBuf_.size() - outPos_ + eventBytes_;
+}
+
+std::shared_ptr<void> Connection::holdOpen()
+{
+    struct Hold {
+        std::weak_ptr<Connection> conn;
+        ~Hold()
+        {
+            auto c = conn.lock();
+            if (c && c->holds_.fetch_sub(1, std::memory_order_acq_rel) == 1 && c->server_) c->server_->wake();
+        }
+    };
+    holds_.fetch_add(1, std::memory_order_acq_rel);
+    auto hold = std::make_shared<Hold>();
+    hold->conn = weak_from_this();
+    return hold;
+}
+
+void Connection::refillLocked()
+{
+    // Bound what sits in outBuf_ so drop-oldest keeps working under backpressure
+    static constexpr size_t REFILL_BYTES = 16 * 1024;
+
+    outBuf_.clear();
+    outPos_ = 0;
+    while (!events_.empty() && outBuf_.size() < REFILL_BYTES) {
+        std::string& ev = events_.front();
+        eventBytes_ -= ev.size() + 1;
+        outBuf_ += ev;
+        outBuf_ += '\n';
+        events_.pop_front();
+        evStats_.sent++;
+    }
+}
+
+bool Connection::flushLocked()
+{
+    if (overflowed_) return false;
+    for (;;) {
+        while (outPos_ < outBuf_.size()) {
+            int n = ::send(to_sock(sock_), outBuf_.data() + outPos_,
+                           (int)(outBuf_.size() - outPos_), SEND_FLAGS);
+            if (n > 0) {
+                outPos_ += (size_t)n;
+                continue;
+            }
+            return n < 0 && would_block();
+        }
+        if (events_.empty()) break;
+        refillLocked();
+    }
+    outBuf_.clear();
+    outPos_ = 0;
+    return true;
+}
+
+/* ── Server ──────────────────────────────────────────────────────────── */
+
+Server::~Server()
+{
+    stop();
+}
+
+bool Server::start(uint16_t port, LineHandler onLine, CloseHandler onClose)
+{
+    if (running_) return true;
+
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+        printf("[Remote] WSAStartup failed\n");
+        return false;
+    }
+#endif
+
+    onLine_  = std::move(onLine);
+    onClose_ = std::move(onClose);
+
+    socket_t ls = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (ls == SOCKET_INVALID) {
+        printf("[Remote] Failed to create socket\n");
+        return false;
+    }
+
+    // Allow reuse
+    int reuse = 1;
+    setsockopt(ls, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // localhost only
+    addr.sin_port = htons(port);
+
+    if (bind(ls, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(ls, SOMAXCONN) != 0) {
+        printf("[Remote] Failed to bind port %d\n", port);
+        CLOSE_SOCKET(ls);
+        return false;
+    }
+    set_nonblocking(ls);
+
+    // Port 0 binds an ephemeral port; report the real one
+    socklen_t alen = sizeof(addr);
+    if (getsockname(ls, (struct sockaddr*)&addr, &alen) == 0) port = ntohs(addr.sin_port);
+    port_ = port;
+
+    // Doorbell: a UDP socket bound to an ephemeral loopback port that
+    // sends datagrams to itself. Works with WSAPoll, unlike pipes.
+    socket_t ws = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    struct sockaddr_in waddr = {};
+    waddr.sin_family = AF_INET;
+    waddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    waddr.sin_port = 0;
+    socklen_t wlen = sizeof(waddr);
+    if (ws == SOCKET_INVALID ||
+        bind(ws, (struct sockaddr*)&waddr, sizeof(waddr)) != 0 ||
+        getsockname(ws, (struct sockaddr*)&waddr, &wlen) != 0 ||
+        connect(ws, (struct sockaddr*)&waddr, sizeof(waddr)) != 0) {
+        printf("[Remote] Failed to create wake socket\n");
+        if (ws != SOCKET_INVALID) CLOSE_SOCKET(ws);
+        CLOSE_SOCKET(ls);
+        return false;
+    }
+    set_nonblocking(ws);
+
+    listeners_.clear();
+    listeners_.push_back(from_sock(ls));
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wakeSock_ = from_sock(ws);
+        wakePending_ = false;
+    }
+    printf("[Remote] Listening on 127.0.0.1:%d\n", port);
+
+    if (!unixPath_.empty()) openUnixListener();
+
+    running_    = true;
+    thread_     = std::thread(&Server::threadFunc, this);
+    return true;
+}
+
+bool Server::openUnixListener()
+{
+#ifdef HAVE_AF_UNIX
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::string path = unixPath_;
+    size_t tok = path.find("{port}");
+    if (tok != std::string::npos) path.replace(tok, 6, std::to_string(port_));
+
+    if (path.size() >= sizeof(addr.sun_path)) {
+        printf("[Remote] Unix socket path too long: %s\n", path.c_str());
+        return false;
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    socket_t us = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (us == SOCKET_INVALID) {
+        printf("[Remote] AF_UNIX sockets not available\n");
+        return false;
+    }
+
+    remove(path.c_str());   // stale socket from a previous run
+    if (bind(us, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(us, SOMAXCONN) != 0) {
+        printf("[Remote] Failed to bind %s\n", path.c_str());
+        CLOSE_SOCKET(us);
+        return false;
+    }
+    set_nonblocking(us);
+
+    listeners_.push_back(from_sock(us));
+    boundUnixPath_ = path;
+    printf("[Remote] Listening on %s\n", path.c_str());
+    return true;
+#else
+    printf("[Remote] AF_UNIX not supported by this build\n");
+    return false;
+#endif
+}
+
+void Server::stop()
+{
+    if (!running_.exchange(false)) return;
+    wake();
+    if (thread_.joinable()) thread_.join();
+
+    for (uintptr_t ls : listeners_) CLOSE_SOCKET(to_sock(ls));
+    listeners_.clear();
+    {
+        // Replies finishing on other threads may still ring
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        CLOSE_SOCKET(to_sock(wakeSock_));
+        wakeSock_ = INVALID;
+    }
+
+    if (!boundUnixPath_.empty()) {
+        remove(boundUnixPath_.c_str());
+        boundUnixPath_.clear();
+    }
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void Server::wake()
+{
+    if (wakePending_.exchange(true)) return;   // already ringing
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    if (wakeSock_ == INVALID) return;           // stopped
+    char b = 1;
+    ::send(to_sock(wakeSock_), &b, 1, 0);
+}
+
+void Server::acceptClients(uintptr_t listenSock)
+{
+    bool tcp = (listenSock == listeners_[0]);
+    for (;;) {
+        socket_t cs = accept(to_sock(listenSock), nullptr, nullptr);
+        if (cs == SOCKET_INVALID) return;
+
+        set_nonblocking(cs);
+        if (tcp) {
+            int nodelay = 1;
+            setsockopt(cs, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+        }
+
+        auto conn = std::make_shared<Connection>();
+        conn->server_ = this;
+        conn->sock_   = from_sock(cs);
+        conn->id_     = nextConnId_++;
+        conns_.push_back(conn);
+        clientCount_ = conns_.size();
+        printf("[Remote] Client #%u connected (%zu active)\n", conn->id_, conns_.size());
+    }
+}
+
+bool Server::readClient(const ConnectionPtr& conn)
+{
+    char chunk[4096];
+    bool alive = true;
+    for (;;) {
+        int n = recv(to_sock(conn->sock_), chunk, sizeof(chunk), 0);
+        if (n == 0) {
+            // Half-close: requests are in, replies may still be due
+            conn->readClosed_ = true;
+            break;
+        }
+        if (n < 0) { alive = would_block(); break; }
+        conn->inBuf_.append(chunk, (size_t)n);
+        if ((size_t)n < sizeof(chunk) || conn->inBuf_.size() > Connection::MAX_LINE_BYTES) break;
+    }
+
+    // Process complete lines (newline-delimited JSON)
+    size_t start = 0, pos;
+    std::string& buf = conn->inBuf_;
+    while ((pos = buf.find('\n', start)) != std::string::npos) {
+        size_t end = pos;
+        if (end > start && buf[end - 1] == '\r') end--;
+        if (end > start) onLine_(conn, buf.substr(start, end - start));
+        start = pos + 1;
+    }
+    buf.erase(0, start);
+
+    if (buf.size() > Connection::MAX_LINE_BYTES) {
+        printf("[Remote] Client #%u sent a line over %zu bytes, closing\n", conn->id_, Connection::MAX_LINE_BYTES);
+        buf.clear();
+        return false;
+    }
+    return alive;
+}
+
+void Server::closeClient(const ConnectionPtr& conn)
+{
+    {
+        std::lock_guard<std::mutex> lock(conn->outMutex_);
+        conn->open_.store(false, std::memory_order_release);
+        CLOSE_SOCKET(to_sock(conn->sock_));
+        conn->sock_ = INVALID;
+    }
+    printf("[Remote] Client #%u disconnected\n", conn->id_);
+    if (onClose_) onClose_(conn);
+}
+
+void Server::threadFunc()
+{
+    std::vector<struct pollfd> fds;
+
+    while (running_) {
+        fds.clear();
+        fds.push_back({ to_sock(wakeSock_), POLLIN, 0 });
+        for (uintptr_t ls : listeners_) fds.push_back({ to_sock(ls), POLLIN, 0 });
+        const size_t base = fds.size();
+        for (auto& c : conns_) {
+            short events = c->readClosed_ ? 0 : POLLIN;
+            if (c->pendingBytes() > 0) events |= POLLOUT;
+            fds.push_back({ to_sock(c->sock_), events, 0 });
+        }
+
+        int ready = poll(fds.data(), (unsigned long)fds.size(), 1000);
+        if (!running_) break;
+        if (ready < 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (recv(to_sock(wakeSock_), drain, sizeof(drain), 0) > 0) {}
+            wakePending_ = false;
+        }
+
+        // Service existing clients first (indices line up with fds[base..])
+        std::vector<ConnectionPtr> dead;
+        for (size_t i = 0; i < conns_.size(); i++) {
+            auto& c = conns_[i];
+            short re = fds[base + i].revents;
+            bool alive = true;
+
+            if (c->readClosed_)
+                alive = !(re & (POLLHUP | POLLERR));
+            else if (re & (POLLIN | POLLHUP | POLLERR))
+                alive = readClient(c) && !(re & POLLERR);
+
+            if (alive) {
+                std::lock_guard<std::mutex> lock(c->outMutex_);
+                alive = c->flushLocked();
+            }
+            // Half-closed: done once every reply is written
+            if (alive && c->readClosed_ && c->holds_.load(std::memory_order_acquire) == 0 &&
+                c->pendingBytes() == 0)
+                alive = false;
+            if (!alive) dead.push_back(c);
+        }
+
+        for (size_t i = 0; i < listeners_.size(); i++) {
+            if (fds[1 + i].revents & POLLIN) acceptClients(listeners_[i]);
+        }
+
+        for (auto& c : dead) {
+            closeClient(c);
+            for (size_t i = 0; i < conns_.size(); i++) {
+                if (conns_[i] == c) { conns_.erase(conns_.begin() + i); break; }
+            }
+        }
+        clientCount_ = conns_.size();
+    }
+
+    for (auto& c : conns_) closeClient(c);
+    conns_.clear();
+    clientCount_ = 0;
+    printf("[Remote] Server stopped\n");
+}
+
+} // namespace remote
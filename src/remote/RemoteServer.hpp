@@ -0,0 +1,181 @@
+#pragma once
+
+/**
+ * @file RemoteServer.hpp
+ * @brief Event-driven, multi-client line server used by RemoteControl.
+ *
+ * One background thread multiplexes the listen sockets (TCP loopback and,
+ * optionally, an AF_UNIX path) and every client with poll() (WSAPoll on
+ * Windows). Incoming bytes are split into lines and handed
+ * to a LineHandler; replies are queued per connection and may be sent from
+ * any thread. A loopback UDP "doorbell" socket wakes the poll loop when
+ * another thread queues output that could not be written immediately.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace remote {
+
+class Server;
+
+/// One connected client. Shared between the server thread and responders.
+class Connection : public std::enable_shared_from_this<Connection> {
+public:
+    /// Unique per server lifetime (never reused).
+    uint32_t id() const { return id_; }
+
+    bool isOpen() const { return open_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Queue @p line (a '\n' is appended) for sending. Thread-safe.
+     *
+     * Tries to write straight to the socket when nothing is queued, so the
+     * common case never touches the server thread. A client that lets more
+     * than MAX_PENDING_BYTES of replies pile up is disconnected.
+     */
+    void send(const std::string& line);
+
+    /// Unsent reply bytes at which a client is dropped.
+    static constexpr size_t MAX_PENDING_BYTES = 64u << 20;
+    /// Longest request line accepted; a longer one drops the client.
+    static constexpr size_t MAX_LINE_BYTES = 16u << 20;
+
+    /**
+     * @brief Queue a push event line (subscription stream). Thread-safe.
+     *
+     * Events wait in a bounded queue and are only moved to the socket buffer
+     * as it drains. When the queue is full the oldest event is dropped, so a
+     * slow client costs memory proportional to the capacity, never a stall.
+     */
+    void pushEvent(std::string&& line);
+
+    /// Maximum number of queued (unsent) events. Default 1024.
+    void setEventCapacity(size_t maxEvents);
+
+    struct EventStats {
+        uint64_t queued  = 0;   ///< accepted by pushEvent()
+        uint64_t sent    = 0;   ///< handed to the socket
+        uint64_t dropped = 0;   ///< discarded by drop-oldest
+        size_t   depth   = 0;   ///< currently waiting
+    };
+    EventStats eventStats() const;
+
+    /// Bytes (responses + events) waiting to be written.
+    size_t pendingBytes() const;
+
+    /**
+     * @brief Keep the connection open for a reply still to come. Thread-safe.
+     *
+     * A client that half-closes after sending its requests (shutdown(SHUT_WR),
+     * `printf ... | nc`) is closed only once every token returned here has
+     * been released and its output has drained.
+     */
+    std::shared_ptr<void> holdOpen();
+
+private:
+    friend class Server;
+
+    bool flushLocked();   // returns false on hard socket error
+    void refillLocked();  // move queued events into outBuf_
+
+    Server*   server_ = nullptr;
+    uintptr_t sock_   = ~uintptr_t(0);
+    uint32_t  id_     = 0;
+    std::atomic<bool> open_{true};
+    std::atomic<int>  holds_{0};   // replies still to come (holdOpen)
+    bool overflowed_ = false;   // replies hit MAX_PENDING_BYTES; server closes it
+    bool readClosed_ = false;   // peer sent EOF; server thread only
+
+    mutable std::mutex outMutex_;
+    std::string outBuf_;
+    size_t      outPos_ = 0;
+
+    std::deque<std::string> events_;
+    size_t      eventBytes_ = 0;
+    size_t      eventCap_   = 1024;
+    EventStats  evStats_;
+
+    std::string inBuf_;   // server thread only
+};
+
+using ConnectionPtr = std::shared_ptr<Connection>;
+
+class Server {
+public:
+    /// Called on the server thread for each complete line (without '\n').
+    using LineHandler  = std::function<void(const ConnectionPtr& conn, std::string&& line)>;
+    using CloseHandler = std::function<void(const ConnectionPtr& conn)>;
+
+    Server() = default;
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * @brief Also listen on a Unix-domain socket at @p path. Call before start().
+     *
+     * A stale socket file is removed first. "{port}" in @p path is replaced
+     * by the bound TCP port. Failure to bind is logged and does not prevent
+     * the TCP listener from starting.
+     */
+    void setUnixSocketPath(const std::string& path) { unixPath_ = path; }
+
+    /// Unix socket path actually bound ("" if none).
+    const std::string& unixSocketPath() const { return boundUnixPath_; }
+
+    /**
+     * @brief Bind 127.0.0.1:@p port and start the server thread.
+     * @param port  0 = let the OS pick a free port (see port())
+     * @return false if the socket could not be bound
+     */
+    bool start(uint16_t port, LineHandler onLine, CloseHandler onClose = nullptr);
+
+    /// TCP port actually bound (0 before start()).
+    uint16_t port() const { return port_; }
+
+    /// Close all connections and join the server thread.
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    /// Ask the poll loop to flush queued output. Thread-safe, coalesced.
+    void wake();
+
+    size_t clientCount() const { return clientCount_.load(); }
+
+private:
+    void threadFunc();
+    void acceptClients(uintptr_t listenSock);
+    bool openUnixListener();
+    bool readClient(const ConnectionPtr& conn);
+    void closeClient(const ConnectionPtr& conn);
+
+    LineHandler  onLine_;
+    CloseHandler onClose_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> wakePending_{false};
+    std::atomic<size_t> clientCount_{0};
+
+    std::vector<uintptr_t> listeners_;        // TCP first, then AF_UNIX
+    std::mutex wakeMutex_;                     // wakeSock_ vs. wake() from other threads
+    uintptr_t wakeSock_   = ~uintptr_t(0);   // ~0 == invalid on both platforms
+    std::string unixPath_;
+    std::string boundUnixPath_;
+    uint16_t  port_       = 0;
+    uint32_t  nextConnId_ = 1;
+
+    std::vector<ConnectionPtr> conns_;   // server thread only
+};
+
+} // namespace remote
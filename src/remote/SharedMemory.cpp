@@ -0,0 +1,220 @@
+/**
+ * @file SharedMemory.cpp
+ * @brief Named shared-memory region with a seqlock LCD and an audio ring.
+ */
+
+#include "SharedMemory.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace remote {
+
+static size_t align_up(size_t v, size_t a) { return (v + a - 1) & ~(a - 1); }
+
+static uint32_t next_pow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+bool SharedMemory::open(const std::string& name, int fbW, int fbH, uint32_t audioFrames)
+{
+    close();
+    if (fbW <= 0 || fbH <= 0) return false;
+
+    const uint32_t stride   = (uint32_t)fbW * 4;
+    const uint32_t capacity = next_pow2(std::max<uint32_t>(audioFrames, 1024));
+    const size_t fbOffset   = align_up(sizeof(ShmHeader), 64);
+    const size_t audioOffset = align_up(fbOffset + (size_t)stride * fbH, 64);
+    const size_t total      = audioOffset + (size_t)capacity * 2 * sizeof(int16_t);
+
+    void* mem = nullptr;
+#ifdef _WIN32
+    std::string winName = "Local\\" + (name[0] == '/' ? name.substr(1) : name);
+    HANDLE h = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                  (DWORD)((uint64_t)total >> 32), (DWORD)(total & 0xFFFFFFFF),
+                                  winName.c_str());
+    if (!h) {
+        printf("[Remote] CreateFileMapping(%s) failed: %lu\n", winName.c_str(), GetLastError());
+        return false;
+    }
+    mem = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, total);
+    if (!mem) {
+        CloseHandle(h);
+        return false;
+    }
+    mapping_ = h;
+#else
+    shm_unlink(name.c_str());   // stale region from a crashed run
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        printf("[Remote] shm_open(%s) failed\n", name.c_str());
+        return false;
+    }
+    if (ftruncate(fd, (off_t)total) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    mem = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    fd_ = fd;
+#endif
+
+    base_   = static_cast<uint8_t*>(mem);
+    size_   = total;
+    name_   = name;
+    memset(base_, 0, sizeof(ShmHeader));
+
+    header_ = new (base_) ShmHeader();
+    header_->headerSize    = sizeof(ShmHeader);
+    header_->totalSize     = (uint32_t)total;
+#ifdef _WIN32
+    header_->pid           = (uint32_t)GetCurrentProcessId();
+#else
+    header_->pid           = (uint32_t)getpid();
+#endif
+    header_->fbOffset      = (uint32_t)fbOffset;
+    header_->fbWidth       = (uint32_t)fbW;
+    header_->fbHeight      = (uint32_t)fbH;
+    header_->fbStride      = stride;
+    header_->fbFormat      = SHM_FORMAT_BGRA8888;
+    header_->audioOffset   = (uint32_t)audioOffset;
+    header_->audioCapacity = capacity;
+    header_->audioChannels = 2;
+    header_->audioRate.store(48000, std::memory_order_relaxed);
+    header_->version       = SHM_VERSION;
+    // Magic last: a reader that sees it sees a complete layout
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic         = SHM_MAGIC;
+
+    fullPending_ = true;
+    printf("[Remote] Shared memory %s: %dx%d LCD, %u-frame audio ring, %zu bytes\n",
+           name.c_str(), fbW, fbH, capacity, total);
+    return true;
+}
+
+void SharedMemory::close()
+{
+    if (!base_) return;
+    header_ = nullptr;
+#ifdef _WIN32
+    UnmapViewOfFile(base_);
+    CloseHandle((HANDLE)mapping_);
+    mapping_ = nullptr;
+#else
+    munmap(base_, size_);
+    ::close(fd_);
+    fd_ = -1;
+    shm_unlink(name_.c_str());
+#endif
+    base_ = nullptr;
+    size_ = 0;
+    name_.clear();
+}
+
+void SharedMemory::publishFrame(const uint8_t* src, int srcStride,
+                                const Rect* dirty, size_t count, uint32_t timeMs)
+{
+    if (!header_ || !src) return;
+
+    const int w = (int)header_->fbWidth;
+    const int h = (int)header_->fbHeight;
+    uint8_t* dst = base_ + header_->fbOffset;
+    const size_t dstStride = header_->fbStride;
+
+    const Rect full = { 0, 0, w, h };
+    if (fullPending_) {
+        dirty = &full;
+        count = 1;
+    }
+    if (count == 0) return;
+
+    uint32_t seq = header_->fbSeq.load(std::memory_order_relaxed);
+    header_->fbSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < count; i++) {
+        const Rect& r = dirty[i];
+        const size_t rowBytes = (size_t)r.w * 4;
+        for (int y = r.y; y < r.y + r.h; y++) {
+            memcpy(dst + (size_t)y * dstStride + (size_t)r.x * 4,
+                   src + (size_t)y * srcStride + (size_t)r.x * 4, rowBytes);
+        }
+    }
+
+    header_->fbFrame++;
+    header_->fbTimeMs = timeMs;
+    header_->fbSeq.store(seq + 2, std::memory_order_release);
+    fullPending_ = false;
+}
+
+void SharedMemory::publishAudio(const int16_t* interleaved, uint32_t frames, uint32_t sampleRate)
+{
+    if (!header_ || !interleaved || frames == 0) return;
+
+    const uint32_t cap = header_->audioCapacity;
+    int16_t* ring = reinterpret_cast<int16_t*>(base_ + header_->audioOffset);
+
+    if (header_->audioRate.load(std::memory_order_relaxed) != sampleRate)
+        header_->audioRate.store(sampleRate, std::memory_order_relaxed);
+
+    // Only the newest `cap` frames can survive anyway
+    if (frames > cap) {
+        interleaved += (size_t)(frames - cap) * 2;
+        header_->audioWritePos.fetch_add(frames - cap, std::memory_order_relaxed);
+        frames = cap;
+    }
+
+    uint64_t pos = header_->audioWritePos.load(std::memory_order_relaxed);
+    uint32_t slot  = (uint32_t)(pos & (cap - 1));
+    uint32_t first = std::min(frames, cap - slot);
+    memcpy(ring + (size_t)slot * 2, interleaved, (size_t)first * 2 * sizeof(int16_t));
+    if (first < frames)
+        memcpy(ring, interleaved + (size_t)first * 2, (size_t)(frames - first) * 2 * sizeof(int16_t));
+
+    header_->audioWritePos.store(pos + frames, std::memory_order_release);
+}
+
+// ── Mixer tap routing ──
+
+static std::atomic<SharedMemory*> s_audioTarget{nullptr};
+static std::atomic<int>           s_audioBusy{0};
+
+void publish_audio(const int16_t* interleaved, uint32_t frames, uint32_t sampleRate)
+{
+    // seq_cst: the busy mark must be visible before the target is read
+    s_audioBusy.fetch_add(1);
+    if (SharedMemory* shm = s_audioTarget.load())
+        shm->publishAudio(interleaved, frames, sampleRate);
+    s_audioBusy.fetch_sub(1);
+}
+
+void set_audio_target(SharedMemory* shm)
+{
+    s_audioTarget.store(shm);
+    // Wait out a publish that may still hold the previous target
+    while (s_audioBusy.load() != 0)
+        std::this_thread::yield();
+}
+
+} // namespace remote
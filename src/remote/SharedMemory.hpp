@@ -0,0 +1,137 @@
+#pragma once
+
+/**
+ * @file SharedMemory.hpp
+ * @brief Zero-copy shared-memory publication of the LCD and tap audio.
+ *
+ * When enabled (remote command "shm"), the simulator maps a named region
+ * (POSIX shm_open "/crosspad-<port>", Windows "Local\crosspad-<port>") and
+ * keeps it updated:
+ *
+ *   [ShmHeader][LCD framebuffer, BGRA8888][audio ring, int16 stereo]
+ *
+ * Test tools map the same name read-only and use the socket only for
+ * commands. All fields are little-endian; offsets are from the region start.
+ *
+ * Framebuffer — seqlock. The writer makes fbSeq odd, copies the dirty rows,
+ * then makes it even again. Readers:
+ *
+ *     do { s1 = fbSeq (acquire); if (s1 & 1) continue;
+ *          copy pixels;
+ *          s2 = fbSeq (acquire fence first); } while (s1 != s2);
+ *
+ * Audio — single-producer ring of audioCapacity frames (power of two).
+ * audioWritePos counts frames ever written; frame n lives at slot
+ * n & (audioCapacity - 1). A reader keeps its own cursor; if
+ * writePos - cursor > audioCapacity it was lapped and should skip ahead.
+ * Re-check writePos after copying to detect an overwrite during the copy.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "FrameStream.hpp"   // remote::Rect
+
+namespace remote {
+
+static constexpr uint32_t SHM_MAGIC   = 0x48535043;   // "CPSH"
+static constexpr uint32_t SHM_VERSION = 1;
+
+static constexpr uint32_t SHM_FORMAT_BGRA8888 = 0;
+
+struct ShmHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t totalSize;
+    uint32_t pid;
+    uint32_t reserved0[3];
+
+    // LCD framebuffer (seqlock)
+    std::atomic<uint32_t> fbSeq;
+    uint32_t fbOffset;
+    uint32_t fbWidth;
+    uint32_t fbHeight;
+    uint32_t fbStride;      ///< bytes per row
+    uint32_t fbFormat;      ///< SHM_FORMAT_*
+    uint32_t fbFrame;       ///< publications so far
+    uint32_t fbTimeMs;      ///< lv_tick of the last publication
+
+    // Tap audio ring
+    uint32_t audioOffset;
+    uint32_t audioCapacity; ///< frames, power of two
+    uint32_t audioChannels; ///< always 2 (interleaved int16)
+    std::atomic<uint32_t> audioRate;
+    std::atomic<uint64_t> audioWritePos;
+
+    uint32_t reserved1[10];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+              std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == 4 && sizeof(std::atomic<uint64_t>) == 8,
+              "shared-memory atomics must match the plain layout");
+static_assert(sizeof(ShmHeader) == 128, "ShmHeader layout is part of the protocol");
+
+class SharedMemory {
+public:
+    SharedMemory() = default;
+    ~SharedMemory() { close(); }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    /**
+     * @brief Create (or replace) the region and lay it out.
+     * @param name         "/crosspad-19840" style; converted per platform
+     * @param fbW, fbH     framebuffer size in pixels
+     * @param audioFrames  ring capacity, rounded up to a power of two
+     */
+    bool open(const std::string& name, int fbW, int fbH, uint32_t audioFrames);
+
+    /// Unmap and remove the region.
+    void close();
+
+    bool isOpen() const { return header_ != nullptr; }
+    const std::string& name() const { return name_; }
+    size_t size() const { return size_; }
+    const ShmHeader* header() const { return header_; }
+
+    /**
+     * @brief Publish pixels (LVGL thread).
+     *
+     * @p src points at the top-left of the published area, which is the same
+     * size as the region. Only @p dirty rects (region-relative, already
+     * clipped) are copied; the first publication after open() copies all.
+     */
+    void publishFrame(const uint8_t* src, int srcStride,
+                      const Rect* dirty, size_t count, uint32_t timeMs);
+
+    /// Append interleaved stereo frames (audio thread, lock-free).
+    void publishAudio(const int16_t* interleaved, uint32_t frames, uint32_t sampleRate);
+
+private:
+    std::string name_;
+    size_t      size_   = 0;
+    uint8_t*    base_   = nullptr;
+    ShmHeader*  header_ = nullptr;
+    bool        fullPending_ = true;
+
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#else
+    int   fd_ = -1;
+#endif
+};
+
+/// Mixer tap entry point: forwards to the active region, if any.
+/// Matches AudioMixerEngine::TapSink.
+void publish_audio(const int16_t* interleaved, uint32_t frames, uint32_t sampleRate);
+
+/// Make @p shm (or nullptr) the target of publish_audio().
+void set_audio_target(SharedMemory* shm);
+
+} // namespace remote
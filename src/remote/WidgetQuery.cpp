@@ -0,0 +1,272 @@
+/**
+ * @file WidgetQuery.cpp
+ * @brief Selector matching and JSON description of LVGL objects.
+ */
+
+#include "WidgetQuery.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace remote {
+
+namespace {
+
+struct Selector {
+    const char* type         = nullptr;
+    const char* name         = nullptr;
+    const char* text         = nullptr;
+    const char* textContains = nullptr;
+    bool        hidden       = false;   // descend into hidden objects
+};
+
+struct Node {
+    lv_obj_t*   obj;
+    int         depth;
+    std::string path;
+};
+
+/// Displayed text of text-bearing widgets, nullptr for the rest.
+const char* object_text(lv_obj_t* obj, char* buf, size_t size)
+{
+    if (lv_obj_check_type(obj, &lv_label_class))    return lv_label_get_text(obj);
+    if (lv_obj_check_type(obj, &lv_textarea_class)) return lv_textarea_get_text(obj);
+    if (lv_obj_check_type(obj, &lv_checkbox_class)) return lv_checkbox_get_text(obj);
+    if (lv_obj_check_type(obj, &lv_dropdown_class)) {
+        lv_dropdown_get_selected_str(obj, buf, (uint32_t)size);
+        return buf;
+    }
+    if (lv_obj_check_type(obj, &lv_roller_class)) {
+        lv_roller_get_selected_str(obj, buf, (uint32_t)size);
+        return buf;
+    }
+    return nullptr;
+}
+
+/// Current value of value-bearing widgets.
+bool object_value(lv_obj_t* obj, int32_t& out)
+{
+    if (lv_obj_check_type(obj, &lv_slider_class))   { out = lv_slider_get_value(obj); return true; }
+    if (lv_obj_check_type(obj, &lv_bar_class))      { out = lv_bar_get_value(obj); return true; }
+    if (lv_obj_check_type(obj, &lv_arc_class))      { out = lv_arc_get_value(obj); return true; }
+    if (lv_obj_check_type(obj, &lv_spinbox_class))  { out = lv_spinbox_get_value(obj); return true; }
+    if (lv_obj_check_type(obj, &lv_dropdown_class)) { out = (int32_t)lv_dropdown_get_selected(obj); return true; }
+    if (lv_obj_check_type(obj, &lv_roller_class))   { out = (int32_t)lv_roller_get_selected(obj); return true; }
+    if (lv_obj_check_type(obj, &lv_switch_class) || lv_obj_check_type(obj, &lv_checkbox_class)) {
+        out = lv_obj_has_state(obj, LV_STATE_CHECKED) ? 1 : 0;
+        return true;
+    }
+    return false;
+}
+
+bool matches(lv_obj_t* obj, const Selector& sel, char* buf, size_t size)
+{
+    if (sel.type && strcmp(WidgetQuery::typeName(obj), sel.type) != 0) return false;
+    if (sel.name) {
+        const char* n = lv_obj_get_name(obj);
+        if (!n || strcmp(n, sel.name) != 0) return false;
+    }
+    if (sel.text || sel.textContains) {
+        const char* t = object_text(obj, buf, size);
+        if (!t) return false;
+        if (sel.text && strcmp(t, sel.text) != 0) return false;
+        if (sel.textContains && !strstr(t, sel.textContains)) return false;
+    }
+    return true;
+}
+
+void describe(lv_obj_t* obj, const std::string& path, JsonObject out, char* buf, size_t size)
+{
+    lv_area_t a;
+    lv_obj_get_coords(obj, &a);
+
+    out["path"] = path;
+    out["type"] = WidgetQuery::typeName(obj);
+    if (const char* n = lv_obj_get_name(obj)) out["name"] = n;
+    out["x"] = a.x1;
+    out["y"] = a.y1;
+    out["w"] = lv_area_get_width(&a);
+    out["h"] = lv_area_get_height(&a);
+
+    if (const char* t = object_text(obj, buf, size)) out["text"] = t;
+    int32_t value;
+    if (object_value(obj, value)) out["value"] = value;
+
+    // Flags only when set, to keep replies compact
+    if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN))    out["hidden"]    = true;
+    if (lv_obj_has_flag(obj, LV_OBJ_FLAG_CLICKABLE)) out["clickable"] = true;
+    if (lv_obj_has_state(obj, LV_STATE_CHECKED))     out["checked"]   = true;
+    if (lv_obj_has_state(obj, LV_STATE_DISABLED))    out["disabled"]  = true;
+    if (lv_obj_has_state(obj, LV_STATE_FOCUSED))     out["focused"]   = true;
+    if (lv_obj_has_state(obj, LV_STATE_PRESSED))     out["pressed"]   = true;
+    uint32_t children = lv_obj_get_child_count(obj);
+    if (children) out["children"] = children;
+}
+
+/// Resolve "s.0.3" / "t.1" to an object.
+lv_obj_t* resolve_path(const char* path)
+{
+    lv_obj_t* obj;
+    if (path[0] == 's')      obj = lv_screen_active();
+    else if (path[0] == 't') obj = lv_layer_top();
+    else return nullptr;
+
+    const char* p = path + 1;
+    while (obj && *p) {
+        if (*p != '.') return nullptr;
+        char* end;
+        long idx = strtol(p + 1, &end, 10);
+        if (end == p + 1 || idx < 0) return nullptr;
+        obj = lv_obj_get_child(obj, (int32_t)idx);
+        p = end;
+    }
+    return obj;
+}
+
+/// Depth-first search for the object named @p name; fills @p outPath.
+lv_obj_t* find_named(lv_obj_t* root, const std::string& rootPath, const char* name,
+                     std::string& outPath)
+{
+    std::vector<Node> stack;
+    stack.push_back({ root, 0, rootPath });
+    while (!stack.empty()) {
+        Node n = std::move(stack.back());
+        stack.pop_back();
+        const char* nm = lv_obj_get_name(n.obj);
+        if (nm && strcmp(nm, name) == 0) {
+            outPath = std::move(n.path);
+            return n.obj;
+        }
+        uint32_t count = lv_obj_get_child_count(n.obj);
+        for (uint32_t i = count; i-- > 0;)
+            stack.push_back({ lv_obj_get_child(n.obj, (int32_t)i), n.depth + 1,
+                              n.path + "." + std::to_string(i) });
+    }
+    return nullptr;
+}
+
+} // namespace
+
+const char* WidgetQuery::typeName(const lv_obj_t* obj)
+{
+    const lv_obj_class_t* cls = lv_obj_get_class(obj);
+    const char* name = cls ? cls->name : nullptr;
+    if (!name) return "obj";
+    return strncmp(name, "lv_", 3) == 0 ? name + 3 : name;
+}
+
+const char* WidgetQuery::run(JsonObjectConst req, JsonObject resp)
+{
+    // Cache key: every field except the envelope
+    key_.clear();
+    for (JsonPairConst kv : req) {
+        if (strcmp(kv.key().c_str(), "id") == 0 || strcmp(kv.key().c_str(), "cmd") == 0) continue;
+        key_ += kv.key().c_str();
+        key_ += '=';
+        serializeJson(kv.value(), key_);
+        key_ += ';';
+    }
+
+    Selector sel;
+    sel.type         = req["type"];
+    sel.name         = req["name"];
+    sel.text         = req["text"];
+    sel.textContains = req["text_contains"];
+    sel.hidden       = req["hidden"] | false;
+
+    // Apply pending layout first: coordinates are otherwise stale until the
+    // next refresh, and any change it makes invalidates the cache below.
+    lv_obj_update_layout(lv_screen_active());
+    lv_obj_update_layout(lv_layer_top());
+
+    // Hidden objects can change without invalidating the display, so
+    // those queries are never served from the cache.
+    if (!sel.hidden) {
+        auto it = cache_.find(key_);
+        if (it != cache_.end()) {
+            for (JsonPairConst kv : it->second.as<JsonObjectConst>()) resp[kv.key()] = kv.value();
+            resp["generation"] = generation_;
+            resp["cached"]     = true;
+            return nullptr;
+        }
+    }
+
+    const int    maxDepth = std::max(0, req["depth"] | 64);
+    const size_t limit    = (size_t)std::clamp(req["limit"] | 64, 1, 1024);
+    const char*  after    = req["after"];
+
+    // Roots: explicit path, an app's subtree, or screen + top layer
+    std::vector<Node> stack;
+    if (const char* rootPath = req["root"]) {
+        lv_obj_t* root = resolve_path(rootPath);
+        if (!root) return "root not found";
+        stack.push_back({ root, 0, rootPath });
+    } else if (const char* app = req["app"]) {
+        std::string appName = std::string("app:") + app;
+        std::string path;
+        lv_obj_t* root = find_named(lv_screen_active(), "s", appName.c_str(), path);
+        if (!root) root = find_named(lv_layer_top(), "t", appName.c_str(), path);
+        if (root) stack.push_back({ root, 0, path });
+    } else {
+        stack.push_back({ lv_layer_top(), 0, "t" });
+        stack.push_back({ lv_screen_active(), 0, "s" });
+    }
+
+    JsonArray objects = resp["objects"].to<JsonArray>();
+    char buf[128];
+    bool skipping = after != nullptr;
+    uint32_t visited = 0;
+    bool onDisplay = true;   // everything visited would invalidate when it changes
+    size_t found = 0;
+    const char* next = nullptr;
+    std::string nextPath;
+
+    while (!stack.empty()) {
+        Node n = std::move(stack.back());
+        stack.pop_back();
+        visited++;
+
+        // Off-screen or clipped away: changes to it invalidate nothing
+        if (onDisplay && !lv_obj_is_visible(n.obj)) onDisplay = false;
+
+        if (skipping) {
+            if (n.path == after) skipping = false;
+        } else if (matches(n.obj, sel, buf, sizeof(buf))) {
+            if (found == limit) {
+                // Stop here; "after" = last reported object resumes the walk
+                next = nextPath.c_str();
+                break;
+            }
+            describe(n.obj, n.path, objects.add<JsonObject>(), buf, sizeof(buf));
+            nextPath = n.path;
+            found++;
+        }
+
+        if (n.depth >= maxDepth) continue;
+        uint32_t count = lv_obj_get_child_count(n.obj);
+        for (uint32_t i = count; i-- > 0;) {
+            lv_obj_t* child = lv_obj_get_child(n.obj, (int32_t)i);
+            if (!sel.hidden && lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+            stack.push_back({ child, n.depth + 1, n.path + "." + std::to_string(i) });
+        }
+    }
+
+    resp["visited"]    = visited;
+    resp["complete"]   = next == nullptr;
+    if (next) resp["next"] = next;
+    resp["generation"] = generation_;
+
+    if (!sel.hidden && onDisplay) {
+        if (cache_.size() >= MAX_CACHED) cache_.clear();
+        // Only the query's own fields; resp also carries the request id
+        JsonDocument& doc = cache_[key_];
+        for (const char* field : { "objects", "visited", "complete", "next" }) {
+            if (!resp[field].isNull()) doc[field] = resp[field];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace remote
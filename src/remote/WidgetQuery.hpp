@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * @file WidgetQuery.hpp
+ * @brief LVGL object-tree queries for the remote "query" command.
+ *
+ * Lets tests assert on UI state (labels, slider values, checked state,
+ * positions) without screenshots. A query walks the active screen and the
+ * top layer depth-first and returns the objects matching every given
+ * selector:
+ *
+ *   {"cmd":"query","type":"label","text_contains":"Mixer","limit":8}
+ *   → {"ok":true,"objects":[{"path":"s.0.2.1","type":"label","x":12,"y":40,
+ *       "w":64,"h":16,"text":"Mixer"}],"visited":57,"complete":true}
+ *
+ * Selectors: type (LVGL class without "lv_", e.g. "button"), name
+ * (lv_obj_set_name), text (exact) / text_contains, app (only the subtree of
+ * that app's root, named "app:<Name>"), root (a path from an earlier reply).
+ * Limits: depth (levels below the root), limit (max matches). When the
+ * limit is hit the reply has "next"; pass it back as "after" to resume the
+ * walk where it stopped.
+ *
+ * Paths are "s" (screen) or "t" (top layer) followed by child indices.
+ * They stay valid while "generation" (bumped on every invalidation) is
+ * unchanged.
+ *
+ * Replies are cached per query until the display reports an invalidated
+ * area, so polling an unchanged UI costs one map lookup. Objects outside
+ * the display (scrolled away, off-screen, or a UI bigger than the LCD with
+ * --headless=lcd) change without invalidating anything, so a walk that
+ * visited any is not cached.
+ */
+
+#include <ArduinoJson.h>
+#include "lvgl/lvgl.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace remote {
+
+class WidgetQuery {
+public:
+    /// Run the query in @p req and add its fields to @p resp (LVGL thread).
+    /// @return nullptr, or an error message for a bad "root" path
+    const char* run(JsonObjectConst req, JsonObject resp);
+
+    /// Drop cached replies. Hook to LV_EVENT_INVALIDATE_AREA.
+    void invalidate() { if (!cache_.empty()) cache_.clear(); generation_++; }
+
+    uint32_t generation() const { return generation_; }
+
+    /// Short class name ("label", "button", ...) of @p obj.
+    static const char* typeName(const lv_obj_t* obj);
+
+private:
+    static constexpr size_t MAX_CACHED = 32;
+
+    std::unordered_map<std::string, JsonDocument> cache_;
+    uint32_t generation_ = 0;
+    std::string key_;   // scratch: serialized selector set
+};
+
+} // namespace remote
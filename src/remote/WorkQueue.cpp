@@ -0,0 +1,90 @@
+/**
+ * @file WorkQueue.cpp
+ * @brief Background job thread and pixel buffer pool.
+ */
+
+#include "WorkQueue.hpp"
+
+namespace remote {
+
+/* ── WorkQueue ───────────────────────────────────────────────────────── */
+
+WorkQueue::~WorkQueue()
+{
+    stop();
+}
+
+void WorkQueue::post(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+        if (!running_) {
+            running_ = true;
+            thread_ = std::thread(&WorkQueue::threadFunc, this);
+        }
+    }
+    cv_.notify_one();
+}
+
+void WorkQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+size_t WorkQueue::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
+
+void WorkQueue::threadFunc()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return !running_ || !jobs_.empty(); });
+        if (jobs_.empty()) break;   // stopped and drained
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+/* ── BufferPool ──────────────────────────────────────────────────────── */
+
+BufferPool::Buffer BufferPool::acquire(size_t bytes)
+{
+    std::unique_ptr<std::vector<uint8_t>> vec;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->free.empty()) {
+            vec = std::move(state_->free.back());
+            state_->free.pop_back();
+        }
+    }
+    if (!vec) vec = std::make_unique<std::vector<uint8_t>>();
+    vec->resize(bytes);   // keeps capacity from earlier, larger captures
+
+    std::weak_ptr<State> weak = state_;
+    return Buffer(vec.release(), [weak](std::vector<uint8_t>* v) {
+        if (auto st = weak.lock()) {
+            std::lock_guard<std::mutex> lock(st->mutex);
+            if (st->free.size() < st->maxFree) {
+                st->free.emplace_back(v);
+                return;
+            }
+        }
+        delete v;
+    });
+}
+
+} // namespace remote
@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file WorkQueue.hpp
+ * @brief Single background worker thread and a reusable pixel buffer pool.
+ *
+ * Used to move expensive encoding (PNG/QOI/base64) off the LVGL thread:
+ * the LVGL thread copies pixels into a pooled buffer and posts a job; the
+ * worker encodes and replies. Buffers return to the pool when the last
+ * reference is dropped, so steady-state captures do not allocate.
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace remote {
+
+class WorkQueue {
+public:
+    using Job = std::function<void()>;
+
+    WorkQueue() = default;
+    ~WorkQueue();
+
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    /// Queue @p job; starts the worker thread on first use. Thread-safe.
+    void post(Job job);
+
+    /// Finish queued jobs and join the worker.
+    void stop();
+
+    size_t pending() const;
+
+private:
+    void threadFunc();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+class BufferPool {
+public:
+    using Buffer = std::shared_ptr<std::vector<uint8_t>>;
+
+    explicit BufferPool(size_t maxFree = 4) : state_(std::make_shared<State>()) { state_->maxFree = maxFree; }
+
+    /// A buffer of exactly @p bytes, recycled when the last reference goes away.
+    Buffer acquire(size_t bytes);
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<std::vector<uint8_t>>> free;
+        size_t maxFree = 4;
+    };
+    std::shared_ptr<State> state_;   // outlives buffers still in flight
+};
+
+} // namespace remote
@@ -9,8 +9,8 @@
  */
 
 #include "EmuJackPanel.hpp"
+#include "widgets/VuMeter.hpp"
 #include <cstdio>
-#include <cmath>
 
 /* ── Layout constants ────────────────────────────────────────────────── */
 
@@ -48,46 +48,6 @@ static constexpr uint32_t COLOR_MIDI_CONN    = 0x3399FF;
 static constexpr uint32_t COLOR_USB_CONN     = 0xFF9900;
 static constexpr uint32_t COLOR_VU_BG        = 0x1A1A1A;
 
-/* ── VU helpers ──────────────────────────────────────────────────────── */
-
-static uint16_t levelToPercent(int16_t val, int base) {
-    const int16_t NOISE_GATE = 800;
-    if (val < NOISE_GATE) return 0;
-
-    float normalized = (float)val / 32767.0f;
-    const float GAIN_MULTIPLIER = 3.5f;
-    normalized *= GAIN_MULTIPLIER;
-    if (normalized > 1.0f) normalized = 1.0f;
-
-    float db_normalized;
-    if (normalized < 0.018f) {
-        db_normalized = 0.0f;
-    } else {
-        float db = 20.0f * log10f(normalized);
-        db_normalized = (db + 35.0f) / 35.0f;
-        if (db_normalized < 0.0f) db_normalized = 0.0f;
-        if (db_normalized > 1.0f) db_normalized = 1.0f;
-    }
-
-    uint32_t scaled = (uint32_t)(db_normalized * (float)base);
-    return (uint16_t)(scaled > (uint32_t)base ? base : scaled);
-}
-
-static lv_color_t vuColor(float percent) {
-    if (percent < 0.60f) {
-        return lv_color_hex(0x00FF00);
-    } else if (percent < 0.85f) {
-        float t = (percent - 0.60f) / 0.25f;
-        uint8_t red = (uint8_t)(t * 255);
-        return lv_color_make(red, 255, 0);
-    } else {
-        float t = (percent - 0.85f) / 0.15f;
-        if (t > 1.0f) t = 1.0f;
-        uint8_t green = (uint8_t)((1.0f - t) * 255);
-        return lv_color_make(255, green, 0);
-    }
-}
-
 /* ── create ──────────────────────────────────────────────────────────── */
 
 void EmuJackPanel::create(lv_obj_t* parent)
@@ -175,59 +135,14 @@ void EmuJackPanel::createJack(lv_obj_t* parent, JackId id,
     lv_obj_add_event_cb(jack.bar, onBarClicked, LV_EVENT_CLICKED, (void*)(intptr_t)id);
     lv_obj_set_style_bg_opa(jack.bar, LV_OPA_80, LV_STATE_PRESSED);
 
-    // --- VU meter bars inside the jack bar (only for audio jacks) ---
+    // --- VU meter inside the jack bar (only for audio jacks) ---
+    // Vertical bars show the channels side by side growing upward,
+    // horizontal ones stacked (top = L) growing rightward.
     if (isAudio) {
-        if (jack.vertical) {
-            // Vertical bar: two VU channels side-by-side, growing upward
-            int32_t chW = (barW - 2) / 2;
-
-            jack.vuBarL = lv_obj_create(jack.bar);
-            lv_obj_set_style_radius(jack.vuBarL, 0, 0);
-            lv_obj_set_style_border_width(jack.vuBarL, 0, 0);
-            lv_obj_set_style_bg_color(jack.vuBarL, lv_color_hex(0x00FF00), 0);
-            lv_obj_set_style_bg_opa(jack.vuBarL, LV_OPA_COVER, 0);
-            lv_obj_set_style_pad_all(jack.vuBarL, 0, 0);
-            lv_obj_set_size(jack.vuBarL, chW, 0);
-            lv_obj_set_pos(jack.vuBarL, 1, barH - 1);
-            lv_obj_remove_flag(jack.vuBarL, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
-            lv_obj_add_flag(jack.vuBarL, LV_OBJ_FLAG_HIDDEN);
-
-            jack.vuBarR = lv_obj_create(jack.bar);
-            lv_obj_set_style_radius(jack.vuBarR, 0, 0);
-            lv_obj_set_style_border_width(jack.vuBarR, 0, 0);
-            lv_obj_set_style_bg_color(jack.vuBarR, lv_color_hex(0x00FF00), 0);
-            lv_obj_set_style_bg_opa(jack.vuBarR, LV_OPA_COVER, 0);
-            lv_obj_set_style_pad_all(jack.vuBarR, 0, 0);
-            lv_obj_set_size(jack.vuBarR, chW, 0);
-            lv_obj_set_pos(jack.vuBarR, 1 + chW, barH - 1);
-            lv_obj_remove_flag(jack.vuBarR, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
-            lv_obj_add_flag(jack.vuBarR, LV_OBJ_FLAG_HIDDEN);
-        } else {
-            // Horizontal bar: two VU channels stacked (top=L, bottom=R), growing rightward
-            int32_t chH = (barH - 2) / 2;
-
-            jack.vuBarL = lv_obj_create(jack.bar);
-            lv_obj_set_style_radius(jack.vuBarL, 0, 0);
-            lv_obj_set_style_border_width(jack.vuBarL, 0, 0);
-            lv_obj_set_style_bg_color(jack.vuBarL, lv_color_hex(0x00FF00), 0);
-            lv_obj_set_style_bg_opa(jack.vuBarL, LV_OPA_COVER, 0);
-            lv_obj_set_style_pad_all(jack.vuBarL, 0, 0);
-            lv_obj_set_size(jack.vuBarL, 0, chH);
-            lv_obj_set_pos(jack.vuBarL, 1, 1);
-            lv_obj_remove_flag(jack.vuBarL, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
-            lv_obj_add_flag(jack.vuBarL, LV_OBJ_FLAG_HIDDEN);
-
-            jack.vuBarR = lv_obj_create(jack.bar);
-            lv_obj_set_style_radius(jack.vuBarR, 0, 0);
-            lv_obj_set_style_border_width(jack.vuBarR, 0, 0);
-            lv_obj_set_style_bg_color(jack.vuBarR, lv_color_hex(0x00FF00), 0);
-            lv_obj_set_style_bg_opa(jack.vuBarR, LV_OPA_COVER, 0);
-            lv_obj_set_style_pad_all(jack.vuBarR, 0, 0);
-            lv_obj_set_size(jack.vuBarR, 0, chH);
-            lv_obj_set_pos(jack.vuBarR, 1, 1 + chH);
-            lv_obj_remove_flag(jack.vuBarR, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
-            lv_obj_add_flag(jack.vuBarR, LV_OBJ_FLAG_HIDDEN);
-        }
+        jack.meter = vu_meter::create(jack.bar, jack.vertical);
+        lv_obj_set_pos(jack.meter, 1, 1);
+        lv_obj_set_size(jack.meter, barW - 2, barH - 2);
+        lv_obj_add_flag(jack.meter, LV_OBJ_FLAG_HIDDEN);
     }
 
     // --- Label ---
@@ -301,7 +216,7 @@ void EmuJackPanel::applyBarStyle(Jack& jack)
     bool isAudio = (jack.id <= AUDIO_IN2);
 
     if (jack.connected && isAudio) {
-        // Connected audio jack: dark background, VU bars will render the level
+        // Connected audio jack: dark background, the VU meter renders the level
         lv_obj_set_style_bg_color(jack.bar, lv_color_hex(COLOR_VU_BG), 0);
         lv_obj_set_style_bg_opa(jack.bar, LV_OPA_COVER, 0);
         lv_obj_set_style_border_width(jack.bar, 1, 0);
@@ -311,9 +226,8 @@ void EmuJackPanel::applyBarStyle(Jack& jack)
         lv_obj_set_style_shadow_color(jack.bar, lv_color_hex(COLOR_CONNECTED), 0);
         lv_obj_set_style_shadow_opa(jack.bar, LV_OPA_40, 0);
 
-        // Show VU bars
-        if (jack.vuBarL) lv_obj_clear_flag(jack.vuBarL, LV_OBJ_FLAG_HIDDEN);
-        if (jack.vuBarR) lv_obj_clear_flag(jack.vuBarR, LV_OBJ_FLAG_HIDDEN);
+        // Show the VU meter
+        if (jack.meter) lv_obj_clear_flag(jack.meter, LV_OBJ_FLAG_HIDDEN);
     } else {
         uint32_t color;
         if (jack.connected) {
@@ -338,51 +252,11 @@ void EmuJackPanel::applyBarStyle(Jack& jack)
             lv_obj_set_style_shadow_opa(jack.bar, LV_OPA_TRANSP, 0);
         }
 
-        // Hide VU bars for disconnected or MIDI jacks
-        if (jack.vuBarL) lv_obj_add_flag(jack.vuBarL, LV_OBJ_FLAG_HIDDEN);
-        if (jack.vuBarR) lv_obj_add_flag(jack.vuBarR, LV_OBJ_FLAG_HIDDEN);
-    }
-}
-
-/* ── VU meter bar update ─────────────────────────────────────────────── */
-
-void EmuJackPanel::updateVuBars(Jack& jack)
-{
-    if (!jack.connected || !jack.vuBarL || !jack.vuBarR) return;
-
-    int32_t barW = lv_obj_get_width(jack.bar);
-    int32_t barH = lv_obj_get_height(jack.bar);
-
-    if (jack.vertical) {
-        // Vertical: bars grow upward from bottom
-        int32_t maxH = barH - 2;
-        int32_t hL = levelToPercent(jack.levelL, maxH);
-        int32_t hR = levelToPercent(jack.levelR, maxH);
-
-        float pctL = (maxH > 0) ? (float)hL / (float)maxH : 0;
-        float pctR = (maxH > 0) ? (float)hR / (float)maxH : 0;
-
-        lv_obj_set_height(jack.vuBarL, hL);
-        lv_obj_set_y(jack.vuBarL, 1 + (maxH - hL));
-        lv_obj_set_style_bg_color(jack.vuBarL, vuColor(pctL), 0);
-
-        lv_obj_set_height(jack.vuBarR, hR);
-        lv_obj_set_y(jack.vuBarR, 1 + (maxH - hR));
-        lv_obj_set_style_bg_color(jack.vuBarR, vuColor(pctR), 0);
-    } else {
-        // Horizontal: bars grow rightward from left
-        int32_t maxW = barW - 2;
-        int32_t wL = levelToPercent(jack.levelL, maxW);
-        int32_t wR = levelToPercent(jack.levelR, maxW);
-
-        float pctL = (maxW > 0) ? (float)wL / (float)maxW : 0;
-        float pctR = (maxW > 0) ? (float)wR / (float)maxW : 0;
-
-        lv_obj_set_width(jack.vuBarL, wL);
-        lv_obj_set_style_bg_color(jack.vuBarL, vuColor(pctL), 0);
-
-        lv_obj_set_width(jack.vuBarR, wR);
-        lv_obj_set_style_bg_color(jack.vuBarR, vuColor(pctR), 0);
+        // Hide the VU meter for disconnected jacks (stops polling it too)
+        if (jack.meter) {
+            lv_obj_add_flag(jack.meter, LV_OBJ_FLAG_HIDDEN);
+            vu_meter::reset(jack.meter);
+        }
     }
 }
 
@@ -413,11 +287,10 @@ void EmuJackPanel::setConnected(JackId id, bool connected)
     applyBarStyle(jacks_[id]);
 }
 
-void EmuJackPanel::setLevel(JackId id, int16_t left, int16_t right)
+void EmuJackPanel::setLevelSource(JackId id, vu_meter::Source fn, void* ctx)
 {
-    if (id < 0 || id >= JACK_COUNT) return;
-    jacks_[id].levelL = left;
-    jacks_[id].levelR = right;
+    if (id < 0 || id >= JACK_COUNT || !jacks_[id].meter) return;
+    vu_meter::set_source(jacks_[id].meter, fn, ctx);
 }
 
 void EmuJackPanel::setDeviceList(JackId id,
@@ -446,16 +319,6 @@ void EmuJackPanel::setOnDeviceSelected(DeviceSelectedCb cb)
     deviceSelectedCb_ = std::move(cb);
 }
 
-void EmuJackPanel::update()
-{
-    // Update VU bars for connected audio jacks
-    for (int i = 0; i <= AUDIO_IN2; i++) {
-        if (jacks_[i].connected) {
-            updateVuBars(jacks_[i]);
-        }
-    }
-}
-
 /* ── Close all dropdowns ─────────────────────────────────────────────── */
 
 void EmuJackPanel::closeAllDropdowns(int exceptJackId)
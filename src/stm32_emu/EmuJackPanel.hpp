@@ -5,13 +5,14 @@
  * @brief Visual audio/MIDI/USB jack connectors for the CrossPad PC emulator.
  *
  * Renders bar-shaped jack connectors on the device body edges.
- * Audio jacks show VU meter bars when connected.
+ * Audio jacks show a VU meter (widgets/VuMeter) when connected.
  * MIDI jacks use colored bars. USB uses a rectangular port shape
  * with COM port selection for UART host/device (OTG) functionality.
  * All jacks are clickable for device selection via styled dropdown menus.
  */
 
 #include "lvgl/lvgl.h"
+#include "widgets/VuMeter.hpp"
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -45,9 +46,9 @@ public:
     /// Update a jack's connection status (green = connected, gray = none).
     void setConnected(JackId id, bool connected);
 
-    /// Set stereo audio levels for a jack (used when connected).
-    /// Values are int16 amplitude (0-32767). Only meaningful for audio jacks.
-    void setLevel(JackId id, int16_t left, int16_t right);
+    /// Set where an audio jack's meter reads its levels (int16 amplitude,
+    /// 0-32767). Polled by the shared meter timer while the jack is connected.
+    void setLevelSource(JackId id, vu_meter::Source fn, void* ctx);
 
     /// Populate a jack's dropdown device list.
     /// @param devices  List of device names (index 0 should be "(None)")
@@ -59,21 +60,15 @@ public:
     /// Set callback for when user selects a device from a dropdown.
     void setOnDeviceSelected(DeviceSelectedCb cb);
 
-    /// Periodic update (called from Stm32EmuWindow timer).
-    void update();
-
 private:
     struct Jack {
         lv_obj_t* bar        = nullptr;   // bar shape on device edge
-        lv_obj_t* vuBarL     = nullptr;   // VU left channel bar (audio only)
-        lv_obj_t* vuBarR     = nullptr;   // VU right channel bar (audio only)
+        lv_obj_t* meter      = nullptr;   // stereo VU meter (audio only)
         lv_obj_t* label      = nullptr;   // type/device name label
         lv_obj_t* dropdown   = nullptr;
         bool      connected  = false;
         bool      vertical   = false;     // true for audio OUT (left edge)
         JackId    id         = AUDIO_OUT1;
-        int16_t   levelL     = 0;
-        int16_t   levelR     = 0;
     };
 
     Jack jacks_[JACK_COUNT] = {};
@@ -87,7 +82,6 @@ private:
                     lv_dir_t dropdownDir);
 
     void applyBarStyle(Jack& jack);
-    void updateVuBars(Jack& jack);
     void closeAllDropdowns(int exceptJackId = -1);
 
     static void onBarClicked(lv_event_t* e);
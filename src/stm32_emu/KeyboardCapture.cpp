@@ -17,6 +17,7 @@
 
 #include <SDL2/SDL.h>
 #include <crosspad/pad/PadManager.hpp>
+#include "remote/RemoteEvents.hpp"
 
 /* ── Key → pad mapping ────────────────────────────────────────────────── */
 
@@ -62,6 +63,7 @@ void KeyboardCapture::pressPad(int padIdx)
 
     padHeld_[padIdx] = true;
     crosspad::getPadManager().handlePadPress((uint8_t)padIdx, 127);
+    remote::notify(remote::TOPIC_PAD);
 }
 
 void KeyboardCapture::releasePad(int padIdx)
@@ -71,6 +73,7 @@ void KeyboardCapture::releasePad(int padIdx)
 
     padHeld_[padIdx] = false;
     crosspad::getPadManager().handlePadRelease((uint8_t)padIdx);
+    remote::notify(remote::TOPIC_PAD);
 }
 
 void KeyboardCapture::releaseAllPads()
@@ -79,6 +82,7 @@ void KeyboardCapture::releaseAllPads()
         if (padHeld_[i]) {
             padHeld_[i] = false;
             crosspad::getPadManager().handlePadRelease((uint8_t)i);
+            remote::notify(remote::TOPIC_PAD);
         }
     }
 }
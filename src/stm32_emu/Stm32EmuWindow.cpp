@@ -15,6 +15,7 @@
 
 #include <SDL2/SDL.h>
 #include "crosspad-gui/platform/IGuiPlatform.h"
+#include "pc_stubs/pc_platform.h"
 
 /* ── SDL event watcher (encoder + keyboard capture) ──────────────────── */
 
@@ -33,6 +34,7 @@ static int sdlEventWatcher(void* userdata, SDL_Event* event)
     // Window close — use _exit() to avoid abort() from detached FreeRTOS threads
     if (event->type == SDL_QUIT) {
         printf("[PC] Window closed — exiting\n");
+        pc_platform_sync_state();
         fflush(stdout);
         _Exit(0);
     }
@@ -56,14 +58,14 @@ static int sdlEventWatcher(void* userdata, SDL_Event* event)
 
 Stm32EmuWindow::~Stm32EmuWindow()
 {
-    SDL_DelEventWatch(sdlEventWatcher, this);
+    if (!pc_platform_options().headless) SDL_DelEventWatch(sdlEventWatcher, this);
 }
 
 /* ── Layout constants ────────────────────────────────────────────────── */
 
 // LCD container
-static constexpr int32_t LCD_W = 320;
-static constexpr int32_t LCD_H = 240;
+static constexpr int32_t LCD_W = Stm32EmuWindow::LCD_W;
+static constexpr int32_t LCD_H = Stm32EmuWindow::LCD_H;
 
 // Pad grid
 static constexpr int32_t PAD_SIZE_SCALE = 5;  // overall size multiplier for emulator UI
@@ -73,8 +75,8 @@ static constexpr int32_t GRID_W   = 4 * PAD_SIZE + 3 * PAD_GAP;
 static constexpr int32_t GRID_H   = crosspad_gui::VirtualPadGrid::gridHeight(PAD_SIZE, PAD_GAP*2/3);
 
 // LCD centered horizontally in window
-static constexpr int32_t LCD_X = (Stm32EmuWindow::WIN_W - LCD_W) / 2;
-static constexpr int32_t LCD_Y = 58;
+static constexpr int32_t LCD_X = Stm32EmuWindow::LCD_X;
+static constexpr int32_t LCD_Y = Stm32EmuWindow::LCD_Y;
 
 // Encoder to the right of LCD
 static constexpr int32_t ENC_SIZE = 60;
@@ -127,14 +129,39 @@ static void createScrew(lv_obj_t* parent, int32_t cx, int32_t cy, int32_t dia)
     lv_obj_remove_flag(socket, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
 }
 
+int32_t Stm32EmuWindow::lcdX()
+{
+    return pc_platform_options().lcdOnly ? 0 : LCD_X;
+}
+
+int32_t Stm32EmuWindow::lcdY()
+{
+    return pc_platform_options().lcdOnly ? 0 : LCD_Y;
+}
+
 /* ── init ─────────────────────────────────────────────────────────────── */
 
 lv_obj_t* Stm32EmuWindow::init()
 {
+    const PcRunOptions& opts = pc_platform_options();
+
     screen_ = lv_screen_active();
+    if (opts.lcdOnly) {
+        // LCD-sized display: build the full body, shifted so the LCD lands
+        // at (0,0). Everything else is off-screen and never rendered, but
+        // the widgets (encoder, pads) still exist for input routing.
+        lv_obj_remove_flag(screen_, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_t* body = lv_obj_create(screen_);
+        lv_obj_remove_style_all(body);
+        lv_obj_set_size(body, WIN_W, WIN_H);
+        lv_obj_set_pos(body, -LCD_X, -LCD_Y);
+        screen_ = body;
+    }
 
-    lv_display_t* disp = lv_display_get_default();
-    lv_sdl_window_set_title(disp, "CrossPad");
+    if (!opts.headless) {
+        lv_display_t* disp = lv_display_get_default();
+        lv_sdl_window_set_title(disp, "CrossPad");
+    }
 
     buildLayout();
 
@@ -142,7 +169,8 @@ lv_obj_t* Stm32EmuWindow::init()
     kbCapture_.init();
 
     // Register SDL event watcher for encoder + keyboard input
-    SDL_AddEventWatch(sdlEventWatcher, this);
+    // (headless: remote input goes through the virtual indevs instead)
+    if (!opts.headless) SDL_AddEventWatch(sdlEventWatcher, this);
 
     // Ensure the LCD container (and its children like the embedded status bar)
     // is drawn above other screen children so it isn't occluded.
@@ -243,7 +271,6 @@ void Stm32EmuWindow::onUpdateTimer(lv_timer_t* t)
 
     self->padGrid_.updateLeds();
     self->encoder_.update();
-    self->jackPanel_.update();
 
     // Poll Windows global hotkeys (no-op when not in Global mode)
     self->kbCapture_.processGlobalHotkeys();
@@ -24,6 +24,17 @@ public:
     static constexpr int32_t WIN_W = 490;
     static constexpr int32_t WIN_H = 714;
 
+    /// LCD area within the window (centered horizontally)
+    static constexpr int32_t LCD_W = 320;
+    static constexpr int32_t LCD_H = 240;
+    static constexpr int32_t LCD_X = (WIN_W - LCD_W) / 2;
+    static constexpr int32_t LCD_Y = 58;
+
+    /// LCD origin in display coordinates: (LCD_X, LCD_Y), or (0, 0) when
+    /// only the LCD is rendered (--headless=lcd).
+    static int32_t lcdX();
+    static int32_t lcdY();
+
     /// Build device body on the active screen. Returns the 320x240 LCD container.
     /// Call after sdl_hal_init(WIN_W, WIN_H) and pc_platform_init().
     lv_obj_t* init();
@@ -50,7 +61,7 @@ public:
     EmuSdCardSlot& getSdCardSlot() { return sdCardSlot_; }
 
 private:
-    lv_obj_t* screen_       = nullptr;
+    lv_obj_t* screen_       = nullptr;   ///< device body parent (the screen, or an offset body)
     lv_obj_t* lcdContainer_ = nullptr;
 
     crosspad_gui::VirtualEncoder     encoder_;
@@ -0,0 +1,128 @@
+/**
+ * @file FrameCodec.cpp
+ * @brief COBS encoder, frame validation and the CRC table.
+ */
+
+#include "FrameCodec.hpp"
+
+namespace {
+
+struct Crc16Table {
+    uint16_t t[256];
+    Crc16Table()
+    {
+        for (int i = 0; i < 256; i++) {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (int b = 0; b < 8; b++)
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                     : static_cast<uint16_t>(crc << 1);
+            t[i] = crc;
+        }
+    }
+};
+
+const Crc16Table s_crcTable;
+
+} // namespace
+
+uint16_t frame_crc16(const uint8_t* data, size_t len, uint16_t crc)
+{
+    for (size_t i = 0; i < len; i++)
+        crc = static_cast<uint16_t>((crc << 8) ^ s_crcTable.t[((crc >> 8) ^ data[i]) & 0xFF]);
+    return crc;
+}
+
+/* ── Encoder ─────────────────────────────────────────────────────────── */
+
+size_t FrameCodec::encode(uint8_t type, const uint8_t* payload, size_t len, uint8_t* out)
+{
+    if (len > MAX_PAYLOAD) return 0;
+
+    const uint16_t crc = frame_crc16(payload, len, frame_crc16(&type, 1));
+    const uint8_t tail[2] = { static_cast<uint8_t>(crc & 0xFF), static_cast<uint8_t>(crc >> 8) };
+
+    uint8_t* o = out;
+    *o++ = 0;
+    uint8_t* code = o++;   // filled in when its block ends
+    uint8_t  run  = 1;
+
+    auto put = [&](const uint8_t* src, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (src[i] == 0) {
+                *code = run;
+                code  = o++;
+                run   = 1;
+                continue;
+            }
+            *o++ = src[i];
+            if (++run == 0xFF) {
+                *code = run;
+                code  = o++;
+                run   = 1;
+            }
+        }
+    };
+    put(&type, 1);
+    put(payload, len);
+    put(tail, 2);
+    *code = run;
+    *o++  = 0;
+    return (size_t)(o - out);
+}
+
+/* ── Decoder ─────────────────────────────────────────────────────────── */
+
+void FrameCodec::reset()
+{
+    beginFrame();
+    inFrame_ = false;
+}
+
+void FrameCodec::beginFrame()
+{
+    inFrame_    = true;
+    started_    = false;
+    zeroBefore_ = false;
+    len_        = 0;
+    rawLen_     = 0;
+    remaining_  = 0;
+}
+
+bool FrameCodec::keepRaw(const uint8_t* src, size_t n)
+{
+    if (rawLen_ + n > RAW_MAX) return false;
+    memcpy(raw_ + rawLen_, src, n);
+    rawLen_ += n;
+    return true;
+}
+
+bool FrameCodec::put(const uint8_t* src, size_t n)
+{
+    // Longer than any frame: this was text after all
+    if (len_ + n > BODY_MAX) return false;
+    memcpy(buf_ + len_, src, n);
+    len_ += n;
+    return true;
+}
+
+bool FrameCodec::endFrame()
+{
+    bool ok = remaining_ == 0 && len_ >= 3;
+    if (ok) {
+        const uint16_t crc = static_cast<uint16_t>(buf_[len_ - 2] | (buf_[len_ - 1] << 8));
+        ok = frame_crc16(buf_, len_ - 2) == crc;
+    }
+    if (!ok) return false;
+    stats_.frames++;
+    inFrame_ = false;
+    return true;
+}
+
+bool FrameCodec::rawIsText() const
+{
+    for (size_t i = 0; i < rawLen_; i++) {
+        const uint8_t c = raw_[i];
+        if (c < 0x20 && c != '\t' && c != '\r' && c != '\n' && c != 0x1B) return false;
+    }
+    return true;
+}
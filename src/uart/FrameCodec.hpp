@@ -0,0 +1,182 @@
+#pragma once
+
+/**
+ * @file FrameCodec.hpp
+ * @brief COBS-framed binary messages interleaved with text lines on a UART.
+ *
+ * A binary frame on the wire:
+ *
+ *   00  COBS( type  payload[n]  crc[2] )  00
+ *
+ * COBS removes every zero byte from the frame body and log text never
+ * contains NUL, so a zero byte alone tells the two apart: runs outside
+ * frames are text for the line framer, everything between a pair of zeros
+ * is one frame. The CRC is CRC-16/CCITT (the one SysExTransfer uses) over
+ * type and payload, little-endian.
+ *
+ * feed() takes raw read chunks. Text costs one memchr per chunk; frame
+ * bodies are decoded a COBS block at a time straight into a fixed buffer,
+ * so nothing allocates. A body that fails its CRC is dropped and its
+ * closing zero taken as the next frame's opening one, which resynchronizes
+ * after joining a stream mid-frame. A body longer than any valid frame
+ * means we were never in one: the decoder drops back to text. In both
+ * cases the raw body bytes are kept, and passed on as text when they are
+ * text (always for the long body, and for a failed one that contains no
+ * control characters but tab, CR, LF and ESC: a real frame's type byte is
+ * one), so a stray zero in the log does not eat the line after it.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// CRC-16/CCITT-FALSE (poly 0x1021), continuing from @p crc.
+uint16_t frame_crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+class FrameCodec {
+public:
+    static constexpr size_t MAX_PAYLOAD = 1024;
+
+    /// Worst-case encoded size of a frame, both delimiters included.
+    static constexpr size_t maxEncodedSize(size_t payloadLen)
+    {
+        return (payloadLen + 3) + (payloadLen + 3) / 254 + 1 + 2;
+    }
+
+    /// Encode one frame into @p out (at least maxEncodedSize(len) bytes).
+    /// @return bytes written, or 0 if @p len exceeds MAX_PAYLOAD
+    static size_t encode(uint8_t type, const uint8_t* payload, size_t len, uint8_t* out);
+
+    struct Stats {
+        uint64_t frames       = 0;
+        uint64_t crcErrors    = 0;   ///< Bodies dropped: bad CRC or malformed COBS
+        uint64_t droppedBytes = 0;   ///< Raw bytes of those bodies
+        uint64_t oversize     = 0;   ///< Too long for a frame: passed on as text
+        uint64_t recovered    = 0;   ///< Failed the CRC but read as text: passed on
+    };
+
+    /// Split @p len bytes into text and frames, in stream order:
+    /// onText(const uint8_t* data, size_t len) for runs outside frames,
+    /// onFrame(uint8_t type, const uint8_t* payload, size_t len) per valid
+    /// frame (the payload is only valid during the call).
+    template <typename TextFn, typename FrameFn>
+    void feed(const uint8_t* data, size_t len, TextFn&& onText, FrameFn&& onFrame);
+
+    const Stats& stats() const { return stats_; }
+
+    /// Back to text mode, discarding any partial frame.
+    void reset();
+
+private:
+    static constexpr size_t BODY_MAX = MAX_PAYLOAD + 3;
+    static constexpr size_t RAW_MAX  = BODY_MAX + BODY_MAX / 254 + 1;   // encoded, no delimiters
+
+    void beginFrame();
+    /// Keep @p n raw body bytes. @return false if the body got too long.
+    bool keepRaw(const uint8_t* src, size_t n);
+    bool put(const uint8_t* src, size_t n);
+    /// Called on a frame's closing zero. @return true if buf_ holds a valid frame.
+    bool endFrame();
+    /// Whether the failed body in raw_ reads as log text.
+    bool rawIsText() const;
+
+    template <typename TextFn, typename FrameFn>
+    void closeFrame(TextFn& onText, FrameFn& onFrame);
+
+    uint8_t buf_[BODY_MAX];
+    uint8_t raw_[RAW_MAX];         // the body as received, for handing back as text
+    size_t  rawLen_     = 0;
+    size_t  len_        = 0;
+    size_t  remaining_  = 0;       // data bytes left in the current COBS block
+    bool    inFrame_    = false;
+    bool    started_    = false;   // any body byte since the opening zero
+    bool    zeroBefore_ = false;   // next block starts with an implied zero
+    Stats   stats_;
+};
+
+// ── Template members ──
+
+template <typename TextFn, typename FrameFn>
+void FrameCodec::closeFrame(TextFn& onText, FrameFn& onFrame)
+{
+    // 00 00 is an empty frame: keep waiting for a body
+    if (!started_) return;
+    if (endFrame()) {
+        onFrame(buf_[0], buf_ + 1, len_ - 3);
+        return;
+    }
+    if (rawIsText()) {
+        stats_.recovered++;
+        onText(raw_, rawLen_);
+    } else {
+        stats_.crcErrors++;
+        stats_.droppedBytes += rawLen_;
+    }
+    // Likely joined mid-frame: this zero opens the next one
+    beginFrame();
+}
+
+template <typename TextFn, typename FrameFn>
+void FrameCodec::feed(const uint8_t* data, size_t len, TextFn&& onText, FrameFn&& onFrame)
+{
+    const uint8_t* p   = data;
+    const uint8_t* end = data + len;
+
+    // Too long for a frame: hand back what was taken for one, go on as text
+    auto giveUp = [&] {
+        stats_.oversize++;
+        inFrame_ = false;
+        if (rawLen_) onText(raw_, rawLen_);
+    };
+
+    while (p < end) {
+        if (!inFrame_) {
+            auto* z = static_cast<const uint8_t*>(memchr(p, 0, (size_t)(end - p)));
+            if (z != p) onText(p, (size_t)((z ? z : end) - p));
+            if (!z) return;
+            p = z + 1;
+            beginFrame();
+            continue;
+        }
+
+        if (remaining_ == 0) {
+            // COBS code byte: the next block's length, or the closing zero
+            const uint8_t code = *p;
+            if (code == 0) {
+                p++;
+                closeFrame(onText, onFrame);
+                continue;
+            }
+            if (!keepRaw(p, 1)) {
+                giveUp();
+                continue;
+            }
+            p++;
+            started_ = true;
+            static const uint8_t zero = 0;
+            if (zeroBefore_ && !put(&zero, 1)) {
+                giveUp();
+                continue;
+            }
+            remaining_  = code - 1u;
+            zeroBefore_ = code != 0xFF;
+            continue;
+        }
+
+        // Block data; a zero inside it ends the frame early (malformed)
+        const size_t n = std::min(remaining_, (size_t)(end - p));
+        auto* z = static_cast<const uint8_t*>(memchr(p, 0, n));
+        const size_t run = z ? (size_t)(z - p) : n;
+        if (!put(p, run) || !keepRaw(p, run)) {
+            giveUp();
+            continue;
+        }
+        p += run;
+        remaining_ -= run;
+        if (z) {
+            p++;
+            closeFrame(onText, onFrame);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ * @file LineRing.cpp
+ * @brief Producer-side framing and ring space accounting.
+ */
+
+#include "LineRing.hpp"
+
+#include <algorithm>
+
+static size_t round_up_pow2(size_t v)
+{
+    size_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+LineRing::LineRing(size_t byteCapacity, size_t lineCapacity)
+    : byteCap_(round_up_pow2(std::max(byteCapacity, MAX_LINE_LENGTH * 2)))
+    , lineMask_(round_up_pow2(std::max<size_t>(lineCapacity, 2)) - 1)
+    , bytes_(std::make_unique<char[]>(byteCap_))
+    , descs_(std::make_unique<Desc[]>(lineMask_ + 1))
+{
+}
+
+void LineRing::append(const char* src, size_t n)
+{
+    if (discarding_ || n == 0) return;
+
+    const size_t have = (size_t)(writePos_ - lineStart_);
+    n = std::min(n, MAX_LINE_LENGTH + 1 - have);   // +1 keeps room for a '\r'
+    if (n == 0) return;
+
+    // Keep the line contiguous: restart it at the front of the ring
+    uint64_t start = lineStart_;
+    const size_t at = (size_t)(start & (byteCap_ - 1));
+    if (at + have + n > byteCap_) start += byteCap_ - at;
+
+    // Consumer is behind: make room by dropping the oldest lines
+    for (;;) {
+        uint64_t tail;
+        const uint64_t queued  = oldestQueued(tail);
+        const uint64_t reading = reading_.load(std::memory_order_seq_cst);
+        const uint64_t needed  = std::min(queued, reading);
+        if (needed >= start || start + have + n - needed <= byteCap_) break;
+        if (needed != reading) {
+            dropOldest(tail);   // a failed CAS means the consumer took it; look again
+            continue;
+        }
+
+        // The consumer is reading the line in the way: drop this one instead
+        discarding_ = true;
+        writePos_   = lineStart_;
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    char* base = bytes_.get();
+    if (start != lineStart_) {
+        memmove(base, base + at, have);
+        lineStart_ = start;
+        writePos_  = start + have;
+    }
+    memcpy(base + (size_t)(writePos_ & (byteCap_ - 1)), src, n);
+    writePos_ += n;
+}
+
+bool LineRing::finishLine(uint64_t timestampUs, std::string_view& line)
+{
+    if (discarding_) {
+        discarding_ = false;
+        lineStart_  = writePos_;
+        return false;
+    }
+
+    const char* text = bytes_.get() + (size_t)(lineStart_ & (byteCap_ - 1));
+    size_t len = (size_t)(writePos_ - lineStart_);
+    if (len > 0 && text[len - 1] == '\r') len--;
+    len = std::min(len, MAX_LINE_LENGTH);
+
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    for (uint64_t tail = tail_.load(std::memory_order_acquire); head - tail > lineMask_;
+         tail = tail_.load(std::memory_order_acquire)) {
+        dropOldest(tail);   // a failed CAS means the consumer made room
+    }
+
+    Desc& d = descs_[head & lineMask_];
+    d.offset.store(lineStart_, std::memory_order_relaxed);
+    d.length.store((uint32_t)len, std::memory_order_relaxed);
+    d.timestampUs.store(timestampUs, std::memory_order_relaxed);
+    head_.store(head + 1, std::memory_order_release);
+    line = std::string_view(text, len);
+    lineStart_ = writePos_;
+    return true;
+}
+
+uint64_t LineRing::oldestQueued(uint64_t& tail) const
+{
+    // Callers load reading_ after this: a consumer claim seen here was
+    // preceded by its reading_ store, so the line being read is never missed
+    tail = tail_.load(std::memory_order_seq_cst);
+    if (tail == head_.load(std::memory_order_relaxed)) return NO_LINE;
+    return descs_[tail & lineMask_].offset.load(std::memory_order_relaxed);
+}
+
+void LineRing::dropOldest(uint64_t tail)
+{
+    if (tail == head_.load(std::memory_order_relaxed)) return;
+    if (tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_seq_cst))
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LineRing::reset()
+{
+    lineStart_ = writePos_ = 0;
+    discarding_ = false;
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    reading_.store(NO_LINE, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+}
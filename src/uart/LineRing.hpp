@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @file LineRing.hpp
+ * @brief Single-producer, single-consumer line framer over a fixed byte ring.
+ *
+ * The producer (UART reader thread) push()es raw chunks: each is scanned
+ * with memchr for '\n' and copied once into the byte ring, and every
+ * completed line is published as a descriptor (offset, length, timestamp)
+ * through a lock-free descriptor queue. The consumer drain()s descriptors
+ * and sees each line as a string_view straight into the ring; the bytes
+ * are handed back to the producer when drain() returns.
+ *
+ * A line is always contiguous in the ring: when one would run past the
+ * end, its partial bytes are moved to the front first. Nothing allocates
+ * after construction. When the consumer falls behind (or is not running
+ * at all, e.g. the Serial Monitor is closed), the producer drops the
+ * oldest undrained lines to make room, so the ring always holds the
+ * newest output. The consumer claims each line with a CAS on the tail
+ * and advertises the line it is reading, which the producer never
+ * overwrites. A trailing '\r' is stripped; lines longer than
+ * MAX_LINE_LENGTH are truncated.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+class LineRing {
+public:
+    static constexpr size_t DEFAULT_BYTES   = 1u << 20;
+    static constexpr size_t DEFAULT_LINES   = 8192;
+    static constexpr size_t MAX_LINE_LENGTH = 4096;
+
+    /// Both capacities are rounded up to a power of two.
+    explicit LineRing(size_t byteCapacity = DEFAULT_BYTES, size_t lineCapacity = DEFAULT_LINES);
+
+    LineRing(const LineRing&) = delete;
+    LineRing& operator=(const LineRing&) = delete;
+
+    // ── Producer (one thread) ──
+
+    /// Frame @p len bytes received at @p timestampUs; returns lines completed.
+    /// onLine(std::string_view, uint64_t) sees each line as it is published.
+    template <typename Fn>
+    size_t push(const uint8_t* data, size_t len, uint64_t timestampUs, Fn&& onLine);
+
+    size_t push(const uint8_t* data, size_t len, uint64_t timestampUs)
+    {
+        return push(data, len, timestampUs, [](std::string_view, uint64_t) {});
+    }
+
+    // ── Consumer (one thread) ──
+
+    /// Call fn(std::string_view line, uint64_t timestampUs) for up to
+    /// @p maxLines waiting lines, oldest first; returns lines drained.
+    template <typename Fn>
+    size_t drain(Fn&& fn, size_t maxLines = SIZE_MAX);
+
+    /// Lines waiting to be drained.
+    size_t pending() const
+    {
+        return (size_t)(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed));
+    }
+
+    /// Lines dropped because the ring or the descriptor queue was full:
+    /// the oldest undrained ones, or rarely a new one that would have
+    /// overwritten the line the consumer is reading.
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /// Forget everything. Only while neither side is running.
+    void reset();
+
+private:
+    // Fields are atomic because the producer may reuse the slot of a line
+    // it dropped while the consumer is copying it; the consumer's CAS on
+    // tail_ then fails and the copy is discarded.
+    struct Desc {
+        std::atomic<uint64_t> offset{0};        // stream position of the first byte
+        std::atomic<uint32_t> length{0};
+        std::atomic<uint64_t> timestampUs{0};
+    };
+
+    static constexpr uint64_t NO_LINE = UINT64_MAX;
+
+    void   append(const char* src, size_t n);
+    bool   finishLine(uint64_t timestampUs, std::string_view& line);
+    void   dropOldest(uint64_t tail);     // unless the consumer claimed it first
+    uint64_t oldestQueued(uint64_t& tail) const;
+
+    size_t byteCap_;
+    size_t lineMask_;
+    std::unique_ptr<char[]> bytes_;
+    std::unique_ptr<Desc[]> descs_;
+
+    // Producer-only
+    uint64_t lineStart_  = 0;      // stream position of the line being built
+    uint64_t writePos_   = 0;
+    bool     discarding_ = false;  // current line did not fit; skip to '\n'
+
+    alignas(64) std::atomic<uint64_t> head_{0};      // descriptors published
+    alignas(64) std::atomic<uint64_t> tail_{0};      // descriptors drained or dropped
+    std::atomic<uint64_t> reading_{NO_LINE};     // offset of the line being drained
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// ── Template members ──
+
+template <typename Fn>
+size_t LineRing::push(const uint8_t* data, size_t len, uint64_t timestampUs, Fn&& onLine)
+{
+    const char* p   = reinterpret_cast<const char*>(data);
+    const char* end = p + len;
+    size_t lines = 0;
+
+    while (p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', (size_t)(end - p)));
+        append(p, (size_t)((nl ? nl : end) - p));
+        if (!nl) break;
+
+        std::string_view line;
+        if (finishLine(timestampUs, line)) {
+            onLine(line, timestampUs);
+            lines++;
+        }
+        p = nl + 1;
+    }
+    return lines;
+}
+
+template <typename Fn>
+size_t LineRing::drain(Fn&& fn, size_t maxLines)
+{
+    size_t n = 0;
+
+    while (n < maxLines) {
+        // Both reloaded per line: a producer dropping the oldest lines while
+        // fn runs moves tail_ on, possibly past any head read before
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        if ((int64_t)(head - tail) <= 0) break;
+
+        const Desc& slot = descs_[tail & lineMask_];
+        const uint64_t offset = slot.offset.load(std::memory_order_relaxed);
+        const uint32_t length = slot.length.load(std::memory_order_relaxed);
+        const uint64_t ts     = slot.timestampUs.load(std::memory_order_relaxed);
+
+        // Advertise the line before claiming it, so a producer that sees
+        // the claim also sees which bytes it must leave alone
+        reading_.store(offset, std::memory_order_seq_cst);
+        if (!tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_seq_cst)) {
+            reading_.store(NO_LINE, std::memory_order_release);
+            continue;   // the producer dropped it first
+        }
+
+        fn(std::string_view(bytes_.get() + (offset & (byteCap_ - 1)), length), ts);
+        reading_.store(NO_LINE, std::memory_order_release);
+        n++;
+    }
+    return n;
+}
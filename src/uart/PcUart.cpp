@@ -1,12 +1,99 @@
 /**
  * @file PcUart.cpp
- * @brief Windows COM port backend for the CrossPad virtual USB/UART.
+ * @brief Shared PcUart parts and the Windows COM port backend.
  */
 
 #include "PcUart.hpp"
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 
+/* ── Public helpers ──────────────────────────────────────────────────── */
+
+PcUart::~PcUart()
+{
+    close();
+}
+
+int PcUart::write(const std::string& text)
+{
+    return write(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+int PcUart::writeFrame(uint8_t type, const uint8_t* payload, size_t len)
+{
+    uint8_t buf[FrameCodec::maxEncodedSize(FrameCodec::MAX_PAYLOAD)];
+    size_t n = FrameCodec::encode(type, payload, len, buf);
+    if (n == 0) return -1;
+    return write(buf, n);
+}
+
+std::string PcUart::getPortName() const
+{
+    return portName_;
+}
+
+void PcUart::setOnLineReceived(LineCallback cb)
+{
+    auto p = cb ? std::make_shared<const LineCallback>(std::move(cb)) : nullptr;
+    std::lock_guard<std::mutex> lock(cbMutex_);
+    lineCb_ = std::move(p);
+}
+
+void PcUart::setOnFrameReceived(FrameCallback cb)
+{
+    auto p = cb ? std::make_shared<const FrameCallback>(std::move(cb)) : nullptr;
+    std::lock_guard<std::mutex> lock(cbMutex_);
+    frameCb_ = std::move(p);
+}
+
+size_t PcUart::drainLines(const LineCallback& fn)
+{
+    return rxLines_.drain(fn);
+}
+
+std::vector<std::string> PcUart::readLines()
+{
+    std::vector<std::string> result;
+    rxLines_.drain([&](std::string_view line, uint64_t) { result.emplace_back(line); });
+    return result;
+}
+
+/* ── RX framing (both backends) ──────────────────────────────────────── */
+
+void PcUart::deliver(const uint8_t* data, size_t len)
+{
+    const uint64_t now = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // Callbacks are fetched per chunk and run without any lock held
+    std::shared_ptr<const LineCallback>  cb;
+    std::shared_ptr<const FrameCallback> frameCb;
+    {
+        std::lock_guard<std::mutex> lock(cbMutex_);
+        cb      = lineCb_;
+        frameCb = frameCb_;
+    }
+
+    size_t lines = 0;
+    rxFrames_.feed(data, len,
+        [&](const uint8_t* text, size_t n) {
+            lines += cb ? rxLines_.push(text, n, now,
+                                        [&](std::string_view line, uint64_t ts) { (*cb)(line, ts); })
+                        : rxLines_.push(text, n, now);
+        },
+        [&](uint8_t type, const uint8_t* payload, size_t n) {
+            if (frameCb) (*frameCb)(type, payload, n, now);
+        });
+    totalLines_.fetch_add(lines, std::memory_order_relaxed);
+
+    const FrameCodec::Stats& fs = rxFrames_.stats();
+    totalFrames_.store(fs.frames, std::memory_order_relaxed);
+    frameErrors_.store(fs.crcErrors, std::memory_order_relaxed);
+}
+
+/* ── Windows backend (POSIX: PcUartPosix.cpp) ────────────────────────── */
+
 #ifdef _WIN32
 #include <setupapi.h>
 #include <devguid.h>
@@ -161,6 +248,7 @@ bool PcUart::open(const std::string& portName, BaudRate baud)
 
     portName_ = portName;
     baudRate_ = baud;
+    failed_.store(false);
     open_.store(true);
     stopReader_.store(false);
 
@@ -188,22 +276,18 @@ void PcUart::close()
     printf("[UART] Closed %s\n", portName_.c_str());
     portName_.clear();
     open_.store(false);
+    failed_.store(false);
 
-    std::lock_guard<std::mutex> lock(bufMutex_);
-    lineBuffer_.clear();
-    partialLine_.clear();
-}
-
-PcUart::~PcUart()
-{
-    close();
+    // Reader is gone; the consumer is the thread calling close()
+    rxLines_.reset();
+    rxFrames_.reset();
 }
 
 /* ── TX (write) ──────────────────────────────────────────────────────── */
 
 int PcUart::write(const uint8_t* data, size_t len)
 {
-    if (!open_.load() || hSerial_ == INVALID_HANDLE_VALUE) return -1;
+    if (!isOpen() || hSerial_ == INVALID_HANDLE_VALUE) return -1;
 
     DWORD written = 0;
     if (!WriteFile(hSerial_, data, (DWORD)len, &written, nullptr)) {
@@ -213,22 +297,18 @@ int PcUart::write(const uint8_t* data, size_t len)
     return (int)written;
 }
 
-int PcUart::write(const std::string& text)
-{
-    return write(reinterpret_cast<const uint8_t*>(text.data()), text.size());
-}
-
 /* ── RX (reader thread) ─────────────────────────────────────────────── */
 
 void PcUart::readerLoop()
 {
-    uint8_t buf[512];
+    uint8_t buf[4096];
 
     while (!stopReader_.load()) {
         DWORD bytesRead = 0;
         if (!ReadFile(hSerial_, buf, sizeof(buf), &bytesRead, nullptr)) {
             if (GetLastError() != ERROR_TIMEOUT) {
                 printf("[UART] Read error %lu, closing\n", GetLastError());
+                failed_.store(true);   // isOpen() turns false; close() releases the handle
                 break;
             }
             continue;
@@ -236,68 +316,8 @@ void PcUart::readerLoop()
 
         if (bytesRead == 0) continue;
 
-        // Process received bytes into lines
-        std::lock_guard<std::mutex> lock(bufMutex_);
-        for (DWORD i = 0; i < bytesRead; i++) {
-            char c = static_cast<char>(buf[i]);
-            if (c == '\n') {
-                // Remove trailing \r if present
-                if (!partialLine_.empty() && partialLine_.back() == '\r') {
-                    partialLine_.pop_back();
-                }
-                // Ring buffer: drop oldest if full
-                if (lineBuffer_.size() >= MAX_BUFFERED_LINES) {
-                    lineBuffer_.erase(lineBuffer_.begin());
-                }
-                lineBuffer_.push_back(partialLine_);
-                totalLines_.fetch_add(1);
-
-                // Fire callback (still under lock — callbacks should be fast)
-                if (lineCb_) {
-                    lineCb_(partialLine_);
-                }
-                partialLine_.clear();
-            } else {
-                partialLine_ += c;
-            }
-        }
+        deliver(buf, bytesRead);
     }
 }
 
-/* ── Public helpers ──────────────────────────────────────────────────── */
-
-std::string PcUart::getPortName() const
-{
-    return portName_;
-}
-
-void PcUart::setOnLineReceived(LineCallback cb)
-{
-    std::lock_guard<std::mutex> lock(bufMutex_);
-    lineCb_ = std::move(cb);
-}
-
-std::vector<std::string> PcUart::readLines()
-{
-    std::lock_guard<std::mutex> lock(bufMutex_);
-    std::vector<std::string> result;
-    result.swap(lineBuffer_);
-    return result;
-}
-
-#else
-/* ── Stub for non-Windows platforms ──────────────────────────────────── */
-
-std::vector<std::string> PcUart::enumeratePorts() { return {}; }
-std::vector<std::string> PcUart::findPortsByVidPid(uint16_t, uint16_t) { return {}; }
-bool PcUart::open(const std::string&, BaudRate) { return false; }
-void PcUart::close() {}
-PcUart::~PcUart() {}
-int PcUart::write(const uint8_t*, size_t) { return -1; }
-int PcUart::write(const std::string&) { return -1; }
-std::string PcUart::getPortName() const { return {}; }
-void PcUart::setOnLineReceived(LineCallback) {}
-std::vector<std::string> PcUart::readLines() { return {}; }
-void PcUart::readerLoop() {}
-
 #endif // _WIN32
@@ -6,15 +6,28 @@
  *
  * Provides OTG-like functionality: the simulator can act as either a UART
  * host (reading data from a connected device) or device (writing data out),
- * or both simultaneously over the same COM port. Uses Windows serial API.
+ * or both simultaneously over the same COM port. Uses the Windows serial
+ * API, or termios on POSIX hosts (PcUartPosix.cpp), where ports are device
+ * paths ("/dev/ttyACM0"; a bare name gets "/dev/" prepended).
  *
- * Received data is stored in a thread-safe ring buffer and can be polled
- * by the Serial Monitor app or other consumers.
+ * The reader thread frames received bytes into lines in a LineRing (one
+ * copy, no allocation, no lock); one consumer — the Serial Monitor —
+ * drains them with drainLines()/readLines().
+ *
+ * Binary telemetry frames (FrameCodec: COBS, zero-delimited) may be mixed
+ * into the same stream; they are split out before line framing and handed
+ * to the frame callback on the reader thread.
  */
 
+#include "FrameCodec.hpp"
+#include "LineRing.hpp"
+
+#include <deque>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <atomic>
 #include <thread>
@@ -38,11 +51,22 @@ public:
         B115200 = 115200,
         B230400 = 230400,
         B460800 = 460800,
-        B921600 = 921600
+        B921600 = 921600,
+        B1000000 = 1000000,
+        B2000000 = 2000000,
+        B3000000 = 3000000
+        // Any other rate can be passed as static_cast<BaudRate>(bps); so
+        // must these where <termios.h> (which #defines Bxxx) is included
     };
 
-    /// Callback for received data lines (newline-terminated)
-    using LineCallback = std::function<void(const std::string& line)>;
+    /// Callback for received data lines (terminator stripped). The view is
+    /// only valid during the call; timestamps are steady-clock microseconds.
+    using LineCallback = std::function<void(std::string_view line, uint64_t timestampUs)>;
+
+    /// Callback for received binary frames (CRC checked). The payload is
+    /// only valid during the call.
+    using FrameCallback = std::function<void(uint8_t type, const uint8_t* payload, size_t len,
+                                             uint64_t timestampUs)>;
 
     PcUart() = default;
     ~PcUart();
@@ -57,8 +81,10 @@ public:
     /// Close the current connection.
     void close();
 
-    /// @return true if the COM port is currently open
-    bool isOpen() const { return open_.load(); }
+    /// @return true if the COM port is currently open. False once the
+    /// reader lost the port (read error, device unplugged); close() or
+    /// open() then releases it.
+    bool isOpen() const { return open_.load() && !failed_.load(); }
 
     /// @return the name of the currently connected port (empty if not connected)
     std::string getPortName() const;
@@ -67,28 +93,53 @@ public:
     BaudRate getBaudRate() const { return baudRate_; }
 
     /// Send raw bytes out the COM port (device/TX mode).
+    /// On POSIX the bytes are queued and sent with batched writev() calls;
+    /// the count returned is what was accepted.
     /// @return number of bytes actually written, or -1 on error
     int write(const uint8_t* data, size_t len);
 
     /// Send a string (convenience wrapper).
     int write(const std::string& text);
 
-    /// Set callback invoked for each received line (called from reader thread).
+    /// Send one binary frame (payload up to FrameCodec::MAX_PAYLOAD bytes).
+    /// @return encoded bytes written, or -1 on error
+    int writeFrame(uint8_t type, const uint8_t* payload, size_t len);
+
+    /// Set callback invoked for each received line (called from reader thread,
+    /// no lock held).
     void setOnLineReceived(LineCallback cb);
 
-    /// Read all buffered lines since last call. Thread-safe.
+    /// Set callback invoked for each received binary frame (reader thread,
+    /// no lock held). Without one, frames are still stripped from the text.
+    void setOnFrameReceived(FrameCallback cb);
+
+    /// Pass every buffered line to @p fn, oldest first, without copying.
+    /// Single consumer. @return lines drained
+    size_t drainLines(const LineCallback& fn);
+
+    /// Read all buffered lines since last call (copying drainLines()).
     /// @return vector of received lines (oldest first)
     std::vector<std::string> readLines();
 
+    /// Oldest lines overwritten because the consumer fell behind or was
+    /// not running; the ring always keeps the newest.
+    uint64_t droppedLines() const { return rxLines_.dropped(); }
+
     /// Get total number of lines received since open.
     size_t totalLinesReceived() const { return totalLines_.load(); }
 
+    /// Valid binary frames received, and frames dropped (bad CRC or
+    /// malformed), since construction. Bodies that turn out to be log
+    /// text are passed on as lines and not counted.
+    uint64_t totalFramesReceived() const { return totalFrames_.load(); }
+    uint64_t frameErrors() const { return frameErrors_.load(); }
+
     /// Enumerate available COM ports on the system.
-    /// @return vector of port names (e.g., "COM3", "COM4")
+    /// @return vector of port names (e.g., "COM3", "/dev/ttyUSB0")
     static std::vector<std::string> enumeratePorts();
 
     /// Find COM ports matching a specific USB VID:PID.
-    /// Uses Windows SetupAPI to query device hardware IDs.
+    /// Uses Windows SetupAPI, or the USB attributes in sysfs on Linux.
     /// @return vector of matching port names
     static std::vector<std::string> findPortsByVidPid(uint16_t vid, uint16_t pid);
 
@@ -97,25 +148,51 @@ public:
     static constexpr uint16_t CROSSPAD_PID = 0x1001;
 
 private:
-    static constexpr size_t MAX_BUFFERED_LINES = 2000;
-
 #ifdef _WIN32
     HANDLE hSerial_ = INVALID_HANDLE_VALUE;
+#else
+    static constexpr size_t TX_QUEUE_LIMIT = 1u << 20;   // bytes waiting for the port
+
+    int fd_ = -1;
+    int pollFd_ = -1;                // epoll instance (Linux)
+    int wakePipe_[2] = { -1, -1 };   // wakes the reader for close() / TX
+
+    // Transmit queue, flushed with writev() by write() and by the reader
+    // thread whenever the port can take more
+    std::mutex txMutex_;
+    std::deque<std::vector<uint8_t>> txQueue_;
+    size_t txHeadOff_ = 0;           // bytes of txQueue_.front() already sent
+    size_t txQueued_  = 0;
+    bool   txWaiting_ = false;       // reader is watching for writability
+    bool   outArmed_  = false;       // reader-only: EPOLLOUT registered
+
+    enum : unsigned { EV_READ = 1, EV_WRITE = 2, EV_HUP = 4 };
+
+    bool flushTxLocked();
+    void wakeReader();
+    unsigned waitEvents(bool wantWrite);
 #endif
 
     std::string portName_;
     BaudRate baudRate_ = BaudRate::B115200;
     std::atomic<bool> open_{false};
+    std::atomic<bool> failed_{false};    // reader gave up; still needs close()
     std::atomic<bool> stopReader_{false};
     std::thread readerThread_;
 
-    // Line buffer (ring)
-    mutable std::mutex bufMutex_;
-    std::vector<std::string> lineBuffer_;
-    std::string partialLine_;  // incomplete line being built
+    // Received lines: reader thread -> drainLines()
+    LineRing rxLines_;
     std::atomic<size_t> totalLines_{0};
 
-    LineCallback lineCb_;
+    // Binary frames split out of the stream (reader thread only)
+    FrameCodec rxFrames_;
+    std::atomic<uint64_t> totalFrames_{0};
+    std::atomic<uint64_t> frameErrors_{0};
+
+    std::mutex cbMutex_;
+    std::shared_ptr<const LineCallback>  lineCb_;    // swapped whole under cbMutex_
+    std::shared_ptr<const FrameCallback> frameCb_;
 
     void readerLoop();
+    void deliver(const uint8_t* data, size_t len);   // split + frame one read chunk
 };
@@ -0,0 +1,41 @@
+/**
+ * @file PcUartBaud.cpp
+ * @brief Arbitrary baud rates on POSIX serial ports.
+ *
+ * Kept out of PcUartPosix.cpp: Linux's termios2 (<asm/termbits.h>) cannot
+ * be included alongside <termios.h>.
+ */
+
+#ifndef _WIN32
+
+#include <cstdint>
+#include <sys/ioctl.h>
+
+#if defined(__linux__)
+#include <asm/termbits.h>
+#elif defined(__APPLE__)
+#include <IOKit/serial/ioss.h>
+#endif
+
+/// Set a rate that has no Bxxx constant; call after tcsetattr().
+bool pcuart_set_custom_baud(int fd, uint32_t baud)
+{
+#if defined(__linux__)
+    struct termios2 tio;
+    if (ioctl(fd, TCGETS2, &tio) != 0) return false;
+    tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    tio.c_ispeed = baud;
+    tio.c_ospeed = baud;
+    return ioctl(fd, TCSETS2, &tio) == 0;
+#elif defined(__APPLE__)
+    speed_t speed = baud;
+    return ioctl(fd, IOSSIOSPEED, &speed) == 0;
+#else
+    (void)fd;
+    (void)baud;
+    return false;
+#endif
+}
+
+#endif // !_WIN32
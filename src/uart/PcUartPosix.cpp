@@ -0,0 +1,444 @@
+/**
+ * @file PcUartPosix.cpp
+ * @brief termios backend for the CrossPad virtual USB/UART (Linux, macOS).
+ *
+ * The port is opened non-blocking; one reader thread sleeps in epoll (poll
+ * elsewhere) on the port and a wake pipe, reads whatever is available and
+ * flushes the transmit queue when the port becomes writable again.
+ * Enumeration and VID/PID lookup use sysfs on Linux.
+ */
+
+#ifndef _WIN32
+
+#include "PcUart.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+// PcUartBaud.cpp
+bool pcuart_set_custom_baud(int fd, uint32_t baud);
+
+namespace {
+
+/// Bxxx constant for a standard rate, or 0 if there is none.
+speed_t standard_speed(uint32_t baud)
+{
+    switch (baud) {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+#ifdef B460800
+    case 460800:  return B460800;
+#endif
+#ifdef B921600
+    case 921600:  return B921600;
+#endif
+#ifdef B1000000
+    case 1000000: return B1000000;
+#endif
+#ifdef B2000000
+    case 2000000: return B2000000;
+#endif
+#ifdef B3000000
+    case 3000000: return B3000000;
+#endif
+    default:      return 0;
+    }
+}
+
+std::string device_path(const std::string& name)
+{
+    return name.find('/') == std::string::npos ? "/dev/" + name : name;
+}
+
+std::vector<std::string> list_dir(const char* path)
+{
+    std::vector<std::string> names;
+    if (DIR* d = opendir(path)) {
+        while (dirent* e = readdir(d)) {
+            if (e->d_name[0] != '.') names.emplace_back(e->d_name);
+        }
+        closedir(d);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+#ifdef __linux__
+
+std::string real_path(const std::string& path)
+{
+    char buf[PATH_MAX];
+    return realpath(path.c_str(), buf) ? std::string(buf) : std::string();
+}
+
+/// Hex attribute such as idVendor; -1 if missing.
+long read_hex_attr(const std::string& path)
+{
+    std::ifstream f(path);
+    std::string s;
+    if (!(f >> s)) return -1;
+    return strtol(s.c_str(), nullptr, 16);
+}
+
+/// TTYs backed by a real driver. serial8250 registers placeholder ports
+/// whether or not hardware exists, so those are left out.
+std::vector<std::string> sysfs_ttys()
+{
+    std::vector<std::string> ttys;
+    for (const std::string& name : list_dir("/sys/class/tty")) {
+        std::string driver = real_path("/sys/class/tty/" + name + "/device/driver");
+        if (driver.empty() || driver.substr(driver.rfind('/') + 1) == "serial8250") continue;
+        ttys.push_back(name);
+    }
+    return ttys;
+}
+
+#endif // __linux__
+
+} // namespace
+
+/* ── Enumerate ports ─────────────────────────────────────────────────── */
+
+std::vector<std::string> PcUart::enumeratePorts()
+{
+    std::vector<std::string> ports;
+#ifdef __linux__
+    for (const std::string& name : sysfs_ttys()) ports.push_back("/dev/" + name);
+#else
+    // macOS/BSD: call-out devices
+    for (const std::string& name : list_dir("/dev")) {
+        if (name.compare(0, 3, "cu.") == 0) ports.push_back("/dev/" + name);
+    }
+#endif
+    return ports;
+}
+
+/* ── Find ports by USB VID:PID ───────────────────────────────────────── */
+
+std::vector<std::string> PcUart::findPortsByVidPid(uint16_t vid, uint16_t pid)
+{
+    std::vector<std::string> result;
+#ifdef __linux__
+    for (const std::string& name : sysfs_ttys()) {
+        // Walk up from the tty's device (the USB interface for ACM/serial
+        // adapters) to the USB device that carries idVendor/idProduct
+        std::string dir = real_path("/sys/class/tty/" + name + "/device");
+        while (dir.size() > sizeof("/sys/devices")) {
+            long v = read_hex_attr(dir + "/idVendor");
+            if (v >= 0) {
+                if (v == vid && read_hex_attr(dir + "/idProduct") == pid)
+                    result.push_back("/dev/" + name);
+                break;
+            }
+            dir.erase(dir.rfind('/'));
+        }
+    }
+#else
+    (void)vid;
+    (void)pid;
+#endif
+    return result;
+}
+
+/* ── Open / Close ────────────────────────────────────────────────────── */
+
+bool PcUart::open(const std::string& portName, BaudRate baud)
+{
+    close();
+
+    const std::string path = device_path(portName);
+    int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        printf("[UART] Failed to open %s (%s)\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    ioctl(fd, TIOCEXCL);   // exclusive like the Windows backend; not on every device
+
+    // Raw 8N1, no flow control, reads never block (the fd is non-blocking)
+    termios tio = {};
+    if (tcgetattr(fd, &tio) != 0) {
+        printf("[UART] tcgetattr failed on %s (%s)\n", path.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD | CS8;
+    tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+    tio.c_cc[VMIN]  = 0;
+    tio.c_cc[VTIME] = 0;
+
+    const uint32_t bps = static_cast<uint32_t>(baud);
+    const speed_t speed = standard_speed(bps);
+    if (speed) {
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+    }
+    if (tcsetattr(fd, TCSANOW, &tio) != 0
+        || (!speed && !pcuart_set_custom_baud(fd, bps))) {
+        printf("[UART] Cannot configure %s @ %u baud (%s)\n", path.c_str(), bps, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    // Assert DTR/RTS like the Windows backend (ptys don't have them)
+    int lines = TIOCM_DTR | TIOCM_RTS;
+    ioctl(fd, TIOCMBIS, &lines);
+    tcflush(fd, TCIOFLUSH);
+
+    if (pipe(wakePipe_) != 0) {
+        printf("[UART] pipe failed (%s)\n", strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    for (int p : wakePipe_) {
+        fcntl(p, F_SETFL, fcntl(p, F_GETFL) | O_NONBLOCK);
+        fcntl(p, F_SETFD, FD_CLOEXEC);
+    }
+
+#ifdef __linux__
+    pollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev = {};
+    ev.events  = EPOLLIN;
+    ev.data.fd = fd;
+    bool polling = pollFd_ >= 0 && epoll_ctl(pollFd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+    ev.data.fd = wakePipe_[0];
+    polling = polling && epoll_ctl(pollFd_, EPOLL_CTL_ADD, wakePipe_[0], &ev) == 0;
+    if (!polling) {
+        printf("[UART] epoll setup failed for %s (%s)\n", path.c_str(), strerror(errno));
+        for (int* p : { &pollFd_, &wakePipe_[0], &wakePipe_[1] }) {
+            if (*p >= 0) ::close(*p);
+            *p = -1;
+        }
+        ::close(fd);
+        return false;
+    }
+#endif
+    outArmed_ = false;
+
+    fd_ = fd;
+    portName_ = path;
+    baudRate_ = baud;
+    failed_.store(false);
+    open_.store(true);
+    stopReader_.store(false);
+
+    readerThread_ = std::thread(&PcUart::readerLoop, this);
+
+    printf("[UART] Opened %s @ %u baud\n", path.c_str(), bps);
+    return true;
+}
+
+void PcUart::close()
+{
+    if (!open_.load()) return;
+
+    stopReader_.store(true);
+    wakeReader();
+    if (readerThread_.joinable()) {
+        readerThread_.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(txMutex_);
+        txQueue_.clear();
+        txHeadOff_ = txQueued_ = 0;
+        txWaiting_ = false;
+    }
+
+    for (int* fd : { &fd_, &pollFd_, &wakePipe_[0], &wakePipe_[1] }) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+    }
+
+    printf("[UART] Closed %s\n", portName_.c_str());
+    portName_.clear();
+    open_.store(false);
+    failed_.store(false);
+
+    // Reader is gone; the consumer is the thread calling close()
+    rxLines_.reset();
+    rxFrames_.reset();
+}
+
+/* ── TX (queued, batched writev) ─────────────────────────────────────── */
+
+int PcUart::write(const uint8_t* data, size_t len)
+{
+    if (!isOpen() || fd_ < 0) return -1;
+    if (len == 0) return 0;
+
+    std::lock_guard<std::mutex> lock(txMutex_);
+    if (txQueued_ + len > TX_QUEUE_LIMIT) {
+        printf("[UART] TX queue full, dropping %zu bytes\n", len);
+        return -1;
+    }
+    txQueue_.emplace_back(data, data + len);
+    txQueued_ += len;
+
+    if (!flushTxLocked()) return -1;
+    if (txQueued_ && !txWaiting_) {
+        // Port is full: let the reader send the rest when it drains
+        txWaiting_ = true;
+        wakeReader();
+    }
+    return (int)len;
+}
+
+bool PcUart::flushTxLocked()
+{
+    while (!txQueue_.empty()) {
+        iovec iov[64];
+        int n = 0;
+        for (auto it = txQueue_.begin(); it != txQueue_.end() && n < 64; ++it, ++n) {
+            size_t off = n == 0 ? txHeadOff_ : 0;
+            iov[n].iov_base = it->data() + off;
+            iov[n].iov_len  = it->size() - off;
+        }
+
+        ssize_t w = ::writev(fd_, iov, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            printf("[UART] Write failed (%s)\n", strerror(errno));
+            return false;
+        }
+
+        txQueued_ -= (size_t)w;
+        size_t left = (size_t)w;
+        while (left > 0) {
+            size_t rest = txQueue_.front().size() - txHeadOff_;
+            if (left < rest) {
+                txHeadOff_ += left;
+                break;
+            }
+            left -= rest;
+            txQueue_.pop_front();
+            txHeadOff_ = 0;
+        }
+    }
+    return true;
+}
+
+/* ── RX (reader thread) ─────────────────────────────────────────────── */
+
+void PcUart::wakeReader()
+{
+    if (wakePipe_[1] >= 0) {
+        char c = 0;
+        (void)!::write(wakePipe_[1], &c, 1);
+    }
+}
+
+unsigned PcUart::waitEvents(bool wantWrite)
+{
+    unsigned events = 0;
+#ifdef __linux__
+    if (wantWrite != outArmed_) {
+        epoll_event ev = {};
+        ev.events  = EPOLLIN | (wantWrite ? (uint32_t)EPOLLOUT : 0u);
+        ev.data.fd = fd_;
+        epoll_ctl(pollFd_, EPOLL_CTL_MOD, fd_, &ev);
+        outArmed_ = wantWrite;
+    }
+
+    epoll_event ev[2];
+    int n = epoll_wait(pollFd_, ev, 2, -1);
+    for (int i = 0; i < n; i++) {
+        if (ev[i].data.fd == wakePipe_[0]) {
+            char drain[64];
+            while (::read(wakePipe_[0], drain, sizeof(drain)) > 0) {}
+            continue;
+        }
+        if (ev[i].events & EPOLLIN)                events |= EV_READ;
+        if (ev[i].events & EPOLLOUT)               events |= EV_WRITE;
+        if (ev[i].events & (EPOLLHUP | EPOLLERR))  events |= EV_HUP;
+    }
+#else
+    pollfd fds[2] = {
+        { fd_, (short)(POLLIN | (wantWrite ? POLLOUT : 0)), 0 },
+        { wakePipe_[0], POLLIN, 0 },
+    };
+    if (poll(fds, 2, -1) > 0) {
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (::read(wakePipe_[0], drain, sizeof(drain)) > 0) {}
+        }
+        if (fds[0].revents & POLLIN)               events |= EV_READ;
+        if (fds[0].revents & POLLOUT)              events |= EV_WRITE;
+        if (fds[0].revents & (POLLHUP | POLLERR))  events |= EV_HUP;
+    }
+#endif
+    return events;
+}
+
+void PcUart::readerLoop()
+{
+    uint8_t buf[4096];
+    bool wantWrite = false;
+
+    while (!stopReader_.load()) {
+        const unsigned events = waitEvents(wantWrite);
+        if (stopReader_.load()) break;
+
+        // Data still queued from write(): send what the port takes now
+        {
+            std::lock_guard<std::mutex> lock(txMutex_);
+            if (txWaiting_) {
+                if (!flushTxLocked()) {
+                    txQueue_.clear();
+                    txHeadOff_ = txQueued_ = 0;
+                }
+                txWaiting_ = txQueued_ != 0;
+            }
+            wantWrite = txWaiting_;
+        }
+
+        if (events & (EV_READ | EV_HUP)) {
+            for (;;) {
+                ssize_t n = ::read(fd_, buf, sizeof(buf));
+                if (n > 0) {
+                    deliver(buf, (size_t)n);
+                    if ((size_t)n < sizeof(buf)) break;
+                    continue;
+                }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                if (n == 0 && !(events & EV_HUP)) break;
+                // Port is gone (e.g. unplugged): report closed so the
+                // owner can close() and reconnect; drop queued TX
+                printf("[UART] Read error (%s), closing\n", n < 0 ? strerror(errno) : "hang-up");
+                {
+                    std::lock_guard<std::mutex> lock(txMutex_);
+                    txQueue_.clear();
+                    txHeadOff_ = txQueued_ = 0;
+                    txWaiting_ = false;
+                }
+                failed_.store(true);
+                return;
+            }
+        }
+    }
+}
+
+#endif // !_WIN32
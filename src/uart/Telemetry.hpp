@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * @file Telemetry.hpp
+ * @brief Typed binary telemetry from the device and its dispatch table.
+ *
+ * Each message is a fixed-layout little-endian struct carried as the
+ * payload of one FrameCodec frame whose type byte is the struct's TYPE.
+ * Field layouts are part of the protocol: change them only together with
+ * the firmware.
+ *
+ * Handlers are registered once, before the port is opened, into a fixed
+ * 256-entry table. dispatch() is then a table lookup, a size check and a
+ * copy into a stack struct — no allocation and no lock, so it runs on the
+ * UART reader thread.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+
+namespace telemetry {
+
+enum class MsgType : uint8_t {
+    PadPressure  = 0x01,
+    AudioLevels  = 0x02,
+    PerfCounters = 0x03,
+};
+
+/// Raw pressure of all 16 pads, sent every scan.
+struct PadPressure {
+    static constexpr MsgType TYPE = MsgType::PadPressure;
+    uint32_t deviceUs;        ///< Device clock
+    uint16_t pressure[16];    ///< Raw sensor values, pads 0..15
+};
+
+/// Peak and RMS per channel (in L/R, out L/R), in dBFS * 10.
+struct AudioLevels {
+    static constexpr MsgType TYPE = MsgType::AudioLevels;
+    uint32_t deviceUs;
+    int16_t  peak[4];
+    int16_t  rms[4];
+};
+
+struct PerfCounters {
+    static constexpr MsgType TYPE = MsgType::PerfCounters;
+    uint32_t deviceUs;
+    uint32_t freeHeap;
+    uint16_t cpuLoad[2];      ///< Per core, 0.01 %
+    uint16_t audioUnderruns;
+    uint16_t maxLoopUs;
+};
+
+static_assert(sizeof(PadPressure) == 36 && sizeof(AudioLevels) == 20 && sizeof(PerfCounters) == 16,
+              "telemetry layouts are part of the protocol");
+
+class Dispatcher {
+public:
+    using RawHandler = std::function<void(const uint8_t* payload, size_t len, uint64_t timestampUs)>;
+
+    /// Handle frames of @p type as raw bytes.
+    void onRaw(uint8_t type, RawHandler fn) { handlers_[type] = std::move(fn); }
+
+    /// Handle @p Msg; frames of the wrong size are counted and dropped.
+    template <typename Msg, typename Fn>
+    void on(Fn fn)
+    {
+        static_assert(std::is_trivially_copyable_v<Msg>, "telemetry messages are plain structs");
+        onRaw(static_cast<uint8_t>(Msg::TYPE),
+              [this, fn = std::move(fn)](const uint8_t* payload, size_t len, uint64_t ts) {
+                  if (len != sizeof(Msg)) {
+                      sizeErrors_.fetch_add(1, std::memory_order_relaxed);
+                      return;
+                  }
+                  Msg msg;
+                  memcpy(&msg, payload, sizeof(Msg));
+                  fn(msg, ts);
+              });
+    }
+
+    /// Route one decoded frame. @return false if nothing handles @p type
+    bool dispatch(uint8_t type, const uint8_t* payload, size_t len, uint64_t timestampUs)
+    {
+        const RawHandler& h = handlers_[type];
+        if (!h) {
+            unhandled_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        h(payload, len, timestampUs);
+        return true;
+    }
+
+    uint64_t unhandled() const { return unhandled_.load(std::memory_order_relaxed); }
+    uint64_t sizeErrors() const { return sizeErrors_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<RawHandler, 256> handlers_;
+    std::atomic<uint64_t> unhandled_{0};
+    std::atomic<uint64_t> sizeErrors_{0};
+};
+
+/// Most recent @p Msg, written by a handler on the reader thread and read
+/// from any other. Meant for low-rate messages (a short lock per store).
+template <typename Msg>
+class Latest {
+public:
+    void store(const Msg& msg, uint64_t timestampUs)
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        msg_ = msg;
+        timestampUs_ = timestampUs;
+        count_++;
+    }
+
+    /// @return false if no message arrived yet
+    bool load(Msg& msg, uint64_t& timestampUs) const
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (count_ == 0) return false;
+        msg = msg_;
+        timestampUs = timestampUs_;
+        return true;
+    }
+
+    uint64_t count() const
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return count_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    Msg      msg_{};
+    uint64_t timestampUs_ = 0;
+    uint64_t count_       = 0;
+};
+
+} // namespace telemetry
@@ -8,6 +8,7 @@
 
 #include "updater/PcUpdater.hpp"
 #include "crosspad_pc_version.h"
+#include "pc_stubs/pc_platform.h"
 
 #include <crosspad/net/IHttpClient.hpp>
 #include <crosspad/platform/PlatformServices.hpp>
@@ -729,6 +730,7 @@ static void launchBatAndExit(const std::string& batPath)
         return;
     }
     // Terminate immediately — _exit() works from any thread and skips CRT cleanup
+    pc_platform_sync_state();
     _exit(0);
 }
 
@@ -0,0 +1,295 @@
+/**
+ * @file VuMeter.cpp
+ * @brief Stereo peak meter: shared poll timer and tick hooks, span invalidation,
+ *        direct drawing.
+ */
+
+#include "VuMeter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vu_meter {
+
+namespace {
+
+struct Meter {
+    lv_obj_t*  obj;
+    bool       vertical;
+    int32_t    gap;
+    Source     source   = nullptr;
+    void*      ctx      = nullptr;
+    Scale      scale    = db_scale;
+    uint8_t    decay    = 230;
+    bool       hasTrack = false;
+    lv_color_t track    = {};
+    int16_t    peak[2]  = {};   // held amplitude
+    int32_t    lit[2]   = {};   // lit length in pixels (what is on screen)
+};
+
+struct Hook {
+    TickHook fn;
+    void*    ctx;
+};
+
+std::vector<Meter*> s_meters;
+std::vector<Hook>   s_hooks;
+lv_timer_t*         s_timer = nullptr;
+
+void timer_cb(lv_timer_t*);
+
+/// Start the shared tick with the first user, stop it after the last.
+void update_timer()
+{
+    const bool needed = !s_meters.empty() || !s_hooks.empty();
+    if (needed && !s_timer) {
+        s_timer = lv_timer_create(timer_cb, PERIOD_MS, nullptr);
+    } else if (!needed && s_timer) {
+        lv_timer_delete(s_timer);
+        s_timer = nullptr;
+    }
+}
+
+Meter* meter_of(lv_obj_t* obj)
+{
+    return obj ? static_cast<Meter*>(lv_obj_get_user_data(obj)) : nullptr;
+}
+
+int32_t lane_length(const Meter& m, const lv_area_t& c)
+{
+    return m.vertical ? lv_area_get_height(&c) : lv_area_get_width(&c);
+}
+
+/// Absolute area of positions [from, to) along lane @p ch.
+lv_area_t lane_area(const Meter& m, const lv_area_t& c, int ch, int32_t from, int32_t to)
+{
+    lv_area_t a;
+    if (m.vertical) {
+        int32_t laneW = (lv_area_get_width(&c) - m.gap) / 2;
+        a.x1 = c.x1 + ch * (laneW + m.gap);
+        a.x2 = a.x1 + laneW - 1;
+        a.y1 = c.y2 - to + 1;
+        a.y2 = c.y2 - from;
+    } else {
+        int32_t laneH = (lv_area_get_height(&c) - m.gap) / 2;
+        a.y1 = c.y1 + ch * (laneH + m.gap);
+        a.y2 = a.y1 + laneH - 1;
+        a.x1 = c.x1 + from;
+        a.x2 = c.x1 + to - 1;
+    }
+    return a;
+}
+
+/// Colour of lane position @p pos: green, then to yellow at 85 %, red at the top.
+lv_color_t color_at(int32_t pos, int32_t len)
+{
+    float pct = len > 0 ? (float)pos / (float)len : 0.0f;
+    if (pct < 0.60f) return lv_color_make(0, 255, 0);
+    if (pct < 0.85f) return lv_color_make((uint8_t)((pct - 0.60f) / 0.25f * 255), 255, 0);
+    float t = std::min((pct - 0.85f) / 0.15f, 1.0f);
+    return lv_color_make(255, (uint8_t)((1.0f - t) * 255), 0);
+}
+
+/// Fill [from, to) of a lane. The gradient runs between the colours of its
+/// end positions, so a pixel's colour depends on where it is, not on the
+/// current level.
+void draw_segment(lv_layer_t* layer, const Meter& m, const lv_area_t& c, int ch,
+                  int32_t from, int32_t to, int32_t len)
+{
+    if (from >= to) return;
+    lv_area_t a = lane_area(m, c, ch, from, to);
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    lv_color_t lo = color_at(from, len);
+    lv_color_t hi = color_at(to - 1, len);
+    if (lv_color_eq(lo, hi)) {
+        dsc.bg_color = lo;
+    } else {
+        // Vertical gradients run top to bottom, i.e. from the lane's high end
+        dsc.bg_grad.dir         = m.vertical ? LV_GRAD_DIR_VER : LV_GRAD_DIR_HOR;
+        dsc.bg_grad.stops_count = 2;
+        dsc.bg_grad.stops[0].color = m.vertical ? hi : lo;
+        dsc.bg_grad.stops[0].opa   = LV_OPA_COVER;
+        dsc.bg_grad.stops[0].frac  = 0;
+        dsc.bg_grad.stops[1].color = m.vertical ? lo : hi;
+        dsc.bg_grad.stops[1].opa   = LV_OPA_COVER;
+        dsc.bg_grad.stops[1].frac  = 255;
+    }
+    lv_draw_rect(layer, &dsc, &a);
+}
+
+void on_draw(lv_event_t* e)
+{
+    Meter* m = static_cast<Meter*>(lv_event_get_user_data(e));
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_area_t c;
+    lv_obj_get_coords(m->obj, &c);
+    const int32_t len = lane_length(*m, c);
+    const int32_t z1  = len * 60 / 100;
+    const int32_t z2  = len * 85 / 100;
+
+    for (int ch = 0; ch < 2; ch++) {
+        if (m->hasTrack) {
+            lv_draw_rect_dsc_t dsc;
+            lv_draw_rect_dsc_init(&dsc);
+            dsc.bg_color = m->track;
+            lv_area_t a = lane_area(*m, c, ch, 0, len);
+            lv_draw_rect(layer, &dsc, &a);
+        }
+        const int32_t lit = m->lit[ch];
+        draw_segment(layer, *m, c, ch, 0, std::min(lit, z1), len);
+        draw_segment(layer, *m, c, ch, z1, std::min(lit, z2), len);
+        draw_segment(layer, *m, c, ch, z2, lit, len);
+    }
+}
+
+void on_event(lv_event_t* e)
+{
+    Meter* m = static_cast<Meter*>(lv_event_get_user_data(e));
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_SIZE_CHANGED:
+        // LVGL repaints the whole object; re-derive lit lengths next tick
+        m->lit[0] = m->lit[1] = 0;
+        break;
+    case LV_EVENT_DELETE:
+        s_meters.erase(std::remove(s_meters.begin(), s_meters.end(), m), s_meters.end());
+        delete m;
+        update_timer();
+        break;
+    default:
+        break;
+    }
+}
+
+void poll(Meter& m)
+{
+    int16_t raw[2] = {};
+    m.source(m.ctx, raw[0], raw[1]);
+
+    lv_area_t c;
+    lv_obj_get_coords(m.obj, &c);
+    const int32_t len = lane_length(m, c);
+
+    for (int ch = 0; ch < 2; ch++) {
+        int16_t held = (int16_t)((m.peak[ch] * m.decay) / 256);
+        m.peak[ch] = std::max(raw[ch], held);
+
+        int32_t px = std::min<int32_t>(m.scale(m.peak[ch], (uint16_t)std::max(len, 0)), len);
+        if (px == m.lit[ch]) continue;
+
+        // Repaint just the span that turned on or off
+        lv_area_t a = lane_area(m, c, ch, std::min(px, m.lit[ch]), std::max(px, m.lit[ch]));
+        lv_obj_invalidate_area(m.obj, &a);
+        m.lit[ch] = px;
+    }
+}
+
+void timer_cb(lv_timer_t*)
+{
+    // By index: a hook may add or remove hooks
+    for (size_t i = 0; i < s_hooks.size(); i++) s_hooks[i].fn(s_hooks[i].ctx);
+
+    for (Meter* m : s_meters) {
+        if (m->source && !lv_obj_has_flag(m->obj, LV_OBJ_FLAG_HIDDEN)) poll(*m);
+    }
+}
+
+} // namespace
+
+uint16_t db_scale(int16_t level, uint16_t max)
+{
+    const int16_t NOISE_GATE = 800;
+    if (level < NOISE_GATE) return 0;
+
+    float normalized = (float)level / 32767.0f;
+    const float GAIN_MULTIPLIER = 3.5f;
+    normalized *= GAIN_MULTIPLIER;
+    if (normalized > 1.0f) normalized = 1.0f;
+
+    float db_normalized;
+    if (normalized < 0.018f) {
+        db_normalized = 0.0f;
+    } else {
+        float db = 20.0f * log10f(normalized);
+        db_normalized = (db + 35.0f) / 35.0f;
+        if (db_normalized < 0.0f) db_normalized = 0.0f;
+        if (db_normalized > 1.0f) db_normalized = 1.0f;
+    }
+
+    uint32_t scaled = (uint32_t)(db_normalized * (float)max);
+    return (uint16_t)(scaled > max ? max : scaled);
+}
+
+lv_obj_t* create(lv_obj_t* parent, bool vertical, int32_t laneGap)
+{
+    lv_obj_t* obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_remove_flag(obj, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
+
+    Meter* m = new Meter;
+    m->obj      = obj;
+    m->vertical = vertical;
+    m->gap      = laneGap;
+    lv_obj_set_user_data(obj, m);
+    lv_obj_add_event_cb(obj, on_draw, LV_EVENT_DRAW_MAIN, m);
+    lv_obj_add_event_cb(obj, on_event, LV_EVENT_ALL, m);
+
+    s_meters.push_back(m);
+    update_timer();
+    return obj;
+}
+
+void set_source(lv_obj_t* meter, Source fn, void* ctx)
+{
+    if (Meter* m = meter_of(meter)) {
+        m->source = fn;
+        m->ctx    = ctx;
+    }
+}
+
+void set_decay(lv_obj_t* meter, uint8_t decay)
+{
+    if (Meter* m = meter_of(meter)) m->decay = decay;
+}
+
+void set_scale(lv_obj_t* meter, Scale fn)
+{
+    if (Meter* m = meter_of(meter)) m->scale = fn ? fn : db_scale;
+}
+
+void set_track_color(lv_obj_t* meter, lv_color_t color)
+{
+    if (Meter* m = meter_of(meter)) {
+        m->hasTrack = true;
+        m->track    = color;
+        lv_obj_invalidate(meter);
+    }
+}
+
+void reset(lv_obj_t* meter)
+{
+    if (Meter* m = meter_of(meter)) {
+        m->peak[0] = m->peak[1] = 0;
+        m->lit[0]  = m->lit[1]  = 0;
+        lv_obj_invalidate(meter);
+    }
+}
+
+void add_tick_hook(TickHook fn, void* ctx)
+{
+    s_hooks.push_back({ fn, ctx });
+    update_timer();
+}
+
+void remove_tick_hook(TickHook fn, void* ctx)
+{
+    s_hooks.erase(std::remove_if(s_hooks.begin(), s_hooks.end(),
+                                 [&](const Hook& h) { return h.fn == fn && h.ctx == ctx; }),
+                  s_hooks.end());
+    update_timer();
+}
+
+} // namespace vu_meter
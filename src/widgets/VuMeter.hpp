@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file VuMeter.hpp
+ * @brief Stereo peak meter drawn straight from its draw callback.
+ *
+ * A meter is one plain LVGL object with two lanes (L/R). It has no child
+ * objects and sets no styles at runtime. It redraws only what actually moved:
+ *
+ *   - all meters share one timer that polls each meter's level source
+ *     (other per-frame work that follows the meters, such as the main VU
+ *     and the mixer's engine → GUI sync, hooks into the same timer);
+ *   - a level is applied only if its pixel height changed;
+ *   - only the span between the old and new height is invalidated.
+ *
+ * The lit part is a green → yellow → red gradient tied to the lane
+ * position, so pixels that stay lit never need repainting.
+ */
+
+#include "lvgl/lvgl.h"
+#include <cstdint>
+
+namespace vu_meter {
+
+/// Fills the current raw peak amplitude (0–32767) per channel. Called from
+/// the shared meter timer (LVGL thread).
+using Source = void (*)(void* ctx, int16_t& left, int16_t& right);
+
+/// Maps a decayed amplitude to 0..max pixels.
+using Scale = uint16_t (*)(int16_t level, uint16_t max);
+
+/// Extra work run on every shared tick, before the meters are polled.
+using TickHook = void (*)(void* ctx);
+
+/// Meter refresh period (shared by every meter).
+static constexpr uint32_t PERIOD_MS = 16;
+
+/**
+ * @brief Create a meter.
+ * @param vertical  lanes side by side growing upward (else stacked, growing right)
+ * @param laneGap   pixels between the two lanes
+ */
+lv_obj_t* create(lv_obj_t* parent, bool vertical, int32_t laneGap = 0);
+
+/// Set where the meter reads levels from; nullptr stops polling it.
+void set_source(lv_obj_t* meter, Source fn, void* ctx);
+
+/// Peak hold decay per tick, n/256 (default 230 ≈ 0.90).
+void set_decay(lv_obj_t* meter, uint8_t decay);
+
+/// Replace the default dB curve.
+void set_scale(lv_obj_t* meter, Scale fn);
+
+/// Draw an unlit lane background (transparent by default).
+void set_track_color(lv_obj_t* meter, lv_color_t color);
+
+/// Drop the held peak and clear the lanes.
+void reset(lv_obj_t* meter);
+
+/// Run @p fn every PERIOD_MS on the shared tick (LVGL thread). The tick
+/// runs while any meter or hook exists.
+void add_tick_hook(TickHook fn, void* ctx);
+
+/// Remove a hook added with the same @p fn and @p ctx.
+void remove_tick_hook(TickHook fn, void* ctx);
+
+/// Default curve: noise gate, then about 35 dB of range above the floor.
+uint16_t db_scale(int16_t level, uint16_t max);
+
+} // namespace vu_meter
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio/AudioBroadcastTap.hpp"
+
+#include <vector>
+
+namespace {
+
+/// Write @p frames frames whose left sample is the running frame index.
+void produce(AudioBroadcastTap& tap, uint32_t& next, uint32_t frames)
+{
+    std::vector<int16_t> chunk((size_t)frames * 2);
+    for (uint32_t i = 0; i < frames; i++) {
+        chunk[i * 2]     = (int16_t)(next + i);
+        chunk[i * 2 + 1] = 0;
+    }
+    tap.write(chunk.data(), frames, 48000);
+    next += frames;
+}
+
+} // namespace
+
+TEST_CASE("AudioBroadcastTap: idle without readers", "[audio]") {
+    AudioBroadcastTap tap(1024);
+    uint32_t next = 0;
+    produce(tap, next, 256);
+    REQUIRE_FALSE(tap.hasReaders());
+    REQUIRE(tap.writePos() == 0);
+}
+
+TEST_CASE("AudioBroadcastTap: readers keep independent cursors", "[audio]") {
+    AudioBroadcastTap tap(1024);
+    auto a = tap.attach();
+    auto b = tap.attach();
+    uint32_t next = 0;
+    produce(tap, next, 300);
+
+    int16_t buf[512 * 2];
+    REQUIRE(tap.read(a, buf, 100) == 100);
+    REQUIRE(buf[0] == 0);
+    REQUIRE(buf[99 * 2] == 99);
+
+    REQUIRE(tap.read(b, buf, 512) == 300);
+    REQUIRE(tap.available(a) == 200);
+    REQUIRE(tap.available(b) == 0);
+
+    REQUIRE(tap.read(a, buf, 512) == 200);
+    REQUIRE(buf[0] == 100);
+    REQUIRE(a.dropped == 0);
+    REQUIRE(b.dropped == 0);
+
+    tap.detach();
+    tap.detach();
+    REQUIRE_FALSE(tap.hasReaders());
+}
+
+TEST_CASE("AudioBroadcastTap: lapped reader skips ahead and counts drops", "[audio]") {
+    AudioBroadcastTap tap(1024);
+    auto slow = tap.attach();
+    uint32_t next = 0;
+    for (int i = 0; i < 10; i++) produce(tap, next, 256);   // 2560 frames
+
+    std::vector<int16_t> buf(2048 * 2);
+    uint32_t n = tap.read(slow, buf.data(), 2048);
+    REQUIRE(n == 1024);
+    REQUIRE(slow.dropped == 2560 - 1024);
+    REQUIRE(buf[0] == (int16_t)(2560 - 1024));   // oldest frame still in the ring
+    REQUIRE(slow.pos == 2560);
+    tap.detach();
+}
@@ -0,0 +1,225 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "pc_stubs/PcDirectoryIndex.hpp"
+#include "test_temp_dir.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void write_file(const fs::path& path, size_t bytes)
+{
+    std::ofstream f(path, std::ios::binary);
+    f << std::string(bytes, 'x');
+}
+
+/// 16-bit stereo PCM WAV with @p frames frames of silence.
+void write_wav(const fs::path& path, uint32_t sampleRate, uint32_t frames)
+{
+    auto le32 = [](std::ofstream& f, uint32_t v) { for (int i = 0; i < 4; i++) f.put(char(v >> (8 * i))); };
+    auto le16 = [](std::ofstream& f, uint16_t v) { f.put(char(v)); f.put(char(v >> 8)); };
+    const uint32_t dataSize = frames * 4;
+
+    std::ofstream f(path, std::ios::binary);
+    f << "RIFF";
+    le32(f, 36 + 10 + dataSize);
+    f << "WAVE";
+    f << "LIST";   // a chunk readers have to skip
+    le32(f, 2);
+    f << "xy";
+    f << "fmt ";
+    le32(f, 16);
+    le16(f, 1);                // PCM
+    le16(f, 2);                // channels
+    le32(f, sampleRate);
+    le32(f, sampleRate * 4);   // byte rate
+    le16(f, 4);                // block align
+    le16(f, 16);               // bits
+    f << "data";
+    le32(f, dataSize);
+    f << std::string(dataSize, '\0');
+}
+
+template <typename Pred>
+bool wait_for(Pred pred)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("PcDirectoryIndex: lists with metadata, caches, paginates", "[dirindex]") {
+    test::TempDir tmp("crosspad_dir");
+    fs::create_directories(tmp / "kits" / "808");
+    write_file(tmp / "b.txt", 10);
+    write_file(tmp / "a.txt", 1234);
+    write_wav(tmp / "loop.WAV", 48000, 24000);
+
+    PcDirectoryIndex index;
+    PcDirectoryIndex::ListingPtr l = index.list(tmp.str() + "/");
+    REQUIRE(l->exists);
+    REQUIRE(l->entries.size() == 4);
+
+    // Folders first, then by name
+    REQUIRE(l->entries[0].name == "kits");
+    REQUIRE(l->entries[0].isFolder);
+    REQUIRE(l->entries[1].name == "a.txt");
+    REQUIRE(l->entries[1].path == tmp.str() + "/a.txt");
+    REQUIRE(l->entries[3].name == "loop.WAV");
+
+    // Sizes, mtimes and durations arrive in later passes
+    REQUIRE(wait_for([&] {
+        auto c = index.cached(tmp.str());
+        return c && c->durationsKnown;
+    }));
+    l = index.cached(tmp.str());
+    REQUIRE(l->detailsKnown);
+    REQUIRE(l->entries[1].size == 1234);
+    REQUIRE(l->entries[1].mtime > 0);
+    REQUIRE(l->entries[3].durationMs == 500);
+    REQUIRE(l->entries[1].durationMs == 0);
+
+    // Second listing is served from the cache
+    REQUIRE(index.list(tmp.str())->entries.size() == 4);
+    REQUIRE(index.stats().hits >= 1);
+
+    // The subfolder was prefetched
+    REQUIRE(wait_for([&] { return index.cached(tmp.str() + "/kits") != nullptr; }));
+    REQUIRE(index.cached(tmp.str() + "/kits")->entries[0].name == "808");
+
+    // Pages: the cached case answers at once
+    PcDirectoryIndex::Page page;
+    index.requestPage(tmp.str(), 1, 2, [&](const PcDirectoryIndex::Page& p) { page = p; });
+    REQUIRE(page.total == 4);
+    REQUIRE(page.entries.size() == 2);
+    REQUIRE(page.entries[0].name == "a.txt");
+
+    // ...a miss answers from the worker
+    std::atomic<bool> done{false};
+    PcDirectoryIndex::Page missing;
+    index.requestPage(tmp.str() + "/nope", 0, 10, [&](const PcDirectoryIndex::Page& p) {
+        missing = p;
+        done = true;
+    });
+    REQUIRE(wait_for([&] { return done.load(); }));
+    REQUIRE_FALSE(missing.exists);
+    REQUIRE(missing.total == 0);
+}
+
+TEST_CASE("PcDirectoryIndex: notices changes", "[dirindex]") {
+    test::TempDir tmp("crosspad_dir");
+    const std::string recordings = tmp.str() + "/crosspad/recordings";
+    fs::create_directories(recordings);
+    write_file(recordings + "/take1.wav", 4);
+
+    PcDirectoryIndex index;
+    index.watchRoot(tmp.str());
+    REQUIRE(index.list(recordings)->entries.size() == 1);
+
+    // Watched: inotify on Linux, the directory mtime elsewhere
+    write_file(recordings + "/take2.wav", 4);
+    REQUIRE(wait_for([&] { return index.list(recordings)->entries.size() == 2; }));
+
+    fs::remove(recordings + "/take1.wav");
+    REQUIRE(wait_for([&] { return index.list(recordings)->entries.size() == 1; }));
+    REQUIRE(index.list(recordings)->entries[0].name == "take2.wav");
+
+    // Outside the watched root the mtime check applies
+    test::TempDir other("crosspad_dir");
+    REQUIRE(index.list(other.str())->entries.empty());
+    write_file(other / "new.txt", 1);
+    REQUIRE(wait_for([&] { return index.list(other.str())->entries.size() == 1; }));
+
+    index.invalidate();
+    REQUIRE(index.stats().invalidations >= 2);
+}
+
+TEST_CASE("PcDirectoryIndex: evicts least recently used directories", "[dirindex]") {
+    test::TempDir tmp("crosspad_dir");
+    const size_t DIRS = PcDirectoryIndex::MAX_CACHED_DIRS + 8;
+    for (size_t i = 0; i < DIRS; i++) fs::create_directories(tmp / ("d" + std::to_string(i)));
+
+    PcDirectoryIndex index;
+    index.watchRoot(tmp.str());
+    for (size_t i = 0; i < DIRS; i++) REQUIRE(index.list(tmp.str() + "/d" + std::to_string(i))->exists);
+
+    // The oldest listings are gone, together with their nodes and watches
+    const PcDirectoryIndex::Stats st = index.stats();
+    REQUIRE(st.dirs <= PcDirectoryIndex::MAX_CACHED_DIRS);
+    REQUIRE(st.watches <= st.dirs);
+    REQUIRE(index.cached(tmp.str() + "/d0") == nullptr);
+    REQUIRE(index.cached(tmp.str() + "/d" + std::to_string(DIRS - 1)) != nullptr);
+
+    // An evicted directory lists again
+    REQUIRE(index.list(tmp.str() + "/d0")->exists);
+}
+
+TEST_CASE("PcDirectoryIndex: listing cost", "[dirindex][.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr int FILES = 5000;
+
+    test::TempDir tmp("crosspad_dir");
+    for (int i = 0; i < FILES; i++) write_file(tmp / ("sample_" + std::to_string(i) + ".wav"), 0);
+
+    // What listDirectory() did before: walk the folder on every call
+    auto t0 = Clock::now();
+    size_t walked = 0;
+    std::error_code ec;
+    for (auto& entry : fs::directory_iterator(tmp.path(), ec)) {
+        std::string path = entry.path().string();
+        walked += entry.is_directory(ec) ? 0 : 1;
+    }
+    const double walkMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    PcDirectoryIndex index;
+    t0 = Clock::now();
+    auto first = index.list(tmp.str());
+    const double missMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    t0 = Clock::now();
+    auto again = index.list(tmp.str());
+    const double hitMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    // A miss elsewhere while the detail passes run
+    test::TempDir small("crosspad_dir");
+    write_file(small / "one.wav", 0);
+    t0 = Clock::now();
+    index.list(small.str());
+    const double busyMissMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    t0 = Clock::now();
+    REQUIRE(wait_for([&] {
+        auto c = index.cached(tmp.str());
+        return c && c->durationsKnown;
+    }));
+    const double detailsMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    std::atomic<bool> done{false};
+    index.invalidate(tmp.str());
+    t0 = Clock::now();
+    index.requestPage(tmp.str(), 0, 50, [&](const PcDirectoryIndex::Page&) { done = true; });
+    const double asyncMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    REQUIRE(wait_for([&] { return done.load(); }));
+
+    printf("[DirIndex] %d files: walk per call %.2f ms, first list %.2f ms, cached %.4f ms, "
+           "other dir during details %.2f ms, details done after %.1f ms more, "
+           "async page request %.4f ms on the caller\n",
+           FILES, walkMs, missMs, hitMs, busyMissMs, detailsMs, asyncMs);
+    REQUIRE(walked == FILES);
+    REQUIRE(first->entries.size() == FILES);
+    REQUIRE(again->entries.size() == FILES);
+}
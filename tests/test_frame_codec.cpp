@@ -0,0 +1,247 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "uart/FrameCodec.hpp"
+#include "uart/Telemetry.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Frame {
+    uint8_t type;
+    std::vector<uint8_t> payload;
+    bool operator==(const Frame& o) const { return type == o.type && payload == o.payload; }
+};
+
+void appendFrame(std::vector<uint8_t>& out, uint8_t type, const std::vector<uint8_t>& payload)
+{
+    uint8_t buf[FrameCodec::maxEncodedSize(FrameCodec::MAX_PAYLOAD)];
+    size_t n = FrameCodec::encode(type, payload.data(), payload.size(), buf);
+    out.insert(out.end(), buf, buf + n);
+}
+
+void appendText(std::vector<uint8_t>& out, const std::string& text)
+{
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+/// Feed @p stream in @p chunk-sized pieces; collect text and frames.
+void decode(FrameCodec& codec, const std::vector<uint8_t>& stream, size_t chunk,
+            std::string& text, std::vector<Frame>& frames)
+{
+    for (size_t off = 0; off < stream.size(); off += chunk) {
+        codec.feed(stream.data() + off, std::min(chunk, stream.size() - off),
+                   [&](const uint8_t* p, size_t n) { text.append(reinterpret_cast<const char*>(p), n); },
+                   [&](uint8_t type, const uint8_t* p, size_t n) {
+                       frames.push_back({ type, std::vector<uint8_t>(p, p + n) });
+                   });
+    }
+}
+
+} // namespace
+
+TEST_CASE("FrameCodec: frames round-trip between text lines", "[uart]") {
+    std::vector<uint8_t> zeros(40, 0);
+    std::vector<uint8_t> big(FrameCodec::MAX_PAYLOAD);
+    for (size_t i = 0; i < big.size(); i++) big[i] = (uint8_t)(i % 7 ? i : 0);
+    std::vector<uint8_t> noZeros(600, 0xAB);   // several full 254-byte COBS blocks
+
+    std::vector<uint8_t> stream;
+    appendText(stream, "I (1) boot: ok\r\nI (2) par");
+    appendFrame(stream, 0x01, { 1, 2, 3 });
+    appendText(stream, "tial line\n");
+    appendFrame(stream, 0x02, zeros);
+    appendFrame(stream, 0x03, big);
+    appendFrame(stream, 0x04, noZeros);
+    appendFrame(stream, 0x05, {});
+    appendText(stream, "done\n");
+
+    const std::vector<Frame> expected = {
+        { 0x01, { 1, 2, 3 } }, { 0x02, zeros }, { 0x03, big }, { 0x04, noZeros }, { 0x05, {} },
+    };
+    for (size_t chunk : { stream.size(), (size_t)1, (size_t)7, (size_t)255 }) {
+        FrameCodec codec;
+        std::string text;
+        std::vector<Frame> frames;
+        decode(codec, stream, chunk, text, frames);
+        REQUIRE(text == "I (1) boot: ok\r\nI (2) partial line\ndone\n");
+        REQUIRE(frames == expected);
+        REQUIRE(codec.stats().crcErrors == 0);
+    }
+
+    uint8_t buf[8];
+    REQUIRE(FrameCodec::encode(0, big.data(), FrameCodec::MAX_PAYLOAD + 1, buf) == 0);
+}
+
+TEST_CASE("FrameCodec: drops corrupt frames and resynchronizes", "[uart]") {
+    std::vector<uint8_t> one, two;
+    appendFrame(one, 0x10, { 'a', 'b', 'c', 0, 'd' });
+    appendFrame(two, 0x11, { 9, 8, 7 });
+
+    SECTION("joined mid-frame") {
+        std::vector<uint8_t> stream(one.begin() + 3, one.end());   // tail, then its closing zero
+        appendText(stream, "lost\n");
+        stream.insert(stream.end(), two.begin(), two.end());
+        appendText(stream, "kept\n");
+
+        FrameCodec codec;
+        std::string text;
+        std::vector<Frame> frames;
+        decode(codec, stream, stream.size(), text, frames);
+        REQUIRE(frames == std::vector<Frame>{ { 0x11, { 9, 8, 7 } } });
+        REQUIRE(text.substr(text.size() - 10) == "lost\nkept\n");   // the line after the tail survives
+        REQUIRE(codec.stats().recovered == 1);
+        REQUIRE(codec.stats().crcErrors == 0);
+    }
+
+    SECTION("bit error") {
+        std::vector<uint8_t> stream = one;
+        stream[4] ^= 0x20;
+        stream.insert(stream.end(), two.begin(), two.end());
+        appendText(stream, "kept\n");
+
+        FrameCodec codec;
+        std::string text;
+        std::vector<Frame> frames;
+        decode(codec, stream, 3, text, frames);
+        REQUIRE(frames == std::vector<Frame>{ { 0x11, { 9, 8, 7 } } });
+        REQUIRE(text == "kept\n");
+        REQUIRE(codec.stats().crcErrors == 1);
+        REQUIRE(codec.stats().droppedBytes == one.size() - 2);
+    }
+
+    SECTION("stray zero in a text stream") {
+        const std::string longLine = std::string(2000, 'y') + "\nnext\n";
+        std::vector<uint8_t> stream = { 'x', 0 };
+        appendText(stream, longLine);
+
+        for (size_t chunk : { (size_t)1, (size_t)64, stream.size() }) {
+            FrameCodec codec;
+            std::string text;
+            std::vector<Frame> frames;
+            decode(codec, stream, chunk, text, frames);
+            REQUIRE(frames.empty());
+            REQUIRE(codec.stats().oversize == 1);
+            REQUIRE(text == "x" + longLine);
+        }
+    }
+
+    SECTION("short text between stray zeros") {
+        std::vector<uint8_t> stream = { 'a', 0 };
+        appendText(stream, "\x1b[0;32mI (5) wifi: up\x1b[0m\r\n");
+        stream.push_back(0);
+        appendText(stream, "after\n");
+        stream.insert(stream.end(), two.begin(), two.end());
+
+        FrameCodec codec;
+        std::string text;
+        std::vector<Frame> frames;
+        decode(codec, stream, 5, text, frames);
+        REQUIRE(text == "a\x1b[0;32mI (5) wifi: up\x1b[0m\r\nafter\n");
+        REQUIRE(frames == std::vector<Frame>{ { 0x11, { 9, 8, 7 } } });
+        REQUIRE(codec.stats().recovered == 2);
+        REQUIRE(codec.stats().crcErrors == 0);
+    }
+}
+
+TEST_CASE("Telemetry: typed dispatch", "[uart]") {
+    telemetry::Dispatcher dispatcher;
+    std::vector<uint16_t> pressures;
+    uint64_t stamp = 0;
+    dispatcher.on<telemetry::PadPressure>([&](const telemetry::PadPressure& m, uint64_t ts) {
+        pressures.assign(m.pressure, m.pressure + 16);
+        stamp = ts;
+    });
+
+    telemetry::PadPressure msg = {};
+    msg.deviceUs = 1234;
+    for (int i = 0; i < 16; i++) msg.pressure[i] = (uint16_t)(i * 100);
+    REQUIRE(dispatcher.dispatch(0x01, reinterpret_cast<const uint8_t*>(&msg), sizeof(msg), 77));
+    REQUIRE(pressures[15] == 1500);
+    REQUIRE(stamp == 77);
+
+    REQUIRE(dispatcher.dispatch(0x01, reinterpret_cast<const uint8_t*>(&msg), sizeof(msg) - 1, 0));
+    REQUIRE(dispatcher.sizeErrors() == 1);
+    REQUIRE_FALSE(dispatcher.dispatch(0x02, nullptr, 0, 0));
+    REQUIRE(dispatcher.unhandled() == 1);
+
+    // What the app keeps of PerfCounters for the stats command
+    telemetry::Latest<telemetry::PerfCounters> latest;
+    telemetry::PerfCounters perf = {};
+    uint64_t at = 0;
+    REQUIRE_FALSE(latest.load(perf, at));
+    dispatcher.on<telemetry::PerfCounters>([&](const telemetry::PerfCounters& m, uint64_t ts) { latest.store(m, ts); });
+    perf.freeHeap = 123456;
+    REQUIRE(dispatcher.dispatch(0x03, reinterpret_cast<const uint8_t*>(&perf), sizeof(perf), 99));
+    perf = {};
+    REQUIRE(latest.load(perf, at));
+    REQUIRE(perf.freeHeap == 123456);
+    REQUIRE(at == 99);
+    REQUIRE(latest.count() == 1);
+}
+
+TEST_CASE("FrameCodec: loopback throughput", "[uart][.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+
+    // Device-like traffic: pad scans and perf counters with the odd log line
+    telemetry::PadPressure pads = {};
+    telemetry::PerfCounters perf = {};
+    for (int i = 0; i < 16; i++) pads.pressure[i] = (uint16_t)(i * 37);   // includes zero bytes
+
+    std::vector<uint8_t> stream;
+    size_t frames = 0;
+    for (unsigned i = 0; stream.size() < 32u * 1024 * 1024; i++) {
+        pads.deviceUs = perf.deviceUs = i * 1000;
+        appendFrame(stream, 0x01, std::vector<uint8_t>(reinterpret_cast<uint8_t*>(&pads),
+                                                       reinterpret_cast<uint8_t*>(&pads) + sizeof(pads)));
+        frames++;
+        if (i % 16 == 0) {
+            appendFrame(stream, 0x03, std::vector<uint8_t>(reinterpret_cast<uint8_t*>(&perf),
+                                                           reinterpret_cast<uint8_t*>(&perf) + sizeof(perf)));
+            frames++;
+        }
+        if (i % 64 == 0) appendText(stream, "I (" + std::to_string(i) + ") pad_task: scan ok\r\n");
+    }
+
+    telemetry::Dispatcher dispatcher;
+    uint64_t padSum = 0, perfCount = 0;
+    dispatcher.on<telemetry::PadPressure>([&](const telemetry::PadPressure& m, uint64_t) { padSum += m.pressure[3]; });
+    dispatcher.on<telemetry::PerfCounters>([&](const telemetry::PerfCounters&, uint64_t) { perfCount++; });
+
+    // Decode + dispatch in PcUart's 4 KiB read chunks
+    FrameCodec codec;
+    size_t textBytes = 0;
+    auto t0 = Clock::now();
+    for (size_t off = 0; off < stream.size(); off += 4096) {
+        codec.feed(stream.data() + off, std::min<size_t>(4096, stream.size() - off),
+                   [&](const uint8_t*, size_t n) { textBytes += n; },
+                   [&](uint8_t type, const uint8_t* p, size_t n) { dispatcher.dispatch(type, p, n, 0); });
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    REQUIRE(codec.stats().frames == frames);
+    REQUIRE(codec.stats().crcErrors == 0);
+    REQUIRE(perfCount > 0);
+    printf("[UART] decode: %.2f ns/byte, %.1f M frames/s (%.0f MiB/s, %zu text bytes)\n",
+           sec * 1e9 / (double)stream.size(), (double)frames / sec / 1e6,
+           (double)stream.size() / (1024.0 * 1024.0) / sec, textBytes);
+
+    uint8_t out[FrameCodec::maxEncodedSize(sizeof(pads))];
+    t0 = Clock::now();
+    size_t encoded = 0;
+    for (size_t i = 0; i < frames; i++)
+        encoded += FrameCodec::encode(0x01, reinterpret_cast<const uint8_t*>(&pads), sizeof(pads), out);
+    sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    printf("[UART] encode: %.2f ns/byte, %.1f M frames/s\n",
+           sec * 1e9 / (double)encoded, (double)frames / sec / 1e6);
+
+    BENCHMARK("encode + decode one PadPressure frame") {
+        size_t n = FrameCodec::encode(0x01, reinterpret_cast<const uint8_t*>(&pads), sizeof(pads), out);
+        codec.feed(out, n, [](const uint8_t*, size_t) {},
+                   [&](uint8_t type, const uint8_t* p, size_t len) { dispatcher.dispatch(type, p, len, 0); });
+        return n;
+    };
+}
@@ -1,7 +1,7 @@
 /**
  * @file    test_gui_harness.cpp
  * @brief   GUI integration tests — launches the full simulator and interacts
- *          via the TCP remote control protocol (localhost:19840).
+ *          via the TCP remote control protocol (ephemeral localhost port).
  *
  * These tests exercise the LVGL interface end-to-end: launch app, click on
  * launcher icons, navigate settings, verify screenshot changes, pad input
@@ -9,6 +9,8 @@
  *
  * Requires: bin/CrossPad.exe built and accessible. The test launches it as a
  * subprocess, waits for the TCP server, runs test scenarios, then kills it.
+ * With --jobs N the cases are split across N shard processes (Catch2
+ * --shard-count/--shard-index), each driving its own headless simulator.
  *
  * Protocol: newline-delimited JSON over TCP.
  *   Request:  {"cmd":"screenshot"}\n
@@ -27,6 +29,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <atomic>
+#include <filesystem>
 
 #ifdef _WIN32
 #  ifndef WIN32_LEAN_AND_MEAN
@@ -45,6 +48,7 @@
 #  include <arpa/inet.h>
 #  include <unistd.h>
 #  include <signal.h>
+#  include <sys/wait.h>
    typedef int socket_t;
 #  define CLOSE_SOCKET close
 #  define SOCKET_INVALID (-1)
@@ -93,13 +97,13 @@ static bool json_get_bool(const std::string& json, const std::string& key, bool
 
 class SimulatorClient {
 public:
-    bool connect(int timeoutMs = 10000) {
+    bool connect(int port, int timeoutMs = 10000) {
         sock_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
         if (sock_ == SOCKET_INVALID) return false;
 
         struct sockaddr_in addr = {};
         addr.sin_family = AF_INET;
-        addr.sin_port = htons(19840);
+        addr.sin_port = htons((uint16_t)port);
         inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
 
         int waited = 0;
@@ -124,22 +128,32 @@ public:
     }
 
     std::string sendCommand(const std::string& json) {
+        sendRaw(json);
+        return readLine();
+    }
+
+    /// Send one request line without waiting for the response (pipelining).
+    void sendRaw(const std::string& json) {
         std::string msg = json + "\n";
         send(sock_, msg.c_str(), (int)msg.size(), 0);
+    }
 
-        // Read response (newline-delimited)
-        std::string buf;
+    /// Read the next newline-delimited response; keeps any extra bytes.
+    std::string readLine() {
+        size_t nl;
         char chunk[8192];
-        while (true) {
-            int n = recv(sock_, chunk, sizeof(chunk) - 1, 0);
-            if (n <= 0) break;
-            chunk[n] = '\0';
-            buf.append(chunk, n);
-            if (buf.find('\n') != std::string::npos) break;
+        while ((nl = rxBuf_.find('\n')) == std::string::npos) {
+            int n = recv(sock_, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                std::string rest;
+                rest.swap(rxBuf_);
+                return rest;
+            }
+            rxBuf_.append(chunk, n);
         }
-        // Strip trailing newline
-        if (!buf.empty() && buf.back() == '\n') buf.pop_back();
-        return buf;
+        std::string line = rxBuf_.substr(0, nl);
+        rxBuf_.erase(0, nl + 1);
+        return line;
     }
 
     // Convenience wrappers
@@ -197,39 +211,82 @@ public:
 
 private:
     socket_t sock_ = SOCKET_INVALID;
+    std::string rxBuf_;
 };
 
 // ── Process management ──
+//
+// Every run gets its own simulator: an ephemeral remote port (reported
+// through --port-file) and a private profile directory, so several
+// harnesses — or a harness next to a developer's simulator — never share
+// a port or overwrite each other's preferences.
+
+static std::string s_workDir;    // per-run scratch: port file + profile
+static bool s_headless = false;  // --headless passed to the simulator
+
+static std::string portFilePath() { return s_workDir + "/port"; }
+
+static std::vector<std::string> simulatorArgs() {
+    std::vector<std::string> args = {
+        "--port=0",
+        "--port-file=" + portFilePath(),
+        "--profile-dir=" + s_workDir + "/profile",
+    };
+    if (s_headless) args.push_back("--headless");
+    return args;
+}
+
+/// Wait for the simulator to report its bound port (0 on timeout).
+static int waitForPort(int timeoutMs) {
+    for (int waited = 0; waited < timeoutMs; waited += 100) {
+        if (FILE* f = fopen(portFilePath().c_str(), "r")) {
+            int port = 0;
+            int n = fscanf(f, "%d", &port);
+            fclose(f);
+            if (n == 1 && port > 0) return port;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return 0;
+}
 
 #ifdef _WIN32
 static HANDLE s_simProcess = NULL;
 
-static bool launchSimulator() {
+static std::string quoteArg(const std::string& a) {
+    return "\"" + a + "\"";
+}
+
+/// CreateProcess wrapper; returns the process handle or NULL.
+static HANDLE spawn(const std::string& exe, const std::vector<std::string>& args) {
+    std::string cmd = quoteArg(exe);
+    for (const auto& a : args) cmd += " " + quoteArg(a);
+
     STARTUPINFOA si = {};
     si.cb = sizeof(si);
     PROCESS_INFORMATION pi = {};
+    std::vector<char> buf(cmd.begin(), cmd.end());
+    buf.push_back('\0');
+    if (!CreateProcessA(NULL, buf.data(), NULL, NULL, FALSE,
+                        CREATE_NEW_PROCESS_GROUP, NULL, NULL, &si, &pi)) {
+        return NULL;
+    }
+    CloseHandle(pi.hThread);
+    return pi.hProcess;
+}
 
+static bool launchSimulator() {
     // Try multiple paths — test may run from project root or from bin/
     const char* paths[] = { "bin\\CrossPad.exe", "CrossPad.exe", "..\\bin\\CrossPad.exe" };
-    bool launched = false;
     for (auto path : paths) {
-        char cmd[MAX_PATH];
-        strncpy(cmd, path, MAX_PATH - 1);
-        cmd[MAX_PATH - 1] = '\0';
-        memset(&pi, 0, sizeof(pi));
-        if (CreateProcessA(NULL, cmd, NULL, NULL, FALSE,
-                           CREATE_NEW_PROCESS_GROUP, NULL, NULL, &si, &pi)) {
-            launched = true;
-            break;
-        }
+        s_simProcess = spawn(path, simulatorArgs());
+        if (s_simProcess) break;
     }
-    if (!launched) {
+    if (!s_simProcess) {
         printf("[GUI Test] Failed to launch simulator (error %lu)\n", GetLastError());
         return false;
     }
-    s_simProcess = pi.hProcess;
-    CloseHandle(pi.hThread);
-    printf("[GUI Test] Simulator launched (PID %lu)\n", pi.dwProcessId);
+    printf("[GUI Test] Simulator launched (PID %lu)\n", GetProcessId(s_simProcess));
     return true;
 }
 
@@ -242,15 +299,57 @@ static void killSimulator() {
         printf("[GUI Test] Simulator killed\n");
     }
 }
+
+static int currentPid() { return (int)GetCurrentProcessId(); }
+
+/// Run @p jobs copies of this executable, one Catch2 shard each.
+static int runShards(const char* self, int jobs, const std::vector<std::string>& catchArgs) {
+    std::vector<HANDLE> procs;
+    for (int i = 0; i < jobs; i++) {
+        std::vector<std::string> args = catchArgs;
+        args.push_back("--allow-running-no-tests");   // more shards than (filtered) cases
+        args.push_back("--shard-count");
+        args.push_back(std::to_string(jobs));
+        args.push_back("--shard-index");
+        args.push_back(std::to_string(i));
+        HANDLE h = spawn(self, args);
+        if (!h) {
+            printf("[GUI Test] Failed to start shard %d\n", i);
+            continue;
+        }
+        procs.push_back(h);
+    }
+
+    int failed = jobs - (int)procs.size();
+    for (size_t i = 0; i < procs.size(); i++) {
+        DWORD code = 1;
+        WaitForSingleObject(procs[i], INFINITE);
+        GetExitCodeProcess(procs[i], &code);
+        CloseHandle(procs[i]);
+        printf("[GUI Test] Shard %zu/%d: %s\n", i + 1, jobs, code == 0 ? "passed" : "FAILED");
+        if (code != 0) failed++;
+    }
+    return failed == 0 ? 0 : 1;
+}
 #else
 static pid_t s_simPid = 0;
 
-static bool launchSimulator() {
-    s_simPid = fork();
-    if (s_simPid == 0) {
-        execl("bin/CrossPad.exe", "CrossPad.exe", NULL);
-        _exit(1);
+/// fork + execv; returns the child pid or -1.
+static pid_t spawn(const std::string& exe, const std::vector<std::string>& args) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(exe.c_str()));
+        for (const auto& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+        argv.push_back(nullptr);
+        execv(exe.c_str(), argv.data());
+        _exit(127);
     }
+    return pid;
+}
+
+static bool launchSimulator() {
+    s_simPid = spawn("bin/CrossPad.exe", simulatorArgs());
     if (s_simPid < 0) return false;
     printf("[GUI Test] Simulator launched (PID %d)\n", s_simPid);
     return true;
@@ -259,25 +358,94 @@ static bool launchSimulator() {
 static void killSimulator() {
     if (s_simPid > 0) {
         kill(s_simPid, SIGTERM);
+        waitpid(s_simPid, nullptr, 0);
         s_simPid = 0;
         printf("[GUI Test] Simulator killed\n");
     }
 }
+
+static int currentPid() { return (int)getpid(); }
+
+/// Run @p jobs copies of this executable, one Catch2 shard each.
+static int runShards(const char* self, int jobs, const std::vector<std::string>& catchArgs) {
+    std::vector<pid_t> pids;
+    for (int i = 0; i < jobs; i++) {
+        std::vector<std::string> args = catchArgs;
+        args.push_back("--allow-running-no-tests");   // more shards than (filtered) cases
+        args.push_back("--shard-count");
+        args.push_back(std::to_string(jobs));
+        args.push_back("--shard-index");
+        args.push_back(std::to_string(i));
+        pid_t pid = spawn(self, args);
+        if (pid < 0) {
+            printf("[GUI Test] Failed to start shard %d\n", i);
+            continue;
+        }
+        pids.push_back(pid);
+    }
+
+    int failed = jobs - (int)pids.size();
+    for (size_t i = 0; i < pids.size(); i++) {
+        int status = 0;
+        waitpid(pids[i], &status, 0);
+        bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        printf("[GUI Test] Shard %zu/%d: %s\n", i + 1, jobs, ok ? "passed" : "FAILED");
+        if (!ok) failed++;
+    }
+    return failed == 0 ? 0 : 1;
+}
 #endif
 
 // ── Shared fixtures ──
 
 static SimulatorClient g_client;
 static bool g_simulatorRunning = false;
+static int  g_simPort = 0;            // bound remote port of our simulator
 
 // ── Main — launch simulator, run tests, cleanup ──
+//
+// Harness options (everything else goes to Catch2):
+//   --jobs N      run N shards in parallel, each with its own headless
+//                 simulator (default: CROSSPAD_GUI_JOBS, else 1)
+//   --headless    start the simulator without a window
 
 int main(int argc, char* argv[]) {
+    int jobs = 1;
+    if (const char* env = getenv("CROSSPAD_GUI_JOBS")) jobs = atoi(env);
+
+    std::vector<std::string> catchArgs;
+    bool sharded = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (arg == "--headless") {
+            s_headless = true;
+        } else {
+            if (arg == "--shard-count") sharded = true;
+            catchArgs.push_back(arg);
+        }
+    }
+
+    // Coordinator: fan out to shard processes, each runs the branch below
+    if (jobs > 1 && !sharded) {
+        if (jobs > 64) jobs = 64;
+        printf("[GUI Test] Running %d shards in parallel\n", jobs);
+        catchArgs.insert(catchArgs.begin(), "--headless");
+        return runShards(argv[0], jobs, catchArgs);
+    }
+
 #ifdef _WIN32
     WSADATA wsa;
     WSAStartup(MAKEWORD(2, 2), &wsa);
 #endif
 
+    std::error_code ec;
+    s_workDir = (std::filesystem::temp_directory_path(ec) /
+                 ("crosspad-gui-" + std::to_string(currentPid()))).string();
+    std::filesystem::remove_all(s_workDir, ec);
+    std::filesystem::create_directories(s_workDir + "/profile", ec);
+
     // Launch simulator
     if (!launchSimulator()) {
         printf("[GUI Test] Cannot start simulator — is bin/CrossPad.exe built?\n");
@@ -286,21 +454,28 @@ int main(int argc, char* argv[]) {
 
     // Connect to remote control
     printf("[GUI Test] Waiting for simulator TCP server...\n");
-    if (!g_client.connect(15000)) {
-        printf("[GUI Test] Failed to connect to simulator on port 19840\n");
+    g_simPort = waitForPort(15000);
+    if (g_simPort == 0 || !g_client.connect(g_simPort, 5000)) {
+        printf("[GUI Test] Failed to connect to simulator (port %d)\n", g_simPort);
         killSimulator();
+        std::filesystem::remove_all(s_workDir, ec);
         return 1;
     }
     g_simulatorRunning = true;
-    printf("[GUI Test] Connected to simulator\n");
+    printf("[GUI Test] Connected to simulator on port %d\n", g_simPort);
 
     // Let LVGL fully initialize (launcher, status bar, etc.)
     std::this_thread::sleep_for(std::chrono::seconds(2));
 
-    int result = Catch::Session().run(argc, argv);
+    // Catch2 wants argv[0] first
+    std::vector<char*> cargv;
+    cargv.push_back(argv[0]);
+    for (auto& a : catchArgs) cargv.push_back(const_cast<char*>(a.c_str()));
+    int result = Catch::Session().run((int)cargv.size(), cargv.data());
 
     g_client.disconnect();
     killSimulator();
+    std::filesystem::remove_all(s_workDir, ec);
 
 #ifdef _WIN32
     WSACleanup();
@@ -318,6 +493,192 @@ TEST_CASE("GUI: Simulator responds to ping", "[gui]") {
     REQUIRE(json_get_bool(resp, "ok") == true);
 }
 
+TEST_CASE("GUI: Pipelined requests are answered in order with their ids", "[gui]") {
+    for (int i = 1; i <= 8; i++)
+        g_client.sendRaw("{\"id\":" + std::to_string(i) + ",\"cmd\":\"stats\"}");
+
+    for (int i = 1; i <= 8; i++) {
+        auto resp = g_client.readLine();
+        REQUIRE(json_get_bool(resp, "ok") == true);
+        REQUIRE(json_get_int(resp, "id", -1) == i);
+    }
+}
+
+TEST_CASE("GUI: Batch runs pad presses and stats in one round trip", "[gui]") {
+    std::string cmds;
+    for (int i = 0; i < 16; i++)
+        cmds += "{\"cmd\":\"pad_press\",\"pad\":" + std::to_string(i) + ",\"velocity\":90},";
+    cmds += R"({"cmd":"stats"})";
+
+    auto resp = g_client.sendCommand("{\"cmd\":\"batch\",\"commands\":[" + cmds + "]}");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_int(resp, "count") == 17);
+
+    // Stats ran in the same turn, after all 16 presses
+    size_t pos = 0;
+    int pressedCount = 0;
+    while ((pos = resp.find("\"pressed\":true", pos)) != std::string::npos) {
+        pressedCount++;
+        pos++;
+    }
+    REQUIRE(pressedCount == 16);
+
+    cmds.clear();
+    for (int i = 0; i < 16; i++)
+        cmds += std::string(i ? "," : "") + "{\"cmd\":\"pad_release\",\"pad\":" + std::to_string(i) + "}";
+    resp = g_client.sendCommand("{\"cmd\":\"batch\",\"commands\":[" + cmds + "]}");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+}
+
+TEST_CASE("GUI: Malformed request gets an error, connection survives", "[gui]") {
+    auto resp = g_client.sendCommand(R"({"cmd":"stats",)");
+    REQUIRE(json_get_bool(resp, "ok", true) == false);
+    REQUIRE(json_get_bool(g_client.ping(), "ok") == true);
+}
+
+TEST_CASE("GUI: Second client is served concurrently", "[gui]") {
+    SimulatorClient second;
+    REQUIRE(second.connect(g_simPort, 2000));
+
+    auto resp = second.sendCommand(R"({"id":"b","cmd":"stats"})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_string(resp, "id") == "b");
+
+    // First connection is still usable
+    REQUIRE(json_get_bool(g_client.ping(), "ok") == true);
+    second.disconnect();
+}
+
+TEST_CASE("GUI: wait_for replies when the condition becomes true", "[gui]") {
+    g_client.sendRaw(R"({"id":"w","cmd":"wait_for","condition":{"type":"pad_pressed","pad":5},"timeout_ms":5000})");
+
+    // Satisfy it from another connection
+    SimulatorClient second;
+    REQUIRE(second.connect(g_simPort, 2000));
+    REQUIRE(json_get_bool(second.padPress(5, 100), "ok") == true);
+
+    auto resp = g_client.readLine();
+    REQUIRE(json_get_string(resp, "id") == "w");
+    REQUIRE(json_get_bool(resp, "met") == true);
+    REQUIRE(json_get_int(resp, "elapsed_ms", -1) < 5000);
+
+    second.padRelease(5);
+    second.disconnect();
+}
+
+TEST_CASE("GUI: wait_for times out with met=false", "[gui]") {
+    auto resp = g_client.sendCommand(
+        R"({"cmd":"wait_for","condition":{"type":"app","name":"NoSuchApp"},"timeout_ms":100})");
+    REQUIRE(json_get_bool(resp, "ok", true) == false);
+    REQUIRE(json_get_bool(resp, "met", true) == false);
+    REQUIRE(json_get_string(resp, "error") == "timeout");
+}
+
+TEST_CASE("GUI: step advances virtual time instantly", "[gui]") {
+    auto resp = g_client.sendCommand(R"({"cmd":"step","ms":100})");
+    REQUIRE(json_get_bool(resp, "ok", true) == false);   // real time by default
+
+    resp = g_client.sendCommand(R"({"cmd":"clock","mode":"virtual"})");
+    REQUIRE(json_get_string(resp, "mode") == "virtual");
+    int t0 = json_get_int(resp, "now_ms");
+
+    // A wait_for timeout expires on the virtual timeline, during the step
+    g_client.sendRaw(R"({"id":"v","cmd":"wait_for","condition":{"type":"app","name":"NoSuchApp"},"timeout_ms":5000})");
+    auto start = std::chrono::steady_clock::now();
+    g_client.sendRaw(R"({"id":"s","cmd":"step","ms":10000})");
+
+    auto waitResp = g_client.readLine();
+    REQUIRE(json_get_string(waitResp, "id") == "v");
+    REQUIRE(json_get_bool(waitResp, "met", true) == false);
+
+    auto stepResp = g_client.readLine();
+    auto realMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    REQUIRE(json_get_string(stepResp, "id") == "s");
+    REQUIRE(json_get_int(stepResp, "now_ms") - t0 == 10000);
+    REQUIRE(json_get_int(stepResp, "timer_runs") > 0);
+    REQUIRE(realMs < 5000);
+
+    resp = g_client.sendCommand(R"({"cmd":"clock","mode":"real"})");
+    REQUIRE(json_get_string(resp, "mode") == "real");
+    REQUIRE(json_get_int(resp, "now_ms") >= t0 + 10000);
+}
+
+TEST_CASE("GUI: play_macro replays a 1 kHz pad roll on virtual time", "[gui]") {
+    g_client.sendCommand(R"({"cmd":"clock","mode":"virtual"})");
+
+    // 50 passes of press@0 / release@1 ms, 2 ms per pass
+    g_client.sendRaw(R"({"id":"m","cmd":"play_macro","wait":true,"repeat":50,"length_ms":2,)"
+                     R"("events":[{"t":0,"type":"pad_press","pad":5,"velocity":90},)"
+                     R"({"t":1,"type":"pad_release","pad":5}]})");
+    g_client.sendRaw(R"({"id":"s","cmd":"step","ms":200})");
+
+    auto macroResp = g_client.readLine();
+    REQUIRE(json_get_string(macroResp, "id") == "m");
+    REQUIRE(json_get_int(macroResp, "played") == 100);
+    REQUIRE(json_get_int(macroResp, "late_max_us", -1) == 0);
+    REQUIRE(json_get_bool(macroResp, "aborted", true) == false);
+
+    auto stepResp = g_client.readLine();
+    REQUIRE(json_get_string(stepResp, "id") == "s");
+
+    auto resp = g_client.sendCommand(R"({"cmd":"play_macro","events":[{"t":0,"type":"warp"}]})");
+    REQUIRE(json_get_bool(resp, "ok", true) == false);
+
+    g_client.sendCommand(R"({"cmd":"clock","mode":"real"})");
+}
+
+TEST_CASE("GUI: subscribe pushes pad events", "[gui]") {
+    auto resp = g_client.sendCommand(R"({"cmd":"subscribe","topics":["pad"]})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+
+    SimulatorClient second;
+    REQUIRE(second.connect(g_simPort, 2000));
+    second.padPress(7, 100);
+
+    // Skip unrelated pad events until pad 7 shows up
+    std::string ev;
+    for (int i = 0; i < 32; i++) {
+        ev = g_client.readLine();
+        if (json_get_int(ev, "pad", -1) == 7) break;
+    }
+    REQUIRE(json_get_string(ev, "event") == "pad");
+    REQUIRE(json_get_bool(ev, "pressed") == true);
+
+    second.padRelease(7);
+    second.disconnect();
+
+    // Events may precede the reply; drain until the unsubscribe answer
+    g_client.sendRaw(R"({"id":"u","cmd":"unsubscribe"})");
+    for (int i = 0; i < 32; i++) {
+        resp = g_client.readLine();
+        if (json_get_string(resp, "id") == "u") break;
+    }
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_int(resp, "dropped", -1) == 0);
+}
+
+TEST_CASE("GUI: stream_frames starts with a keyframe", "[gui]") {
+    auto resp = g_client.sendCommand(R"({"cmd":"stream_frames","encoding":"qoi","region":"lcd"})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_int(resp, "width") == 320);
+    REQUIRE(json_get_int(resp, "height") == 240);
+
+    auto frame = g_client.readLine();
+    REQUIRE(json_get_string(frame, "event") == "frame");
+    REQUIRE(json_get_bool(frame, "key") == true);
+    REQUIRE(json_get_string(frame, "enc") == "qoi");
+    REQUIRE(frame.find("\"data\":\"cW9pZg") != std::string::npos);   // "qoif"
+
+    g_client.sendRaw(R"({"id":"s","cmd":"stream_frames","enable":false})");
+    for (int i = 0; i < 64; i++) {
+        resp = g_client.readLine();
+        if (json_get_string(resp, "id") == "s") break;
+    }
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_int(resp, "sent") >= 1);
+}
+
 TEST_CASE("GUI: Screenshot returns valid image data", "[gui]") {
     auto resp = g_client.screenshot();
     REQUIRE(json_get_bool(resp, "ok") == true);
@@ -325,16 +686,36 @@ TEST_CASE("GUI: Screenshot returns valid image data", "[gui]") {
     int width = json_get_int(resp, "width");
     int height = json_get_int(resp, "height");
 
-    // Simulator window is 490x680 (LCD 320x240 + emulator body)
+    // Simulator window is 490x714 (LCD 320x240 + emulator body)
     REQUIRE(width == 490);
-    REQUIRE(height == 680);
+    REQUIRE(height == 714);
 
     std::string format = json_get_string(resp, "format");
-    REQUIRE(format == "bmp");
+    REQUIRE(format == "png");
 
     // base64 data should be non-empty
     std::string data = json_get_string(resp, "data");
-    REQUIRE(data.size() > 1000); // BMP header + pixel data
+    REQUIRE(data.size() > 1000); // PNG header + pixel data
+}
+
+TEST_CASE("GUI: Screenshot formats and custom regions", "[gui]") {
+    auto resp = g_client.sendCommand(
+        R"({"cmd":"screenshot","format":"raw","region":{"x":10,"y":20,"w":30,"h":40}})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_string(resp, "format") == "bgra8888");
+    REQUIRE(json_get_int(resp, "size") == 30 * 40 * 4);
+
+    resp = g_client.sendCommand(R"({"cmd":"screenshot","format":"thumb","scale":4,"region":"lcd"})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_int(resp, "width") == 80);
+    REQUIRE(json_get_int(resp, "height") == 60);
+
+    resp = g_client.sendCommand(R"({"cmd":"screenshot","format":"qoi"})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_string(resp, "data").rfind("cW9pZg", 0) == 0);   // "qoif"
+
+    resp = g_client.sendCommand(R"({"cmd":"screenshot","format":"gif"})");
+    REQUIRE(json_get_bool(resp, "ok", true) == false);
 }
 
 TEST_CASE("GUI: Stats show registered apps", "[gui]") {
@@ -349,6 +730,39 @@ TEST_CASE("GUI: Stats show registered apps", "[gui]") {
     REQUIRE(resp.find("\"Display\"") != std::string::npos);
 }
 
+TEST_CASE("GUI: query returns widgets and caches repeats", "[gui]") {
+    auto resp = g_client.sendCommand(R"({"cmd":"query","type":"label","limit":4})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(resp.find(R"("type":"label")") != std::string::npos);
+    REQUIRE(json_get_int(resp, "visited") > 0);
+
+    // Same query twice in one LVGL turn: nothing can invalidate in between
+    resp = g_client.sendCommand(
+        R"({"cmd":"batch","commands":[{"cmd":"query","type":"button","depth":12},)"
+        R"({"cmd":"query","type":"button","depth":12}]})");
+    REQUIRE(json_get_bool(resp, "ok") == true);
+    REQUIRE(json_get_bool(resp, "cached") == true);
+
+    resp = g_client.sendCommand(R"({"cmd":"query","root":"s.999"})");
+    REQUIRE(json_get_bool(resp, "ok", true) == false);
+}
+
+TEST_CASE("GUI: stats reports refresh timing since the last call", "[gui]") {
+    g_client.stats();   // starts a fresh window
+
+    g_client.padPress(5, 100);
+    g_client.waitFrames(4);
+    g_client.padRelease(5);
+    g_client.waitFrames(4);
+
+    auto stats = g_client.stats();
+    auto renderPos = stats.find("\"render\":{");
+    REQUIRE(renderPos != std::string::npos);
+    auto render = stats.substr(renderPos);
+    REQUIRE(json_get_int(render, "refreshes") > 0);
+    REQUIRE(json_get_int(render, "pixels") > 0);
+}
+
 TEST_CASE("GUI: Pad press via remote changes pad state", "[gui]") {
     // Press pad 0
     auto pressResp = g_client.padPress(0, 100);
@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "remote/ImageCodec.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/// Reference QOI decoder (spec, RGBA output) used to check the encoder.
+std::vector<uint8_t> qoiDecode(const std::vector<uint8_t>& in, int& w, int& h)
+{
+    auto be32 = [&](size_t o) {
+        return (uint32_t)in[o] << 24 | (uint32_t)in[o + 1] << 16 | (uint32_t)in[o + 2] << 8 | in[o + 3];
+    };
+    w = (int)be32(4);
+    h = (int)be32(8);
+
+    std::vector<uint8_t> out((size_t)w * h * 4);
+    uint8_t index[64][4] = {};
+    uint8_t px[4] = { 0, 0, 0, 255 };
+    size_t p = 14;
+    int run = 0;
+
+    for (size_t o = 0; o < out.size(); o += 4) {
+        if (run > 0) {
+            run--;
+        } else {
+            uint8_t b1 = in[p++];
+            if (b1 == 0xFE) {
+                px[0] = in[p++]; px[1] = in[p++]; px[2] = in[p++];
+            } else if (b1 == 0xFF) {
+                px[0] = in[p++]; px[1] = in[p++]; px[2] = in[p++]; px[3] = in[p++];
+            } else if ((b1 & 0xC0) == 0x00) {
+                memcpy(px, index[b1], 4);
+            } else if ((b1 & 0xC0) == 0x40) {
+                px[0] += ((b1 >> 4) & 3) - 2;
+                px[1] += ((b1 >> 2) & 3) - 2;
+                px[2] += (b1 & 3) - 2;
+            } else if ((b1 & 0xC0) == 0x80) {
+                uint8_t b2 = in[p++];
+                int vg = (b1 & 0x3F) - 32;
+                px[0] += vg - 8 + ((b2 >> 4) & 0x0F);
+                px[1] += vg;
+                px[2] += vg - 8 + (b2 & 0x0F);
+            } else {
+                run = b1 & 0x3F;
+            }
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) & 63], px, 4);
+        }
+        memcpy(&out[o], px, 4);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("ImageCodec: base64 matches RFC 4648 vectors", "[codec]") {
+    auto enc = [](const char* s) {
+        return remote::base64_encode(reinterpret_cast<const uint8_t*>(s), strlen(s));
+    };
+    REQUIRE(enc("") == "");
+    REQUIRE(enc("f") == "Zg==");
+    REQUIRE(enc("fo") == "Zm8=");
+    REQUIRE(enc("foo") == "Zm9v");
+    REQUIRE(enc("foobar") == "Zm9vYmFy");
+}
+
+TEST_CASE("ImageCodec: QOI round-trips a strided BGRA image", "[codec]") {
+    const int W = 37, H = 23, STRIDE = W * 4 + 12;
+    std::vector<uint8_t> bgra((size_t)STRIDE * H, 0xAA);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint8_t* p = &bgra[(size_t)y * STRIDE + x * 4];
+            bool flat = y < 8;                       // exercises RUN/INDEX
+            p[0] = flat ? 10 : (uint8_t)(x * 7);     // B
+            p[1] = flat ? 20 : (uint8_t)(x + y);     // G
+            p[2] = flat ? 30 : (uint8_t)(y * 11);    // R
+            p[3] = (x == 5 && y == 20) ? 128 : 255;  // A (one RGBA op)
+        }
+    }
+
+    std::vector<uint8_t> qoi = { 0x55 };   // encoder appends
+    remote::qoi_encode(bgra.data(), W, H, STRIDE, qoi);
+    qoi.erase(qoi.begin());
+    REQUIRE(memcmp(qoi.data(), "qoif", 4) == 0);
+    REQUIRE(qoi.size() < (size_t)W * H * 4);
+
+    int w = 0, h = 0;
+    auto rgba = qoiDecode(qoi, w, h);
+    REQUIRE(w == W);
+    REQUIRE(h == H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            const uint8_t* s = &bgra[(size_t)y * STRIDE + x * 4];
+            const uint8_t* d = &rgba[((size_t)y * W + x) * 4];
+            REQUIRE(d[0] == s[2]);
+            REQUIRE(d[1] == s[1]);
+            REQUIRE(d[2] == s[0]);
+            REQUIRE(d[3] == s[3]);
+        }
+    }
+}
+
+TEST_CASE("ImageCodec: box downscale averages each block", "[codec]") {
+    // 5x4 image, factor 2 -> 2x2 (last column dropped)
+    const int W = 5, H = 4;
+    std::vector<uint8_t> bgra((size_t)W * H * 4);
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            for (int c = 0; c < 4; c++)
+                bgra[((size_t)y * W + x) * 4 + c] = (uint8_t)((x + y) * 10 + c);
+
+    std::vector<uint8_t> out;
+    int w = 0, h = 0;
+    remote::box_downscale(bgra.data(), W, H, W * 4, 2, out, w, h);
+    REQUIRE(w == 2);
+    REQUIRE(h == 2);
+    REQUIRE(out.size() == 16);
+    // Block (0,0): (x+y) in {0,1,1,2} -> mean 10
+    REQUIRE(out[0] == 10);
+    REQUIRE(out[3] == 13);
+    // Block (1,1): (x+y) in {4,5,5,6} -> mean 50
+    REQUIRE(out[12] == 50);
+
+    // A factor larger than the image averages one min(w, h) box
+    remote::box_downscale(bgra.data(), W, H, W * 4, 16, out, w, h);
+    REQUIRE(w == 1);
+    REQUIRE(h == 1);
+    REQUIRE(out.size() == 4);
+    REQUIRE(out[0] == 30);   // mean of x+y over the 4x4 box is 3
+}
+
+TEST_CASE("ImageCodec: PNG output has a valid signature", "[codec]") {
+    std::vector<uint8_t> bgra(16 * 16 * 4, 0x80);
+    std::vector<uint8_t> png;
+    remote::png_encode(bgra.data(), 16, 16, 16 * 4, png);
+    static const uint8_t sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    REQUIRE(png.size() > sizeof(sig));
+    REQUIRE(memcmp(png.data(), sig, sizeof(sig)) == 0);
+}
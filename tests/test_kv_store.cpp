@@ -0,0 +1,158 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "pc_stubs/PcKeyValueStore.hpp"
+#include "crosspad/settings/CrosspadSettings.hpp"
+#include "test_temp_dir.hpp"
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// Write syscalls issued by this process so far (Linux; 0 elsewhere).
+uint64_t write_syscalls()
+{
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    uint64_t value;
+    while (io >> key >> value) {
+        if (key == "syscw:") return value;
+    }
+    return 0;
+}
+
+/// The store as it was: every save rewrites preferences.json in place.
+class RewriteOnSaveStore : public crosspad::IKeyValueStore {
+public:
+    explicit RewriteOnSaveStore(std::string path) : path_(std::move(path)) {}
+
+    bool init() override { return true; }
+    void saveBool(const char* ns, const char* key, bool value) override { save(ns, key, value ? 1 : 0); }
+    void saveU8(const char* ns, const char* key, uint8_t value) override { save(ns, key, value); }
+    void saveI32(const char* ns, const char* key, int32_t value) override { save(ns, key, value); }
+    bool readBool(const char*, const char*, bool d) override { return d; }
+    uint8_t readU8(const char*, const char*, uint8_t d) override { return d; }
+    int32_t readI32(const char*, const char*, int32_t d) override { return d; }
+    void eraseAll() override { store_.clear(); }
+
+    int files = 0;
+
+private:
+    void save(const char* ns, const char* key, int32_t value)
+    {
+        store_[std::string(ns) + "/" + key] = value;
+        JsonDocument doc;
+        for (const auto& [k, v] : store_) doc[k] = v;
+        std::ofstream f(path_);
+        serializeJsonPretty(doc, f);
+        files++;
+    }
+
+    std::string path_;
+    std::map<std::string, int32_t> store_;
+};
+
+} // namespace
+
+TEST_CASE("PcKeyValueStore: saves are written behind as one snapshot", "[settings]") {
+    test::TempDir profile("crosspad_kv");
+    {
+        PcKeyValueStore store;
+        REQUIRE(store.open(profile.str()));
+        for (int i = 0; i < 50; i++) store.saveI32("cfg", ("k" + std::to_string(i)).c_str(), i);
+        store.saveBool("cfg", "flag", true);
+        store.saveU8("cfg", "level", 200);
+
+        // Memory is current at once; the file only after the delay or sync()
+        REQUIRE(store.readI32("cfg", "k49", -1) == 49);
+        REQUIRE(store.snapshotsWritten() == 0);
+        REQUIRE(store.sync());
+        REQUIRE(store.snapshotsWritten() == 1);
+        REQUIRE(fs::exists(profile / "preferences.json"));
+        REQUIRE_FALSE(fs::exists(profile / "preferences.json.tmp"));
+
+        // Saving unchanged values writes nothing
+        store.saveI32("cfg", "k7", 7);
+        REQUIRE(store.sync());
+        REQUIRE(store.snapshotsWritten() == 1);
+
+        store.saveI32("cfg", "k7", -7);
+    }   // destructor writes what is still pending
+
+    PcKeyValueStore reopened;
+    REQUIRE(reopened.open(profile.str()));
+    REQUIRE(reopened.readI32("cfg", "k7", 0) == -7);
+    REQUIRE(reopened.readI32("cfg", "k49", 0) == 49);
+    REQUIRE(reopened.readBool("cfg", "flag", false));
+    REQUIRE(reopened.readU8("cfg", "level", 0) == 200);
+
+    reopened.eraseAll();
+    REQUIRE(reopened.sync());
+    PcKeyValueStore erased;
+    REQUIRE(erased.open(profile.str()));
+    REQUIRE(erased.readI32("cfg", "k7", 123) == 123);
+}
+
+TEST_CASE("PcKeyValueStore: flushes by itself after the delay", "[settings]") {
+    test::TempDir profile("crosspad_kv");
+    PcKeyValueStore store;
+    REQUIRE(store.open(profile.str()));
+
+    store.saveI32("cfg", "a", 1);
+    store.saveI32("cfg", "b", 2);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (store.snapshotsWritten() == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(store.snapshotsWritten() == 1);
+
+    PcKeyValueStore other;
+    REQUIRE(other.open(profile.str()));
+    REQUIRE(other.readI32("cfg", "b", 0) == 2);
+}
+
+TEST_CASE("PcKeyValueStore: settings save cost", "[settings][.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    auto* settings = crosspad::CrosspadSettings::getInstance();
+    constexpr int SAVES = 20;   // e.g. dragging a slider in the settings UI
+
+    test::TempDir before("crosspad_kv");
+    RewriteOnSaveStore old((before / "preferences.json").string());
+    uint64_t w0 = write_syscalls();
+    auto t0 = Clock::now();
+    for (int i = 0; i < SAVES; i++) {
+        settings->LCDbrightness = (uint8_t)(50 + i);
+        settings->saveTo(old);
+    }
+    double oldMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    uint64_t oldWrites = write_syscalls() - w0;
+
+    test::TempDir after("crosspad_kv");
+    PcKeyValueStore store;
+    REQUIRE(store.open(after.str()));
+    w0 = write_syscalls();
+    t0 = Clock::now();
+    for (int i = 0; i < SAVES; i++) {
+        settings->LCDbrightness = (uint8_t)(50 + i);
+        settings->saveTo(store);
+    }
+    double newMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    REQUIRE(store.sync());
+    double syncMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() - newMs;
+    uint64_t newWrites = write_syscalls() - w0;
+
+    printf("[KVStore] %d settings saves, rewrite per key: %.2f ms on the caller, %d files, %llu write syscalls\n",
+           SAVES, oldMs, old.files, (unsigned long long)oldWrites);
+    printf("[KVStore] %d settings saves, write-behind:    %.3f ms on the caller, %u file, %llu write syscalls "
+           "(+%.2f ms sync, fsync'ed)\n",
+           SAVES, newMs, store.snapshotsWritten(), (unsigned long long)newWrites, syncMs);
+    REQUIRE(store.snapshotsWritten() == 1);
+}
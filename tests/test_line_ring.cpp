@@ -0,0 +1,208 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "uart/LineRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> drainAll(LineRing& ring)
+{
+    std::vector<std::string> out;
+    ring.drain([&](std::string_view line, uint64_t) { out.emplace_back(line); });
+    return out;
+}
+
+size_t pushText(LineRing& ring, const std::string& text, uint64_t ts = 0)
+{
+    return ring.push(reinterpret_cast<const uint8_t*>(text.data()), text.size(), ts);
+}
+
+/// Synthetic ESP-IDF style log: ~60-byte lines.
+std::vector<uint8_t> makeLog(size_t bytes)
+{
+    std::vector<uint8_t> out;
+    out.reserve(bytes + 128);
+    for (unsigned i = 0; out.size() < bytes; i++) {
+        char line[128];
+        int n = snprintf(line, sizeof(line), "I (%u) pad_task: note %u vel %u ch 1 latency 42us\r\n",
+                         i * 7, i % 128, (i * 13) % 128);
+        out.insert(out.end(), line, line + n);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("LineRing: frames lines across chunk boundaries", "[uart]") {
+    LineRing ring(16 * 1024, 16);
+
+    REQUIRE(pushText(ring, "hel", 1) == 0);
+    REQUIRE(pushText(ring, "lo\r\nwor", 2) == 1);
+    REQUIRE(pushText(ring, "ld\n\n", 3) == 2);
+
+    std::vector<uint64_t> stamps;
+    std::vector<std::string> lines;
+    ring.drain([&](std::string_view l, uint64_t ts) {
+        lines.emplace_back(l);
+        stamps.push_back(ts);
+    });
+    REQUIRE(lines == std::vector<std::string>{ "hello", "world", "" });
+    REQUIRE(stamps == std::vector<uint64_t>{ 2, 3, 3 });
+    REQUIRE(ring.pending() == 0);
+}
+
+TEST_CASE("LineRing: wraps without splitting lines, drops oldest when full", "[uart]") {
+    LineRing ring(8192, 4);   // the byte ring is rounded up to 2 * MAX_LINE_LENGTH
+    const std::string line(1000, 'a');
+
+    // Many laps of the byte ring, draining as we go: every line intact
+    for (int i = 0; i < 100; i++) {
+        pushText(ring, line.substr(0, 900 + i) + "\n");
+        auto out = drainAll(ring);
+        REQUIRE(out.size() == 1);
+        REQUIRE(out[0].size() == (size_t)(900 + i));
+    }
+
+    // Descriptor queue (4) fills first; the oldest lines make way
+    for (int i = 0; i < 6; i++) pushText(ring, std::to_string(i) + "\n");
+    REQUIRE(ring.dropped() == 2);
+    REQUIRE(drainAll(ring) == std::vector<std::string>{ "2", "3", "4", "5" });
+
+    // Overlong lines are truncated
+    pushText(ring, std::string(LineRing::MAX_LINE_LENGTH + 500, 'x') + "\n");
+    REQUIRE(drainAll(ring)[0].size() == LineRing::MAX_LINE_LENGTH);
+}
+
+TEST_CASE("LineRing: lines pushed from inside drain wrap the descriptor queue", "[uart]") {
+    LineRing ring(8192, 4);
+    for (int i = 0; i < 4; i++) pushText(ring, "L" + std::to_string(i) + "\n");
+
+    // The first callback pushes enough to drop every line queued behind it
+    std::vector<std::string> out;
+    const size_t n = ring.drain([&](std::string_view line, uint64_t) {
+        out.emplace_back(line);
+        if (out.size() == 1)
+            for (int i = 4; i < 11; i++) pushText(ring, "L" + std::to_string(i) + "\n");
+    });
+    REQUIRE(out == std::vector<std::string>{ "L0", "L7", "L8", "L9", "L10" });
+    REQUIRE(n == 5);
+    REQUIRE(ring.pending() == 0);
+    REQUIRE(ring.dropped() == 6);
+
+    // Still consistent afterwards
+    pushText(ring, "after\n");
+    REQUIRE(drainAll(ring) == std::vector<std::string>{ "after" });
+}
+
+TEST_CASE("LineRing: keeps the newest lines with no consumer", "[uart]") {
+    LineRing ring(8192, 1024);   // bytes run out long before descriptors
+
+    // Nobody drains (Serial Monitor closed) while far more than fits arrives
+    for (int i = 0; i < 5000; i++) pushText(ring, "boot line " + std::to_string(i) + " " + std::string(40, '.') + "\n");
+    REQUIRE(ring.dropped() > 0);
+    REQUIRE(ring.pending() + ring.dropped() == 5000);
+
+    auto out = drainAll(ring);
+    REQUIRE_FALSE(out.empty());
+    REQUIRE(out.back().rfind("boot line 4999 ", 0) == 0);
+    for (size_t i = 1; i < out.size(); i++) {
+        // Contiguous run ending at the newest line
+        REQUIRE(out[i - 1].rfind("boot line " + std::to_string(5000 - out.size() + i - 1) + " ", 0) == 0);
+    }
+}
+
+TEST_CASE("LineRing: producer overruns a slow consumer without tearing lines", "[uart]") {
+    LineRing ring(8192, 16);
+    std::atomic<bool> done{false};
+    std::vector<int> seen;
+    bool intact = true;
+
+    std::thread consumer([&] {
+        auto take = [&](std::string_view l, uint64_t) {
+            // Every line is "<n>:" followed by n % 200 copies of (char)('a' + n % 26)
+            int n = std::stoi(std::string(l.substr(0, l.find(':'))));
+            std::string_view body = l.substr(l.find(':') + 1);
+            intact = intact && body == std::string((size_t)(n % 200), (char)('a' + n % 26));
+            seen.push_back(n);
+        };
+        while (!done.load()) ring.drain(take, 3);
+        ring.drain(take);
+    });
+
+    for (int i = 0; i < 20000; i++)
+        pushText(ring, std::to_string(i) + ":" + std::string((size_t)(i % 200), (char)('a' + i % 26)) + "\n");
+    done.store(true);
+    consumer.join();
+
+    REQUIRE(intact);
+    REQUIRE(std::is_sorted(seen.begin(), seen.end()));
+    REQUIRE(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+    REQUIRE(seen.back() == 19999);
+    REQUIRE(seen.size() + ring.dropped() == 20000);
+}
+
+TEST_CASE("LineRing: reader/consumer throughput", "[uart][.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t CHUNK = 4096;   // PcUart's read size
+    const std::vector<uint8_t> log = makeLog(64u * 1024 * 1024);
+
+    // Producer feeds @p bytes in CHUNKs, paced to @p baud (8N1: 10 bits per
+    // byte; 0 = flat out, waiting only for the consumer). The consumer
+    // drains every @p drainMs like the Serial Monitor's poll timer.
+    auto run = [&](size_t bytes, double baud, unsigned drainMs) {
+        LineRing ring;
+        std::atomic<bool> done{false};
+        size_t received = 0;
+        std::thread consumer([&] {
+            while (!done.load() || ring.pending()) {
+                ring.drain([&](std::string_view, uint64_t) { received++; });
+                std::this_thread::sleep_for(std::chrono::milliseconds(drainMs));
+            }
+        });
+
+        size_t expected = 0;
+        auto t0 = Clock::now();
+        for (size_t off = 0; off < bytes; off += CHUNK) {
+            size_t n = std::min(CHUNK, bytes - off);
+            if (baud > 0) {
+                std::this_thread::sleep_until(t0 + std::chrono::microseconds((uint64_t)(off * 10 * 1e6 / baud)));
+            } else {
+                while (ring.pending() > LineRing::DEFAULT_LINES / 2) std::this_thread::yield();
+            }
+            expected += ring.push(log.data() + off, n, off);
+        }
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        done.store(true);
+        consumer.join();
+
+        REQUIRE(received == expected);
+        return std::make_pair(sec, ring.dropped());
+    };
+
+    for (double mbaud : { 3.0, 6.0, 12.0 }) {
+        auto [sec, dropped] = run((size_t)(mbaud * 1e6 / 10 * 0.5), mbaud * 1e6, 50);
+        printf("[UART] %.0f Mbaud for %.2f s, 50 ms drains: %llu dropped\n",
+               mbaud, sec, (unsigned long long)dropped);
+        REQUIRE(dropped == 0);
+    }
+
+    auto [sec, dropped] = run(log.size(), 0, 1);
+    printf("[UART] 64 MiB flat out: %.1f MiB/s (~%.0f Mbaud), %llu dropped\n",
+           (double)log.size() / (1024.0 * 1024.0) / sec, (double)log.size() * 10.0 / sec / 1e6,
+           (unsigned long long)dropped);
+
+    LineRing ring;
+    BENCHMARK("push + drain one 4 KiB chunk") {
+        size_t n = ring.push(log.data(), CHUNK, 0);
+        ring.drain([](std::string_view, uint64_t) {});
+        return n;
+    };
+}
@@ -0,0 +1,41 @@
+/**
+ * @file    test_log_buffer.cpp
+ * @brief   Serial Monitor line history (LogBuffer).
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "apps/serial_monitor/LogBuffer.hpp"
+
+#include <string>
+
+TEST_CASE("LogBuffer: keeps the newest lines within the line cap", "[log_buffer]") {
+    LogBuffer buf(100);
+    for (int i = 0; i < 250; i++) buf.append("line " + std::to_string(i));
+
+    REQUIRE(buf.size() == 100);
+    REQUIRE(buf.firstSeq() == 150);
+    REQUIRE(buf.line(0) == "line 150");
+    REQUIRE(buf.line(99) == "line 249");
+    REQUIRE(buf.line(100).empty());
+
+    buf.clear();
+    REQUIRE(buf.empty());
+    REQUIRE(buf.firstSeq() == 250);
+    buf.append("after clear");
+    REQUIRE(buf.line(0) == "after clear");
+}
+
+TEST_CASE("LogBuffer: memory cap evicts whole chunks", "[log_buffer]") {
+    LogBuffer buf(1000000, 256 * 1024);
+    const std::string payload(1100, 'x');
+    for (int i = 0; i < 2000; i++) buf.append(std::to_string(i) + ":" + payload);
+
+    REQUIRE(buf.memoryBytes() <= 256 * 1024);
+    REQUIRE(buf.firstSeq() + buf.size() == 2000);
+
+    // Survivors are intact and in order, oversized lines are truncated
+    REQUIRE(buf.line(buf.size() - 1).substr(0, 5) == "1999:");
+    REQUIRE(buf.line(0).substr(0, buf.line(0).find(':')) == std::to_string(buf.firstSeq()));
+    REQUIRE(buf.line(0).size() == LogBuffer::MAX_LINE_LENGTH);
+}
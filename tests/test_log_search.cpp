@@ -0,0 +1,71 @@
+/**
+ * @file    test_log_search.cpp
+ * @brief   Serial Monitor background index and search (LogSearch).
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "apps/serial_monitor/LogSearch.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+static LogSearch::Result waitResult(LogSearch& search)
+{
+    LogSearch::Result r;
+    for (int i = 0; i < 500 && !search.takeResult(r); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return r;
+}
+
+TEST_CASE("LogSearch: substring and regex queries over indexed lines", "[log_search]") {
+    LogBuffer buf(10000);
+    LogSearch search(buf);
+    for (int i = 0; i < 5000; i++)
+        search.append(i % 1000 == 7 ? "E (" + std::to_string(i) + ") WiFi: Disconnected"
+                                    : "I (" + std::to_string(i) + ") main: tick");
+
+    uint64_t gen = search.submit("wifi: DISCON", false);
+    LogSearch::Result r = waitResult(search);
+    REQUIRE(r.generation == gen);
+    REQUIRE(r.endSeq == 5000);
+    REQUIRE(r.matches == std::vector<uint64_t>{ 7, 1007, 2007, 3007, 4007 });
+
+    search.submit("^E \\(\\d*7\\) wifi", true);
+    r = waitResult(search);
+    REQUIRE(r.error.empty());
+    REQUIRE(r.matches.size() == 5);
+
+    // Continue from where the last result stopped
+    search.append("E (5000) WiFi: Disconnected");
+    search.submit("disconnected", false, r.endSeq);
+    r = waitResult(search);
+    REQUIRE(r.matches == std::vector<uint64_t>{ 5000 });
+
+    search.submit("([a-z", true);
+    r = waitResult(search);
+    REQUIRE_FALSE(r.error.empty());
+}
+
+TEST_CASE("LogSearch: regex prefilter literal", "[log_search]") {
+    REQUIRE(LogSearch::requiredLiteral("WiFi: (dis)?connected") == "connected");
+    REQUIRE(LogSearch::requiredLiteral("abcd?e") == "abc");
+    REQUIRE(LogSearch::requiredLiteral("err\\.log") == "err.log");
+    REQUIRE(LogSearch::requiredLiteral("\\d+ items") == " items");
+    REQUIRE(LogSearch::requiredLiteral("foo|barbaz").empty());
+    REQUIRE(LogSearch::requiredLiteral("[abc]+x").size() == 1);
+    REQUIRE(LogSearch::requiredLiteral("(a)\\1 ok") == " ok");
+
+    // Escapes that stand for some other character give no literal
+    REQUIRE(LogSearch::requiredLiteral("\\x41BCD").empty());
+    REQUIRE(LogSearch::requiredLiteral("boot\\u0020ok").empty());
+    REQUIRE(LogSearch::requiredLiteral("a\\tb").empty());
+
+    LogBuffer buf(16);
+    LogSearch search(buf);
+    search.append("I (1) main: boot");
+    search.append("I (2) ABCD ready");
+    search.submit("\\x41BCD", true);
+    REQUIRE(waitResult(search).matches == std::vector<uint64_t>{ 1 });
+}
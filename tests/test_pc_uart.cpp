@@ -0,0 +1,241 @@
+/**
+ * @file    test_pc_uart.cpp
+ * @brief   PcUart POSIX backend, end to end over pseudo-terminal pairs.
+ *
+ * PcUart opens the pty's slave side by path like any serial device; the
+ * test plays the remote device on the master fd.
+ */
+
+#ifndef _WIN32
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "uart/PcUart.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <util.h>
+#else
+#include <pty.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Pty {
+    int master = -1;
+    int slave  = -1;
+    std::string path;
+
+    Pty()
+    {
+        char name[128] = {};
+        if (openpty(&master, &slave, name, nullptr, nullptr) == 0) path = name;
+    }
+    ~Pty()
+    {
+        if (slave >= 0) ::close(slave);   // held open so the master never sees a hang-up
+        if (master >= 0) ::close(master);
+    }
+
+    void send(const void* data, size_t len)
+    {
+        auto* p = static_cast<const uint8_t*>(data);
+        while (len > 0) {
+            ssize_t n = ::write(master, p, len);
+            if (n <= 0) break;
+            p += n;
+            len -= (size_t)n;
+        }
+    }
+
+    /// Read from the device side until @p len bytes arrived or 2 s passed.
+    std::string receive(size_t len)
+    {
+        std::string out;
+        auto deadline = Clock::now() + std::chrono::seconds(2);
+        char buf[4096];
+        while (out.size() < len && Clock::now() < deadline) {
+            pollfd p = { master, POLLIN, 0 };
+            if (poll(&p, 1, 50) <= 0) continue;
+            ssize_t n = ::read(master, buf, sizeof(buf));
+            if (n > 0) out.append(buf, (size_t)n);
+        }
+        return out;
+    }
+};
+
+/// Drain lines from @p uart until @p count arrived or 2 s passed.
+std::vector<std::string> waitLines(PcUart& uart, size_t count)
+{
+    std::vector<std::string> lines;
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (lines.size() < count && Clock::now() < deadline) {
+        uart.drainLines([&](std::string_view l, uint64_t) { lines.emplace_back(l); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST_CASE("PcUart: receives lines and transmits over a pty", "[uart]") {
+    Pty pty;
+    REQUIRE(!pty.path.empty());
+
+    PcUart uart;
+    REQUIRE(uart.open(pty.path, static_cast<PcUart::BaudRate>(921600)));   // B921600 is a <termios.h> macro here
+    REQUIRE(uart.isOpen());
+    REQUIRE(uart.getPortName() == pty.path);
+
+    pty.send("I (10) boot: ok\r\nI (11) main: ", 30);
+    pty.send("ready\n", 6);
+    REQUIRE(waitLines(uart, 2) == std::vector<std::string>{ "I (10) boot: ok", "I (11) main: ready" });
+    REQUIRE(uart.totalLinesReceived() == 2);
+
+    // Many small writes arrive intact and in order
+    std::string expected;
+    for (int i = 0; i < 200; i++) {
+        std::string msg = "cmd " + std::to_string(i) + "\r\n";
+        REQUIRE(uart.write(msg) == (int)msg.size());
+        expected += msg;
+    }
+    REQUIRE(pty.receive(expected.size()) == expected);
+
+    // Binary frames are split out of the text, both ways. The frame callback
+    // runs on the reader thread before the line after it is published.
+    const uint8_t payload[4] = { 0, 1, 0, 2 };
+    uint8_t frame[FrameCodec::maxEncodedSize(sizeof(payload))];
+    const size_t frameLen = FrameCodec::encode(0x02, payload, sizeof(payload), frame);
+    std::vector<uint8_t> received;
+    uart.setOnFrameReceived([&](uint8_t type, const uint8_t* p, size_t len, uint64_t) {
+        if (type == 0x02) received.assign(p, p + len);
+    });
+    pty.send("be", 2);
+    pty.send(frame, frameLen);
+    pty.send("fore\n", 5);
+    REQUIRE(waitLines(uart, 1) == std::vector<std::string>{ "before" });
+    REQUIRE(received == std::vector<uint8_t>(payload, payload + sizeof(payload)));
+    REQUIRE(uart.totalFramesReceived() == 1);
+
+    REQUIRE(uart.writeFrame(0x02, payload, sizeof(payload)) == (int)frameLen);
+    REQUIRE(pty.receive(frameLen) == std::string(reinterpret_cast<char*>(frame), frameLen));
+
+    uart.close();
+    REQUIRE_FALSE(uart.isOpen());
+    REQUIRE(uart.write("x") == -1);
+}
+
+TEST_CASE("PcUart: non-standard baud rates", "[uart]") {
+    Pty pty;
+    PcUart uart;
+    REQUIRE(uart.open(pty.path, static_cast<PcUart::BaudRate>(1843200)));
+    REQUIRE(uart.getBaudRate() == static_cast<PcUart::BaudRate>(1843200));
+
+    pty.send("fast\n", 5);
+    REQUIRE(waitLines(uart, 1) == std::vector<std::string>{ "fast" });
+}
+
+TEST_CASE("PcUart: reports a hung-up port as closed", "[uart]") {
+    Pty pty;
+    PcUart uart;
+    REQUIRE(uart.open(pty.path, static_cast<PcUart::BaudRate>(115200)));
+    const std::string path = pty.path;
+
+    // Closing the master hangs up the slave, like unplugging the device
+    ::close(pty.master);
+    pty.master = -1;
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (uart.isOpen() && Clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    REQUIRE_FALSE(uart.isOpen());
+    REQUIRE(uart.write("x") == -1);
+    REQUIRE(uart.getPortName() == path);   // still held until close()
+
+    uart.close();
+    REQUIRE(uart.getPortName().empty());
+
+    // The same object opens a new port afterwards
+    Pty again;
+    REQUIRE(uart.open(again.path, static_cast<PcUart::BaudRate>(115200)));
+    again.send("back\n", 5);
+    REQUIRE(waitLines(uart, 1) == std::vector<std::string>{ "back" });
+}
+
+TEST_CASE("PcUart: pty throughput", "[uart][.benchmark]") {
+    std::vector<uint8_t> log;
+    for (unsigned i = 0; log.size() < 8u * 1024 * 1024; i++) {
+        char line[96];
+        int n = snprintf(line, sizeof(line), "I (%u) pad_task: note %u vel %u\r\n", i, i % 128, i % 100);
+        log.insert(log.end(), line, line + n);
+    }
+
+    // RX: the device side writes paced at the given rate (8N1, 10 bits per
+    // byte; 0 = as fast as the pty takes it), the app drains every 50 ms
+    for (double baud : { 921600.0, 3e6, 12e6, 0.0 }) {
+        Pty pty;
+        PcUart uart;
+        REQUIRE(uart.open(pty.path, static_cast<PcUart::BaudRate>(baud > 0 ? (uint32_t)baud : 3000000)));
+
+        const size_t bytes = baud > 0 ? std::min(log.size(), (size_t)(baud / 10 * 0.5)) : log.size();
+        size_t expected = 0;
+        for (size_t i = 0; i < bytes; i++) expected += log[i] == '\n';
+
+        std::atomic<bool> done{false};
+        std::thread device([&] {
+            auto t0 = Clock::now();
+            for (size_t off = 0; off < bytes; off += 1024) {
+                if (baud > 0)
+                    std::this_thread::sleep_until(t0 + std::chrono::microseconds((uint64_t)(off * 10 * 1e6 / baud)));
+                pty.send(log.data() + off, std::min<size_t>(1024, bytes - off));
+            }
+            done.store(true);
+        });
+
+        size_t got = 0;
+        auto t0 = Clock::now();
+        auto deadline = t0 + std::chrono::seconds(30);
+        while ((!done.load() || got < expected) && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(baud > 0 ? 50 : 1));
+            got += uart.drainLines([](std::string_view, uint64_t) {});
+        }
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        device.join();
+
+        printf("[UART] RX %s: %zu lines in %.2f s (%.1f MiB/s, %llu dropped)\n",
+               baud > 0 ? (std::to_string((int)(baud / 1000)) + " kbaud").c_str() : "flat out",
+               got, sec, (double)bytes / (1024.0 * 1024.0) / sec,
+               (unsigned long long)uart.droppedLines());
+        REQUIRE(got == expected);
+    }
+
+    // TX: many small writes, batched by the queue when the pty is full
+    Pty pty;
+    PcUart uart;
+    REQUIRE(uart.open(pty.path, static_cast<PcUart::BaudRate>(3000000)));
+    const size_t total = 4u * 1024 * 1024;
+    size_t received = 0;
+    std::thread device([&] { received = pty.receive(total).size(); });
+    auto t0 = Clock::now();
+    for (size_t off = 0; off < total; off += 64) {
+        while (uart.write(log.data() + off, 64) < 0) std::this_thread::yield();
+    }
+    device.join();
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    REQUIRE(received == total);
+    printf("[UART] TX 4 MiB in 64 B writes: %.1f MiB/s (~%.0f Mbaud)\n",
+           4.0 / sec, (double)total * 10.0 / sec / 1e6);
+}
+
+#endif // !_WIN32
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "pc_stubs/PcPersistence.hpp"
+#include "test_temp_dir.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string read_file(const fs::path& path)
+{
+    std::ifstream f(path, std::ios::binary);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+} // namespace
+
+TEST_CASE("PcPersistence: coalesces writes per file, newest snapshot wins", "[persistence]") {
+    const test::TempDir dir("crosspad_persist");
+    const std::string a = (dir / "a.json").string();
+    const std::string b = (dir / "b.json").string();
+    std::atomic<int> serialized{0};
+
+    {
+        PcPersistence persistence;
+        for (int i = 0; i < 100; i++) {
+            persistence.schedule(a, [i, &serialized] { serialized++; return "a" + std::to_string(i); });
+        }
+        persistence.schedule(b, [] { return std::string("b"); }, 10'000);
+
+        // Nothing is written on the caller's thread
+        REQUIRE(persistence.stats().written == 0);
+
+        REQUIRE(persistence.flush(a));
+        REQUIRE(read_file(a) == "a99");
+        REQUIRE(serialized == 1);
+        REQUIRE_FALSE(fs::exists(b));
+        REQUIRE_FALSE(fs::exists(a + ".tmp"));
+
+        // Debounced write lands by itself
+        persistence.schedule(a, [] { return std::string("later"); }, 20);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (persistence.stats().written < 2 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        REQUIRE(read_file(a) == "later");
+    }   // destructor writes b
+
+    REQUIRE(read_file(b) == "b");
+}
+
+TEST_CASE("PcPersistence: reports failed writes", "[persistence]") {
+    const test::TempDir dir("crosspad_persist");
+    const std::string bad = (dir / "missing" / "x.json").string();
+
+    PcPersistence persistence;
+    persistence.schedule(bad, [] { return std::string("x"); });
+    REQUIRE_FALSE(persistence.flush(bad));
+    REQUIRE_FALSE(persistence.flush());
+    REQUIRE(persistence.stats().failed == 1);
+}
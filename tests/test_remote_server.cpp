@@ -0,0 +1,123 @@
+/**
+ * @file    test_remote_server.cpp
+ * @brief   RemoteServer connection lifetime: buffer limits and half-closed clients.
+ */
+
+#ifndef _WIN32
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "remote/RemoteServer.hpp"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int connectTo(uint16_t port)
+{
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(s);
+        return -1;
+    }
+    return s;
+}
+
+template <typename Pred>
+bool waitFor(Pred pred)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("RemoteServer: drops clients that overrun its buffers", "[remote]") {
+    std::atomic<int> closed{0};
+    std::atomic<int> lines{0};
+    remote::Server server;
+    REQUIRE(server.start(0,
+        [&](const remote::ConnectionPtr& conn, std::string&& line) {
+            lines++;
+            if (line != "flood") return;
+            const std::string reply(8u << 20, 'r');
+            for (size_t sent = 0; sent <= remote::Connection::MAX_PENDING_BYTES && conn->isOpen(); sent += reply.size())
+                conn->send(reply);
+        },
+        [&](const remote::ConnectionPtr&) { closed++; }));
+
+    SECTION("replies it never reads") {
+        int s = connectTo(server.port());
+        REQUIRE(s >= 0);
+        REQUIRE(::send(s, "flood\n", 6, MSG_NOSIGNAL) == 6);
+        REQUIRE(waitFor([&] { return closed.load() == 1; }));
+        close(s);
+    }
+
+    SECTION("a request line without an end") {
+        int s = connectTo(server.port());
+        REQUIRE(s >= 0);
+        REQUIRE(::send(s, "ping\n", 5, MSG_NOSIGNAL) == 5);
+        const std::string chunk(1u << 20, 'a');
+        for (size_t sent = 0; sent <= remote::Connection::MAX_LINE_BYTES; sent += chunk.size()) {
+            if (::send(s, chunk.data(), chunk.size(), MSG_NOSIGNAL) < 0) break;
+        }
+        REQUIRE(waitFor([&] { return closed.load() == 1; }));
+        REQUIRE(lines.load() == 1);
+        close(s);
+    }
+
+    server.stop();
+}
+
+TEST_CASE("RemoteServer: answers a client that half-closes after its requests", "[remote]") {
+    std::atomic<int> closed{0};
+    struct Responders : std::vector<std::thread> {
+        ~Responders() { for (auto& t : *this) t.join(); }
+    } responders;
+    remote::Server server;
+    REQUIRE(server.start(0,
+        [&](const remote::ConnectionPtr& conn, std::string&& line) {
+            // Replied later from another thread, like the LVGL command queue
+            const auto delay = std::chrono::milliseconds(50 * (int)(responders.size() + 1));
+            responders.emplace_back([conn, line, delay, hold = conn->holdOpen()] {
+                std::this_thread::sleep_for(delay);
+                conn->send("re:" + line);
+            });
+        },
+        [&](const remote::ConnectionPtr&) { closed++; }));
+
+    int s = connectTo(server.port());
+    REQUIRE(s >= 0);
+    REQUIRE(::send(s, "a\nb\n", 4, MSG_NOSIGNAL) == 4);
+    REQUIRE(shutdown(s, SHUT_WR) == 0);
+
+    std::string got;
+    char buf[256];
+    ssize_t n;
+    while ((n = recv(s, buf, sizeof(buf), 0)) > 0) got.append(buf, (size_t)n);
+    REQUIRE(n == 0);
+    REQUIRE(got == "re:a\nre:b\n");
+    REQUIRE(waitFor([&] { return closed.load() == 1; }));
+    close(s);
+
+    server.stop();
+}
+
+#endif // _WIN32
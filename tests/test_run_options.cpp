@@ -0,0 +1,56 @@
+/**
+ * @file    test_run_options.cpp
+ * @brief   Simulator command-line options (pc_platform_parse_args).
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "pc_stubs/pc_platform.h"
+
+#include <initializer_list>
+#include <vector>
+
+static void parse(std::initializer_list<const char*> args) {
+    std::vector<char*> argv = { const_cast<char*>("CrossPad") };
+    for (const char* a : args) argv.push_back(const_cast<char*>(a));
+    pc_platform_parse_args((int)argv.size(), argv.data());
+}
+
+TEST_CASE("Options: port, profile dir and port file", "[options]") {
+    parse({ "--port=0", "--profile-dir=/tmp/cp-profile", "--port-file=/tmp/cp.port" });
+    const PcRunOptions& o = pc_platform_options();
+    REQUIRE(o.remotePort == 0);
+    REQUIRE(o.profileDir == "/tmp/cp-profile");
+    REQUIRE(o.portFile == "/tmp/cp.port");
+
+    parse({ "--port=19841" });
+    REQUIRE(o.remotePort == 19841);
+
+    // Out-of-range values are rejected and leave the port unchanged
+    parse({ "--port=70000" });
+    REQUIRE(o.remotePort == 19841);
+    parse({ "--port=abc" });
+    REQUIRE(o.remotePort == 19841);
+}
+
+TEST_CASE("Options: headless modes", "[options]") {
+    parse({ "--headless=lcd" });
+    REQUIRE(pc_platform_options().headless);
+    REQUIRE(pc_platform_options().lcdOnly);
+
+    parse({ "--headless" });
+    REQUIRE(pc_platform_options().headless);
+    REQUIRE_FALSE(pc_platform_options().lcdOnly);
+}
+
+TEST_CASE("Options: state file format", "[options]") {
+    parse({ "--state-format=binary" });
+    REQUIRE(pc_platform_options().binaryState);
+
+    // Unknown formats keep the current one
+    parse({ "--state-format=yaml" });
+    REQUIRE(pc_platform_options().binaryState);
+
+    parse({ "--state-format=json" });
+    REQUIRE_FALSE(pc_platform_options().binaryState);
+}
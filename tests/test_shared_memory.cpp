@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "remote/SharedMemory.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/// Seqlock read as an external tool would do it.
+std::vector<uint8_t> readFrame(const remote::ShmHeader* h)
+{
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(h);
+    std::vector<uint8_t> px((size_t)h->fbStride * h->fbHeight);
+    uint32_t s1, s2;
+    do {
+        s1 = h->fbSeq.load(std::memory_order_acquire);
+        if (s1 & 1) continue;
+        memcpy(px.data(), base + h->fbOffset, px.size());
+        std::atomic_thread_fence(std::memory_order_acquire);
+        s2 = h->fbSeq.load(std::memory_order_relaxed);
+    } while ((s1 & 1) || s1 != s2);
+    return px;
+}
+
+} // namespace
+
+TEST_CASE("SharedMemory: framebuffer publishes dirty rects", "[shm]") {
+    remote::SharedMemory shm;
+    REQUIRE(shm.open("/crosspad-test-fb", 8, 4, 1024));
+    const remote::ShmHeader* h = shm.header();
+    REQUIRE(h->magic == remote::SHM_MAGIC);
+    REQUIRE(h->fbStride == 32);
+    REQUIRE(h->fbOffset % 64 == 0);
+
+    std::vector<uint8_t> src(32 * 4, 0x11);
+    shm.publishFrame(src.data(), 32, nullptr, 0, 5);   // first publish is full
+    REQUIRE(h->fbFrame == 1);
+    REQUIRE(h->fbSeq.load() == 2);
+    REQUIRE(readFrame(h) == src);
+
+    // Only the dirty rect is copied
+    std::vector<uint8_t> next(32 * 4, 0x22);
+    remote::Rect r = { 2, 1, 3, 2 };
+    shm.publishFrame(next.data(), 32, &r, 1, 6);
+    auto px = readFrame(h);
+    REQUIRE(px[1 * 32 + 2 * 4] == 0x22);
+    REQUIRE(px[2 * 32 + 4 * 4 + 3] == 0x22);
+    REQUIRE(px[0] == 0x11);
+    REQUIRE(px[1 * 32 + 5 * 4] == 0x11);
+    REQUIRE(h->fbTimeMs == 6);
+}
+
+TEST_CASE("SharedMemory: audio ring wraps and counts frames", "[shm]") {
+    remote::SharedMemory shm;
+    REQUIRE(shm.open("/crosspad-test-audio", 4, 4, 1000));
+    const remote::ShmHeader* h = shm.header();
+    REQUIRE(h->audioCapacity == 1024);
+
+    std::vector<int16_t> chunk(256 * 2);
+    for (int i = 0; i < 5; i++) {
+        for (size_t s = 0; s < chunk.size(); s++) chunk[s] = (int16_t)(i * 1000 + s / 2);
+        shm.publishAudio(chunk.data(), 256, 44100);
+    }
+    REQUIRE(h->audioWritePos.load() == 5 * 256);
+    REQUIRE(h->audioRate.load() == 44100);
+
+    // Frame 1024 (5th chunk, first frame) wrapped to slot 0
+    const int16_t* ring = reinterpret_cast<const int16_t*>(
+        reinterpret_cast<const uint8_t*>(h) + h->audioOffset);
+    REQUIRE(ring[0] == 4000);
+    REQUIRE(ring[1] == 4000);
+    REQUIRE(ring[256 * 2] == 1000);
+}
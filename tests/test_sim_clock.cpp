@@ -0,0 +1,25 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "pc_stubs/pc_platform.h"
+
+TEST_CASE("SimClock: virtual time only moves when advanced", "[clock]") {
+    pc_time_set_virtual(true);
+    REQUIRE(pc_time_is_virtual());
+
+    uint64_t t0 = pc_time_us();
+    REQUIRE(pc_time_us() == t0);
+
+    pc_time_advance_us(10 * 1000 * 1000);
+    REQUIRE(pc_time_us() == t0 + 10 * 1000 * 1000);
+    REQUIRE(pc_time_ms() == (uint32_t)((t0 + 10 * 1000 * 1000) / 1000));
+
+    // Resuming real time continues from the virtual reading
+    pc_time_set_virtual(false);
+    REQUIRE_FALSE(pc_time_is_virtual());
+    REQUIRE(pc_time_us() >= t0 + 10 * 1000 * 1000);
+
+    // Advancing is ignored in real mode
+    uint64_t t1 = pc_time_us();
+    pc_time_advance_us(60ull * 1000 * 1000);
+    REQUIRE(pc_time_us() < t1 + 60ull * 1000 * 1000);
+}
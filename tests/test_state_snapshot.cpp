@@ -0,0 +1,297 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "pc_stubs/StateSnapshot.hpp"
+#include "pc_stubs/PcKeyValueStore.hpp"
+#include "pc_stubs/PcDevicePrefs.hpp"
+#include "apps/mixer/AudioMixerEngine.hpp"
+#include "crosspad/settings/CrosspadSettings.hpp"
+#include "test_temp_dir.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// Collects what CrosspadSettings::saveTo() stores.
+class MapStore : public crosspad::IKeyValueStore {
+public:
+    bool init() override { return true; }
+    void saveBool(const char* ns, const char* key, bool value) override { save(ns, key, value ? 1 : 0); }
+    void saveU8(const char* ns, const char* key, uint8_t value) override { save(ns, key, value); }
+    void saveI32(const char* ns, const char* key, int32_t value) override { save(ns, key, value); }
+    bool readBool(const char*, const char*, bool d) override { return d; }
+    uint8_t readU8(const char*, const char*, uint8_t d) override { return d; }
+    int32_t readI32(const char*, const char*, int32_t d) override { return d; }
+    void eraseAll() override { entries.clear(); }
+
+    std::map<std::string, int32_t> entries;
+
+private:
+    void save(const char* ns, const char* key, int32_t value) { entries[std::string(ns) + "/" + key] = value; }
+};
+
+AudioMixerEngine::State sample_mixer_state()
+{
+    AudioMixerEngine::State st{};
+    for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
+        for (int o = 0; o < MIXER_NUM_OUTPUTS; o++)
+            st.routes[i][o] = { 0.25f * float(i + o), (i + o) % 2 == 0 };
+        st.channels[i] = { 0.5f + 0.125f * float(i), i == 1, i == 2 };
+    }
+    st.outputs[0] = { 0.8f, false };
+    st.outputs[1] = { 0.3f, true };
+    return st;
+}
+
+bool same_mixer_state(const AudioMixerEngine::State& a, const AudioMixerEngine::State& b)
+{
+    for (int i = 0; i < MIXER_NUM_INPUTS; i++) {
+        for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+            if (a.routes[i][o].volume != b.routes[i][o].volume) return false;
+            if (a.routes[i][o].enabled != b.routes[i][o].enabled) return false;
+        }
+        if (a.channels[i].volume != b.channels[i].volume || a.channels[i].muted != b.channels[i].muted ||
+            a.channels[i].soloed != b.channels[i].soloed)
+            return false;
+    }
+    for (int o = 0; o < MIXER_NUM_OUTPUTS; o++) {
+        if (a.outputs[o].volume != b.outputs[o].volume || a.outputs[o].muted != b.outputs[o].muted) return false;
+    }
+    return true;
+}
+
+DevicePreferences sample_device_prefs()
+{
+    DevicePreferences p;
+    p.audioOut1  = "Speakers (Realtek High Definition Audio)";
+    p.audioIn1   = "Microphone Array";
+    p.midiOut    = "loopMIDI Port 1";
+    p.midiIn     = "CrossPad MIDI";
+    p.sdcardPath = "/home/user/crosspad-sd";
+    p.uartPort   = "/dev/ttyACM0";
+    p.uartBaud   = 921600;
+    return p;
+}
+
+} // namespace
+
+TEST_CASE("StateSnapshot: fields round-trip, unknown tags are skipped", "[snapshot]") {
+    StateSnapshot::Writer w(StateSnapshot::Kind::Settings);
+    w.putU32(1, 0xDEADBEEF);
+    w.putI32(2, -42);
+    w.putF32(3, 0.75f);
+    w.putBool(4, true);
+    w.putString(5, "hello");
+    size_t mark = w.beginRecord(6);
+    w.putString(1, std::string(200, 'n'));   // record longer than one length byte
+    w.putU32(999, 7);   // a tag this reader does not know
+    w.endRecord(mark);
+    w.putString(1000, "from a newer version");
+    w.putU32(7, 5);
+    const std::string data = w.finish();
+
+    REQUIRE(StateSnapshot::isSnapshot(data));
+    StateSnapshot::Reader r;
+    REQUIRE(StateSnapshot::open(data, StateSnapshot::Kind::Settings, r));
+
+    std::map<uint16_t, StateSnapshot::Field> seen;
+    StateSnapshot::Field f;
+    while (r.next(f)) seen[f.tag] = f;
+    REQUIRE(seen.size() == 8);
+    REQUIRE(seen[1].u32() == 0xDEADBEEF);
+    REQUIRE(seen[2].i32() == -42);
+    REQUIRE(seen[3].f32() == 0.75f);
+    REQUIRE(seen[4].boolean());
+    REQUIRE(seen[5].str() == "hello");
+    REQUIRE(seen[7].u32() == 5);
+
+    // Wrong-sized values read as the default
+    REQUIRE(seen[5].u32(9) == 9);
+    REQUIRE(seen[1].boolean(true));
+
+    StateSnapshot::Reader rec = seen[6].record();
+    REQUIRE(rec.next(f));
+    REQUIRE(f.tag == 1);
+    REQUIRE(f.str() == std::string(200, 'n'));
+    REQUIRE(rec.next(f));
+    REQUIRE(f.tag == 999);
+    REQUIRE_FALSE(rec.next(f));
+}
+
+TEST_CASE("StateSnapshot: rejects corrupt, foreign and too-new files", "[snapshot]") {
+    StateSnapshot::Writer w(StateSnapshot::Kind::Mixer);
+    w.putString(1, "payload");
+    const std::string good = w.finish();
+    StateSnapshot::Reader r;
+    REQUIRE(StateSnapshot::open(good, StateSnapshot::Kind::Mixer, r));
+
+    REQUIRE_FALSE(StateSnapshot::open(good, StateSnapshot::Kind::Devices, r));
+
+    std::string flipped = good;
+    flipped.back() ^= 0x01;
+    REQUIRE_FALSE(StateSnapshot::open(flipped, StateSnapshot::Kind::Mixer, r));
+
+    REQUIRE_FALSE(StateSnapshot::open(good.substr(0, good.size() - 1), StateSnapshot::Kind::Mixer, r));
+    REQUIRE_FALSE(StateSnapshot::open(good.substr(0, 10), StateSnapshot::Kind::Mixer, r));
+
+    std::string newer = good;
+    newer[6] = static_cast<char>(StateSnapshot::VERSION + 1);   // minVersion
+    REQUIRE_FALSE(StateSnapshot::open(newer, StateSnapshot::Kind::Mixer, r));
+
+    REQUIRE_FALSE(StateSnapshot::isSnapshot("{\n  \"a\": 1\n}"));
+}
+
+TEST_CASE("StateSnapshot: settings, mixer and device prefs round-trip in both formats", "[snapshot]") {
+    MapStore settings;
+    crosspad::CrosspadSettings::getInstance()->saveTo(settings);
+    REQUIRE_FALSE(settings.entries.empty());
+    for (bool binary : { false, true }) {
+        std::map<std::string, int32_t> loaded;
+        REQUIRE(PcKeyValueStore::decode(PcKeyValueStore::encode(settings.entries, binary), loaded));
+        REQUIRE(loaded == settings.entries);
+    }
+
+    const AudioMixerEngine::State mixer = sample_mixer_state();
+    AudioMixerEngine::State fromJson{}, fromSnapshot{};
+    REQUIRE(AudioMixerEngine::stateFromJson(AudioMixerEngine::stateToJson(mixer), fromJson));
+    REQUIRE(AudioMixerEngine::stateFromSnapshot(AudioMixerEngine::stateToSnapshot(mixer), fromSnapshot));
+    REQUIRE(same_mixer_state(fromJson, mixer));
+    REQUIRE(same_mixer_state(fromSnapshot, mixer));
+
+    const DevicePreferences prefs = sample_device_prefs();
+    for (const std::string& data : { prefs.toJson(), prefs.toSnapshot() }) {
+        DevicePreferences loaded;
+        REQUIRE(loaded.parse(data));
+        REQUIRE(loaded.audioOut1 == prefs.audioOut1);
+        REQUIRE(loaded.audioOut2.empty());
+        REQUIRE(loaded.midiIn == prefs.midiIn);
+        REQUIRE(loaded.sdcardPath == prefs.sdcardPath);
+        REQUIRE(loaded.uartPort == prefs.uartPort);
+        REQUIRE(loaded.uartBaud == 921600);
+    }
+    DevicePreferences garbage;
+    REQUIRE_FALSE(garbage.parse("not json"));
+}
+
+TEST_CASE("StateSnapshot: loads whichever format was written last", "[snapshot]") {
+    const test::TempDir dir("crosspad_snap");
+    {
+        PcKeyValueStore store;
+        REQUIRE(store.open(dir.str(), true));
+        store.saveI32("cfg", "x", 1);
+        REQUIRE(store.sync());
+    }
+    REQUIRE(fs::exists(dir / "preferences.bin"));
+    REQUIRE_FALSE(fs::exists(dir / "preferences.json"));
+
+    // Switching back to JSON imports the snapshot, then writes JSON
+    {
+        PcKeyValueStore store;
+        REQUIRE(store.open(dir.str(), false));
+        REQUIRE(store.readI32("cfg", "x", 0) == 1);
+        store.saveI32("cfg", "x", 2);
+        REQUIRE(store.sync());
+    }
+    fs::last_write_time(dir / "preferences.bin",
+                        fs::last_write_time(dir / "preferences.json") - std::chrono::seconds(10));
+
+    std::string path;
+    REQUIRE(StateSnapshot::readNewest((dir / "preferences").string(), [](const std::string&) { return true; }, &path));
+    REQUIRE(path == (dir / "preferences.json").string());
+
+    {
+        PcKeyValueStore store;
+        REQUIRE(store.open(dir.str(), true));
+        REQUIRE(store.readI32("cfg", "x", 0) == 2);
+    }
+
+    // A corrupt newer file falls back to the older one
+    fs::last_write_time(dir / "preferences.bin",
+                        fs::last_write_time(dir / "preferences.json") + std::chrono::seconds(10));
+    {
+        std::fstream f(dir / "preferences.bin", std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-1, std::ios::end);
+        f.put('\x7f');
+    }
+    fs::last_write_time(dir / "preferences.bin",
+                        fs::last_write_time(dir / "preferences.json") + std::chrono::seconds(10));
+    PcKeyValueStore store;
+    REQUIRE(store.open(dir.str(), false));
+    REQUIRE(store.readI32("cfg", "x", 0) == 2);
+
+    REQUIRE_FALSE(StateSnapshot::readNewest((dir / "nothing").string(), [](const std::string&) { return true; }, &path));
+    REQUIRE(path.empty());
+}
+
+TEST_CASE("StateSnapshot: load and store cost against JSON", "[snapshot][.benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr int ROUNDS = 2000;
+
+    MapStore settings;
+    crosspad::CrosspadSettings::getInstance()->saveTo(settings);
+    const AudioMixerEngine::State mixer = sample_mixer_state();
+    const DevicePreferences prefs = sample_device_prefs();
+
+    const test::TempDir dir("crosspad_snap");
+    for (bool binary : { false, true }) {
+        const char* name = binary ? "snapshot" : "JSON";
+        const std::string stem = (dir / (binary ? "bin" : "json")).string();
+        const std::string settingsPath = stem + "_preferences" + StateSnapshot::extension(binary);
+        const std::string mixerPath    = stem + "_mixer" + StateSnapshot::extension(binary);
+        const std::string prefsPath    = stem + "_devices" + StateSnapshot::extension(binary);
+
+        auto t0 = Clock::now();
+        size_t bytes[3] = {};
+        for (int i = 0; i < ROUNDS; i++) {
+            std::string a = PcKeyValueStore::encode(settings.entries, binary);
+            std::string b = binary ? AudioMixerEngine::stateToSnapshot(mixer) : AudioMixerEngine::stateToJson(mixer);
+            std::string c = binary ? prefs.toSnapshot() : prefs.toJson();
+            bytes[0] = a.size();
+            bytes[1] = b.size();
+            bytes[2] = c.size();
+            if (i == 0) {
+                REQUIRE(PcPersistence::writeAtomically(settingsPath, a));
+                REQUIRE(PcPersistence::writeAtomically(mixerPath, b));
+                REQUIRE(PcPersistence::writeAtomically(prefsPath, c));
+            }
+        }
+        const double storeUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / ROUNDS;
+
+        t0 = Clock::now();
+        for (int i = 0; i < ROUNDS; i++) {
+            std::string data;
+            std::map<std::string, int32_t> entries;
+            AudioMixerEngine::State st{};
+            DevicePreferences loaded;
+            StateSnapshot::readFile(settingsPath, data);
+            PcKeyValueStore::decode(data, entries);
+            StateSnapshot::readFile(mixerPath, data);
+            binary ? AudioMixerEngine::stateFromSnapshot(data, st) : AudioMixerEngine::stateFromJson(data, st);
+            StateSnapshot::readFile(prefsPath, data);
+            loaded.parse(data);
+        }
+        const double loadUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / ROUNDS;
+
+        printf("[Snapshot] %-8s settings (%zu keys) %zu B, mixer %zu B, devices %zu B; "
+               "encode all %.1f us, read + decode all %.1f us\n",
+               name, settings.entries.size(), bytes[0], bytes[1], bytes[2], storeUs, loadUs);
+    }
+
+    std::string settingsJson = PcKeyValueStore::encode(settings.entries, false);
+    std::string settingsBin  = PcKeyValueStore::encode(settings.entries, true);
+    BENCHMARK("decode settings, JSON") {
+        std::map<std::string, int32_t> entries;
+        return PcKeyValueStore::decode(settingsJson, entries);
+    };
+    BENCHMARK("decode settings, snapshot") {
+        std::map<std::string, int32_t> entries;
+        return PcKeyValueStore::decode(settingsBin, entries);
+    };
+}
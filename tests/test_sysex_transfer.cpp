@@ -0,0 +1,191 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "midi/SysExTransfer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+namespace {
+
+/// In-process MIDI port pair: messages sent by one side are queued and
+/// delivered to the other on pump(), optionally dropping every Nth packet.
+struct Loopback {
+    std::deque<std::vector<uint8_t>> toB;
+    std::deque<std::vector<uint8_t>> toA;
+    unsigned dropEvery = 0;
+    unsigned counter   = 0;
+
+    SysExTransfer::SendFn sinkTo(std::deque<std::vector<uint8_t>>& q)
+    {
+        return [this, &q](const uint8_t* data, size_t size) {
+            if (dropEvery && (++counter % dropEvery) == 0) return;
+            q.emplace_back(data, data + size);
+        };
+    }
+
+    /// Deliver everything queued; returns number of messages moved.
+    size_t pump(SysExTransfer& a, SysExTransfer& b)
+    {
+        size_t moved = 0;
+        while (!toA.empty() || !toB.empty()) {
+            while (!toB.empty()) {
+                auto msg = std::move(toB.front());
+                toB.pop_front();
+                b.handleSysEx(msg.data(), msg.size());
+                moved++;
+            }
+            while (!toA.empty()) {
+                auto msg = std::move(toA.front());
+                toA.pop_front();
+                a.handleSysEx(msg.data(), msg.size());
+                moved++;
+            }
+        }
+        return moved;
+    }
+};
+
+std::vector<uint8_t> makePayload(size_t size)
+{
+    std::vector<uint8_t> data(size);
+    uint32_t x = 0x12345678;
+    for (auto& b : data) {
+        x = x * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(x >> 24);
+    }
+    return data;
+}
+
+} // namespace
+
+TEST_CASE("SysExTransfer: 7-bit codec round-trip", "[sysex]") {
+    auto raw = makePayload(100);
+    std::vector<uint8_t> enc(SysExTransfer::encodedSize(raw.size()));
+    REQUIRE(SysExTransfer::encode7(raw.data(), raw.size(), enc.data()) == enc.size());
+    for (uint8_t b : enc) REQUIRE(b < 0x80);
+
+    std::vector<uint8_t> dec(raw.size());
+    REQUIRE(SysExTransfer::decode7(enc.data(), enc.size(), dec.data()) == raw.size());
+    REQUIRE(dec == raw);
+}
+
+TEST_CASE("SysExTransfer: loopback delivers payload intact", "[sysex]") {
+    Loopback link;
+    SysExTransfer::Config cfg;
+    cfg.chunkSize = 100;
+    cfg.window    = 4;
+    SysExTransfer a(link.sinkTo(link.toB), cfg);
+    SysExTransfer b(link.sinkTo(link.toA), cfg);
+
+    std::vector<uint8_t> rxBuf(64 * 1024);
+    b.setReceiveBuffer(rxBuf.data(), rxBuf.size());
+
+    size_t receivedSize = 0;
+    b.setOnReceived([&](const uint8_t* data, size_t size) {
+        REQUIRE(data == rxBuf.data());   // reassembled in place
+        receivedSize = size;
+    });
+
+    auto payload = makePayload(10007);   // not a multiple of the chunk size
+    bool done = false, ok = false;
+    REQUIRE(a.send(payload.data(), payload.size(), [&](bool success) { done = true; ok = success; }));
+    REQUIRE_FALSE(a.send(payload.data(), payload.size()));   // one at a time
+
+    link.pump(a, b);
+
+    REQUIRE(done);
+    REQUIRE(ok);
+    REQUIRE(receivedSize == payload.size());
+    REQUIRE(std::equal(payload.begin(), payload.end(), rxBuf.begin()));
+    REQUIRE(a.bytesAcked() == payload.size());
+    REQUIRE(a.getStats().retransmits == 0);
+}
+
+TEST_CASE("SysExTransfer: recovers from dropped packets", "[sysex]") {
+    Loopback link;
+    link.dropEvery = 7;
+    SysExTransfer::Config cfg;
+    cfg.chunkSize    = 64;
+    cfg.window       = 8;
+    cfg.retransmitMs = 10;
+    cfg.maxRetries   = 50;
+    SysExTransfer a(link.sinkTo(link.toB), cfg);
+    SysExTransfer b(link.sinkTo(link.toA), cfg);
+
+    std::vector<uint8_t> rxBuf(8192);
+    b.setReceiveBuffer(rxBuf.data(), rxBuf.size());
+
+    auto payload = makePayload(5000);
+    bool done = false, ok = false;
+    REQUIRE(a.send(payload.data(), payload.size(), [&](bool success) { done = true; ok = success; }));
+
+    uint32_t now = 0;
+    for (int i = 0; i < 10000 && !done; i++) {
+        link.pump(a, b);
+        now += 10;
+        a.poll(now);
+    }
+
+    REQUIRE(done);
+    REQUIRE(ok);
+    REQUIRE(std::equal(payload.begin(), payload.end(), rxBuf.begin()));
+    REQUIRE(a.getStats().retransmits > 0);
+}
+
+TEST_CASE("SysExTransfer: rejects transfers larger than receive buffer", "[sysex]") {
+    Loopback link;
+    SysExTransfer a(link.sinkTo(link.toB));
+    SysExTransfer b(link.sinkTo(link.toA));
+
+    std::vector<uint8_t> rxBuf(1024);
+    b.setReceiveBuffer(rxBuf.data(), rxBuf.size());
+
+    auto payload = makePayload(4096);
+    bool done = false, ok = true;
+    REQUIRE(a.send(payload.data(), payload.size(), [&](bool success) { done = true; ok = success; }));
+    link.pump(a, b);
+
+    REQUIRE(done);
+    REQUIRE_FALSE(ok);
+    REQUIRE_FALSE(a.isSending());
+}
+
+TEST_CASE("SysExTransfer: ignores foreign SysEx", "[sysex]") {
+    SysExTransfer t(nullptr);
+    const uint8_t identity[] = { 0xF0, 0x7E, 0x7F, 0x06, 0x01, 0xF7 };
+    REQUIRE_FALSE(t.handleSysEx(identity, sizeof(identity)));
+}
+
+TEST_CASE("SysExTransfer: loopback throughput", "[sysex][.benchmark]") {
+    Loopback link;
+    SysExTransfer::Config cfg;
+    cfg.chunkSize = 256;
+    cfg.window    = 16;
+    SysExTransfer a(link.sinkTo(link.toB), cfg);
+    SysExTransfer b(link.sinkTo(link.toA), cfg);
+
+    constexpr size_t SIZE = 1024 * 1024;
+    std::vector<uint8_t> rxBuf(SIZE);
+    b.setReceiveBuffer(rxBuf.data(), rxBuf.size());
+    auto payload = makePayload(SIZE);
+
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok = false;
+    a.send(payload.data(), payload.size(), [&](bool success) { ok = success; });
+    link.pump(a, b);
+    auto t1 = std::chrono::steady_clock::now();
+    REQUIRE(ok);
+
+    double sec = std::chrono::duration<double>(t1 - t0).count();
+    printf("[SysEx] 1 MiB loopback: %.2f ms, %.1f MiB/s\n", sec * 1000.0, 1.0 / sec);
+
+    BENCHMARK("1 MiB transfer, 256 B chunks, window 16") {
+        bool success = false;
+        a.send(payload.data(), payload.size(), [&](bool s) { success = s; });
+        link.pump(a, b);
+        return success;
+    };
+}
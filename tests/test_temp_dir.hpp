@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * @file    test_temp_dir.hpp
+ * @brief   Scoped temporary directory for tests that touch the filesystem.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace test {
+
+/// Fresh, empty directory under the system temp dir, removed with its
+/// contents when the object goes out of scope.
+class TempDir {
+public:
+    explicit TempDir(const char* prefix = "crosspad_test")
+    {
+        static std::atomic<unsigned> counter{0};
+        dir_ = std::filesystem::temp_directory_path() /
+               (std::string(prefix) + "_" +
+                std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+                std::to_string(counter++));
+        std::filesystem::create_directories(dir_);
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(dir_, ec);
+    }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    const std::filesystem::path& path() const { return dir_; }
+
+    /// Forward slashes, no trailing slash.
+    std::string str() const { return dir_.generic_string(); }
+
+    std::filesystem::path operator/(const std::filesystem::path& name) const { return dir_ / name; }
+
+private:
+    std::filesystem::path dir_;
+};
+
+} // namespace test